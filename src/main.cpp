@@ -9,12 +9,29 @@
 #include "stellar_xdr.h"
 #include "stellar_account.h"
 #include "stellar_payment.h"
+#include "stellar_sse.h"
 #include "stellar_webserver.h"
+#include "stellar_bench.h"
 // Variable global para el keypair actual
 StellarKeypair* currentKeypair = nullptr;
 StellarNetwork* currentNetwork = nullptr;
 StellarAccount* currentAccount = nullptr;
 StellarPayment* currentPayment = nullptr;
+StellarEventStream* paymentStream = nullptr;
+
+// 'network fund/balance/info' en curso: el resultado se imprime desde loop()
+enum ConsoleRequest {
+    REQUEST_NONE,
+    REQUEST_FUND,
+    REQUEST_BALANCE,
+    REQUEST_INFO
+};
+ConsoleRequest pendingRequest = REQUEST_NONE;
+NetworkFuture networkRequest;
+DynamicJsonDocument* networkDoc = nullptr;
+
+// 'pay send' en curso: avanza desde loop()
+PaymentRequest paymentRequest;
 
 StellarWebServer* webServer = nullptr;
 
@@ -60,7 +77,7 @@ void setup() {
     Serial.println("  Crypto + Storage + Network");
     Serial.println("=================================\n");
 
-    StellarUtils::infoPrint("System", "ESP32 initialized");
+    STELLAR_LOGI("System", "ESP32 initialized");
 
     Serial.println("Memory Info:");
     Serial.println(StellarUtils::getMemoryInfo());
@@ -103,6 +120,14 @@ void setup() {
 void ensureManagers() {
     if (!currentNetwork) {
         currentNetwork = new StellarNetwork(STELLAR_TESTNET);
+        
+        // Sesiones TLS de un arranque anterior (si se guardaron)
+        currentNetwork->loadTlsSessions();
+    }
+    
+    // Peticiones en su propia tarea: loop() sigue atendiendo la web
+    if (!currentNetwork->hasWorker()) {
+        currentNetwork->startWorker();
     }
     
     if (currentKeypair && !currentAccount) {
@@ -114,8 +139,149 @@ void ensureManagers() {
     }
 }
 
+// Pago recibido por el stream de 'pay watch'
+void printPaymentEvent(const PaymentEvent& event, void* /*context*/) {
+    bool incoming = currentKeypair && strcmp(event.to, currentKeypair->getPublicKeyCStr()) == 0;
+    String other = incoming ? String(event.from) : String(event.to);
+    
+    Serial.print(incoming ? "\n⇐ Received " : "\n⇒ Sent ");
+    Serial.print(event.amount);
+    Serial.print(" ");
+    Serial.print(event.assetCode[0] != '\0' ? event.assetCode : "XLM");
+    Serial.print(incoming ? " from " : " to ");
+    Serial.println(other.substring(0, 10) + "...");
+    Serial.print("  TX: ");
+    Serial.println(event.transactionHash);
+}
+
+// Resultado de 'network fund'
+void printFunding() {
+    if (networkRequest.succeeded()) {
+        Serial.println("\n✓ Account funded successfully!");
+        Serial.println("Balance: 10,000 XLM (testnet)");
+
+        // El balance en caché es de antes del fondeo
+        if (currentAccount) currentAccount->invalidateCache();
+    } else {
+        Serial.println("\n✗ Funding failed");
+        Serial.println("Error: " + networkRequest.getError());
+    }
+    Serial.println();
+}
+
+// Resultado de 'network balance'
+void printBalance() {
+    if (networkRequest.succeeded()) {
+        Serial.println("\n--- Account Balance ---");
+
+        JsonArray balances = (*networkDoc)["balances"];
+        for (JsonObject balance : balances) {
+            String assetType = balance["asset_type"];
+            String amount = balance["balance"];
+
+            if (assetType == "native") {
+                Serial.print("XLM: ");
+                Serial.println(amount);
+            } else {
+                String assetCode = balance["asset_code"];
+                Serial.print(assetCode);
+                Serial.print(": ");
+                Serial.println(amount);
+            }
+        }
+
+        Serial.println("----------------------\n");
+    } else {
+        Serial.println("✗ Query failed");
+        Serial.println("Error: " + networkRequest.getError());
+        Serial.println("\nAccount might not be funded yet.");
+        Serial.println("Use 'network fund' to fund it (testnet only)\n");
+    }
+}
+
+// Resultado de 'network info'
+void printAccountInfo() {
+    if (networkRequest.succeeded()) {
+        JsonDocument& doc = *networkDoc;
+
+        Serial.println("\n--- Account Info ---");
+        Serial.print("ID: ");
+        Serial.println(doc["id"].as<String>());
+        Serial.print("Sequence: ");
+        Serial.println(doc["sequence"].as<String>());
+        Serial.print("Subentry Count: ");
+        Serial.println(doc["subentry_count"].as<int>());
+        Serial.println("-------------------\n");
+    } else {
+        Serial.println("✗ Query failed");
+        Serial.println("Error: " + networkRequest.getError());
+        Serial.println();
+    }
+}
+
+// Imprime y libera la petición de la consola (llamar cuando networkRequest termina)
+void finishNetworkRequest() {
+    switch (pendingRequest) {
+        case REQUEST_FUND:    printFunding();     break;
+        case REQUEST_BALANCE: printBalance();     break;
+        case REQUEST_INFO:    printAccountInfo(); break;
+        default: break;
+    }
+
+    delete networkDoc;
+    networkDoc = nullptr;
+    pendingRequest = REQUEST_NONE;
+}
+
+// Lanza una petición de la consola: vuelve al momento y loop() imprime el
+// resultado (si se rechaza, el future ya está terminado con el error)
+void startNetworkRequest(ConsoleRequest request, size_t docSize) {
+    ensureManagers();
+
+    networkDoc = new DynamicJsonDocument(docSize);
+    pendingRequest = request;
+
+    const char* accountId = currentKeypair->getPublicKeyCStr();
+    if (request == REQUEST_FUND) {
+        currentNetwork->fundWithFriendbotAsync(accountId, *networkDoc, networkRequest);
+    } else {
+        currentNetwork->getAccountAsync(accountId, *networkDoc, networkRequest);
+    }
+}
+
+// Resultado de 'pay send'
+void printPaymentResult() {
+    const PaymentResult& result = paymentRequest.getResult();
+
+    if (result.success) {
+        Serial.println("\n✓ Payment successful!");
+        Serial.println("\nTransaction Hash:");
+        Serial.println(result.transactionHash);
+        Serial.print("Ledger: ");
+        Serial.println(result.ledger);
+        Serial.println("\nView on Stellar Explorer:");
+        Serial.print("https://stellar.expert/explorer/testnet/tx/");
+        Serial.println(result.transactionHash);
+    } else {
+        Serial.println("\n✗ Payment failed");
+        Serial.print("Error: ");
+        Serial.println(result.error);
+
+        if (result.error == "Source account does not exist") {
+            Serial.println("Use 'network fund' first (testnet only)");
+        }
+    }
+    Serial.println();
+}
+
 // Helper para limpiar managers
 void cleanupManagers() {
+    // El stream sigue la cuenta anterior
+    if (paymentStream) {
+        delete paymentStream;
+        paymentStream = nullptr;
+    }
+    
     if (currentPayment) {
         delete currentPayment;
         currentPayment = nullptr;
@@ -131,6 +297,20 @@ void loop() {
     // Handle incoming HTTP requests
     if (webServer) webServer->handle();
 
+    // Liberar conexiones HTTPS ociosas
+    if (currentNetwork) currentNetwork->closeIdleConnections();
+
+    // Eventos de 'pay watch' (no bloquea)
+    if (paymentStream) paymentStream->poll();
+
+    // 'network fund/balance/info' terminado en el worker
+    if (pendingRequest != REQUEST_NONE && networkRequest.isDone()) finishNetworkRequest();
+
+    // 'pay send': firma aquí, consulta y envío en el worker
+    if (paymentRequest.isPending() && currentPayment && currentPayment->poll(paymentRequest)) {
+        printPaymentResult();
+    }
+
     if (Serial.available()) {
         String command = Serial.readStringUntil('\n');
         command.trim();
@@ -141,6 +321,8 @@ void loop() {
             Serial.println("help          - Show this help");
             Serial.println("memory        - Show memory stats");
             Serial.println("crypto        - Run crypto tests");
+            Serial.println("crypto ed25519 - Benchmark Ed25519 keygen/sign");
+            Serial.println("crypto bench [case] - Benchmark crypto primitives");
             Serial.println("xdr           - Test XDR encoding");
             Serial.println("\nWallet Commands:");
             Serial.println("wallet new    - Generate new wallet");
@@ -149,15 +331,20 @@ void loop() {
             Serial.println("wallet show   - Show current wallet");
             Serial.println("wallet delete - Delete saved wallet");
             Serial.println("wallet import - Import from secret key");
+            Serial.println("wallet restore - Restore from mnemonic (SEP-0005)");
+            Serial.println("wallet account <n> - Switch to HD account n");
             Serial.println("\nNetwork Commands:");
             Serial.println("network test    - Test Horizon connection");
             Serial.println("network fund    - Fund with Friendbot (testnet)");
             Serial.println("network balance - Get account balance");
             Serial.println("network info    - Get account info");
+            Serial.println("network stats   - Connection reuse and TLS resumption");
+            Serial.println("network save    - Save TLS sessions to flash");
             Serial.println("\nPayment Commands:");
             Serial.println("pay send      - Send XLM payment");
             Serial.println("pay status    - Check last payment status");
             Serial.println("pay history   - View payment history");
+            Serial.println("pay watch     - Stream payments live (toggle)");
             Serial.println("-------------------------\n");
 
         } else if (command == "pay") {
@@ -165,6 +352,7 @@ void loop() {
             Serial.println("pay send      - Send XLM payment");
             Serial.println("pay status    - Check last payment status");
             Serial.println("pay history   - View payment history");
+            Serial.println("pay watch     - Stream payments live (toggle)");
             Serial.println("-------------------------\n");
             
         } else if (command == "pay send") {
@@ -172,16 +360,11 @@ void loop() {
                 Serial.println("\n✗ No wallet loaded. Use 'wallet new' first\n");
             } else if (!WiFi.isConnected()) {
                 Serial.println("\n✗ WiFi not connected\n");
+            } else if (paymentRequest.isPending()) {
+                Serial.println("\n✗ Payment already in progress\n");
             } else {
                 ensureManagers();
                 
-                // Verificar que la cuenta existe
-                if (!currentAccount->isAccountActive()) {
-                    Serial.println("\n✗ Account not funded yet");
-                    Serial.println("Use 'network fund' first (testnet only)\n");
-                    return;
-                }
-                
                 Serial.println("\n--- Send Payment ---");
                 
                 // Pedir destination
@@ -226,30 +409,20 @@ void loop() {
                     return;
                 }
                 
-                // Enviar pago
+                // Enviar pago: loop() imprime el resultado al terminar
+                // (la cuenta fuente se comprueba con datos frescos)
                 Serial.println("\nSending payment...");
                 
-                PaymentResult result = currentPayment->sendPayment(
+                bool started = currentPayment->sendPaymentAsync(
                     destination.c_str(),
                     amount,
-                    memo.length() > 0 ? memo.c_str() : nullptr
+                    memo.length() > 0 ? memo.c_str() : nullptr,
+                    paymentRequest
                 );
                 
-                if (result.success) {
-                    Serial.println("\n✓ Payment successful!");
-                    Serial.println("\nTransaction Hash:");
-                    Serial.println(result.transactionHash);
-                    Serial.print("Ledger: ");
-                    Serial.println(result.ledger);
-                    Serial.println("\nView on Stellar Explorer:");
-                    Serial.print("https://stellar.expert/explorer/testnet/tx/");
-                    Serial.println(result.transactionHash);
-                } else {
-                    Serial.println("\n✗ Payment failed");
-                    Serial.print("Error: ");
-                    Serial.println(result.error);
+                if (!started) {
+                    printPaymentResult();
                 }
-                Serial.println();
             }
             
         } else if (command == "pay status") {
@@ -296,17 +469,14 @@ void loop() {
                 
                 Serial.println("\nFetching payment history...");
                 
-                String response = currentNetwork->getAccountPayments(
-                    currentKeypair->getPublicKey().c_str(),
-                    nullptr,
-                    10
-                );
+                DynamicJsonDocument doc(HORIZON_PAYMENT_DOC_SIZE * 10);
                 
-                if (response.length() > 0) {
-                    DynamicJsonDocument doc(8192);
-                    DeserializationError error = deserializeJson(doc, response);
-                    
-                    if (!error && doc.containsKey("_embedded")) {
+                if (currentNetwork->getAccountPayments(
+                        currentKeypair->getPublicKeyCStr(),
+                        nullptr,
+                        10,
+                        doc)) {
+                    if (doc.containsKey("_embedded")) {
                         JsonArray records = doc["_embedded"]["records"];
                         
                         Serial.println("\n--- Payment History (Last 10) ---");
@@ -356,6 +526,31 @@ void loop() {
                 }
             }
 
+        } else if (command == "pay watch") {
+            if (paymentStream) {
+                delete paymentStream;
+                paymentStream = nullptr;
+                Serial.println("\n✓ Payment stream stopped\n");
+            } else if (!currentKeypair) {
+                Serial.println("\n✗ No wallet loaded\n");
+            } else if (!WiFi.isConnected()) {
+                Serial.println("\n✗ WiFi not connected\n");
+            } else {
+                ensureManagers();
+                
+                paymentStream = new StellarEventStream(*currentNetwork);
+                paymentStream->onPayment(printPaymentEvent);
+                
+                // Si falla, poll() sigue reintentando
+                if (paymentStream->streamPayments(currentKeypair->getPublicKeyCStr())) {
+                    Serial.println("\n✓ Watching payments (run 'pay watch' again to stop)\n");
+                } else {
+                    Serial.println("\n✗ Stream not connected yet, retrying");
+                    Serial.println("Error: " + paymentStream->getLastError());
+                    Serial.println();
+                }
+            }
+
         } else if (command == "memory") {
             Serial.println("\n--- Memory Statistics ---");
             Serial.println(StellarUtils::getMemoryInfo());
@@ -402,12 +597,97 @@ void loop() {
             Serial.println("\nAll crypto tests completed!");
             Serial.println("-------------------------\n");
 
+        } else if (command == "crypto ed25519") {
+            Serial.println("\n--- Ed25519 Benchmark ---");
+
+            // Genérico (rweather) vs tabla de base fija + clave expandida
+            const uint32_t iterations = 20;
+            uint8_t seed[32], pub[32], sig[64], message[32];
+            StellarCrypto::randomBytes(seed, 32);
+            StellarCrypto::randomBytes(message, 32);
+
+            uint32_t start = micros();
+            for (uint32_t i = 0; i < iterations; i++) {
+                Ed25519::derivePublicKey(pub, seed);
+            }
+            uint32_t genericKeygen = (micros() - start) / iterations;
+
+            start = micros();
+            for (uint32_t i = 0; i < iterations; i++) {
+                StellarEd25519::derivePublicKey(pub, seed);
+            }
+            uint32_t tableKeygen = (micros() - start) / iterations;
+
+            start = micros();
+            for (uint32_t i = 0; i < iterations; i++) {
+                Ed25519::sign(sig, seed, pub, message, 32);
+            }
+            uint32_t genericSign = (micros() - start) / iterations;
+
+            Ed25519ExpandedKey key;
+            StellarEd25519::expandKey(seed, pub, key);
+
+            start = micros();
+            for (uint32_t i = 0; i < iterations; i++) {
+                StellarEd25519::sign(key, message, 32, sig);
+            }
+            uint32_t tableSign = (micros() - start) / iterations;
+
+            StellarUtils::secureZero(&key, sizeof(key));
+            StellarUtils::secureZero(seed, 32);
+
+            Serial.print("Keygen: generic ");
+            Serial.print(genericKeygen);
+            Serial.print(" us, table ");
+            Serial.print(tableKeygen);
+            Serial.print(" us (x");
+            Serial.print((float)genericKeygen / (tableKeygen ? tableKeygen : 1), 1);
+            Serial.println(")");
+
+            Serial.print("Sign:   generic ");
+            Serial.print(genericSign);
+            Serial.print(" us, table ");
+            Serial.print(tableSign);
+            Serial.print(" us (x");
+            Serial.print((float)genericSign / (tableSign ? tableSign : 1), 1);
+            Serial.println(")");
+
+            Serial.print("Base table: ");
+            Serial.println(STELLAR_ED25519_BASE_TABLE ? "enabled" : "disabled");
+            Serial.println("-------------------------\n");
+
+        } else if (command.startsWith("crypto bench")) {
+            // "crypto bench sha256" -> solo los casos que empiezan por sha256
+            String filter = command.substring(strlen("crypto bench"));
+            filter.trim();
+
+            Serial.println("\n--- Crypto Benchmark ---");
+            Serial.println(StellarBench::formatHeader());
+
+            BenchResult results[STELLAR_BENCH_MAX_RESULTS];
+            size_t count = StellarBench::run(filter.c_str(), results, STELLAR_BENCH_MAX_RESULTS);
+
+            bool allWithinBudget = true;
+            for (size_t i = 0; i < count; i++) {
+                Serial.println(StellarBench::formatResult(results[i]));
+                allWithinBudget = allWithinBudget && results[i].withinBudget;
+            }
+
+            if (count == 0) {
+                Serial.println("No matching benchmark cases");
+            } else if (!allWithinBudget) {
+                Serial.println("\nSLOW: over the regression budget");
+            }
+            Serial.println("-------------------------\n");
+
         } else if (command == "network") {
             Serial.println("\n--- Network Commands ---");
             Serial.println("network test    - Test connection to Horizon");
             Serial.println("network fund    - Fund account with Friendbot (testnet)");
             Serial.println("network balance - Get account balance");
             Serial.println("network info    - Get account info");
+            Serial.println("network stats   - Connection reuse and TLS resumption counters");
+            Serial.println("network save    - Save TLS sessions to flash (resume after reboot)");
             Serial.println("-------------------------\n");
 
         } else if (command == "network test") {
@@ -427,7 +707,8 @@ void loop() {
             Serial.print("IP: ");
             Serial.println(WiFi.localIP());
 
-            StellarNetwork network(STELLAR_TESTNET);
+            ensureManagers();
+            StellarNetwork& network = *currentNetwork;
 
             Serial.println("\nTesting Horizon connection...");
 
@@ -448,20 +729,14 @@ void loop() {
                 Serial.println("\n✗ No wallet loaded. Use 'wallet new' first\n");
             } else if (!WiFi.isConnected()) {
                 Serial.println("\n✗ WiFi not connected\n");
+            } else if (pendingRequest != REQUEST_NONE) {
+                Serial.println("\n✗ Network request already in progress\n");
             } else {
                 Serial.println("\nFunding account with Friendbot...");
                 Serial.println("Account: " + currentKeypair->getPublicKey());
 
-                StellarNetwork network(STELLAR_TESTNET);
-
-                if (network.fundWithFriendbot(currentKeypair->getPublicKey().c_str())) {
-                    Serial.println("\n✓ Account funded successfully!");
-                    Serial.println("Balance: 10,000 XLM (testnet)");
-                } else {
-                    Serial.println("\n✗ Funding failed");
-                    Serial.println("Error: " + network.getLastError());
-                }
-                Serial.println();
+                // Solo el hash de la transacción de fondeo
+                startNetworkRequest(REQUEST_FUND, 128);
             }
 
         } else if (command == "network balance") {
@@ -469,46 +744,11 @@ void loop() {
                 Serial.println("\n✗ No wallet loaded\n");
             } else if (!WiFi.isConnected()) {
                 Serial.println("\n✗ WiFi not connected\n");
+            } else if (pendingRequest != REQUEST_NONE) {
+                Serial.println("\n✗ Network request already in progress\n");
             } else {
                 Serial.println("\nQuerying balance...");
-
-                StellarNetwork network(STELLAR_TESTNET);
-                String response = network.getAccount(currentKeypair->getPublicKey().c_str());
-
-                if (response.length() > 0) {
-                    // Parse JSON response
-                    DynamicJsonDocument doc(4096);
-                    DeserializationError error = deserializeJson(doc, response);
-
-                    if (!error) {
-                        Serial.println("\n--- Account Balance ---");
-
-                        JsonArray balances = doc["balances"];
-                        for (JsonObject balance : balances) {
-                            String assetType = balance["asset_type"];
-                            String amount = balance["balance"];
-
-                            if (assetType == "native") {
-                                Serial.print("XLM: ");
-                                Serial.println(amount);
-                            } else {
-                                String assetCode = balance["asset_code"];
-                                Serial.print(assetCode);
-                                Serial.print(": ");
-                                Serial.println(amount);
-                            }
-                        }
-
-                        Serial.println("----------------------\n");
-                    } else {
-                        Serial.println("✗ Failed to parse response\n");
-                    }
-                } else {
-                    Serial.println("✗ Query failed");
-                    Serial.println("Error: " + network.getLastError());
-                    Serial.println("\nAccount might not be funded yet.");
-                    Serial.println("Use 'network fund' to fund it (testnet only)\n");
-                }
+                startNetworkRequest(REQUEST_BALANCE, HORIZON_ACCOUNT_DOC_SIZE);
             }
 
         } else if (command == "network info") {
@@ -516,33 +756,48 @@ void loop() {
                 Serial.println("\n✗ No wallet loaded\n");
             } else if (!WiFi.isConnected()) {
                 Serial.println("\n✗ WiFi not connected\n");
+            } else if (pendingRequest != REQUEST_NONE) {
+                Serial.println("\n✗ Network request already in progress\n");
             } else {
                 Serial.println("\nQuerying account info...");
+                startNetworkRequest(REQUEST_INFO, HORIZON_ACCOUNT_DOC_SIZE);
+            }
 
-                StellarNetwork network(STELLAR_TESTNET);
-                String response = network.getAccount(currentKeypair->getPublicKey().c_str());
-
-                if (response.length() > 0) {
-                    DynamicJsonDocument doc(4096);
-                    DeserializationError error = deserializeJson(doc, response);
-
-                    if (!error) {
-                        Serial.println("\n--- Account Info ---");
-                        Serial.print("ID: ");
-                        Serial.println(doc["id"].as<String>());
-                        Serial.print("Sequence: ");
-                        Serial.println(doc["sequence"].as<String>());
-                        Serial.print("Subentry Count: ");
-                        Serial.println(doc["subentry_count"].as<int>());
-                        Serial.println("-------------------\n");
-                    } else {
-                        Serial.println("✗ Failed to parse response\n");
-                    }
-                } else {
-                    Serial.println("✗ Query failed");
-                    Serial.println("Error: " + network.getLastError());
-                    Serial.println();
-                }
+        } else if (command == "network stats") {
+            ensureManagers();
+            
+            const HttpPoolStats& pool = currentNetwork->getConnectionStats();
+            const TlsSessionStats& tls = currentNetwork->getTlsSessionStats();
+            
+            Serial.println("\n--- Network Stats ---");
+            Serial.print("Requests: ");
+            Serial.print(pool.requests);
+            Serial.print(" (reused ");
+            Serial.print(pool.reused);
+            Serial.print(", new ");
+            Serial.print(pool.opened);
+            Serial.println(")");
+            Serial.print("Closed: ");
+            Serial.print(pool.dropped);
+            Serial.print(" dead, ");
+            Serial.print(pool.expired);
+            Serial.println(" idle");
+            Serial.print("TLS resumption: ");
+            Serial.print(tls.hits);
+            Serial.print(" hits, ");
+            Serial.print(tls.misses);
+            Serial.print(" misses (");
+            Serial.print(tls.rejected);
+            Serial.println(" rejected)");
+            Serial.println("---------------------\n");
+
+        } else if (command == "network save") {
+            ensureManagers();
+            
+            if (currentNetwork->saveTlsSessions()) {
+                Serial.println("\n✓ TLS sessions saved\n");
+            } else {
+                Serial.println("\n✗ No TLS sessions saved\n");
             }
 
         } else if (command == "xdr") {
@@ -601,11 +856,12 @@ void loop() {
             if (command == "wallet new") {
                 Serial.println("\nGenerating new wallet...");
 
+                cleanupManagers();
                 if (currentKeypair) {
                     delete currentKeypair;
                 }
 
-                currentKeypair = StellarKeypair::generate();
+                currentKeypair = StellarKeypair::generateWithMnemonic();
 
                 if (currentKeypair) {
                     Serial.println("✓ Wallet generated!");
@@ -613,7 +869,7 @@ void loop() {
                     Serial.println(currentKeypair->getPublicKey());
                     Serial.println("\nSecret Key (SAVE THIS SECURELY):");
                     Serial.println(currentKeypair->getSecretKey());
-                    Serial.println("\nMnemonic (12 words for backup):");
+                    Serial.println("\nMnemonic (12 words, restores all HD accounts):");
                     Serial.println(currentKeypair->getMnemonic());
                     Serial.println("\nUse 'wallet save' to encrypt and save to flash");
                     ensureManagers();
@@ -639,6 +895,12 @@ void loop() {
                         SecureWallet wallet;
                         if (wallet.saveToFlash(currentKeypair, password.c_str())) {
                             Serial.println("✓ Wallet saved to flash successfully!\n");
+
+                            // Nodo HD: 'wallet account <n>' sin el mnemonic tras reiniciar
+                            if (StellarKeypair::hasAccountNode() &&
+                                SecureWallet::saveAccountNode(password.c_str())) {
+                                Serial.println("✓ HD account node saved\n");
+                            }
                         } else {
                             Serial.println("✗ Failed to save wallet\n");
                         }
@@ -653,10 +915,13 @@ void loop() {
                 String password = Serial.readStringUntil('\n');
                 password.trim();
 
+                cleanupManagers();
                 if (currentKeypair) {
                     delete currentKeypair;
                 }
 
+                // El nodo HD de esta wallet se carga de flash con 'wallet account'
+                StellarKeypair::clearAccountNode();
                 currentKeypair = SecureWallet::loadFromFlash(password.c_str());
 
                 if (currentKeypair) {
@@ -678,6 +943,12 @@ void loop() {
                     Serial.print("Secret Key:  ");
                     Serial.println(currentKeypair->getSecretKey());
 
+                    if (currentKeypair->getAccountIndex() >= 0) {
+                        Serial.print("HD Account:  m/44'/148'/");
+                        Serial.print(currentKeypair->getAccountIndex());
+                        Serial.println("'");
+                    }
+
                     String mnemonic = currentKeypair->getMnemonic();
                     if (mnemonic.length() > 0) {
                         Serial.print("Mnemonic:    ");
@@ -698,6 +969,9 @@ void loop() {
                     if (SecureWallet::deleteFromFlash()) {
                         Serial.println("✓ Wallet deleted from flash\n");
 
+                        StellarKeypair::clearAccountNode();
+
+                        cleanupManagers();
                         if (currentKeypair) {
                             delete currentKeypair;
                             currentKeypair = nullptr;
@@ -716,10 +990,13 @@ void loop() {
                 String secretKey = Serial.readStringUntil('\n');
                 secretKey.trim();
 
+                cleanupManagers();
                 if (currentKeypair) {
                     delete currentKeypair;
                 }
 
+                // El nodo HD en caché es de la wallet anterior
+                StellarKeypair::clearAccountNode();
                 currentKeypair = StellarKeypair::fromSecret(secretKey.c_str());
 
                 if (currentKeypair) {
@@ -732,6 +1009,70 @@ void loop() {
                     Serial.println("✗ Invalid secret key\n");
                 }
 
+            } else if (command == "wallet restore") {
+                Serial.println("\nEnter mnemonic (12-24 words):");
+
+                while (!Serial.available()) { delay(100); }
+                String words = Serial.readStringUntil('\n');
+                words.trim();
+
+                cleanupManagers();
+                if (currentKeypair) {
+                    delete currentKeypair;
+                }
+
+                Serial.println("Deriving seed...");
+                currentKeypair = StellarKeypair::fromMnemonic(words.c_str(), 0);
+                StellarUtils::secureZero((char*)words.c_str(), words.length());
+
+                if (currentKeypair) {
+                    Serial.println("✓ Wallet restored (account 0)");
+                    Serial.println("\nPublic Key:");
+                    Serial.println(currentKeypair->getPublicKey());
+                    Serial.println("\nUse 'wallet account <n>' for other accounts");
+                    Serial.println();
+                    ensureManagers();
+                } else {
+                    Serial.println("✗ Invalid mnemonic\n");
+                }
+
+            } else if (command.startsWith("wallet account ")) {
+                long account = command.substring(15).toInt();
+
+                // Sin nodo en memoria: se carga (cifrado) desde flash
+                if (!StellarKeypair::hasAccountNode() && SecureWallet::accountNodeExistsInFlash()) {
+                    Serial.println("\nEnter password:");
+
+                    while (!Serial.available()) { delay(100); }
+                    String password = Serial.readStringUntil('\n');
+                    password.trim();
+
+                    SecureWallet::loadAccountNode(password.c_str());
+                }
+
+                StellarKeypair* derived = nullptr;
+                if (account >= 0 && StellarKeypair::hasAccountNode()) {
+                    derived = StellarKeypair::deriveAccount((uint32_t)account);
+                }
+
+                if (derived) {
+                    // Account/payment apuntan al keypair anterior
+                    cleanupManagers();
+                    if (currentKeypair) {
+                        delete currentKeypair;
+                    }
+                    currentKeypair = derived;
+
+                    Serial.print("\n✓ Account ");
+                    Serial.println(account);
+                    Serial.println("Public Key:");
+                    Serial.println(currentKeypair->getPublicKey());
+                    Serial.println();
+                    ensureManagers();
+                } else {
+                    Serial.println("\n✗ No HD account node (use 'wallet restore' or 'wallet new')\n");
+                }
+
             } else {
                 Serial.println("\n✗ Unknown wallet command. Try 'wallet' alone for help\n");
             }
@@ -12,14 +12,14 @@ StellarAccount::StellarAccount(StellarKeypair* keypair, StellarNetwork* network)
     this->cacheTimestamp = 0;
     
     // Inicializar caché vacío
-    cachedInfo.accountId = keypair->getPublicKey();
+    cachedInfo.accountId = keypair->getPublicKeyCStr();
     cachedInfo.sequence = "0";
     cachedInfo.subentryCount = 0;
     cachedInfo.nativeBalance = 0.0f;
     cachedInfo.exists = false;
     cachedInfo.lastError = "";
     
-    StellarUtils::infoPrint("Account", "Account manager initialized");
+    STELLAR_LOGI("Account", "Account manager initialized");
 }
 
 StellarAccount::~StellarAccount() {
@@ -31,11 +31,11 @@ StellarAccount::~StellarAccount() {
 // ============================================
 
 AccountInfo StellarAccount::getAccountInfo() {
-    StellarUtils::debugPrint("Account", "Getting account info");
+    STELLAR_LOGD("Account", "Getting account info");
     
     // Si el caché es válido, usarlo
     if (isCacheValid()) {
-        StellarUtils::debugPrint("Account", "Using cached data");
+        STELLAR_LOGD("Account", "Using cached data");
         return cachedInfo;
     }
     
@@ -55,7 +55,7 @@ float StellarAccount::getBalance() {
     AccountInfo info = getAccountInfo();
     
     if (!info.exists) {
-        StellarUtils::errorPrint("Account", "Account does not exist");
+        STELLAR_LOGE("Account", "Account does not exist");
         return -1.0f;
     }
     
@@ -66,7 +66,7 @@ uint64_t StellarAccount::getSequenceNumber() {
     AccountInfo info = getAccountInfo();
     
     if (!info.exists) {
-        StellarUtils::errorPrint("Account", "Account does not exist");
+        STELLAR_LOGE("Account", "Account does not exist");
         return 0;
     }
     
@@ -97,19 +97,17 @@ String StellarAccount::getPublicKey() const {
 // ============================================
 
 bool StellarAccount::fundAccount() {
-    StellarUtils::infoPrint("Account", "Funding account with Friendbot");
+    STELLAR_LOGI("Account", "Funding account with Friendbot");
     
     if (network->getNetworkType() != STELLAR_TESTNET) {
         lastError = "Friendbot only available on testnet";
-        StellarUtils::errorPrint("Account", lastError.c_str());
+        STELLAR_LOGE("Account", "%s", lastError.c_str());
         return false;
     }
     
-    String publicKey = keypair->getPublicKey();
-    
-    if (!network->fundWithFriendbot(publicKey.c_str())) {
+    if (!network->fundWithFriendbot(keypair->getPublicKeyCStr())) {
         lastError = "Friendbot request failed: " + network->getLastError();
-        StellarUtils::errorPrint("Account", lastError.c_str());
+        STELLAR_LOGE("Account", "%s", lastError.c_str());
         return false;
     }
     
@@ -121,11 +119,11 @@ bool StellarAccount::fundAccount() {
     
     // Verificar que la cuenta ahora existe
     if (cachedInfo.exists) {
-        StellarUtils::infoPrint("Account", "Account funded successfully");
+        STELLAR_LOGI("Account", "Account funded successfully");
         return true;
     } else {
         lastError = "Account funded but not yet visible";
-        StellarUtils::errorPrint("Account", lastError.c_str());
+        STELLAR_LOGE("Account", "%s", lastError.c_str());
         return false;
     }
 }
@@ -156,15 +154,18 @@ bool StellarAccount::isCacheValid() const {
 }
 
 bool StellarAccount::updateCache() {
-    StellarUtils::debugPrint("Account", "Updating cache from Horizon");
+    STELLAR_LOGD("Account", "Updating cache from Horizon");
     
-    String publicKey = keypair->getPublicKey();
-    String response = network->getAccount(publicKey.c_str());
+    // Solo los campos de AccountInfo, parseados según llegan
+    DynamicJsonDocument doc(HORIZON_ACCOUNT_DOC_SIZE);
     
-    if (response.length() == 0) {
+    bool found = network->getAccount(keypair->getPublicKeyCStr(), doc);
+    return updateCacheFrom(found, doc, network->getLastError());
+}
+
+bool StellarAccount::updateCacheFrom(bool found, JsonDocument& doc, const String& networkError) {
+    if (!found) {
         // Cuenta no existe o error de red
-        String networkError = network->getLastError();
-        
         if (networkError.indexOf("404") >= 0 || 
             networkError.indexOf("not found") >= 0) {
             // Cuenta no existe (no es error)
@@ -175,20 +176,20 @@ bool StellarAccount::updateCache() {
             cachedInfo.subentryCount = 0;
             cacheTimestamp = millis();
             
-            StellarUtils::debugPrint("Account", "Account does not exist yet");
+            STELLAR_LOGD("Account", "Account does not exist yet");
             return true;
         } else {
             // Error de red real
             lastError = "Network error: " + networkError;
-            StellarUtils::errorPrint("Account", lastError.c_str());
+            STELLAR_LOGE("Account", "%s", lastError.c_str());
             return false;
         }
     }
     
     // Parsear respuesta
-    if (!parseAccountData(response, cachedInfo)) {
+    if (!parseAccountData(doc, cachedInfo)) {
         lastError = "Failed to parse account data";
-        StellarUtils::errorPrint("Account", lastError.c_str());
+        STELLAR_LOGE("Account", "%s", lastError.c_str());
         return false;
     }
     
@@ -196,22 +197,14 @@ bool StellarAccount::updateCache() {
     cacheTimestamp = millis();
     lastError = "";
     
-    StellarUtils::debugPrint("Account", "Cache updated successfully");
+    STELLAR_LOGD("Account", "Cache updated successfully");
     return true;
 }
 
-bool StellarAccount::parseAccountData(const String& json, AccountInfo& info) {
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, json);
-    
-    if (error) {
-        StellarUtils::errorPrint("Account", "JSON parse error");
-        return false;
-    }
-    
+bool StellarAccount::parseAccountData(JsonDocument& doc, AccountInfo& info) {
     // Extraer campos
     if (!doc.containsKey("id") || !doc.containsKey("sequence")) {
-        StellarUtils::errorPrint("Account", "Missing required fields");
+        STELLAR_LOGE("Account", "Missing required fields");
         return false;
     }
     
@@ -94,6 +94,23 @@ public:
      */
     void refreshCache();
     
+    /**
+     * Actualiza la caché con una consulta hecha aparte
+     * (p.ej. getAccountAsync() terminada en el worker), sin ir a la red
+     * 
+     * @param found Resultado de la consulta
+     * @param doc Respuesta de getAccount() (HORIZON_ACCOUNT_DOC_SIZE)
+     * @param networkError Error de la consulta si falló
+     * @return true si la caché quedó al día (cuenta inexistente incluida)
+     */
+    bool updateCacheFrom(bool found, JsonDocument& doc, const String& networkError);
+    
+    /**
+     * Invalida la caché sin consultar la red
+     * La próxima lectura la refresca
+     */
+    void invalidateCache() { cacheTimestamp = 0; }
+    
     /**
      * Obtiene último error
      * 
@@ -114,7 +131,7 @@ private:
     // Helpers
     bool isCacheValid() const;
     bool updateCache();
-    bool parseAccountData(const String& json, AccountInfo& info);
+    bool parseAccountData(JsonDocument& doc, AccountInfo& info);
 };
 
 #endif // STELLAR_ACCOUNT_H
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "stellar_bench.h"
+#include "stellar_bip39.h"
+#include "stellar_crypto.h"
+#include "stellar_strkey.h"
+#include "stellar_utils.h"
+#include <esp_system.h>
+
+#define BENCH_MAX_INPUT 1024
+
+static const char BENCH_MNEMONIC[] =
+    "illness spike retreat truth genius clock brain pass fit cave bargain toe";
+
+// Estado compartido por los casos (en heap, no en la pila del loop)
+struct BenchContext {
+    uint8_t seed[32];
+    uint8_t publicKey[32];
+    uint8_t signature[64];
+    uint8_t key[32];
+    uint8_t iv[12];
+    uint8_t tag[16];
+    uint8_t hash[32];
+    uint8_t salt[16];
+    char password[17];
+    char address[STRKEY_ED25519_LENGTH + 1];
+    uint8_t input[BENCH_MAX_INPUT];
+    uint8_t output[BENCH_MAX_INPUT];
+};
+
+typedef void (*BenchOp)(BenchContext& ctx, size_t size);
+
+struct BenchCase {
+    const char* name;
+    BenchOp op;
+    size_t inputSize;
+    uint32_t budgetMicros;
+    uint32_t costFactor;      // Divide las iteraciones (casos muy lentos)
+};
+
+// ============================================
+// OPERACIONES
+// ============================================
+
+static void benchSha256(BenchContext& ctx, size_t size) {
+    StellarCrypto::sha256(ctx.input, size, ctx.hash);
+}
+
+static void benchCrc16(BenchContext& ctx, size_t size) {
+    StellarUtils::crc16XModem(ctx.input, size);
+}
+
+static void benchStrKey(BenchContext& ctx, size_t) {
+    StellarStrKey::isValid(ctx.address, STRKEY_ACCOUNT_ID);
+}
+
+static void benchRandom(BenchContext& ctx, size_t size) {
+    StellarCrypto::randomBytes(ctx.output, size);
+}
+
+static void benchEncrypt(BenchContext& ctx, size_t size) {
+    StellarCrypto::encryptAES256GCM(ctx.input, size, ctx.key, ctx.iv, ctx.output, ctx.tag);
+}
+
+static void benchDecrypt(BenchContext& ctx, size_t size) {
+    StellarCrypto::decryptAES256GCM(ctx.output, size, ctx.key, ctx.iv, ctx.tag, ctx.input);
+}
+
+static void benchKeygen(BenchContext& ctx, size_t) {
+    StellarCrypto::derivePublicKey(ctx.publicKey, ctx.seed);
+}
+
+static void benchSign(BenchContext& ctx, size_t size) {
+    StellarCrypto::sign(ctx.seed, ctx.publicKey, ctx.input, size, ctx.signature);
+}
+
+static void benchVerify(BenchContext& ctx, size_t size) {
+    StellarCrypto::verify(ctx.publicKey, ctx.input, size, ctx.signature);
+}
+
+static void benchBip39Seed(BenchContext& ctx, size_t) {
+    StellarBIP39::toSeed(BENCH_MNEMONIC, nullptr, ctx.output);
+}
+
+// Un paso SLIP-0010: lo que cuesta cada cuenta con el nodo m/44'/148' en caché
+static void benchHdAccount(BenchContext& ctx, size_t size) {
+    StellarCrypto::hmacSHA512(ctx.key, 32, ctx.input, size, ctx.output);
+}
+
+static void benchPbkdf2(BenchContext& ctx, size_t) {
+    StellarCrypto::deriveKeyPBKDF2(ctx.password, ctx.salt, STELLAR_BENCH_PBKDF2_ITERATIONS, ctx.hash);
+}
+
+// Presupuestos: ~3-5x lo esperado en un ESP32 a 240 MHz
+// Decrypt va justo detrás de encrypt del mismo tamaño (usa su ciphertext y tag)
+static const BenchCase BENCH_CASES[] = {
+    { "sha256",          benchSha256,     32,   300,    1 },
+    { "sha256",          benchSha256,     256,  1000,   1 },
+    { "sha256",          benchSha256,     1024, 3000,   1 },
+    { "crc16",           benchCrc16,      35,   20,     1 },
+    { "strkey_valid",    benchStrKey,     56,   60,     1 },
+    { "random",          benchRandom,     32,   200,    1 },
+    { "random",          benchRandom,     1024, 2000,   1 },
+    { "aes256gcm_enc",   benchEncrypt,    32,   1000,   1 },
+    { "aes256gcm_enc",   benchEncrypt,    256,  3000,   1 },
+    { "aes256gcm_enc",   benchEncrypt,    1024, 10000,  1 },
+    { "aes256gcm_dec",   benchDecrypt,    1024, 10000,  1 },
+    { "ed25519_keygen",  benchKeygen,     32,   30000,  1 },
+    { "ed25519_sign",    benchSign,       32,   30000,  1 },
+    { "ed25519_sign",    benchSign,       1024, 35000,  1 },
+    { "ed25519_verify",  benchVerify,     1024, 100000, 1 },
+    { "pbkdf2_1k",       benchPbkdf2,     16,   150000, 8 },
+    { "bip39_seed",      benchBip39Seed,  64,   800000, 20 },
+    { "hd_account",      benchHdAccount,  37,   1000,   1 },
+};
+
+static const size_t BENCH_CASE_COUNT = sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]);
+
+// ============================================
+// EJECUCIÓN
+// ============================================
+
+static void initContext(BenchContext& ctx) {
+    StellarCrypto::randomBytes(ctx.seed, 32);
+    StellarCrypto::randomBytes(ctx.key, 32);
+    StellarCrypto::randomBytes(ctx.iv, 12);
+    StellarCrypto::randomBytes(ctx.salt, 16);
+    StellarCrypto::randomBytes(ctx.input, sizeof(ctx.input));
+
+    memcpy(ctx.password, "bench-password-1", sizeof(ctx.password));
+
+    StellarCrypto::derivePublicKey(ctx.publicKey, ctx.seed);
+    StellarStrKey::encode(STRKEY_ACCOUNT_ID, ctx.publicKey, ctx.address);
+    StellarCrypto::sign(ctx.seed, ctx.publicKey, ctx.input, sizeof(ctx.input), ctx.signature);
+}
+
+static void runCase(const BenchCase& bench, BenchContext& ctx, uint32_t iterations, BenchResult& result) {
+    iterations /= bench.costFactor;
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    // Calentamiento: caché de flash y primeras reservas fuera de la medida
+    bench.op(ctx, bench.inputSize);
+
+    // No hay contador de pico por operación: si la marca mínima global del
+    // heap baja durante el caso, esa es la medida; si no, el mínimo muestreado
+    uint32_t freeBefore = esp_get_free_heap_size();
+    uint32_t lowWaterBefore = esp_get_minimum_free_heap_size();
+    uint32_t minSampled = freeBefore;
+
+    uint32_t startCycles = ESP.getCycleCount();
+    uint32_t startMicros = micros();
+    uint32_t elapsedMicros = 0;
+    uint32_t batch = iterations;
+    iterations = 0;
+
+    // Tandas completas hasta STELLAR_BENCH_MIN_MICROS
+    do {
+        for (uint32_t i = 0; i < batch; i++) {
+            bench.op(ctx, bench.inputSize);
+
+            uint32_t freeNow = esp_get_free_heap_size();
+            if (freeNow < minSampled) {
+                minSampled = freeNow;
+            }
+        }
+
+        iterations += batch;
+        elapsedMicros = micros() - startMicros;
+    } while (elapsedMicros < STELLAR_BENCH_MIN_MICROS);
+
+    uint32_t elapsedCycles = ESP.getCycleCount() - startCycles;
+
+    uint32_t lowWaterAfter = esp_get_minimum_free_heap_size();
+    uint32_t lowest = lowWaterAfter < lowWaterBefore ? lowWaterAfter : minSampled;
+
+    result.name = bench.name;
+    result.inputSize = bench.inputSize;
+    result.iterations = iterations;
+    result.totalMicros = elapsedMicros;
+    result.microsPerOp = (float)elapsedMicros / iterations;
+    result.opsPerSecond = 1000000.0f * iterations / elapsedMicros;
+    result.cyclesPerOp = elapsedCycles / iterations;
+    result.peakHeap = freeBefore > lowest ? freeBefore - lowest : 0;
+    result.budgetMicros = bench.budgetMicros;
+    result.withinBudget = result.microsPerOp <= bench.budgetMicros;
+}
+
+size_t StellarBench::run(BenchResult* results, size_t maxResults, uint32_t iterations) {
+    return run("", results, maxResults, iterations);
+}
+
+size_t StellarBench::run(const char* prefix, BenchResult* results, size_t maxResults, uint32_t iterations) {
+    BenchContext* ctx = (BenchContext*)malloc(sizeof(BenchContext));
+    if (!ctx) {
+        STELLAR_LOGE("Bench", "Out of memory for benchmark context");
+        return 0;
+    }
+
+    initContext(*ctx);
+
+    if (iterations == 0) {
+        iterations = STELLAR_BENCH_ITERATIONS;
+    }
+
+    size_t prefixLength = prefix ? strlen(prefix) : 0;
+    size_t count = 0;
+
+    for (size_t i = 0; i < BENCH_CASE_COUNT && count < maxResults; i++) {
+        const BenchCase& bench = BENCH_CASES[i];
+
+        if (prefixLength > 0 && strncmp(bench.name, prefix, prefixLength) != 0) {
+            continue;
+        }
+
+        // aes256gcm_dec necesita el ciphertext/tag de su tamaño
+        if (bench.op == benchDecrypt) {
+            benchEncrypt(*ctx, bench.inputSize);
+        }
+
+        runCase(bench, *ctx, iterations, results[count]);
+
+        STELLAR_LOGD("Bench", "%s/%u: %.1f us/op",
+                     bench.name, (unsigned)bench.inputSize, results[count].microsPerOp);
+
+        count++;
+        yield();
+    }
+
+    StellarUtils::secureZero(ctx, sizeof(BenchContext));
+    free(ctx);
+
+    return count;
+}
+
+// ============================================
+// FORMATO
+// ============================================
+
+String StellarBench::formatHeader() {
+    return "case             bytes     us/op     ops/s   cycles/op  heap";
+}
+
+String StellarBench::formatResult(const BenchResult& result) {
+    char line[96];
+    snprintf(line, sizeof(line), "%-16s %5u %9.1f %9.1f %11u %5u%s",
+             result.name,
+             (unsigned)result.inputSize,
+             result.microsPerOp,
+             result.opsPerSecond,
+             (unsigned)result.cyclesPerOp,
+             (unsigned)result.peakHeap,
+             result.withinBudget ? "" : "  SLOW");
+    return String(line);
+}
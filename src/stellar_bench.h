@@ -0,0 +1,72 @@
+#ifndef STELLAR_BENCH_H
+#define STELLAR_BENCH_H
+
+#include <Arduino.h>
+
+/**
+ * Micro-benchmarks de las primitivas criptográficas
+ *
+ * Ejecuta cada primitiva N veces sobre varios tamaños de entrada y mide
+ * tiempo (micros), ciclos de CPU y pico de heap. Lo usan el comando
+ * "crypto bench", GET /api/crypto/bench y el test de regresión (unity).
+ *
+ * Cada caso tiene un presupuesto en µs/op generoso para un ESP32 a 240 MHz:
+ * superarlo indica una regresión, no una medida fina.
+ */
+
+// Iteraciones por caso si no se indica otra cosa (PBKDF2 usa menos)
+#ifndef STELLAR_BENCH_ITERATIONS
+#define STELLAR_BENCH_ITERATIONS 20
+#endif
+
+// Tiempo mínimo medido por caso: las operaciones rápidas se repiten hasta
+// superarlo para que la resolución de micros() no deje el resultado en 0
+#ifndef STELLAR_BENCH_MIN_MICROS
+#define STELLAR_BENCH_MIN_MICROS 1000
+#endif
+
+#define STELLAR_BENCH_MAX_RESULTS 24
+#define STELLAR_BENCH_PBKDF2_ITERATIONS 1000
+
+struct BenchResult {
+    const char* name;
+    size_t inputSize;         // Bytes procesados por operación
+    uint32_t iterations;
+    uint32_t totalMicros;
+    float microsPerOp;
+    float opsPerSecond;
+    uint32_t cyclesPerOp;
+    uint32_t peakHeap;        // Bytes de heap por debajo del inicio (aprox.)
+    uint32_t budgetMicros;    // Máximo µs/op aceptable
+    bool withinBudget;
+};
+
+class StellarBench {
+public:
+    /**
+     * Ejecuta todos los casos
+     *
+     * @param results Array de salida (STELLAR_BENCH_MAX_RESULTS)
+     * @param maxResults Tamaño del array
+     * @param iterations Iteraciones por caso (0 = valor por defecto de cada caso)
+     * @return Número de resultados escritos
+     */
+    static size_t run(BenchResult* results, size_t maxResults, uint32_t iterations = 0);
+
+    /**
+     * Ejecuta solo los casos cuyo nombre empieza por prefix ("sha256", "ed25519"...)
+     */
+    static size_t run(const char* prefix, BenchResult* results, size_t maxResults, uint32_t iterations = 0);
+
+    /**
+     * Línea de texto con un resultado (para serial y web)
+     */
+    static String formatResult(const BenchResult& result);
+
+    /**
+     * Cabecera de la tabla de formatResult()
+     */
+    static String formatHeader();
+};
+
+#endif // STELLAR_BENCH_H
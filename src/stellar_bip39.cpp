@@ -0,0 +1,279 @@
+#include "stellar_bip39.h"
+#include "stellar_crypto.h"
+#include "stellar_utils.h"
+#include "stellar_bip39_wordlist.h"
+#include <SHA512.h>
+
+static const size_t SHA512_BLOCK_SIZE = 128;
+static const size_t BIP39_MAX_WORD_LENGTH = 8;
+
+// 24 palabras x 11 bits = 264 bits
+static const size_t BIP39_MAX_BITS_BYTES = (BIP39_MAX_WORDS * 11 + 7) / 8;
+
+// ============================================
+// WORDLIST
+// ============================================
+
+int StellarBIP39::findWord(const char* word, size_t length) {
+    if (!word || length == 0 || length > BIP39_MAX_WORD_LENGTH) {
+        return -1;
+    }
+
+    int low = 0;
+    int high = BIP39_WORDLIST_SIZE - 1;
+
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        const char* candidate = BIP39_WORDLIST[middle];
+
+        int cmp = strncmp(candidate, word, length);
+        if (cmp == 0 && candidate[length] != '\0') {
+            cmp = 1;  // candidate es más larga: va detrás
+        }
+
+        if (cmp == 0) {
+            return middle;
+        } else if (cmp < 0) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    return -1;
+}
+
+const char* StellarBIP39::getWord(uint16_t index) {
+    return index < BIP39_WORDLIST_SIZE ? BIP39_WORDLIST[index] : nullptr;
+}
+
+// ============================================
+// FRASE <-> ENTROPÍA
+// ============================================
+
+// Lee 11 bits desde la posición bit (MSB primero)
+static uint16_t readIndex(const uint8_t* data, size_t bit) {
+    uint16_t value = 0;
+
+    for (int i = 0; i < 11; i++, bit++) {
+        value = (value << 1) | ((data[bit >> 3] >> (7 - (bit & 7))) & 1);
+    }
+
+    return value;
+}
+
+String StellarBIP39::fromEntropy(const uint8_t* entropy, size_t length) {
+    if (!entropy || length < 16 || length > 32 || length % 4 != 0) {
+        return "";
+    }
+
+    // entropía || checksum (length / 4 bits del SHA-256, como máximo 8)
+    uint8_t data[33];
+    uint8_t hash[32];
+
+    memcpy(data, entropy, length);
+    StellarCrypto::sha256(entropy, length, hash);
+    data[length] = hash[0];
+
+    size_t wordCount = length * 3 / 4;
+    String words;
+    words.reserve(wordCount * (BIP39_MAX_WORD_LENGTH + 1));
+
+    for (size_t i = 0; i < wordCount; i++) {
+        if (i > 0) words += " ";
+        words += BIP39_WORDLIST[readIndex(data, i * 11)];
+    }
+
+    StellarUtils::secureZero(data, sizeof(data));
+    StellarUtils::secureZero(hash, sizeof(hash));
+
+    return words;
+}
+
+String StellarBIP39::generate(size_t wordCount) {
+    if (wordCount < BIP39_MIN_WORDS || wordCount > BIP39_MAX_WORDS || wordCount % 3 != 0) {
+        STELLAR_LOGE("BIP39", "Word count must be 12, 15, 18, 21 or 24");
+        return "";
+    }
+
+    uint8_t entropy[32];
+    size_t length = wordCount * 4 / 3;
+
+    StellarCrypto::randomBytes(entropy, length);
+    String words = fromEntropy(entropy, length);
+    StellarUtils::secureZero(entropy, sizeof(entropy));
+
+    return words;
+}
+
+bool StellarBIP39::validate(const char* words, String* normalized) {
+    if (!words) {
+        return false;
+    }
+
+    uint8_t bits[BIP39_MAX_BITS_BYTES];
+    uint16_t indices[BIP39_MAX_WORDS];
+    char word[BIP39_MAX_WORD_LENGTH + 1];
+    size_t wordCount = 0;
+    bool valid = true;
+
+    memset(bits, 0, sizeof(bits));
+
+    const char* p = words;
+    while (valid) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        if (*p == '\0') break;
+
+        // Palabra en minúsculas; más de 8 letras no está en la lista
+        size_t length = 0;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+            if (length < BIP39_MAX_WORD_LENGTH + 1) {
+                char c = *p;
+                word[length] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+            }
+            length++;
+            p++;
+        }
+
+        int index = findWord(word, length);
+        if (index < 0 || wordCount == BIP39_MAX_WORDS) {
+            valid = false;
+            break;
+        }
+
+        for (int b = 10; b >= 0; b--) {
+            size_t bit = wordCount * 11 + (10 - b);
+            if ((index >> b) & 1) {
+                bits[bit >> 3] |= 0x80 >> (bit & 7);
+            }
+        }
+
+        indices[wordCount++] = (uint16_t)index;
+    }
+
+    valid = valid && wordCount >= BIP39_MIN_WORDS && wordCount % 3 == 0;
+
+    if (valid) {
+        // ENT = 32 * palabras / 3 bits; CS = ENT / 32 bits
+        size_t entropyLength = wordCount * 4 / 3;
+        size_t checksumBits = entropyLength / 4;
+        uint8_t hash[32];
+
+        StellarCrypto::sha256(bits, entropyLength, hash);
+
+        uint8_t mask = (uint8_t)(0xFF << (8 - checksumBits));
+        valid = ((bits[entropyLength] ^ hash[0]) & mask) == 0;
+
+        StellarUtils::secureZero(hash, sizeof(hash));
+    }
+
+    if (valid && normalized) {
+        *normalized = "";
+        normalized->reserve(wordCount * (BIP39_MAX_WORD_LENGTH + 1));
+
+        for (size_t i = 0; i < wordCount; i++) {
+            if (i > 0) *normalized += " ";
+            *normalized += BIP39_WORDLIST[indices[i]];
+        }
+    }
+
+    StellarUtils::secureZero(bits, sizeof(bits));
+    StellarUtils::secureZero(indices, sizeof(indices));
+    StellarUtils::secureZero(word, sizeof(word));
+
+    return valid;
+}
+
+bool StellarBIP39::isValid(const char* words) {
+    return validate(words, nullptr);
+}
+
+// ============================================
+// SEED (PBKDF2-HMAC-SHA512)
+// ============================================
+
+bool StellarBIP39::toSeed(const char* words, const char* passphrase, uint8_t seed[BIP39_SEED_SIZE]) {
+    String mnemonic;
+    if (!validate(words, &mnemonic)) {
+        STELLAR_LOGE("BIP39", "Invalid mnemonic (unknown word, word count or checksum)");
+        return false;
+    }
+
+    if (!passphrase) {
+        passphrase = "";
+    }
+
+    // Igual que deriveKeyPBKDF2: los estados tras K ^ ipad y K ^ opad se
+    // calculan una vez (2 compresiones por ronda en lugar de 4)
+    SHA512 inner;
+    SHA512 outer;
+
+    const uint8_t* hmacKey = (const uint8_t*)mnemonic.c_str();
+    size_t hmacKeyLen = mnemonic.length();
+    uint8_t hashedKey[64];
+
+    // 24 palabras pueden superar el bloque: se usa su hash
+    if (hmacKeyLen > SHA512_BLOCK_SIZE) {
+        SHA512 sha;
+        sha.update(hmacKey, hmacKeyLen);
+        sha.finalize(hashedKey, sizeof(hashedKey));
+        hmacKey = hashedKey;
+        hmacKeyLen = sizeof(hashedKey);
+    }
+
+    uint8_t pad[SHA512_BLOCK_SIZE];
+
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0; i < hmacKeyLen; i++) {
+        pad[i] ^= hmacKey[i];
+    }
+    inner.reset();
+    inner.update(pad, sizeof(pad));
+
+    memset(pad, 0x5c, sizeof(pad));
+    for (size_t i = 0; i < hmacKeyLen; i++) {
+        pad[i] ^= hmacKey[i];
+    }
+    outer.reset();
+    outer.update(pad, sizeof(pad));
+
+    StellarUtils::secureZero(pad, sizeof(pad));
+    StellarUtils::secureZero(hashedKey, sizeof(hashedKey));
+    StellarUtils::secureZero((char*)mnemonic.c_str(), mnemonic.length());
+
+    SHA512 sha;
+    uint8_t block[64];
+
+    // Un solo bloque de salida: U1 = HMAC(frase, "mnemonic" || passphrase || 0x00000001)
+    static const uint8_t counter[4] = {0, 0, 0, 1};
+
+    sha = inner;
+    sha.update("mnemonic", 8);
+    sha.update(passphrase, strlen(passphrase));
+    sha.update(counter, sizeof(counter));
+    sha.finalize(block, sizeof(block));
+
+    sha = outer;
+    sha.update(block, sizeof(block));
+    sha.finalize(block, sizeof(block));
+
+    memcpy(seed, block, BIP39_SEED_SIZE);
+
+    for (uint32_t i = 1; i < BIP39_PBKDF2_ROUNDS; i++) {
+        sha = inner;
+        sha.update(block, sizeof(block));
+        sha.finalize(block, sizeof(block));
+
+        sha = outer;
+        sha.update(block, sizeof(block));
+        sha.finalize(block, sizeof(block));
+
+        for (size_t j = 0; j < BIP39_SEED_SIZE; j++) {
+            seed[j] ^= block[j];
+        }
+    }
+
+    StellarUtils::secureZero(block, sizeof(block));
+
+    return true;
+}
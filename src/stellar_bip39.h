@@ -0,0 +1,82 @@
+#ifndef STELLAR_BIP39_H
+#define STELLAR_BIP39_H
+
+#include <Arduino.h>
+
+/**
+ * Mnemonics BIP39 (wordlist en inglés)
+ *
+ * entropía (128-256 bits) + checksum SHA-256 -> palabras de 11 bits
+ * seed = PBKDF2-HMAC-SHA512(frase, "mnemonic" + passphrase, 2048) -> 64 bytes
+ *
+ * La seed es la entrada de la derivación SEP-0005 (ver StellarKeypair).
+ * Las palabras se aceptan en mayúsculas o minúsculas y con cualquier
+ * separación; la seed se calcula sobre la forma normalizada. La passphrase
+ * debe ser ASCII (no se aplica NFKD).
+ */
+
+#define BIP39_WORDLIST_SIZE 2048
+#define BIP39_SEED_SIZE 64
+#define BIP39_PBKDF2_ROUNDS 2048
+#define BIP39_MIN_WORDS 12
+#define BIP39_MAX_WORDS 24
+
+class StellarBIP39 {
+public:
+    /**
+     * Genera una frase nueva con el DRBG del dispositivo
+     *
+     * @param wordCount 12, 15, 18, 21 o 24
+     * @return Frase o string vacío si wordCount no es válido
+     */
+    static String generate(size_t wordCount = 12);
+
+    /**
+     * Frase correspondiente a una entropía
+     *
+     * @param entropy Entropía
+     * @param length 16, 20, 24, 28 o 32 bytes
+     * @return Frase o string vacío si la longitud no es válida
+     */
+    static String fromEntropy(const uint8_t* entropy, size_t length);
+
+    /**
+     * Valida palabras, número de palabras y checksum
+     *
+     * @param words Frase
+     * @param normalized Salida opcional: minúsculas separadas por un espacio
+     * @return true si es una frase BIP39 válida
+     */
+    static bool validate(const char* words, String* normalized);
+
+    /**
+     * Igual que validate() sin salida
+     */
+    static bool isValid(const char* words);
+
+    /**
+     * Calcula la seed BIP39 (2048 rondas: la parte cara de la derivación)
+     *
+     * @param words Frase
+     * @param passphrase Passphrase opcional (nullptr = "")
+     * @param seed Buffer de salida (64 bytes)
+     * @return false si la frase no es válida
+     */
+    static bool toSeed(const char* words, const char* passphrase, uint8_t seed[BIP39_SEED_SIZE]);
+
+    /**
+     * Busca una palabra en la lista (búsqueda binaria)
+     *
+     * @param word Palabra en minúsculas
+     * @param length Longitud
+     * @return Índice 0-2047 o -1 si no está
+     */
+    static int findWord(const char* word, size_t length);
+
+    /**
+     * Palabra de un índice (nullptr si index >= 2048)
+     */
+    static const char* getWord(uint16_t index);
+};
+
+#endif // STELLAR_BIP39_H
@@ -1,27 +1,31 @@
 #include "stellar_crypto.h"
+#include "stellar_random.h"
 #include "stellar_utils.h"
-#include <esp_system.h>
+#include <SHA512.h>
+
+static const size_t SHA256_BLOCK_SIZE = 64;
+static const size_t SHA512_BLOCK_SIZE = 128;
 
 // ============================================
 // ED25519 OPERATIONS
 // ============================================
 
 bool StellarCrypto::generateKeypair(uint8_t publicKey[32], uint8_t privateKey[32]) {
-    StellarUtils::debugPrint("Crypto", "Generating Ed25519 keypair");
+    STELLAR_LOGD("Crypto", "Generating Ed25519 keypair");
     
     // Generar seed aleatorio con hardware RNG del ESP32
     randomBytes(privateKey, 32);
     
-    // Derivar public key desde private key
-    Ed25519::derivePublicKey(publicKey, privateKey);
+    // Derivar public key desde private key (tabla de base fija)
+    StellarEd25519::derivePublicKey(publicKey, privateKey);
     
-    StellarUtils::debugPrintHex("Crypto", publicKey, 32);
+    STELLAR_LOGD_HEX("Crypto", "Public key: ", publicKey, 32);
     
     return true;
 }
 
 bool StellarCrypto::derivePublicKey(uint8_t publicKey[32], const uint8_t privateKey[32]) {
-    Ed25519::derivePublicKey(publicKey, privateKey);
+    StellarEd25519::derivePublicKey(publicKey, privateKey);
     return true;
 }
 
@@ -32,10 +36,13 @@ bool StellarCrypto::sign(
     size_t messageLen,
     uint8_t signature[64]
 ) {
-    StellarUtils::debugPrint("Crypto", "Signing with Ed25519");
+    STELLAR_LOGD("Crypto", "Signing with Ed25519");
     
-    // Firmar con Ed25519
-    Ed25519::sign(signature, privateKey, publicKey, message, messageLen);
+    // Firmar con Ed25519 (para muchas firmas con la misma clave: SigningContext)
+    Ed25519ExpandedKey key;
+    StellarEd25519::expandKey(privateKey, publicKey, key);
+    StellarEd25519::sign(key, message, messageLen, signature);
+    StellarUtils::secureZero(&key, sizeof(key));
     
     return true;
 }
@@ -49,6 +56,26 @@ bool StellarCrypto::verify(
     return Ed25519::verify(signature, publicKey, message, messageLen);
 }
 
+bool StellarCrypto::verifyBatch(Ed25519BatchEntry* entries, size_t count) {
+    if (count == 0) {
+        return true;
+    }
+    
+    STELLAR_LOGD("Crypto", "Batch verifying %u signatures", (unsigned)count);
+    
+    bool allValid = StellarEd25519::verifyBatch(entries, count);
+    
+    if (!allValid) {
+        for (size_t i = 0; i < count; i++) {
+            if (!entries[i].valid) {
+                STELLAR_LOGD("Crypto", "Invalid signature at index %u", (unsigned)i);
+            }
+        }
+    }
+    
+    return allValid;
+}
+
 // ============================================
 // SHA-256
 // ============================================
@@ -72,6 +99,53 @@ void StellarCrypto::sha256Multiple(
     sha.finalize(hash, 32);
 }
 
+// ============================================
+// HMAC-SHA512
+// ============================================
+
+void StellarCrypto::hmacSHA512(
+    const uint8_t* key, size_t keyLength,
+    const uint8_t* data, size_t length,
+    uint8_t mac[64]
+) {
+    SHA512 sha;
+    uint8_t hashedKey[64];
+    
+    // Claves más largas que el bloque se reemplazan por su hash
+    if (keyLength > SHA512_BLOCK_SIZE) {
+        sha.reset();
+        sha.update(key, keyLength);
+        sha.finalize(hashedKey, 64);
+        key = hashedKey;
+        keyLength = 64;
+    }
+    
+    uint8_t pad[SHA512_BLOCK_SIZE];
+    
+    // H((K ^ ipad) || m)
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0; i < keyLength; i++) {
+        pad[i] ^= key[i];
+    }
+    sha.reset();
+    sha.update(pad, sizeof(pad));
+    sha.update(data, length);
+    sha.finalize(mac, 64);
+    
+    // H((K ^ opad) || H((K ^ ipad) || m))
+    memset(pad, 0x5c, sizeof(pad));
+    for (size_t i = 0; i < keyLength; i++) {
+        pad[i] ^= key[i];
+    }
+    sha.reset();
+    sha.update(pad, sizeof(pad));
+    sha.update(mac, 64);
+    sha.finalize(mac, 64);
+    
+    StellarUtils::secureZero(pad, sizeof(pad));
+    StellarUtils::secureZero(hashedKey, sizeof(hashedKey));
+}
+
 // ============================================
 // AES-256-GCM
 // ============================================
@@ -84,23 +158,14 @@ bool StellarCrypto::encryptAES256GCM(
     uint8_t* ciphertext,
     uint8_t tag[16]
 ) {
-    StellarUtils::debugPrint("Crypto", "Encrypting with AES-256-GCM");
+    STELLAR_LOGD("Crypto", "Encrypting with AES-256-GCM");
     
-    GCM<AES256> gcm;
+    AESGCMStream stream;
+    stream.begin(AESGCMStream::ENCRYPT, key, iv);
+    stream.update(plaintext, ciphertext, plaintextLen);
+    stream.finish(tag);
     
-    // Configurar clave
-    gcm.setKey(key, 32);
-    
-    // Configurar IV
-    gcm.setIV(iv, 12);
-    
-    // Encriptar
-    gcm.encrypt(ciphertext, plaintext, plaintextLen);
-    
-    // Calcular tag de autenticación
-    gcm.computeTag(tag, 16);
-    
-    StellarUtils::debugPrint("Crypto", "Encryption successful");
+    STELLAR_LOGD("Crypto", "Encryption successful");
     
     return true;
 }
@@ -113,34 +178,21 @@ bool StellarCrypto::decryptAES256GCM(
     const uint8_t tag[16],
     uint8_t* plaintext
 ) {
-    StellarUtils::debugPrint("Crypto", "Decrypting with AES-256-GCM");
-    
-    GCM<AES256> gcm;
-    
-    // Configurar clave
-    gcm.setKey(key, 32);
-    
-    // Configurar IV
-    gcm.setIV(iv, 12);
-    
-    // Desencriptar
-    gcm.decrypt(plaintext, ciphertext, ciphertextLen);
+    STELLAR_LOGD("Crypto", "Decrypting with AES-256-GCM");
     
-    // Calcular tag esperado
-    uint8_t computedTag[16];
-    gcm.computeTag(computedTag, 16);
+    AESGCMStream stream;
+    stream.begin(AESGCMStream::DECRYPT, key, iv);
+    stream.update(ciphertext, plaintext, ciphertextLen);
     
     // Verificar tag (autenticación)
-    bool tagValid = (memcmp(tag, computedTag, 16) == 0);
-    
-    if (!tagValid) {
-        StellarUtils::errorPrint("Crypto", "Authentication tag mismatch");
+    if (!stream.verify(tag)) {
+        STELLAR_LOGE("Crypto", "Authentication tag mismatch");
         // Limpiar plaintext por seguridad
         memset(plaintext, 0, ciphertextLen);
         return false;
     }
     
-    StellarUtils::debugPrint("Crypto", "Decryption successful");
+    STELLAR_LOGD("Crypto", "Decryption successful");
     return true;
 }
 
@@ -154,54 +206,203 @@ bool StellarCrypto::deriveKeyPBKDF2(
     uint32_t iterations,
     uint8_t key[32]
 ) {
-    StellarUtils::debugPrint("Crypto", "Deriving key with PBKDF2");
+    STELLAR_LOGD("Crypto", "Deriving key with PBKDF2 (%u iterations)", (unsigned)iterations);
     
     if (iterations < 1000) {
-        StellarUtils::errorPrint("Crypto", "Iterations too low (min 1000)");
+        STELLAR_LOGE("Crypto", "Iterations too low (min 1000)");
         return false;
     }
     
+    // HMAC(K, m) = H((K ^ opad) || H((K ^ ipad) || m))
+    // Los estados tras absorber K ^ ipad y K ^ opad son iguales en todas las
+    // iteraciones: se calculan una vez y cada HMAC parte de una copia
+    // (2 compresiones por iteración en lugar de 4)
+    SHA256 inner;
+    SHA256 outer;
+    
+    const uint8_t* hmacKey = (const uint8_t*)password;
+    size_t hmacKeyLen = strlen(password);
+    uint8_t hashedKey[32];
+    
+    // Claves más largas que el bloque se reemplazan por su hash
+    if (hmacKeyLen > SHA256_BLOCK_SIZE) {
+        sha256(hmacKey, hmacKeyLen, hashedKey);
+        hmacKey = hashedKey;
+        hmacKeyLen = 32;
+    }
+    
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0; i < hmacKeyLen; i++) {
+        pad[i] ^= hmacKey[i];
+    }
+    inner.reset();
+    inner.update(pad, sizeof(pad));
+    
+    memset(pad, 0x5c, sizeof(pad));
+    for (size_t i = 0; i < hmacKeyLen; i++) {
+        pad[i] ^= hmacKey[i];
+    }
+    outer.reset();
+    outer.update(pad, sizeof(pad));
+    
+    StellarUtils::secureZero(pad, sizeof(pad));
+    StellarUtils::secureZero(hashedKey, sizeof(hashedKey));
+    
     SHA256 sha;
     uint8_t block[32];
-    uint8_t temp[32];
-    size_t passwordLen = strlen(password);
     
     // PBKDF2 con 1 bloque (32 bytes de salida)
     // U1 = HMAC(password, salt || 0x00000001)
-    sha.resetHMAC((const uint8_t*)password, passwordLen);
-    sha.update(salt, 16);
+    uint8_t counter[4] = {0, 0, 0, 1};  // Big-endian
     
-    // Counter (big-endian)
-    uint8_t counter[4] = {0, 0, 0, 1};
+    sha = inner;
+    sha.update(salt, 16);
     sha.update(counter, 4);
-    sha.finalizeHMAC((const uint8_t*)password, passwordLen, block, 32);
+    sha.finalize(block, 32);
+    
+    sha = outer;
+    sha.update(block, 32);
+    sha.finalize(block, 32);
     
     // Copiar U1 al resultado
     memcpy(key, block, 32);
     
     // Iteraciones restantes: Ui = HMAC(password, Ui-1)
     for (uint32_t i = 1; i < iterations; i++) {
-        sha.resetHMAC((const uint8_t*)password, passwordLen);
+        sha = inner;
         sha.update(block, 32);
-        sha.finalizeHMAC((const uint8_t*)password, passwordLen, temp, 32);
+        sha.finalize(block, 32);
+        
+        sha = outer;
+        sha.update(block, 32);
+        sha.finalize(block, 32);
         
         // XOR con resultado acumulado
         for (int j = 0; j < 32; j++) {
-            key[j] ^= temp[j];
+            key[j] ^= block[j];
         }
-        
-        memcpy(block, temp, 32);
     }
     
-    StellarUtils::debugPrint("Crypto", "Key derivation complete");
+    StellarUtils::secureZero(block, sizeof(block));
+    
+    STELLAR_LOGD("Crypto", "Key derivation complete");
     return true;
 }
 
+uint32_t StellarCrypto::calibratePBKDF2(
+    uint32_t targetMillis,
+    uint32_t minIterations,
+    uint32_t maxIterations
+) {
+    // Medir un lote corto y escalar linealmente
+    const uint32_t probeIterations = 1000;
+    const uint8_t salt[16] = {0};
+    uint8_t key[32];
+    
+    uint32_t start = micros();
+    deriveKeyPBKDF2("calibration", salt, probeIterations, key);
+    uint32_t elapsed = micros() - start;
+    
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    
+    uint64_t iterations = (uint64_t)probeIterations * targetMillis * 1000 / elapsed;
+    
+    // Múltiplo de 1000 dentro de los límites
+    iterations -= iterations % 1000;
+    
+    if (iterations < minIterations) {
+        iterations = minIterations;
+    }
+    if (iterations > maxIterations) {
+        iterations = maxIterations;
+    }
+    
+    STELLAR_LOGI("Crypto", "PBKDF2 calibrated: %u iterations for %u ms (%u us/1000)",
+                 (unsigned)iterations, (unsigned)targetMillis, (unsigned)elapsed);
+    
+    return (uint32_t)iterations;
+}
+
 // ============================================
 // RANDOM
 // ============================================
 
 void StellarCrypto::randomBytes(uint8_t* buffer, size_t length) {
-    // Usar hardware RNG del ESP32 (criptográficamente seguro)
-    esp_fill_random(buffer, length);
-}
\ No newline at end of file
+    // DRBG ChaCha20 resembrado desde el RNG hardware del ESP32
+    StellarRandom::fill(buffer, length);
+}
+
+// ============================================
+// AES-256-GCM INCREMENTAL
+// ============================================
+
+AESGCMStream::AESGCMStream() : mode(ENCRYPT), state(IDLE) {
+}
+
+AESGCMStream::~AESGCMStream() {
+    gcm.clear();
+}
+
+void AESGCMStream::begin(Mode mode, const uint8_t key[32], const uint8_t iv[12]) {
+    this->mode = mode;
+    
+    gcm.setKey(key, 32);
+    gcm.setIV(iv, 12);
+    
+    state = AUTH_DATA;
+}
+
+bool AESGCMStream::addAuthData(const uint8_t* data, size_t length) {
+    if (state != AUTH_DATA) {
+        STELLAR_LOGE("Crypto", "GCM auth data must precede the payload");
+        return false;
+    }
+    
+    gcm.addAuthData(data, length);
+    return true;
+}
+
+bool AESGCMStream::update(const uint8_t* input, uint8_t* output, size_t length) {
+    if (state == IDLE) {
+        STELLAR_LOGE("Crypto", "GCM stream not started");
+        return false;
+    }
+    
+    if (mode == ENCRYPT) {
+        gcm.encrypt(output, input, length);
+    } else {
+        gcm.decrypt(output, input, length);
+    }
+    
+    state = DATA;
+    return true;
+}
+
+bool AESGCMStream::finish(uint8_t tag[16]) {
+    if (state == IDLE || mode != ENCRYPT) {
+        STELLAR_LOGE("Crypto", "GCM finish() requires an encrypt stream");
+        return false;
+    }
+    
+    gcm.computeTag(tag, 16);
+    state = IDLE;
+    
+    return true;
+}
+
+bool AESGCMStream::verify(const uint8_t tag[16]) {
+    if (state == IDLE || mode != DECRYPT) {
+        STELLAR_LOGE("Crypto", "GCM verify() requires a decrypt stream");
+        return false;
+    }
+    
+    // checkTag compara en tiempo constante
+    bool valid = gcm.checkTag(tag, 16);
+    state = IDLE;
+    
+    return valid;
+}
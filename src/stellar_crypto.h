@@ -6,6 +6,7 @@
 #include <SHA256.h>
 #include <AES.h>
 #include <GCM.h>
+#include "stellar_ed25519.h"
 
 /**
  * Módulo de criptografía para Stellar IoT SDK
@@ -13,6 +14,7 @@
  * Proporciona funciones criptográficas necesarias para:
  * - Firmar transacciones (Ed25519)
  * - Hash de transacciones (SHA-256)
+ * - Derivación HD de cuentas (HMAC-SHA512)
  * - Almacenamiento seguro (AES-256-GCM)
  * - Derivación de claves (PBKDF2)
  */
@@ -77,6 +79,16 @@ public:
         const uint8_t signature[64]
     );
     
+    /**
+     * Verifica varias firmas Ed25519 en lote
+     * Mucho más barato por firma que llamar verify() en cada una
+     * 
+     * @param entries Firmas (publicKey, message, signature); se completa valid
+     * @param count Número de firmas
+     * @return true si todas son válidas
+     */
+    static bool verifyBatch(Ed25519BatchEntry* entries, size_t count);
+    
     // ============================================
     // SHA-256 (Hash)
     // ============================================
@@ -106,6 +118,26 @@ public:
         uint8_t hash[32]
     );
     
+    // ============================================
+    // HMAC-SHA512 (Derivación HD)
+    // ============================================
+    
+    /**
+     * Calcula HMAC-SHA512
+     * Usado por SLIP-0010: cada paso de derivación es un HMAC
+     * 
+     * @param key Clave
+     * @param keyLength Longitud de la clave
+     * @param data Datos
+     * @param length Longitud de datos
+     * @param mac Buffer de salida (64 bytes)
+     */
+    static void hmacSHA512(
+        const uint8_t* key, size_t keyLength,
+        const uint8_t* data, size_t length,
+        uint8_t mac[64]
+    );
+    
     // ============================================
     // AES-256-GCM (Encriptación)
     // ============================================
@@ -173,13 +205,28 @@ public:
         uint8_t key[32]
     );
     
+    /**
+     * Calcula cuántas iteraciones de PBKDF2 caben en un tiempo objetivo
+     * Mide un lote corto en este dispositivo y escala
+     * 
+     * @param targetMillis Tiempo de desbloqueo deseado (ms)
+     * @param minIterations Mínimo aceptable
+     * @param maxIterations Máximo aceptable
+     * @return Iteraciones (múltiplo de 1000)
+     */
+    static uint32_t calibratePBKDF2(
+        uint32_t targetMillis,
+        uint32_t minIterations = 10000,
+        uint32_t maxIterations = 10000000
+    );
+    
     // ============================================
     // RANDOM (Generación Aleatoria)
     // ============================================
     
     /**
-     * Genera bytes aleatorios usando hardware RNG del ESP32
-     * Criptográficamente seguro
+     * Genera bytes aleatorios (DRBG ChaCha20, ver StellarRandom)
+     * Se resiembra periódicamente desde el RNG hardware del ESP32
      * 
      * @param buffer Buffer de salida
      * @param length Número de bytes a generar
@@ -187,4 +234,74 @@ public:
     static void randomBytes(uint8_t* buffer, size_t length);
 };
 
+/**
+ * Contexto AES-256-GCM incremental
+ * 
+ * Cifra o descifra un mensaje por trozos sin tenerlo entero en RAM:
+ * begin() -> addAuthData() -> update() x N -> finish()/verify()
+ * 
+ * CUIDADO al descifrar: update() entrega plaintext antes de comprobar el
+ * tag. No usarlo hasta que verify() devuelva true (SecureFileReader
+ * lo hace por segmentos).
+ */
+class AESGCMStream {
+public:
+    enum Mode {
+        ENCRYPT,
+        DECRYPT
+    };
+    
+    AESGCMStream();
+    ~AESGCMStream();
+    
+    /**
+     * Inicia un mensaje
+     * 
+     * @param mode ENCRYPT o DECRYPT
+     * @param key Clave (32 bytes)
+     * @param iv Vector de inicialización (12 bytes, nunca repetir con la misma clave)
+     */
+    void begin(Mode mode, const uint8_t key[32], const uint8_t iv[12]);
+    
+    /**
+     * Datos autenticados no cifrados (antes del primer update)
+     */
+    bool addAuthData(const uint8_t* data, size_t length);
+    
+    /**
+     * Procesa un trozo (input y output pueden ser el mismo buffer)
+     */
+    bool update(const uint8_t* input, uint8_t* output, size_t length);
+    
+    /**
+     * Termina un cifrado y genera el tag
+     * 
+     * @param tag Buffer de salida (16 bytes)
+     */
+    bool finish(uint8_t tag[16]);
+    
+    /**
+     * Termina un descifrado comprobando el tag (tiempo constante)
+     * 
+     * @param tag Tag recibido (16 bytes)
+     * @return true si el mensaje es auténtico
+     */
+    bool verify(const uint8_t tag[16]);
+    
+private:
+    enum State {
+        IDLE,
+        AUTH_DATA,
+        DATA
+    };
+    
+    GCM<AES256> gcm;
+    Mode mode;
+    State state;
+    
+    // Contiene el key schedule: no copiable
+    AESGCMStream(const AESGCMStream&) = delete;
+    AESGCMStream& operator=(const AESGCMStream&) = delete;
+};
+
 #endif // STELLAR_CRYPTO_H
\ No newline at end of file
@@ -0,0 +1,1105 @@
+#include "stellar_ed25519.h"
+#include "stellar_crypto.h"
+#include "stellar_utils.h"
+#include <SHA512.h>
+
+// ============================================
+// CAMPO GF(2^255 - 19)
+// ============================================
+
+// h = h0 + 2^26 h1 + 2^51 h2 + 2^77 h3 + ... + 2^230 h9
+// (limbs alternados de 26 y 25 bits, con signo)
+typedef int32_t fe[10];
+
+static const uint8_t LIMB_BITS[10] = {26, 25, 26, 25, 26, 25, 26, 25, 26, 25};
+static const uint8_t LIMB_OFFSET[10] = {0, 26, 51, 77, 102, 128, 153, 179, 204, 230};
+
+// d = -121665/121666
+static const fe FE_D = {
+    56195235, 13857412, 51736253, 6949390, 114729,
+    24766616, 60832955, 30306712, 48412415, 21499315
+};
+
+// 2d
+static const fe FE_D2 = {
+    45281625, 27714825, 36363642, 13898781, 229458,
+    15978800, 54557047, 27058993, 29715967, 9444199
+};
+
+// sqrt(-1)
+static const fe FE_SQRTM1 = {
+    34513072, 25610706, 9377949, 3500415, 12389472,
+    33281959, 41962654, 31548777, 326685, 11406482
+};
+
+static void feZero(fe h) {
+    memset(h, 0, sizeof(fe));
+}
+
+static void feOne(fe h) {
+    feZero(h);
+    h[0] = 1;
+}
+
+static void feCopy(fe h, const fe f) {
+    memcpy(h, f, sizeof(fe));
+}
+
+static void feAdd(fe h, const fe f, const fe g) {
+    for (int i = 0; i < 10; i++) {
+        h[i] = f[i] + g[i];
+    }
+}
+
+static void feSub(fe h, const fe f, const fe g) {
+    for (int i = 0; i < 10; i++) {
+        h[i] = f[i] - g[i];
+    }
+}
+
+static void feNeg(fe h, const fe f) {
+    for (int i = 0; i < 10; i++) {
+        h[i] = -f[i];
+    }
+}
+
+// f = b ? g : f en tiempo constante (b = 0 o 1)
+static void feCmov(fe f, const fe g, uint32_t b) {
+    int32_t mask = -(int32_t)b;
+
+    for (int i = 0; i < 10; i++) {
+        f[i] ^= (f[i] ^ g[i]) & mask;
+    }
+}
+
+// Lleva el exceso del limb i al siguiente (el del último vuelve por 2^255 = 19)
+static inline void feCarry(int64_t h[10], int i) {
+    int bits = LIMB_BITS[i];
+    int64_t carry = (h[i] + ((int64_t)1 << (bits - 1))) >> bits;
+    h[i] -= carry * ((int64_t)1 << bits);
+
+    if (i == 9) {
+        h[0] += carry * 19;
+    } else {
+        h[i + 1] += carry;
+    }
+}
+
+// Productos de 64 bits -> limbs de 32 bits (mismo orden que ref10)
+static void feReduce(fe out, int64_t h[10]) {
+    static const uint8_t ORDER[12] = {0, 4, 1, 5, 2, 6, 3, 7, 4, 8, 9, 0};
+
+    for (int i = 0; i < 12; i++) {
+        feCarry(h, ORDER[i]);
+    }
+
+    for (int i = 0; i < 10; i++) {
+        out[i] = (int32_t)h[i];
+    }
+}
+
+static void feMul(fe h, const fe f, const fe g) {
+    int32_t g19[10];
+    int32_t f2[10];
+
+    for (int i = 0; i < 10; i++) {
+        g19[i] = 19 * g[i];
+        f2[i] = 2 * f[i];
+    }
+
+    int64_t t[10] = {0};
+
+    // Limbs impares por impares llevan un factor 2 (radix 2^25.5);
+    // lo que pasa de 2^255 vuelve multiplicado por 19
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j++) {
+            int32_t a = (i & j & 1) ? f2[i] : f[i];
+            int32_t b = (i + j >= 10) ? g19[j] : g[j];
+            t[(i + j) % 10] += (int64_t)a * b;
+        }
+    }
+
+    feReduce(h, t);
+}
+
+static void feSquareWide(int64_t t[10], const fe f) {
+    int32_t f19[10];
+    int32_t f2[10];
+
+    for (int i = 0; i < 10; i++) {
+        f19[i] = 19 * f[i];
+        f2[i] = 2 * f[i];
+        t[i] = 0;
+    }
+
+    // Solo la mitad superior de la matriz: los productos cruzados van dobles
+    for (int i = 0; i < 10; i++) {
+        for (int j = i; j < 10; j++) {
+            int32_t a = (i & j & 1) ? f2[i] : f[i];
+            int32_t b = (i + j >= 10) ? f19[j] : f[j];
+            int64_t p = (int64_t)a * b;
+            t[(i + j) % 10] += (i == j) ? p : p + p;
+        }
+    }
+}
+
+static void feSq(fe h, const fe f) {
+    int64_t t[10];
+    feSquareWide(t, f);
+    feReduce(h, t);
+}
+
+// h = 2 * f^2
+static void feSq2(fe h, const fe f) {
+    int64_t t[10];
+    feSquareWide(t, f);
+
+    for (int i = 0; i < 10; i++) {
+        t[i] += t[i];
+    }
+
+    feReduce(h, t);
+}
+
+// h = f^(2^n)
+static void feSqN(fe h, const fe f, int n) {
+    feSq(h, f);
+
+    for (int i = 1; i < n; i++) {
+        feSq(h, h);
+    }
+}
+
+static void feFromBytes(fe h, const uint8_t s[32]) {
+    int64_t t[10];
+
+    // El bit 255 se ignora
+    for (int i = 0; i < 10; i++) {
+        size_t byte = LIMB_OFFSET[i] / 8;
+        uint64_t v = 0;
+
+        for (size_t k = 0; k < 5 && byte + k < 32; k++) {
+            v |= (uint64_t)s[byte + k] << (8 * k);
+        }
+
+        t[i] = (int64_t)((v >> (LIMB_OFFSET[i] % 8)) & (((uint64_t)1 << LIMB_BITS[i]) - 1));
+    }
+
+    feReduce(h, t);
+}
+
+// Forma canónica (< p), little-endian
+static void feToBytes(uint8_t s[32], const fe f) {
+    int32_t h[10];
+    memcpy(h, f, sizeof(h));
+
+    // q = floor(h / p) en {0, 1}
+    int32_t q = (19 * h[9] + ((int32_t)1 << 24)) >> 25;
+    for (int i = 0; i < 10; i++) {
+        q = (h[i] + q) >> LIMB_BITS[i];
+    }
+
+    h[0] += 19 * q;
+
+    for (int i = 0; i < 9; i++) {
+        int32_t carry = h[i] >> LIMB_BITS[i];
+        h[i + 1] += carry;
+        h[i] -= carry * ((int32_t)1 << LIMB_BITS[i]);
+    }
+    h[9] &= ((int32_t)1 << 25) - 1;
+
+    uint64_t acc = 0;
+    int bits = 0;
+    size_t pos = 0;
+
+    for (int i = 0; i < 10; i++) {
+        acc |= (uint64_t)(uint32_t)h[i] << bits;
+        bits += LIMB_BITS[i];
+
+        while (bits >= 8) {
+            s[pos++] = (uint8_t)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+
+    s[pos] = (uint8_t)acc;  // Últimos 7 bits
+}
+
+static int feIsNegative(const fe f) {
+    uint8_t s[32];
+    feToBytes(s, f);
+    return s[0] & 1;
+}
+
+static int feIsNonZero(const fe f) {
+    uint8_t s[32];
+    feToBytes(s, f);
+
+    uint8_t r = 0;
+    for (int i = 0; i < 32; i++) {
+        r |= s[i];
+    }
+
+    return r != 0;
+}
+
+// h = z^(p - 2) = 1/z
+static void feInvert(fe h, const fe z) {
+    fe t0, t1, t2, t3;
+
+    feSq(t0, z);                // 2
+    feSqN(t1, t0, 2);           // 8
+    feMul(t1, z, t1);           // 9
+    feMul(t0, t0, t1);          // 11
+    feSq(t2, t0);               // 22
+    feMul(t1, t1, t2);          // 2^5 - 1
+    feSqN(t2, t1, 5);
+    feMul(t1, t2, t1);          // 2^10 - 1
+    feSqN(t2, t1, 10);
+    feMul(t2, t2, t1);          // 2^20 - 1
+    feSqN(t3, t2, 20);
+    feMul(t2, t3, t2);          // 2^40 - 1
+    feSqN(t2, t2, 10);
+    feMul(t1, t2, t1);          // 2^50 - 1
+    feSqN(t2, t1, 50);
+    feMul(t2, t2, t1);          // 2^100 - 1
+    feSqN(t3, t2, 100);
+    feMul(t2, t3, t2);          // 2^200 - 1
+    feSqN(t2, t2, 50);
+    feMul(t1, t2, t1);          // 2^250 - 1
+    feSqN(t1, t1, 5);           // 2^255 - 32
+    feMul(h, t1, t0);           // 2^255 - 21
+}
+
+// h = z^((p - 5) / 8) = z^(2^252 - 3)
+static void fePow22523(fe h, const fe z) {
+    fe t0, t1, t2;
+
+    feSq(t0, z);                // 2
+    feSqN(t1, t0, 2);           // 8
+    feMul(t1, z, t1);           // 9
+    feMul(t0, t0, t1);          // 11
+    feSq(t0, t0);               // 22
+    feMul(t0, t1, t0);          // 2^5 - 1
+    feSqN(t1, t0, 5);
+    feMul(t0, t1, t0);          // 2^10 - 1
+    feSqN(t1, t0, 10);
+    feMul(t1, t1, t0);          // 2^20 - 1
+    feSqN(t2, t1, 20);
+    feMul(t1, t2, t1);          // 2^40 - 1
+    feSqN(t1, t1, 10);
+    feMul(t0, t1, t0);          // 2^50 - 1
+    feSqN(t1, t0, 50);
+    feMul(t1, t1, t0);          // 2^100 - 1
+    feSqN(t2, t1, 100);
+    feMul(t1, t2, t1);          // 2^200 - 1
+    feSqN(t1, t1, 50);
+    feMul(t0, t1, t0);          // 2^250 - 1
+    feSqN(t0, t0, 2);           // 2^252 - 4
+    feMul(h, t0, z);            // 2^252 - 3
+}
+
+// ============================================
+// CURVA (coordenadas extendidas, fórmulas de ref10)
+// ============================================
+
+struct GeP2 {
+    fe X, Y, Z;                 // x = X/Z, y = Y/Z
+};
+
+struct GeP3 {
+    fe X, Y, Z, T;              // Además XY = ZT
+};
+
+struct GeP1P1 {
+    fe X, Y, Z, T;              // x = X/Z, y = Y/T
+};
+
+struct GeCached {
+    fe YplusX, YminusX, Z, T2d;
+};
+
+struct GePrecomp {
+    fe yplusx, yminusx, xy2d;   // Afín (Z = 1)
+};
+
+#if STELLAR_ED25519_BASE_TABLE
+#include "stellar_ed25519_table.h"
+#endif
+
+// Punto base B (y = 4/5, x positivo)
+static const GeP3 ED25519_BASE = {
+    {52811034, 25909283, 16144682, 17082669, 27570973, 30858332, 40966398, 8378388, 20764389, 8758491},
+    {40265304, 26843545, 13421772, 20132659, 26843545, 6710886, 53687091, 13421772, 40265318, 26843545},
+    {1, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {28827043, 27438313, 39759291, 244362, 8635006, 11264893, 19351346, 13413597, 16611511, 27139452}
+};
+
+static void geP3Identity(GeP3& h) {
+    feZero(h.X);
+    feOne(h.Y);
+    feOne(h.Z);
+    feZero(h.T);
+}
+
+static void geP3ToP2(GeP2& r, const GeP3& p) {
+    feCopy(r.X, p.X);
+    feCopy(r.Y, p.Y);
+    feCopy(r.Z, p.Z);
+}
+
+static void geP3ToCached(GeCached& r, const GeP3& p) {
+    feAdd(r.YplusX, p.Y, p.X);
+    feSub(r.YminusX, p.Y, p.X);
+    feCopy(r.Z, p.Z);
+    feMul(r.T2d, p.T, FE_D2);
+}
+
+static void geP1P1ToP2(GeP2& r, const GeP1P1& p) {
+    feMul(r.X, p.X, p.T);
+    feMul(r.Y, p.Y, p.Z);
+    feMul(r.Z, p.Z, p.T);
+}
+
+static void geP1P1ToP3(GeP3& r, const GeP1P1& p) {
+    feMul(r.X, p.X, p.T);
+    feMul(r.Y, p.Y, p.Z);
+    feMul(r.Z, p.Z, p.T);
+    feMul(r.T, p.X, p.Y);
+}
+
+// r = 2p
+static void geP2Dbl(GeP1P1& r, const GeP2& p) {
+    fe t0;
+
+    feSq(r.X, p.X);
+    feSq(r.Z, p.Y);
+    feSq2(r.T, p.Z);
+    feAdd(r.Y, p.X, p.Y);
+    feSq(t0, r.Y);
+    feAdd(r.Y, r.Z, r.X);
+    feSub(r.Z, r.Z, r.X);
+    feSub(r.X, t0, r.Y);
+    feSub(r.T, r.T, r.Z);
+}
+
+// r = p + q
+static void geAdd(GeP1P1& r, const GeP3& p, const GeCached& q) {
+    fe t0;
+
+    feAdd(r.X, p.Y, p.X);
+    feSub(r.Y, p.Y, p.X);
+    feMul(r.Z, r.X, q.YplusX);
+    feMul(r.Y, r.Y, q.YminusX);
+    feMul(r.T, q.T2d, p.T);
+    feMul(r.X, p.Z, q.Z);
+    feAdd(t0, r.X, r.X);
+    feSub(r.X, r.Z, r.Y);
+    feAdd(r.Y, r.Z, r.Y);
+    feAdd(r.Z, t0, r.T);
+    feSub(r.T, t0, r.T);
+}
+
+// r = p - q
+static void geSub(GeP1P1& r, const GeP3& p, const GeCached& q) {
+    fe t0;
+
+    feAdd(r.X, p.Y, p.X);
+    feSub(r.Y, p.Y, p.X);
+    feMul(r.Z, r.X, q.YminusX);
+    feMul(r.Y, r.Y, q.YplusX);
+    feMul(r.T, q.T2d, p.T);
+    feMul(r.X, p.Z, q.Z);
+    feAdd(t0, r.X, r.X);
+    feSub(r.X, r.Z, r.Y);
+    feAdd(r.Y, r.Z, r.Y);
+    feSub(r.Z, t0, r.T);
+    feAdd(r.T, t0, r.T);
+}
+
+static void geP3Dbl(GeP1P1& r, const GeP3& p) {
+    GeP2 q;
+    geP3ToP2(q, p);
+    geP2Dbl(r, q);
+}
+
+static void geP3ToBytes(uint8_t s[32], const GeP3& h) {
+    fe recip, x, y;
+
+    feInvert(recip, h.Z);
+    feMul(x, h.X, recip);
+    feMul(y, h.Y, recip);
+    feToBytes(s, y);
+    s[31] ^= feIsNegative(x) << 7;
+}
+
+// Descomprime un punto (tiempo variable: solo para datos públicos)
+static bool geFromBytes(GeP3& h, const uint8_t s[32]) {
+    fe u, v, v3, vxx, check;
+
+    feFromBytes(h.Y, s);
+    feOne(h.Z);
+
+    // x^2 = (y^2 - 1) / (d y^2 + 1)
+    feSq(u, h.Y);
+    feMul(v, u, FE_D);
+    feSub(u, u, h.Z);
+    feAdd(v, v, h.Z);
+
+    // x = u v^3 (u v^7)^((p - 5) / 8)
+    feSq(v3, v);
+    feMul(v3, v3, v);
+    feSq(h.X, v3);
+    feMul(h.X, h.X, v);
+    feMul(h.X, h.X, u);
+    fePow22523(h.X, h.X);
+    feMul(h.X, h.X, v3);
+    feMul(h.X, h.X, u);
+
+    feSq(vxx, h.X);
+    feMul(vxx, vxx, v);
+    feSub(check, vxx, u);
+
+    if (feIsNonZero(check)) {
+        feAdd(check, vxx, u);
+        if (feIsNonZero(check)) {
+            return false;  // No está en la curva
+        }
+        feMul(h.X, h.X, FE_SQRTM1);
+    }
+
+    if (feIsNegative(h.X) != (s[31] >> 7)) {
+        feNeg(h.X, h.X);
+    }
+
+    feMul(h.T, h.X, h.Y);
+    return true;
+}
+
+// 8P == neutro: punto de orden pequeño (claves débiles y R de falsificaciones)
+static bool geIsSmallOrder(const GeP3& p) {
+    GeP1P1 t;
+    GeP2 r;
+
+    geP3ToP2(r, p);
+    for (int i = 0; i < 3; i++) {
+        geP2Dbl(t, r);
+        geP1P1ToP2(r, t);
+    }
+
+    fe yMinusZ;
+    feSub(yMinusZ, r.Y, r.Z);
+
+    return !feIsNonZero(r.X) && !feIsNonZero(yMinusZ);
+}
+
+// 1 si b == c, sin saltos
+static uint32_t ctEqual(uint8_t b, uint8_t c) {
+    uint32_t x = b ^ c;
+    x -= 1;
+    return x >> 31;
+}
+
+// a (escalar de 32 bytes, a[31] <= 127) -> 64 dígitos con signo en [-8, 8]
+static void toRadix16(int8_t e[64], const uint8_t a[32]) {
+    for (int i = 0; i < 32; i++) {
+        e[2 * i] = a[i] & 15;
+        e[2 * i + 1] = (a[i] >> 4) & 15;
+    }
+
+    int8_t carry = 0;
+    for (int i = 0; i < 63; i++) {
+        e[i] += carry;
+        carry = (e[i] + 8) >> 4;
+        e[i] -= carry * 16;
+    }
+    e[63] += carry;
+}
+
+#if STELLAR_ED25519_BASE_TABLE
+
+// r = p + q (q afín de la tabla)
+static void geMadd(GeP1P1& r, const GeP3& p, const GePrecomp& q) {
+    fe t0;
+
+    feAdd(r.X, p.Y, p.X);
+    feSub(r.Y, p.Y, p.X);
+    feMul(r.Z, r.X, q.yplusx);
+    feMul(r.Y, r.Y, q.yminusx);
+    feMul(r.T, q.xy2d, p.T);
+    feAdd(t0, p.Z, p.Z);
+    feSub(r.X, r.Z, r.Y);
+    feAdd(r.Y, r.Z, r.Y);
+    feAdd(r.Z, t0, r.T);
+    feSub(r.T, t0, r.T);
+}
+
+static void gePrecompCmov(GePrecomp& t, const GePrecomp& u, uint32_t b) {
+    feCmov(t.yplusx, u.yplusx, b);
+    feCmov(t.yminusx, u.yminusx, b);
+    feCmov(t.xy2d, u.xy2d, b);
+}
+
+// t = b * 256^pos * B, con b en [-8, 8] (recorre las 8 entradas de la fila)
+static void selectPrecomp(GePrecomp& t, int pos, int8_t b) {
+    uint32_t negative = (uint8_t)b >> 7;
+    uint8_t babs = (uint8_t)(b - ((-(int32_t)negative & b) * 2));
+
+    feOne(t.yplusx);
+    feOne(t.yminusx);
+    feZero(t.xy2d);
+
+    for (int i = 0; i < 8; i++) {
+        gePrecompCmov(t, ED25519_BASE_TABLE[pos][i], ctEqual(babs, i + 1));
+    }
+
+    GePrecomp minus;
+    feCopy(minus.yplusx, t.yminusx);
+    feCopy(minus.yminusx, t.yplusx);
+    feNeg(minus.xy2d, t.xy2d);
+
+    gePrecompCmov(t, minus, negative);
+}
+
+// h = a * B con la tabla: a = sum(e_i 16^i), los dígitos impares se
+// acumulan primero y se multiplican por 16; 64 sumas y 4 doblados
+static void geScalarMultBase(GeP3& h, const uint8_t a[32]) {
+    int8_t e[64];
+    toRadix16(e, a);
+
+    GePrecomp t;
+    GeP1P1 r;
+    GeP2 s;
+
+    geP3Identity(h);
+
+    for (int i = 1; i < 64; i += 2) {
+        selectPrecomp(t, i / 2, e[i]);
+        geMadd(r, h, t);
+        geP1P1ToP3(h, r);
+    }
+
+    geP3Dbl(r, h);
+    geP1P1ToP2(s, r);
+    geP2Dbl(r, s);
+    geP1P1ToP2(s, r);
+    geP2Dbl(r, s);
+    geP1P1ToP2(s, r);
+    geP2Dbl(r, s);
+    geP1P1ToP3(h, r);
+
+    for (int i = 0; i < 64; i += 2) {
+        selectPrecomp(t, i / 2, e[i]);
+        geMadd(r, h, t);
+        geP1P1ToP3(h, r);
+    }
+
+    StellarUtils::secureZero(e, sizeof(e));
+}
+
+#else
+
+static void geCachedIdentity(GeCached& h) {
+    feOne(h.YplusX);
+    feOne(h.YminusX);
+    feOne(h.Z);
+    feZero(h.T2d);
+}
+
+static void geCachedCmov(GeCached& t, const GeCached& u, uint32_t b) {
+    feCmov(t.YplusX, u.YplusX, b);
+    feCmov(t.YminusX, u.YminusX, b);
+    feCmov(t.Z, u.Z, b);
+    feCmov(t.T2d, u.T2d, b);
+}
+
+// t = b * P a partir de table[i] = (i + 1) * P, con b en [-8, 8]
+// Recorre toda la tabla: el acceso no depende del escalar secreto
+static void selectCached(GeCached& t, const GeCached table[8], int8_t b) {
+    uint32_t negative = (uint8_t)b >> 7;
+    uint8_t babs = (uint8_t)(b - ((-(int32_t)negative & b) * 2));
+
+    geCachedIdentity(t);
+
+    for (int i = 0; i < 8; i++) {
+        geCachedCmov(t, table[i], ctEqual(babs, i + 1));
+    }
+
+    GeCached minus;
+    feCopy(minus.YplusX, t.YminusX);
+    feCopy(minus.YminusX, t.YplusX);
+    feCopy(minus.Z, t.Z);
+    feNeg(minus.T2d, t.T2d);
+
+    geCachedCmov(t, minus, negative);
+}
+
+// h = a * P en tiempo constante (ventana fija de 4 bits con signo)
+static void geScalarMult(GeP3& h, const uint8_t a[32], const GeP3& p) {
+    GeCached table[8];
+    GeP1P1 r;
+    GeP2 s;
+    GeP3 multiple = p;
+
+    geP3ToCached(table[0], p);
+    for (int i = 1; i < 8; i++) {
+        geAdd(r, multiple, table[0]);
+        geP1P1ToP3(multiple, r);
+        geP3ToCached(table[i], multiple);
+    }
+
+    int8_t e[64];
+    toRadix16(e, a);
+
+    geP3Identity(h);
+
+    for (int i = 63; i >= 0; i--) {
+        if (i < 63) {
+            // h = 16h
+            geP3ToP2(s, h);
+            geP2Dbl(r, s);
+            geP1P1ToP2(s, r);
+            geP2Dbl(r, s);
+            geP1P1ToP2(s, r);
+            geP2Dbl(r, s);
+            geP1P1ToP2(s, r);
+            geP2Dbl(r, s);
+            geP1P1ToP3(h, r);
+        }
+
+        GeCached selected;
+        selectCached(selected, table, e[i]);
+        geAdd(r, h, selected);
+        geP1P1ToP3(h, r);
+    }
+
+    StellarUtils::secureZero(e, sizeof(e));
+}
+
+static void geScalarMultBase(GeP3& h, const uint8_t a[32]) {
+    geScalarMult(h, a, ED25519_BASE);
+}
+
+#endif
+
+// ============================================
+// ESCALARES MÓDULO L = 2^252 + 27742317777372353535851937790883648493
+// ============================================
+
+static const int64_t ORDER_L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58,
+    0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0x10
+};
+
+// r = x mod L, con x en 64 "dígitos" base 256 (pueden exceder 8 bits)
+static void scModL(uint8_t r[32], int64_t x[64]) {
+    int64_t carry;
+    int i, j;
+
+    for (i = 63; i >= 32; i--) {
+        carry = 0;
+        for (j = i - 32; j < i - 12; j++) {
+            x[j] += carry - 16 * x[i] * ORDER_L[j - (i - 32)];
+            carry = (x[j] + 128) >> 8;
+            x[j] -= carry * 256;
+        }
+        x[j] += carry;
+        x[i] = 0;
+    }
+
+    carry = 0;
+    for (j = 0; j < 32; j++) {
+        x[j] += carry - (x[31] >> 4) * ORDER_L[j];
+        carry = x[j] >> 8;
+        x[j] &= 255;
+    }
+
+    for (j = 0; j < 32; j++) {
+        x[j] -= carry * ORDER_L[j];
+    }
+
+    for (i = 0; i < 32; i++) {
+        x[i + 1] += x[i] >> 8;
+        r[i] = (uint8_t)(x[i] & 255);
+    }
+}
+
+// r = s mod L (s de 64 bytes, salida de SHA-512)
+static void scReduce(uint8_t r[32], const uint8_t s[64]) {
+    int64_t x[64];
+
+    for (int i = 0; i < 64; i++) {
+        x[i] = s[i];
+    }
+
+    scModL(r, x);
+    StellarUtils::secureZero(x, sizeof(x));
+}
+
+// s = (a * b + c) mod L
+static void scMulAdd(uint8_t s[32], const uint8_t a[32], const uint8_t b[32], const uint8_t c[32]) {
+    int64_t x[64] = {0};
+
+    for (int i = 0; i < 32; i++) {
+        x[i] = c[i];
+    }
+
+    for (int i = 0; i < 32; i++) {
+        for (int j = 0; j < 32; j++) {
+            x[i + j] += (int64_t)a[i] * b[j];
+        }
+    }
+
+    scModL(s, x);
+    StellarUtils::secureZero(x, sizeof(x));
+}
+
+// S < L (firmas maleables con S >= L se rechazan)
+static bool scIsCanonical(const uint8_t s[32]) {
+    for (int i = 31; i >= 0; i--) {
+        if (s[i] != ORDER_L[i]) {
+            return s[i] < ORDER_L[i];
+        }
+    }
+
+    return false;
+}
+
+// ============================================
+// MULTIPLICACIÓN MULTI-ESCALAR (tiempo variable, datos públicos)
+// ============================================
+
+// Dígitos wNAF impares en [-7, 7]: tabla de 4 múltiplos por punto
+static const int WNAF_MAX_DIGIT = 7;
+
+struct MsmTerm {
+    GeCached table[4];          // P, 3P, 5P, 7P
+    int8_t naf[256];
+};
+
+// a -> dígitos con signo (ventana deslizante, como slide() de ref10)
+static void toWnaf(int8_t r[256], const uint8_t a[32]) {
+    for (int i = 0; i < 256; i++) {
+        r[i] = 1 & (a[i >> 3] >> (i & 7));
+    }
+
+    for (int i = 0; i < 256; i++) {
+        if (!r[i]) {
+            continue;
+        }
+
+        for (int b = 1; b <= 4 && i + b < 256; b++) {
+            if (!r[i + b]) {
+                continue;
+            }
+
+            int shifted = r[i + b] << b;
+
+            if (r[i] + shifted <= WNAF_MAX_DIGIT) {
+                r[i] += shifted;
+                r[i + b] = 0;
+            } else if (r[i] - shifted >= -WNAF_MAX_DIGIT) {
+                r[i] -= shifted;
+
+                for (int k = i + b; k < 256; k++) {
+                    if (!r[k]) {
+                        r[k] = 1;
+                        break;
+                    }
+                    r[k] = 0;
+                }
+            } else {
+                break;
+            }
+        }
+    }
+}
+
+static void msmPrepare(MsmTerm& term, const GeP3& p, const uint8_t scalar[32]) {
+    GeP1P1 t;
+    GeP3 u;
+    GeCached twice;
+
+    geP3Dbl(t, p);
+    geP1P1ToP3(u, t);
+    geP3ToCached(twice, u);
+
+    geP3ToCached(term.table[0], p);
+    u = p;
+
+    for (int i = 1; i < 4; i++) {
+        geAdd(t, u, twice);
+        geP1P1ToP3(u, t);
+        geP3ToCached(term.table[i], u);
+    }
+
+    toWnaf(term.naf, scalar);
+}
+
+// true si 8 * sum(scalar_i * P_i) es el neutro (Straus: dobles compartidos)
+static bool msmIsIdentity(const MsmTerm* terms, size_t count) {
+    int top = 255;
+    while (top >= 0) {
+        size_t j = 0;
+        while (j < count && terms[j].naf[top] == 0) {
+            j++;
+        }
+        if (j < count) {
+            break;
+        }
+        top--;
+    }
+
+    GeP2 r;
+    GeP1P1 t;
+    GeP3 u;
+
+    feZero(r.X);
+    feOne(r.Y);
+    feOne(r.Z);
+
+    for (int i = top; i >= 0; i--) {
+        geP2Dbl(t, r);
+
+        for (size_t j = 0; j < count; j++) {
+            int8_t digit = terms[j].naf[i];
+
+            if (digit > 0) {
+                geP1P1ToP3(u, t);
+                geAdd(t, u, terms[j].table[digit / 2]);
+            } else if (digit < 0) {
+                geP1P1ToP3(u, t);
+                geSub(t, u, terms[j].table[-digit / 2]);
+            }
+        }
+
+        geP1P1ToP2(r, t);
+    }
+
+    // Multiplicar por el cofactor elimina componentes de orden pequeño
+    for (int i = 0; i < 3; i++) {
+        geP2Dbl(t, r);
+        geP1P1ToP2(r, t);
+    }
+
+    fe yMinusZ;
+    feSub(yMinusZ, r.Y, r.Z);
+
+    return !feIsNonZero(r.X) && !feIsNonZero(yMinusZ);
+}
+
+// ============================================
+// VERIFICACIÓN POR LOTES
+// ============================================
+
+// Firma ya decodificada: R = S B - k A si es válida
+struct BatchItem {
+    GeP3 A;
+    GeP3 R;
+    uint8_t k[32];
+    uint8_t S[32];
+    Ed25519BatchEntry* entry;
+};
+
+static const uint8_t SCALAR_ZERO[32] = {0};
+
+// sum(z_i (R_i + k_i A_i - S_i B)) == 0 con z_i aleatorios de 128 bits
+// terms: espacio para 2 * count + 1 términos
+static bool checkBatch(const BatchItem* items, size_t count, MsmTerm* terms) {
+    uint8_t sum[32] = {0};
+    uint8_t z[32];
+    uint8_t zk[32];
+
+    for (size_t i = 0; i < count; i++) {
+        memset(z, 0, sizeof(z));
+        StellarCrypto::randomBytes(z, 16);
+        z[0] |= 1;  // Nunca cero
+
+        scMulAdd(zk, z, items[i].k, SCALAR_ZERO);
+        scMulAdd(sum, z, items[i].S, sum);
+
+        msmPrepare(terms[2 * i + 1], items[i].R, z);
+        msmPrepare(terms[2 * i + 2], items[i].A, zk);
+    }
+
+    // -B con escalar sum(z_i S_i)
+    GeP3 negativeBase = ED25519_BASE;
+    feNeg(negativeBase.X, negativeBase.X);
+    feNeg(negativeBase.T, negativeBase.T);
+    msmPrepare(terms[0], negativeBase, sum);
+
+    return msmIsIdentity(terms, 2 * count + 1);
+}
+
+// Si el lote falla se parte en mitades hasta aislar las firmas inválidas
+static void verifyItems(BatchItem* items, size_t count, MsmTerm* terms) {
+    if (checkBatch(items, count, terms)) {
+        for (size_t i = 0; i < count; i++) {
+            items[i].entry->valid = true;
+        }
+        return;
+    }
+
+    if (count == 1) {
+        items[0].entry->valid = false;
+        return;
+    }
+
+    size_t half = count / 2;
+    verifyItems(items, half, terms);
+    verifyItems(items + half, count - half, terms);
+}
+
+// ============================================
+// API PÚBLICA
+// ============================================
+
+// SHA512(seed) -> escalar clamped + prefijo
+static void hashSeed(const uint8_t seed[32], Ed25519ExpandedKey& key) {
+    uint8_t hash[64];
+
+    SHA512 sha;
+    sha.reset();
+    sha.update(seed, 32);
+    sha.finalize(hash, 64);
+
+    hash[0] &= 248;
+    hash[31] &= 127;
+    hash[31] |= 64;
+
+    memcpy(key.scalar, hash, 32);
+    memcpy(key.prefix, hash + 32, 32);
+
+    StellarUtils::secureZero(hash, sizeof(hash));
+}
+
+void StellarEd25519::expandKey(const uint8_t seed[32], Ed25519ExpandedKey& key) {
+    hashSeed(seed, key);
+
+    GeP3 A;
+    geScalarMultBase(A, key.scalar);
+    geP3ToBytes(key.publicKey, A);
+}
+
+void StellarEd25519::expandKey(
+    const uint8_t seed[32],
+    const uint8_t publicKey[32],
+    Ed25519ExpandedKey& key
+) {
+    hashSeed(seed, key);
+    memcpy(key.publicKey, publicKey, 32);
+}
+
+void StellarEd25519::derivePublicKey(uint8_t publicKey[32], const uint8_t seed[32]) {
+    Ed25519ExpandedKey key;
+    expandKey(seed, key);
+    memcpy(publicKey, key.publicKey, 32);
+    StellarUtils::secureZero(&key, sizeof(key));
+}
+
+void StellarEd25519::sign(
+    const Ed25519ExpandedKey& key,
+    const uint8_t* message,
+    size_t length,
+    uint8_t signature[64]
+) {
+    uint8_t hash[64];
+    uint8_t r[32];
+    uint8_t k[32];
+    SHA512 sha;
+
+    // r = SHA512(prefix || M) mod L
+    sha.reset();
+    sha.update(key.prefix, 32);
+    sha.update(message, length);
+    sha.finalize(hash, 64);
+    scReduce(r, hash);
+
+    // R = rB
+    GeP3 R;
+    geScalarMultBase(R, r);
+    geP3ToBytes(signature, R);
+
+    // k = SHA512(R || A || M) mod L
+    sha.reset();
+    sha.update(signature, 32);
+    sha.update(key.publicKey, 32);
+    sha.update(message, length);
+    sha.finalize(hash, 64);
+    scReduce(k, hash);
+
+    // S = (r + k * a) mod L
+    scMulAdd(signature + 32, k, key.scalar, r);
+
+    StellarUtils::secureZero(hash, sizeof(hash));
+    StellarUtils::secureZero(r, sizeof(r));
+}
+
+bool StellarEd25519::verifyBatch(Ed25519BatchEntry* entries, size_t count) {
+    const size_t batchSize = STELLAR_ED25519_BATCH_SIZE;
+
+    BatchItem* items = (BatchItem*)malloc(batchSize * sizeof(BatchItem));
+    MsmTerm* terms = (MsmTerm*)malloc((2 * batchSize + 1) * sizeof(MsmTerm));
+
+    if (!items || !terms) {
+        STELLAR_LOGE("Ed25519", "Out of memory for batch verification");
+        free(items);
+        free(terms);
+
+        for (size_t i = 0; i < count; i++) {
+            entries[i].valid = false;
+        }
+        return false;
+    }
+
+    size_t pending = 0;
+    bool allValid = true;
+    uint8_t hash[64];
+    SHA512 sha;
+
+    for (size_t i = 0; i < count; i++) {
+        Ed25519BatchEntry& entry = entries[i];
+        BatchItem& item = items[pending];
+
+        // Encodings inválidos fallan sin entrar al lote. Con el cofactor, A o R
+        // de orden pequeño validarían firmas que verify() rechaza (R = 0, S = 0
+        // con A de orden 8 vale para cualquier mensaje): se rechazan, como libsodium
+        if (!scIsCanonical(entry.signature + 32) ||
+            !geFromBytes(item.A, entry.publicKey) ||
+            !geFromBytes(item.R, entry.signature) ||
+            geIsSmallOrder(item.A) ||
+            geIsSmallOrder(item.R)) {
+            entry.valid = false;
+            allValid = false;
+        } else {
+            // k = SHA512(R || A || M) mod L
+            sha.reset();
+            sha.update(entry.signature, 32);
+            sha.update(entry.publicKey, 32);
+            sha.update(entry.message, entry.messageLen);
+            sha.finalize(hash, 64);
+            scReduce(item.k, hash);
+
+            memcpy(item.S, entry.signature + 32, 32);
+            item.entry = &entry;
+            pending++;
+        }
+
+        if (pending == batchSize || (i == count - 1 && pending > 0)) {
+            verifyItems(items, pending, terms);
+
+            for (size_t j = 0; j < pending; j++) {
+                allValid = allValid && items[j].entry->valid;
+            }
+            pending = 0;
+        }
+    }
+
+    free(items);
+    free(terms);
+
+    return allValid;
+}
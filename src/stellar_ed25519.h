@@ -0,0 +1,107 @@
+#ifndef STELLAR_ED25519_H
+#define STELLAR_ED25519_H
+
+#include <Arduino.h>
+
+/**
+ * Núcleo Ed25519 propio
+ *
+ * La clase Ed25519 de rweather solo expone sign/verify sobre el seed de
+ * 32 bytes: cada firma vuelve a calcular SHA512(seed) para obtener el
+ * escalar y el prefijo. Aquí la clave expandida se calcula una vez y se
+ * reutiliza en todas las firmas (ver SigningContext).
+ *
+ * Aritmética de campo en 10 limbs de 25.5 bits (estilo ref10) con
+ * productos de 32x32 -> 64 bits, que el ESP32 hace en hardware.
+ * Las operaciones con datos secretos son de tiempo constante.
+ *
+ * Las firmas son idénticas a las de RFC 8032 (Ed25519 es determinista).
+ */
+
+// Tabla precomputada de múltiplos del punto base (~30 KB en flash):
+// keygen y la R de cada firma ~4x más rápidas. Con 0 se usa la ventana
+// de 4 bits genérica (sin tabla)
+#ifndef STELLAR_ED25519_BASE_TABLE
+#define STELLAR_ED25519_BASE_TABLE 1
+#endif
+
+// Firmas por lote de verificación (2 * N + 1 términos, ~900 bytes cada uno en heap)
+#ifndef STELLAR_ED25519_BATCH_SIZE
+#define STELLAR_ED25519_BATCH_SIZE 16
+#endif
+
+/**
+ * Clave de firma expandida
+ * SHA512(seed) = escalar (clamped) || prefijo
+ * CUIDADO: equivale a la secret key
+ */
+struct Ed25519ExpandedKey {
+    uint8_t scalar[32];
+    uint8_t prefix[32];
+    uint8_t publicKey[32];
+};
+
+/**
+ * Firma a verificar en lote
+ */
+struct Ed25519BatchEntry {
+    const uint8_t* publicKey;   // 32 bytes
+    const uint8_t* message;
+    size_t messageLen;
+    const uint8_t* signature;   // 64 bytes
+    bool valid;                 // Resultado de verifyBatch()
+};
+
+class StellarEd25519 {
+public:
+    /**
+     * Expande un seed a escalar + prefijo y deriva la public key
+     *
+     * @param seed Secret key (32 bytes)
+     * @param key Clave expandida resultante
+     */
+    static void expandKey(const uint8_t seed[32], Ed25519ExpandedKey& key);
+
+    /**
+     * Expande un seed usando una public key ya conocida
+     * (evita la multiplicación escalar; la public key debe corresponder al seed)
+     */
+    static void expandKey(const uint8_t seed[32], const uint8_t publicKey[32], Ed25519ExpandedKey& key);
+
+    /**
+     * Deriva la public key desde el seed
+     */
+    static void derivePublicKey(uint8_t publicKey[32], const uint8_t seed[32]);
+
+    /**
+     * Firma con una clave ya expandida
+     *
+     * @param key Clave expandida
+     * @param message Datos a firmar
+     * @param length Longitud
+     * @param signature Buffer de salida (64 bytes)
+     */
+    static void sign(
+        const Ed25519ExpandedKey& key,
+        const uint8_t* message,
+        size_t length,
+        uint8_t signature[64]
+    );
+
+    /**
+     * Verifica varias firmas juntas
+     *
+     * Comprueba sum(z_i (R_i + k_i A_i - S_i B)) == 0 con z_i aleatorios en
+     * una sola multiplicación multi-escalar (doblados compartidos entre todas
+     * las firmas). Si un lote falla se divide en mitades para encontrar las
+     * firmas inválidas. Usa la ecuación con cofactor (x8); A o R de orden
+     * pequeño se rechazan para no aceptar firmas que verify() rechaza.
+     *
+     * @param entries Firmas; en cada una se escribe valid
+     * @param count Número de firmas
+     * @return true si todas son válidas
+     */
+    static bool verifyBatch(Ed25519BatchEntry* entries, size_t count);
+};
+
+#endif // STELLAR_ED25519_H
@@ -0,0 +1,218 @@
+#include "stellar_http_pool.h"
+#include "stellar_utils.h"
+
+// ============================================
+// CONSTRUCTOR / DESTRUCTOR
+// ============================================
+
+StellarHttpPool::StellarHttpPool(StellarTlsSessionCache* sessions) : idleTimeout(STELLAR_HTTP_IDLE_TIMEOUT_MS) {
+    for (size_t i = 0; i < STELLAR_HTTP_POOL_SIZE; i++) {
+        connections[i].host[0] = '\0';
+        connections[i].lastUsed = 0;
+        connections[i].inUse = false;
+        connections[i].client.setSessionCache(sessions);
+    }
+
+    resetStats();
+}
+
+StellarHttpPool::~StellarHttpPool() {
+    for (size_t i = 0; i < STELLAR_HTTP_POOL_SIZE; i++) {
+        close(connections[i]);
+    }
+}
+
+// ============================================
+// HELPERS
+// ============================================
+
+bool StellarHttpPool::parseHost(const char* url, char* host, size_t capacity) {
+    if (!url) {
+        return false;
+    }
+
+    const char* start = strstr(url, "://");
+    start = start ? start + 3 : url;
+
+    // host[:port] hasta el path o la query
+    size_t length = strcspn(start, "/?#");
+
+    if (length == 0 || length >= capacity) {
+        return false;
+    }
+
+    memcpy(host, start, length);
+    host[length] = '\0';
+    return true;
+}
+
+bool StellarHttpPool::isAlive(Connection& connection) {
+    // Bytes sin pedir en una conexión ociosa: el servidor la está cerrando
+    // o quedó parte de una respuesta anterior
+    return connection.client.connected() && connection.client.available() == 0;
+}
+
+void StellarHttpPool::close(Connection& connection) {
+    connection.client.stop();
+    connection.host[0] = '\0';
+}
+
+// ============================================
+// ACQUIRE / RELEASE
+// ============================================
+
+HTTPClient* StellarHttpPool::acquire(const char* url, uint32_t timeoutMs, bool* reused) {
+    char host[STELLAR_HTTP_HOST_MAX + 1];
+
+    if (!parseHost(url, host, sizeof(host))) {
+        STELLAR_LOGE("HttpPool", "Invalid URL host");
+        return nullptr;
+    }
+
+    closeIdle();
+
+    Connection* connection = nullptr;
+    Connection* victim = nullptr;
+
+    for (size_t i = 0; i < STELLAR_HTTP_POOL_SIZE; i++) {
+        Connection& candidate = connections[i];
+
+        if (candidate.inUse) {
+            continue;
+        }
+
+        if (strcmp(candidate.host, host) == 0) {
+            connection = &candidate;
+            break;
+        }
+
+        // Slot libre primero; si no, el usado hace más tiempo
+        if (!victim ||
+            (victim->host[0] != '\0' &&
+             (candidate.host[0] == '\0' || (int32_t)(candidate.lastUsed - victim->lastUsed) < 0))) {
+            victim = &candidate;
+        }
+    }
+
+    bool warm = false;
+
+    if (connection) {
+        warm = isAlive(*connection);
+
+        if (!warm && connection->client.connected()) {
+            stats.dropped++;
+        }
+
+        if (!warm) {
+            connection->client.stop();
+            STELLAR_LOGD("HttpPool", "Connection to %s is dead, reconnecting", host);
+        }
+
+    } else if (victim) {
+        if (victim->host[0] != '\0') {
+            STELLAR_LOGD("HttpPool", "Evicting connection to %s", victim->host);
+            close(*victim);
+        }
+
+        connection = victim;
+        memcpy(connection->host, host, strlen(host) + 1);
+
+    } else {
+        STELLAR_LOGE("HttpPool", "All %u connections in use", (unsigned)STELLAR_HTTP_POOL_SIZE);
+        return nullptr;
+    }
+
+    connection->client.setIoTimeoutMs(timeoutMs);
+
+    if (!connection->http.begin(connection->client, url)) {
+        STELLAR_LOGE("HttpPool", "Invalid URL: %s", url);
+        close(*connection);
+        return nullptr;
+    }
+
+    connection->http.setReuse(true);
+    connection->http.setTimeout(timeoutMs);
+    connection->inUse = true;
+
+    stats.requests++;
+    if (warm) {
+        stats.reused++;
+    } else {
+        stats.opened++;
+    }
+
+    if (reused) {
+        *reused = warm;
+    }
+
+    STELLAR_LOGD("HttpPool", "%s connection to %s", warm ? "Reusing" : "Opening", host);
+
+    return &connection->http;
+}
+
+void StellarHttpPool::release(HTTPClient* http, bool keep) {
+    for (size_t i = 0; i < STELLAR_HTTP_POOL_SIZE; i++) {
+        Connection& connection = connections[i];
+
+        if (&connection.http != http) {
+            continue;
+        }
+
+        // end() deja el socket abierto si la respuesta permite keep-alive
+        connection.http.end();
+
+        if (!keep) {
+            connection.client.stop();
+        }
+
+        connection.lastUsed = millis();
+        connection.inUse = false;
+        return;
+    }
+}
+
+// ============================================
+// MANTENIMIENTO
+// ============================================
+
+void StellarHttpPool::closeIdle() {
+    uint32_t now = millis();
+
+    for (size_t i = 0; i < STELLAR_HTTP_POOL_SIZE; i++) {
+        Connection& connection = connections[i];
+
+        if (connection.inUse || connection.host[0] == '\0') {
+            continue;
+        }
+
+        if (now - connection.lastUsed >= idleTimeout) {
+            STELLAR_LOGD("HttpPool", "Closing idle connection to %s", connection.host);
+            close(connection);
+            stats.expired++;
+        }
+    }
+}
+
+void StellarHttpPool::closeAll() {
+    for (size_t i = 0; i < STELLAR_HTTP_POOL_SIZE; i++) {
+        if (!connections[i].inUse) {
+            close(connections[i]);
+        }
+    }
+}
+
+size_t StellarHttpPool::openCount() {
+    size_t open = 0;
+
+    for (size_t i = 0; i < STELLAR_HTTP_POOL_SIZE; i++) {
+        if (connections[i].host[0] != '\0' && connections[i].client.connected()) {
+            open++;
+        }
+    }
+
+    return open;
+}
+
+void StellarHttpPool::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,118 @@
+#ifndef STELLAR_HTTP_POOL_H
+#define STELLAR_HTTP_POOL_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include "stellar_tls.h"
+
+/**
+ * Pool de conexiones HTTPS keep-alive por host
+ *
+ * Cada conexión (HTTPClient + StellarTlsClient) queda abierta tras la
+ * respuesta y la siguiente petición al mismo host la reutiliza: sin TCP
+ * connect ni handshake TLS, la latencia pasa a ser la del RTT. Al reconectar
+ * (timeout, caída de WiFi) se reanuda la sesión TLS del host si hay caché.
+ *
+ * - Una conexión por host (Horizon, Friendbot); si no hay slot libre se
+ *   cierra la usada hace más tiempo
+ * - Se cierran tras STELLAR_HTTP_IDLE_TIMEOUT_MS sin uso (cada sesión TLS
+ *   retiene ~40 KB de heap)
+ * - Antes de reutilizar se comprueba que el socket sigue vivo y sin bytes
+ *   pendientes (el servidor cerró o la respuesta anterior no se consumió)
+ *
+ * La respuesta debe leerse completa (getString() o HttpBodyStream::drain())
+ * antes de release().
+ * No es reentrante: usar desde una sola tarea (con el worker de
+ * StellarNetwork, la suya).
+ */
+
+#ifndef STELLAR_HTTP_POOL_SIZE
+#define STELLAR_HTTP_POOL_SIZE 2
+#endif
+
+#ifndef STELLAR_HTTP_IDLE_TIMEOUT_MS
+#define STELLAR_HTTP_IDLE_TIMEOUT_MS 20000
+#endif
+
+#define STELLAR_HTTP_HOST_MAX 64
+
+struct HttpPoolStats {
+    uint32_t requests;      // acquire() con éxito
+    uint32_t reused;        // ...sobre una conexión abierta
+    uint32_t opened;        // ...que abren conexión nueva
+    uint32_t dropped;       // Conexiones muertas al ir a reutilizarlas
+    uint32_t expired;       // Cerradas por inactividad
+};
+
+class StellarHttpPool {
+public:
+    /**
+     * @param sessions Caché de sesiones TLS compartida (nullptr = sin reanudación)
+     */
+    explicit StellarHttpPool(StellarTlsSessionCache* sessions = nullptr);
+    ~StellarHttpPool();
+
+    /**
+     * Conexión para una URL (la del mismo host si sigue abierta)
+     *
+     * @param url URL completa (https://host/path)
+     * @param timeoutMs Timeout de la petición
+     * @param reused Salida opcional: true si la conexión ya estaba abierta
+     * @return HTTPClient listo para addHeader() + GET()/sendRequest(),
+     *         o nullptr si la URL no es válida o todas están en uso
+     */
+    HTTPClient* acquire(const char* url, uint32_t timeoutMs, bool* reused);
+
+    /**
+     * Devuelve la conexión al pool
+     *
+     * @param http Conexión de acquire()
+     * @param keep false para cerrarla (error de transporte)
+     */
+    void release(HTTPClient* http, bool keep);
+
+    /**
+     * Cierra las conexiones sin uso desde hace más del idle timeout
+     * Barato: llamar desde loop() para liberar el heap de TLS
+     */
+    void closeIdle();
+
+    /**
+     * Cierra todas las conexiones libres
+     */
+    void closeAll();
+
+    void setIdleTimeout(uint32_t ms) { idleTimeout = ms; }
+    uint32_t getIdleTimeout() const { return idleTimeout; }
+
+    /**
+     * Conexiones abiertas ahora mismo
+     */
+    size_t openCount();
+
+    const HttpPoolStats& getStats() const { return stats; }
+    void resetStats();
+
+private:
+    struct Connection {
+        char host[STELLAR_HTTP_HOST_MAX + 1];   // "" = slot libre
+        HTTPClient http;
+        StellarTlsClient client;
+        uint32_t lastUsed;
+        bool inUse;
+    };
+
+    Connection connections[STELLAR_HTTP_POOL_SIZE];
+    uint32_t idleTimeout;
+    HttpPoolStats stats;
+
+    static bool parseHost(const char* url, char* host, size_t capacity);
+    static bool isAlive(Connection& connection);
+    static void close(Connection& connection);
+
+    // Contiene sockets: no copiable
+    StellarHttpPool(const StellarHttpPool&) = delete;
+    StellarHttpPool& operator=(const StellarHttpPool&) = delete;
+};
+
+#endif // STELLAR_HTTP_POOL_H
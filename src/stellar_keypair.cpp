@@ -1,52 +1,75 @@
 #include "stellar_keypair.h"
+#include "stellar_bip39.h"
+#include "stellar_strkey.h"
 #include "stellar_utils.h"
 
-// Alfabeto Base32 de Stellar (RFC 4648)
-static const char STELLAR_BASE32_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+// Nodo m/44'/148' en caché y huella de la frase que lo generó
+static uint8_t accountNode[HD_ACCOUNT_NODE_SIZE];
+static uint8_t accountNodeFingerprint[32];
+static bool accountNodeCached = false;
+static bool accountNodeHasFingerprint = false;
 
-// Tabla inversa para decodificación
-static int base32Index(char c) {
-    if (c >= 'A' && c <= 'Z') return c - 'A';
-    if (c >= '2' && c <= '7') return c - '2' + 26;
-    return -1;
-}
-
-// Wordlist BIP39 simplificada (primeras 128 palabras para demo)
-// En producción usar la lista completa de 2048 palabras
-static const char* BIP39_WORDLIST[] = {
-    "abandon", "ability", "able", "about", "above", "absent", "absorb", "abstract",
-    "absurd", "abuse", "access", "accident", "account", "accuse", "achieve", "acid",
-    "acoustic", "acquire", "across", "act", "action", "actor", "actress", "actual",
-    "adapt", "add", "addict", "address", "adjust", "admit", "adult", "advance",
-    "advice", "aerobic", "affair", "afford", "afraid", "again", "age", "agent",
-    "agree", "ahead", "aim", "air", "airport", "aisle", "alarm", "album",
-    "alcohol", "alert", "alien", "all", "alley", "allow", "almost", "alone",
-    "alpha", "already", "also", "alter", "always", "amateur", "amazing", "among",
-    "amount", "amused", "analyst", "anchor", "ancient", "anger", "angle", "angry",
-    "animal", "ankle", "announce", "annual", "another", "answer", "antenna", "antique",
-    "anxiety", "any", "apart", "apology", "appear", "apple", "approve", "april",
-    "arch", "arctic", "area", "arena", "argue", "arm", "armed", "armor",
-    "army", "around", "arrange", "arrest", "arrive", "arrow", "art", "artefact",
-    "artist", "artwork", "ask", "aspect", "assault", "asset", "assist", "assume",
-    "asthma", "athlete", "atom", "attack", "attend", "attitude", "attract", "auction",
-    "audit", "august", "aunt", "author", "auto", "autumn", "average", "avocado"
-};
-
-static const int BIP39_WORDLIST_SIZE = 128;
+static const uint32_t HD_HARDENED = 0x80000000;
 
 // ============================================
 // CONSTRUCTOR / DESTRUCTOR
 // ============================================
 
-StellarKeypair::StellarKeypair() : hasMnemonic(false) {
+StellarKeypair::StellarKeypair()
+    : hasMnemonic(false), accountIndex(-1), publicKeyEncoded(false), secretKeyEncoded(false) {
     memset(publicKey, 0, 32);
     memset(secretKey, 0, 32);
+    memset(publicKeyStr, 0, sizeof(publicKeyStr));
+    memset(secretKeyStr, 0, sizeof(secretKeyStr));
 }
 
 StellarKeypair::~StellarKeypair() {
     // Limpiar memoria sensible de forma segura
+    wipe();
+}
+
+StellarKeypair::StellarKeypair(StellarKeypair&& other)
+    : hasMnemonic(false), accountIndex(-1), publicKeyEncoded(false), secretKeyEncoded(false) {
+    memset(publicKeyStr, 0, sizeof(publicKeyStr));
+    memset(secretKeyStr, 0, sizeof(secretKeyStr));
+    *this = static_cast<StellarKeypair&&>(other);
+}
+
+StellarKeypair& StellarKeypair::operator=(StellarKeypair&& other) {
+    if (this == &other) {
+        return *this;
+    }
+    
+    wipe();
+    
+    memcpy(publicKey, other.publicKey, 32);
+    memcpy(secretKey, other.secretKey, 32);
+    memcpy(publicKeyStr, other.publicKeyStr, sizeof(publicKeyStr));
+    memcpy(secretKeyStr, other.secretKeyStr, sizeof(secretKeyStr));
+    publicKeyEncoded = other.publicKeyEncoded;
+    secretKeyEncoded = other.secretKeyEncoded;
+    mnemonicPhrase = other.mnemonicPhrase;
+    hasMnemonic = other.hasMnemonic;
+    accountIndex = other.accountIndex;
+    
+    // El origen queda vacío: una sola copia de la clave en RAM
+    other.wipe();
+    
+    return *this;
+}
+
+void StellarKeypair::wipe() {
     StellarUtils::secureZero(secretKey, 32);
+    StellarUtils::secureZero(secretKeyStr, sizeof(secretKeyStr));
+    StellarUtils::secureZero((char*)mnemonicPhrase.c_str(), mnemonicPhrase.length());
+    memset(publicKey, 0, 32);
+    memset(publicKeyStr, 0, sizeof(publicKeyStr));
+    
     mnemonicPhrase = "";
+    hasMnemonic = false;
+    accountIndex = -1;
+    publicKeyEncoded = false;
+    secretKeyEncoded = false;
 }
 
 // ============================================
@@ -54,295 +77,353 @@ StellarKeypair::~StellarKeypair() {
 // ============================================
 
 StellarKeypair* StellarKeypair::generate() {
-    StellarUtils::infoPrint("Keypair", "Generating new keypair");
-    
     StellarKeypair* kp = new StellarKeypair();
     
-    // Generar keypair Ed25519
-    if (!StellarCrypto::generateKeypair(kp->publicKey, kp->secretKey)) {
+    if (!generate(*kp)) {
         delete kp;
         return nullptr;
     }
     
-    // Generar mnemonic para backup
-    kp->generateMnemonic();
-    kp->hasMnemonic = true;
-    
-    StellarUtils::infoPrint("Keypair", "Keypair generated successfully");
-    StellarUtils::debugPrint("Keypair", ("Public: " + kp->getPublicKey()).c_str());
-    
     return kp;
 }
 
-StellarKeypair* StellarKeypair::fromSecret(const char* secretKey) {
-    StellarUtils::infoPrint("Keypair", "Importing from secret key");
+bool StellarKeypair::generate(StellarKeypair& keypair) {
+    STELLAR_LOGI("Keypair", "Generating new keypair");
     
-    if (!StellarUtils::isValidAddress(secretKey)) {
-        StellarUtils::errorPrint("Keypair", "Invalid secret key format");
-        return nullptr;
-    }
+    // Seed aleatoria directa: sin PBKDF2 ni tocar el nodo HD en caché
+    keypair.wipe();
     
-    if (secretKey[0] != 'S') {
-        StellarUtils::errorPrint("Keypair", "Secret key must start with 'S'");
-        return nullptr;
+    if (!StellarCrypto::generateKeypair(keypair.publicKey, keypair.secretKey)) {
+        STELLAR_LOGE("Keypair", "Failed to generate keypair");
+        keypair.wipe();
+        return false;
     }
     
-    StellarKeypair* kp = new StellarKeypair();
+    STELLAR_LOGI("Keypair", "Keypair generated successfully");
+    STELLAR_LOGD("Keypair", "Public: %s", keypair.getPublicKeyCStr());
     
-    // Decodificar secret key
-    if (!kp->decodeSecretKey(secretKey, kp->secretKey)) {
-        StellarUtils::errorPrint("Keypair", "Failed to decode secret key");
-        delete kp;
-        return nullptr;
-    }
+    return true;
+}
+
+StellarKeypair* StellarKeypair::generateWithMnemonic() {
+    StellarKeypair* kp = new StellarKeypair();
     
-    // Derivar public key
-    if (!StellarCrypto::derivePublicKey(kp->publicKey, kp->secretKey)) {
-        StellarUtils::errorPrint("Keypair", "Failed to derive public key");
+    if (!generateWithMnemonic(*kp)) {
         delete kp;
         return nullptr;
     }
     
-    StellarUtils::infoPrint("Keypair", "Keypair imported successfully");
-    StellarUtils::debugPrint("Keypair", ("Public: " + kp->getPublicKey()).c_str());
-    
     return kp;
 }
 
-StellarKeypair* StellarKeypair::fromMnemonic(const char* words) {
-    StellarUtils::infoPrint("Keypair", "Importing from mnemonic");
+bool StellarKeypair::generateWithMnemonic(StellarKeypair& keypair) {
+    STELLAR_LOGI("Keypair", "Generating new HD wallet");
     
-    if (!words || strlen(words) == 0) {
-        StellarUtils::errorPrint("Keypair", "Empty mnemonic");
-        return nullptr;
+    // La clave sale del mnemonic: la frase es un backup real
+    String words = StellarBIP39::generate(12);
+    if (words.length() == 0) {
+        return false;
     }
     
-    StellarKeypair* kp = new StellarKeypair();
+    bool success = fromMnemonic(words.c_str(), 0, nullptr, keypair);
+    StellarUtils::secureZero((char*)words.c_str(), words.length());
     
-    // Convertir mnemonic a seed
-    if (!kp->mnemonicToSeed(words, kp->secretKey)) {
-        StellarUtils::errorPrint("Keypair", "Failed to derive seed from mnemonic");
-        delete kp;
-        return nullptr;
+    if (!success) {
+        return false;
     }
     
-    // Derivar public key
-    if (!StellarCrypto::derivePublicKey(kp->publicKey, kp->secretKey)) {
-        StellarUtils::errorPrint("Keypair", "Failed to derive public key");
+    STELLAR_LOGI("Keypair", "HD wallet generated successfully");
+    STELLAR_LOGD("Keypair", "Public: %s", keypair.getPublicKeyCStr());
+    
+    return true;
+}
+
+StellarKeypair* StellarKeypair::fromSecret(const char* secretKey) {
+    StellarKeypair* kp = new StellarKeypair();
+    
+    if (!fromSecret(secretKey, *kp)) {
         delete kp;
         return nullptr;
     }
     
-    kp->mnemonicPhrase = String(words);
-    kp->hasMnemonic = true;
-    
-    StellarUtils::infoPrint("Keypair", "Keypair imported from mnemonic");
-    StellarUtils::debugPrint("Keypair", ("Public: " + kp->getPublicKey()).c_str());
-    
     return kp;
 }
 
-// ============================================
-// EXPORTACIÓN
-// ============================================
-
-String StellarKeypair::getPublicKey() const {
-    return encodePublicKey(publicKey);
-}
-
-String StellarKeypair::getSecretKey() const {
-    return encodeSecretKey(secretKey);
-}
-
-String StellarKeypair::getMnemonic() const {
-    return hasMnemonic ? mnemonicPhrase : "";
-}
-
-// ============================================
-// FIRMA
-// ============================================
-
-bool StellarKeypair::sign(const uint8_t* data, size_t length, uint8_t signature[64]) const {
-    return StellarCrypto::sign(secretKey, publicKey, data, length, signature);
-}
-
-bool StellarKeypair::verify(const uint8_t* data, size_t length, const uint8_t signature[64]) const {
-    return StellarCrypto::verify(publicKey, data, length, signature);
-}
-
-// ============================================
-// BASE32 ENCODING (Formato Stellar)
-// ============================================
-
-String StellarKeypair::encodePublicKey(const uint8_t* key) const {
-    // Version byte para public key: 6 << 3 = 0x30
-    return base32EncodeWithChecksum(0x30, key, 32);
-}
-
-String StellarKeypair::encodeSecretKey(const uint8_t* seed) const {
-    // Version byte para secret key: 18 << 3 = 0x90
-    return base32EncodeWithChecksum(0x90, seed, 32);
-}
-
-bool StellarKeypair::decodeSecretKey(const char* encoded, uint8_t* seed) const {
-    uint8_t version;
-    size_t length;
+bool StellarKeypair::fromSecret(const char* secretKey, StellarKeypair& keypair) {
+    STELLAR_LOGI("Keypair", "Importing from secret key");
     
-    if (!base32DecodeWithChecksum(encoded, &version, seed, &length)) {
+    if (!secretKey || secretKey[0] != 'S') {
+        STELLAR_LOGE("Keypair", "Secret key must start with 'S'");
         return false;
     }
     
-    // Verificar que sea secret key (version 0x90) y longitud correcta
-    return (version == 0x90 && length == 32);
-}
-
-String StellarKeypair::base32EncodeWithChecksum(uint8_t version, const uint8_t* data, size_t length) const {
-    // Construir payload: version byte + data
-    uint8_t payload[33];
-    payload[0] = version;
-    memcpy(payload + 1, data, length);
+    // Decodificar secret key (formato, version byte y checksum)
+    uint8_t seed[32];
+    if (!StellarStrKey::decode(secretKey, STRKEY_SEED, seed)) {
+        STELLAR_LOGE("Keypair", "Invalid secret key format or checksum");
+        return false;
+    }
     
-    // Calcular checksum CRC16-XModem
-    uint16_t checksum = StellarUtils::crc16XModem(payload, 33);
+    bool success = fromRawSecret(seed, keypair);
+    StellarUtils::secureZero(seed, sizeof(seed));
     
-    // Construir buffer completo: payload + checksum (little-endian)
-    uint8_t fullPayload[35];
-    memcpy(fullPayload, payload, 33);
-    fullPayload[33] = checksum & 0xFF;          // Low byte primero
-    fullPayload[34] = (checksum >> 8) & 0xFF;   // High byte segundo
+    if (success) {
+        STELLAR_LOGI("Keypair", "Keypair imported successfully");
+        STELLAR_LOGD("Keypair", "Public: %s", keypair.getPublicKeyCStr());
+    }
     
-    // Encodear en base32
-    String encoded = "";
-    encoded.reserve(56);  // Pre-allocate para 56 caracteres
+    return success;
+}
+
+bool StellarKeypair::fromRawSecret(const uint8_t secretKey[32], StellarKeypair& keypair) {
+    // secretKey puede apuntar al propio keypair
+    uint8_t seed[32];
+    memcpy(seed, secretKey, 32);
     
-    uint32_t buffer = 0;
-    int bitsLeft = 0;
+    keypair.wipe();
+    memcpy(keypair.secretKey, seed, 32);
+    StellarUtils::secureZero(seed, sizeof(seed));
     
-    for (int i = 0; i < 35; i++) {
-        buffer = (buffer << 8) | fullPayload[i];
-        bitsLeft += 8;
-        
-        while (bitsLeft >= 5) {
-            int index = (buffer >> (bitsLeft - 5)) & 0x1F;
-            encoded += STELLAR_BASE32_ALPHABET[index];
-            bitsLeft -= 5;
-        }
+    // Derivar public key
+    if (!StellarCrypto::derivePublicKey(keypair.publicKey, keypair.secretKey)) {
+        STELLAR_LOGE("Keypair", "Failed to derive public key");
+        keypair.wipe();
+        return false;
     }
     
-    // Manejar bits restantes
-    if (bitsLeft > 0) {
-        int index = (buffer << (5 - bitsLeft)) & 0x1F;
-        encoded += STELLAR_BASE32_ALPHABET[index];
+    return true;
+}
+
+StellarKeypair* StellarKeypair::fromMnemonic(const char* words, uint32_t account, const char* passphrase) {
+    StellarKeypair* kp = new StellarKeypair();
+    
+    if (!fromMnemonic(words, account, passphrase, *kp)) {
+        delete kp;
+        return nullptr;
     }
     
-    return encoded;
+    return kp;
 }
 
-bool StellarKeypair::base32DecodeWithChecksum(const char* encoded, uint8_t* version, uint8_t* data, size_t* length) const {
-    if (strlen(encoded) != 56) {
+bool StellarKeypair::fromMnemonic(
+    const char* words,
+    uint32_t account,
+    const char* passphrase,
+    StellarKeypair& keypair
+) {
+    STELLAR_LOGI("Keypair", "Importing from mnemonic");
+    
+    if (!words || strlen(words) == 0) {
+        STELLAR_LOGE("Keypair", "Empty mnemonic");
         return false;
     }
     
-    // Decodear base32
-    uint8_t decoded[35];
-    int decodedIdx = 0;
-    uint32_t buffer = 0;
-    int bitsLeft = 0;
+    if (!passphrase) {
+        passphrase = "";
+    }
     
-    for (size_t i = 0; i < 56; i++) {
-        int idx = base32Index(encoded[i]);
-        if (idx < 0) return false;
-        
-        buffer = (buffer << 5) | idx;
-        bitsLeft += 5;
+    String normalized;
+    if (!StellarBIP39::validate(words, &normalized)) {
+        STELLAR_LOGE("Keypair", "Invalid mnemonic (unknown word, word count or checksum)");
+        return false;
+    }
+    
+    // Huella de frase + passphrase: si coincide con la del nodo en caché
+    // se evitan las 2048 rondas de la seed
+    uint8_t fingerprint[32];
+    static const uint8_t separator = 0;
+    SHA256 sha;
+    sha.reset();
+    sha.update(normalized.c_str(), normalized.length());
+    sha.update(&separator, 1);
+    sha.update(passphrase, strlen(passphrase));
+    sha.finalize(fingerprint, 32);
+    
+    bool cached = accountNodeCached && accountNodeHasFingerprint &&
+                  memcmp(fingerprint, accountNodeFingerprint, 32) == 0;
+    
+    if (!cached) {
+        STELLAR_LOGD("Keypair", "Deriving BIP39 seed (%u rounds)", (unsigned)BIP39_PBKDF2_ROUNDS);
         
-        if (bitsLeft >= 8) {
-            decoded[decodedIdx++] = (buffer >> (bitsLeft - 8)) & 0xFF;
-            bitsLeft -= 8;
+        uint8_t seed[BIP39_SEED_SIZE];
+        if (!StellarBIP39::toSeed(normalized.c_str(), passphrase, seed)) {
+            StellarUtils::secureZero(fingerprint, sizeof(fingerprint));
+            StellarUtils::secureZero((char*)normalized.c_str(), normalized.length());
+            return false;
         }
+        
+        // Master (SLIP-0010): HMAC-SHA512("ed25519 seed", seed)
+        uint8_t node[HD_ACCOUNT_NODE_SIZE];
+        StellarCrypto::hmacSHA512((const uint8_t*)"ed25519 seed", 12, seed, sizeof(seed), node);
+        StellarUtils::secureZero(seed, sizeof(seed));
+        
+        // m/44'/148'
+        deriveChild(node, SEP0005_PURPOSE, node);
+        deriveChild(node, SEP0005_COIN_TYPE, node);
+        
+        setAccountNode(node);
+        StellarUtils::secureZero(node, sizeof(node));
+        
+        memcpy(accountNodeFingerprint, fingerprint, 32);
+        accountNodeHasFingerprint = true;
+    } else {
+        STELLAR_LOGD("Keypair", "Using cached account node");
     }
     
-    if (decodedIdx != 35) {
-        return false;
-    }
+    StellarUtils::secureZero(fingerprint, sizeof(fingerprint));
     
-    // Verificar checksum (little-endian)
-    uint16_t expectedChecksum = StellarUtils::crc16XModem(decoded, 33);
-    uint16_t actualChecksum = decoded[33] | (decoded[34] << 8);
+    bool success = deriveAccount(account, keypair);
     
-    if (expectedChecksum != actualChecksum) {
-        StellarUtils::errorPrint("Keypair", "Checksum verification failed");
-        return false;
+    if (success) {
+        keypair.mnemonicPhrase = normalized;
+        keypair.hasMnemonic = true;
+        
+        STELLAR_LOGI("Keypair", "Keypair imported from mnemonic (account %u)", (unsigned)account);
+        STELLAR_LOGD("Keypair", "Public: %s", keypair.getPublicKeyCStr());
     }
     
-    // Extraer version y data
-    *version = decoded[0];
-    memcpy(data, decoded + 1, 32);
-    *length = 32;
+    StellarUtils::secureZero((char*)normalized.c_str(), normalized.length());
     
-    return true;
+    return success;
 }
 
 // ============================================
-// MNEMONIC BIP39 (Simplificado)
+// DERIVACIÓN HD (SEP-0005)
 // ============================================
 
-void StellarKeypair::generateMnemonic() {
-    StellarUtils::debugPrint("Keypair", "Generating mnemonic phrase");
+void StellarKeypair::deriveChild(
+    const uint8_t parent[HD_ACCOUNT_NODE_SIZE],
+    uint32_t index,
+    uint8_t child[HD_ACCOUNT_NODE_SIZE]
+) {
+    // I = HMAC-SHA512(chain code, 0x00 || clave || ser32(index + 2^31))
+    uint8_t data[37];
+    uint32_t hardened = index | HD_HARDENED;
+    
+    data[0] = 0x00;
+    memcpy(data + 1, parent, 32);
+    data[33] = (uint8_t)(hardened >> 24);
+    data[34] = (uint8_t)(hardened >> 16);
+    data[35] = (uint8_t)(hardened >> 8);
+    data[36] = (uint8_t)hardened;
+    
+    // child puede ser parent: la chain code se copia antes de escribir
+    uint8_t chainCode[32];
+    memcpy(chainCode, parent + 32, 32);
+    
+    StellarCrypto::hmacSHA512(chainCode, sizeof(chainCode), data, sizeof(data), child);
+    
+    StellarUtils::secureZero(data, sizeof(data));
+    StellarUtils::secureZero(chainCode, sizeof(chainCode));
+}
+
+StellarKeypair* StellarKeypair::deriveAccount(uint32_t account) {
+    StellarKeypair* kp = new StellarKeypair();
+    
+    if (!deriveAccount(account, *kp)) {
+        delete kp;
+        return nullptr;
+    }
     
-    // Generar 128 bits de entropía (12 palabras)
-    uint8_t entropy[16];
-    StellarCrypto::randomBytes(entropy, 16);
+    return kp;
+}
+
+bool StellarKeypair::deriveAccount(uint32_t account, StellarKeypair& keypair) {
+    if (!accountNodeCached) {
+        STELLAR_LOGE("Keypair", "No account node cached (import a mnemonic or load it from flash)");
+        return false;
+    }
     
-    // Calcular checksum (primeros 4 bits del SHA256)
-    uint8_t hash[32];
-    StellarCrypto::sha256(entropy, 16, hash);
-    uint8_t checksum = hash[0] >> 4;  // 4 bits
+    if (account > HD_MAX_ACCOUNT_INDEX) {
+        STELLAR_LOGE("Keypair", "Account index out of range");
+        return false;
+    }
     
-    // Combinar entropy + checksum = 132 bits = 12 palabras (11 bits cada una)
-    mnemonicPhrase = "";
+    // m/44'/148'/account': la clave del hijo es la seed Ed25519
+    uint8_t child[HD_ACCOUNT_NODE_SIZE];
+    deriveChild(accountNode, account, child);
     
-    uint32_t buffer = 0;
-    int bitsLeft = 0;
-    int wordCount = 0;
+    bool success = fromRawSecret(child, keypair);
+    StellarUtils::secureZero(child, sizeof(child));
     
-    // Procesar 16 bytes de entropía
-    for (int i = 0; i < 16; i++) {
-        buffer = (buffer << 8) | entropy[i];
-        bitsLeft += 8;
-        
-        while (bitsLeft >= 11 && wordCount < 11) {
-            int index = (buffer >> (bitsLeft - 11)) & 0x7FF;  // 11 bits
-            
-            if (wordCount > 0) mnemonicPhrase += " ";
-            
-            // Usar módulo del tamaño de la wordlist
-            mnemonicPhrase += BIP39_WORDLIST[index % BIP39_WORDLIST_SIZE];
-            
-            bitsLeft -= 11;
-            wordCount++;
-        }
+    if (success) {
+        keypair.accountIndex = (int32_t)account;
     }
     
-    // Última palabra con checksum
-    if (wordCount < 12) {
-        buffer = (buffer << 4) | checksum;
-        bitsLeft += 4;
-        
-        int index = (buffer >> (bitsLeft - 11)) & 0x7FF;
-        mnemonicPhrase += " ";
-        mnemonicPhrase += BIP39_WORDLIST[index % BIP39_WORDLIST_SIZE];
+    return success;
+}
+
+bool StellarKeypair::hasAccountNode() {
+    return accountNodeCached;
+}
+
+bool StellarKeypair::getAccountNode(uint8_t node[HD_ACCOUNT_NODE_SIZE]) {
+    if (!accountNodeCached) {
+        return false;
     }
     
-    StellarUtils::debugPrint("Keypair", "Mnemonic generated");
+    memcpy(node, accountNode, HD_ACCOUNT_NODE_SIZE);
+    return true;
 }
 
-bool StellarKeypair::mnemonicToSeed(const char* words, uint8_t seed[32]) {
-    // Implementación simplificada:
-    // En producción usar PBKDF2(mnemonic, "mnemonic" + passphrase, 2048, HMAC-SHA512)
-    // Para MVP: usar SHA256 directo del mnemonic
+void StellarKeypair::setAccountNode(const uint8_t node[HD_ACCOUNT_NODE_SIZE]) {
+    memcpy(accountNode, node, HD_ACCOUNT_NODE_SIZE);
+    accountNodeCached = true;
     
-    StellarCrypto::sha256((const uint8_t*)words, strlen(words), seed);
+    // Frase desconocida: el próximo fromMnemonic() recalcula la seed
+    StellarUtils::secureZero(accountNodeFingerprint, sizeof(accountNodeFingerprint));
+    accountNodeHasFingerprint = false;
+}
+
+void StellarKeypair::clearAccountNode() {
+    StellarUtils::secureZero(accountNode, sizeof(accountNode));
+    StellarUtils::secureZero(accountNodeFingerprint, sizeof(accountNodeFingerprint));
+    accountNodeCached = false;
+    accountNodeHasFingerprint = false;
+}
+
+// ============================================
+// EXPORTACIÓN
+// ============================================
+
+String StellarKeypair::getPublicKey() const {
+    return String(getPublicKeyCStr());
+}
+
+const char* StellarKeypair::getPublicKeyCStr() const {
+    if (!publicKeyEncoded) {
+        StellarStrKey::encode(STRKEY_ACCOUNT_ID, publicKey, publicKeyStr);
+        publicKeyEncoded = true;
+    }
     
-    return true;
-}
\ No newline at end of file
+    return publicKeyStr;
+}
+
+String StellarKeypair::getSecretKey() const {
+    return String(getSecretKeyCStr());
+}
+
+const char* StellarKeypair::getSecretKeyCStr() const {
+    if (!secretKeyEncoded) {
+        StellarStrKey::encode(STRKEY_SEED, secretKey, secretKeyStr);
+        secretKeyEncoded = true;
+    }
+    
+    return secretKeyStr;
+}
+
+String StellarKeypair::getMnemonic() const {
+    return hasMnemonic ? mnemonicPhrase : "";
+}
+
+// ============================================
+// FIRMA
+// ============================================
+
+bool StellarKeypair::sign(const uint8_t* data, size_t length, uint8_t signature[64]) const {
+    return StellarCrypto::sign(secretKey, publicKey, data, length, signature);
+}
+
+bool StellarKeypair::verify(const uint8_t* data, size_t length, const uint8_t signature[64]) const {
+    return StellarCrypto::verify(publicKey, data, length, signature);
+}
@@ -3,33 +3,77 @@
 
 #include <Arduino.h>
 #include "stellar_crypto.h"
+#include "stellar_strkey.h"
 
 /**
  * Gestión de keypairs de Stellar
  * 
  * Maneja:
  * - Generación de keypairs Ed25519
- * - Conversión a formato Stellar (base32 con checksum)
+ * - Conversión a formato Stellar (StrKey, ver StellarStrKey)
  * - Importación desde secret key o mnemonic
+ * - Derivación HD de varias cuentas (SEP-0005)
  * - Firma de transacciones
+ * 
+ * SEP-0005: mnemonic BIP39 -> seed -> SLIP-0010 m/44'/148'/n'
+ * La seed cuesta 2048 rondas de PBKDF2-HMAC-SHA512; el nodo m/44'/148'
+ * se cachea en memoria (y cifrado en flash, ver SecureWallet) y cada
+ * cuenta n sale de él con un solo HMAC-SHA512.
+ * 
+ * Las direcciones G... y S... se codifican una vez y se guardan en el
+ * keypair (la S... solo si se pide; se borra al destruirlo). No es
+ * copiable: se mueve (el origen queda vacío) o se crea en su sitio con
+ * las variantes que reciben un StellarKeypair&.
  */
 
+#define SEP0005_PURPOSE 44
+#define SEP0005_COIN_TYPE 148
+#define HD_ACCOUNT_NODE_SIZE 64         // Clave (32) || chain code (32)
+#define HD_MAX_ACCOUNT_INDEX 0x7FFFFFFF // Índices hardened
+
 class StellarKeypair {
 public:
     StellarKeypair();
     ~StellarKeypair();
     
+    // Las claves no se duplican por accidente: solo se mueven
+    StellarKeypair(StellarKeypair&& other);
+    StellarKeypair& operator=(StellarKeypair&& other);
+    StellarKeypair(const StellarKeypair&) = delete;
+    StellarKeypair& operator=(const StellarKeypair&) = delete;
+    
     // ============================================
     // CREACIÓN E IMPORTACIÓN
     // ============================================
     
     /**
-     * Genera un nuevo keypair aleatorio
+     * Genera un nuevo keypair aleatorio (sin mnemonic)
+     * Rápido: para claves de sesión o aprovisionamiento en lote
      * 
      * @return Nuevo keypair
      */
     static StellarKeypair* generate();
     
+    /**
+     * Igual que generate() sobre un keypair existente (sin new/delete)
+     * 
+     * @param keypair Destino (se reemplaza su contenido)
+     * @return true si éxito
+     */
+    static bool generate(StellarKeypair& keypair);
+    
+    /**
+     * Genera una wallet HD: mnemonic de 12 palabras + cuenta 0 de SEP-0005
+     * La frase de backup restaura exactamente este keypair.
+     * 
+     * Paga las 2048 rondas de la seed BIP39 y reemplaza el nodo
+     * m/44'/148' en caché por el de la nueva frase.
+     * 
+     * @return Nuevo keypair
+     */
+    static StellarKeypair* generateWithMnemonic();
+    static bool generateWithMnemonic(StellarKeypair& keypair);
+    
     /**
      * Importa desde secret key en formato Stellar (S...)
      * 
@@ -37,14 +81,70 @@ public:
      * @return Keypair o nullptr si inválido
      */
     static StellarKeypair* fromSecret(const char* secretKey);
+    static bool fromSecret(const char* secretKey, StellarKeypair& keypair);
     
     /**
-     * Importa desde mnemonic BIP39
+     * Importa desde secret key en bytes
+     * 
+     * @param secretKey Seed Ed25519 (32 bytes)
+     * @param keypair Destino (se reemplaza su contenido)
+     * @return true si éxito
+     */
+    static bool fromRawSecret(const uint8_t secretKey[32], StellarKeypair& keypair);
+    
+    /**
+     * Importa desde mnemonic BIP39 (SEP-0005, cuenta m/44'/148'/account')
+     * 
+     * Deja cacheado el nodo m/44'/148': si la frase y la passphrase son
+     * las del nodo en caché no se repiten las 2048 rondas de la seed.
      * 
-     * @param words Frase mnemónica (12 palabras separadas por espacios)
+     * @param words Frase mnemónica (12-24 palabras)
+     * @param account Índice de cuenta
+     * @param passphrase Passphrase BIP39 opcional
      * @return Keypair o nullptr si inválido
      */
-    static StellarKeypair* fromMnemonic(const char* words);
+    static StellarKeypair* fromMnemonic(const char* words, uint32_t account = 0, const char* passphrase = nullptr);
+    static bool fromMnemonic(const char* words, uint32_t account, const char* passphrase, StellarKeypair& keypair);
+    
+    // ============================================
+    // DERIVACIÓN HD (SEP-0005)
+    // ============================================
+    
+    /**
+     * Deriva la cuenta m/44'/148'/account' desde el nodo en caché
+     * Un HMAC-SHA512 + la public key Ed25519
+     * 
+     * @param account Índice de cuenta (0 - HD_MAX_ACCOUNT_INDEX)
+     * @return Keypair o nullptr si no hay nodo en caché
+     */
+    static StellarKeypair* deriveAccount(uint32_t account);
+    static bool deriveAccount(uint32_t account, StellarKeypair& keypair);
+    
+    /**
+     * Verifica si hay un nodo m/44'/148' en caché
+     */
+    static bool hasAccountNode();
+    
+    /**
+     * Copia el nodo en caché (para guardarlo cifrado)
+     * CUIDADO: Permite derivar todas las cuentas
+     * 
+     * @param node Buffer de salida (HD_ACCOUNT_NODE_SIZE bytes)
+     * @return false si no hay nodo en caché
+     */
+    static bool getAccountNode(uint8_t node[HD_ACCOUNT_NODE_SIZE]);
+    
+    /**
+     * Restaura el nodo en caché (desde almacenamiento cifrado)
+     * 
+     * @param node Clave || chain code (HD_ACCOUNT_NODE_SIZE bytes)
+     */
+    static void setAccountNode(const uint8_t node[HD_ACCOUNT_NODE_SIZE]);
+    
+    /**
+     * Borra el nodo en caché
+     */
+    static void clearAccountNode();
     
     // ============================================
     // EXPORTACIÓN
@@ -57,6 +157,14 @@ public:
      */
     String getPublicKey() const;
     
+    /**
+     * Public key en formato Stellar sin reservar memoria
+     * Se codifica la primera vez; válido mientras viva el keypair
+     * 
+     * @return 56 caracteres terminados en '\0'
+     */
+    const char* getPublicKeyCStr() const;
+    
     /**
      * Obtiene secret key en formato Stellar (S...)
      * CUIDADO: Esta es información sensible
@@ -66,12 +174,27 @@ public:
     String getSecretKey() const;
     
     /**
-     * Obtiene mnemonic (solo si fue generado con generate())
+     * Secret key en formato Stellar sin reservar memoria
+     * CUIDADO: Queda en el keypair hasta destruirlo
      * 
-     * @return Frase de 12 palabras o string vacío
+     * @return 56 caracteres terminados en '\0'
+     */
+    const char* getSecretKeyCStr() const;
+    
+    /**
+     * Obtiene mnemonic (solo si fue generado o importado con una frase)
+     * 
+     * @return Frase normalizada o string vacío
      */
     String getMnemonic() const;
     
+    /**
+     * Índice de cuenta SEP-0005
+     * 
+     * @return n de m/44'/148'/n' o -1 si no viene de derivación HD
+     */
+    int32_t getAccountIndex() const { return accountIndex; }
+    
     /**
      * Obtiene raw bytes de public key
      * 
@@ -116,19 +239,19 @@ private:
     uint8_t secretKey[32];
     String mnemonicPhrase;
     bool hasMnemonic;
+    int32_t accountIndex;
     
-    // Base32 encoding/decoding para formato Stellar
-    String encodePublicKey(const uint8_t* key) const;
-    String encodeSecretKey(const uint8_t* seed) const;
-    bool decodeSecretKey(const char* encoded, uint8_t* seed) const;
+    // StrKey codificadas bajo demanda (caché, no cambian el keypair)
+    mutable char publicKeyStr[STRKEY_ED25519_LENGTH + 1];
+    mutable char secretKeyStr[STRKEY_ED25519_LENGTH + 1];
+    mutable bool publicKeyEncoded;
+    mutable bool secretKeyEncoded;
     
-    // Base32 con checksum CRC16
-    String base32EncodeWithChecksum(uint8_t version, const uint8_t* data, size_t length) const;
-    bool base32DecodeWithChecksum(const char* encoded, uint8_t* version, uint8_t* data, size_t* length) const;
+    // Borra claves, frase y cachés
+    void wipe();
     
-    // Mnemonic BIP39 (simplificado)
-    void generateMnemonic();
-    bool mnemonicToSeed(const char* words, uint8_t seed[32]);
+    // SLIP-0010 Ed25519: hijo hardened (solo existe derivación hardened)
+    static void deriveChild(const uint8_t parent[HD_ACCOUNT_NODE_SIZE], uint32_t index, uint8_t child[HD_ACCOUNT_NODE_SIZE]);
 };
 
 #endif // STELLAR_KEYPAIR_H
\ No newline at end of file
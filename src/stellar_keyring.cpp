@@ -0,0 +1,237 @@
+#include "stellar_keyring.h"
+#include "stellar_strkey.h"
+#include "stellar_utils.h"
+
+static_assert((STELLAR_KEYRING_BUCKETS & (STELLAR_KEYRING_BUCKETS - 1)) == 0,
+              "STELLAR_KEYRING_BUCKETS must be a power of two");
+static_assert(STELLAR_KEYRING_BUCKETS >= 2 * STELLAR_KEYRING_CAPACITY,
+              "STELLAR_KEYRING_BUCKETS must be at least twice the capacity");
+static_assert(STELLAR_KEYRING_CAPACITY < 255, "Keyring slots are stored as uint8_t");
+
+static const size_t BUCKET_MASK = STELLAR_KEYRING_BUCKETS - 1;
+
+// ============================================
+// CONSTRUCTOR / DESTRUCTOR
+// ============================================
+
+StellarKeyring::StellarKeyring() : count(0) {
+    memset(bucketHints, 0, sizeof(bucketHints));
+    memset(bucketSlots, 0, sizeof(bucketSlots));
+}
+
+StellarKeyring::~StellarKeyring() {
+    // Cada StellarKeypair borra su clave al destruirse
+    count = 0;
+}
+
+// ============================================
+// ÍNDICE POR HINT
+// ============================================
+
+uint32_t StellarKeyring::readHint(const uint8_t* hint) {
+    return ((uint32_t)hint[0] << 24) | ((uint32_t)hint[1] << 16) |
+           ((uint32_t)hint[2] << 8) | (uint32_t)hint[3];
+}
+
+size_t StellarKeyring::bucketFor(uint32_t hint) {
+    // Hash multiplicativo: reparte también hints con bytes poco aleatorios
+    return ((hint * 2654435769u) >> 16) & BUCKET_MASK;
+}
+
+void StellarKeyring::insertIndex(uint32_t hint, size_t slot) {
+    size_t bucket = bucketFor(hint);
+
+    // Carga <= 50%: siempre hay un bucket libre
+    while (bucketSlots[bucket] != 0) {
+        bucket = (bucket + 1) & BUCKET_MASK;
+    }
+
+    bucketHints[bucket] = hint;
+    bucketSlots[bucket] = (uint8_t)(slot + 1);
+}
+
+void StellarKeyring::rebuildIndex() {
+    memset(bucketHints, 0, sizeof(bucketHints));
+    memset(bucketSlots, 0, sizeof(bucketSlots));
+
+    for (size_t i = 0; i < count; i++) {
+        insertIndex(readHint(keys[i].getRawPublicKey() + 28), i);
+    }
+}
+
+// ============================================
+// ALTA Y BAJA
+// ============================================
+
+int StellarKeyring::add(StellarKeypair&& keypair) {
+    if (count == STELLAR_KEYRING_CAPACITY) {
+        STELLAR_LOGE("Keyring", "Keyring full (%u keys)", (unsigned)STELLAR_KEYRING_CAPACITY);
+        return -1;
+    }
+
+    if (findByPublicKey(keypair.getRawPublicKey()) >= 0) {
+        STELLAR_LOGE("Keyring", "Key already in keyring");
+        return -1;
+    }
+
+    size_t slot = count++;
+    keys[slot] = static_cast<StellarKeypair&&>(keypair);
+    insertIndex(readHint(keys[slot].getRawPublicKey() + 28), slot);
+
+    STELLAR_LOGD("Keyring", "Added %s at slot %u", keys[slot].getPublicKeyCStr(), (unsigned)slot);
+
+    return (int)slot;
+}
+
+int StellarKeyring::addSecret(const char* secretKey) {
+    StellarKeypair keypair;
+
+    if (!StellarKeypair::fromSecret(secretKey, keypair)) {
+        STELLAR_LOGE("Keyring", "Invalid secret key");
+        return -1;
+    }
+
+    return add(static_cast<StellarKeypair&&>(keypair));
+}
+
+int StellarKeyring::addAccount(uint32_t account) {
+    StellarKeypair keypair;
+
+    if (!StellarKeypair::deriveAccount(account, keypair)) {
+        return -1;
+    }
+
+    return add(static_cast<StellarKeypair&&>(keypair));
+}
+
+bool StellarKeyring::remove(size_t index) {
+    if (index >= count) {
+        return false;
+    }
+
+    // La última clave ocupa el hueco: el array sigue contiguo
+    size_t last = count - 1;
+
+    if (index != last) {
+        keys[index] = static_cast<StellarKeypair&&>(keys[last]);
+    } else {
+        keys[index] = StellarKeypair();
+    }
+
+    count = last;
+    rebuildIndex();
+
+    return true;
+}
+
+void StellarKeyring::clear() {
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = StellarKeypair();
+    }
+
+    count = 0;
+    rebuildIndex();
+}
+
+const StellarKeypair* StellarKeyring::get(size_t index) const {
+    return index < count ? &keys[index] : nullptr;
+}
+
+// ============================================
+// BÚSQUEDA
+// ============================================
+
+int StellarKeyring::findByHint(const uint8_t hint[STELLAR_SIGNATURE_HINT_SIZE], int after) const {
+    if (!hint) {
+        return -1;
+    }
+
+    uint32_t value = readHint(hint);
+    bool skipping = after >= 0;
+
+    // Las claves con el mismo hint están en la misma cadena de sondeo,
+    // siempre en el mismo orden
+    for (size_t bucket = bucketFor(value); bucketSlots[bucket] != 0; bucket = (bucket + 1) & BUCKET_MASK) {
+        if (bucketHints[bucket] != value) {
+            continue;
+        }
+
+        int slot = bucketSlots[bucket] - 1;
+
+        if (skipping) {
+            skipping = (slot != after);
+            continue;
+        }
+
+        return slot;
+    }
+
+    return -1;
+}
+
+int StellarKeyring::findByPublicKey(const uint8_t publicKey[32]) const {
+    if (!publicKey) {
+        return -1;
+    }
+
+    for (int slot = findByHint(publicKey + 28); slot >= 0; slot = findByHint(publicKey + 28, slot)) {
+        if (memcmp(keys[slot].getRawPublicKey(), publicKey, 32) == 0) {
+            return slot;
+        }
+    }
+
+    return -1;
+}
+
+int StellarKeyring::findByAddress(const char* address) const {
+    uint8_t publicKey[32];
+
+    if (!StellarStrKey::decodeAccount(address, publicKey, nullptr, nullptr)) {
+        return -1;
+    }
+
+    return findByPublicKey(publicKey);
+}
+
+int StellarKeyring::findSigner(const XDRTransactionEnvelope& envelope) const {
+    const XDRBytesView& source = envelope.feeBump ? envelope.feeBumpSource : envelope.sourceAccount;
+
+    if (!source.data || source.length != 32) {
+        return -1;
+    }
+
+    return findByPublicKey(source.data);
+}
+
+size_t StellarKeyring::matchSignatures(const XDRTransactionEnvelope& envelope, const uint8_t* hash, int* slots) const {
+    XDRDecoder decoder(envelope.signatures);
+    XDRDecoratedSignature signature;
+    size_t matched = 0;
+
+    for (uint32_t i = 0; i < envelope.signatureCount && i < STELLAR_MAX_SIGNATURES; i++) {
+        if (!decoder.decodeDecoratedSignature(signature)) {
+            break;
+        }
+
+        int slot = findByHint(signature.hint.data);
+
+        // Con hash: la clave cuya verificación acepta la firma
+        if (hash) {
+            while (slot >= 0 &&
+                   (signature.signature.length != 64 ||
+                    !keys[slot].verify(hash, 32, signature.signature.data))) {
+                slot = findByHint(signature.hint.data, slot);
+            }
+        }
+
+        if (slots) {
+            slots[i] = slot;
+        }
+
+        if (slot >= 0) {
+            matched++;
+        }
+    }
+
+    return matched;
+}
@@ -0,0 +1,160 @@
+#ifndef STELLAR_KEYRING_H
+#define STELLAR_KEYRING_H
+
+#include <Arduino.h>
+#include "stellar_keypair.h"
+#include "stellar_xdr.h"
+
+/**
+ * Anillo de claves para dispositivos con varias cuentas
+ *
+ * Guarda los keypairs en un array contiguo (cuentas por canal, cofirmantes
+ * multisig, cuentas derivadas) e indexa cada uno por el hint de su
+ * DecoratedSignature: los últimos 4 bytes de la public key, igual que en
+ * StellarPayment::buildTransactionEnvelope.
+ *
+ * El índice es una tabla hash de direccionamiento abierto con el hint
+ * guardado junto al slot: buscar el firmante de un envelope o emparejar
+ * sus firmas no recorre las claves ni decodifica StrKeys. Dos claves con
+ * el mismo hint se distinguen por la public key completa (o por la firma
+ * al verificar).
+ *
+ * Los índices devueltos son estables hasta el siguiente remove() o clear().
+ * No es reentrante: usar desde una sola tarea.
+ */
+
+#ifndef STELLAR_KEYRING_CAPACITY
+#define STELLAR_KEYRING_CAPACITY 32
+#endif
+
+// Potencia de dos, al menos el doble de la capacidad (carga <= 50%)
+#ifndef STELLAR_KEYRING_BUCKETS
+#define STELLAR_KEYRING_BUCKETS 64
+#endif
+
+#define STELLAR_SIGNATURE_HINT_SIZE 4
+#define STELLAR_MAX_SIGNATURES 20   // DecoratedSignature signatures<20>
+
+class StellarKeyring {
+public:
+    StellarKeyring();
+    ~StellarKeyring();
+
+    // ============================================
+    // ALTA Y BAJA
+    // ============================================
+
+    /**
+     * Añade un keypair (se mueve al anillo; el origen queda vacío)
+     *
+     * @param keypair Keypair a añadir
+     * @return Índice del slot o -1 si está lleno o la clave ya existe
+     */
+    int add(StellarKeypair&& keypair);
+
+    /**
+     * Añade desde secret key en formato Stellar (S...)
+     *
+     * @return Índice del slot o -1 si inválida, lleno o repetida
+     */
+    int addSecret(const char* secretKey);
+
+    /**
+     * Añade la cuenta m/44'/148'/account' desde el nodo HD en caché
+     *
+     * @return Índice del slot o -1 si no hay nodo, lleno o repetida
+     */
+    int addAccount(uint32_t account);
+
+    /**
+     * Quita una clave (la última pasa a ocupar su slot)
+     *
+     * @return false si el índice no existe
+     */
+    bool remove(size_t index);
+
+    /**
+     * Borra todas las claves
+     */
+    void clear();
+
+    size_t size() const { return count; }
+    size_t capacity() const { return STELLAR_KEYRING_CAPACITY; }
+    bool isFull() const { return count == STELLAR_KEYRING_CAPACITY; }
+
+    /**
+     * Keypair de un slot (nullptr si no existe)
+     */
+    const StellarKeypair* get(size_t index) const;
+
+    // ============================================
+    // BÚSQUEDA
+    // ============================================
+
+    /**
+     * Busca por hint de firma
+     *
+     * Con colisiones, llamar de nuevo pasando el índice anterior para
+     * obtener la siguiente clave con el mismo hint.
+     *
+     * @param hint 4 bytes (DecoratedSignature.hint)
+     * @param after Índice devuelto por la llamada anterior o -1
+     * @return Índice del slot o -1 si no hay (más) claves con ese hint
+     */
+    int findByHint(const uint8_t hint[STELLAR_SIGNATURE_HINT_SIZE], int after = -1) const;
+
+    /**
+     * Busca por public key (32 bytes)
+     *
+     * @return Índice del slot o -1
+     */
+    int findByPublicKey(const uint8_t publicKey[32]) const;
+
+    /**
+     * Busca por dirección G... o M... (decodifica una vez)
+     *
+     * @return Índice del slot o -1
+     */
+    int findByAddress(const char* address) const;
+
+    /**
+     * Clave que debe firmar un envelope: la fuente de la transacción
+     * (o la fuente del fee bump si el envelope es un fee bump)
+     *
+     * @return Índice del slot o -1 si la cuenta no está en el anillo
+     */
+    int findSigner(const XDRTransactionEnvelope& envelope) const;
+
+    /**
+     * Empareja las firmas de un envelope con las claves del anillo
+     *
+     * Con hash, cada firma se verifica contra las claves con su hint y se
+     * asigna a la que la valida; sin hash solo se empareja por hint.
+     *
+     * @param envelope Envelope decodificado (XDRDecoder::decodeTransactionEnvelope)
+     * @param hash Hash firmado (32 bytes) o nullptr
+     * @param slots Salida opcional: índice por firma o -1 (signatureCount entradas)
+     * @return Número de firmas emparejadas
+     */
+    size_t matchSignatures(const XDRTransactionEnvelope& envelope, const uint8_t* hash, int* slots) const;
+
+private:
+    StellarKeypair keys[STELLAR_KEYRING_CAPACITY];
+    size_t count;
+
+    // Hint de cada bucket y slot + 1 (0 = vacío)
+    uint32_t bucketHints[STELLAR_KEYRING_BUCKETS];
+    uint8_t bucketSlots[STELLAR_KEYRING_BUCKETS];
+
+    static uint32_t readHint(const uint8_t* hint);
+    static size_t bucketFor(uint32_t hint);
+
+    void insertIndex(uint32_t hint, size_t slot);
+    void rebuildIndex();
+
+    // Contiene claves: no copiable
+    StellarKeyring(const StellarKeyring&) = delete;
+    StellarKeyring& operator=(const StellarKeyring&) = delete;
+};
+
+#endif // STELLAR_KEYRING_H
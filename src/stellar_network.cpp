@@ -1,4 +1,5 @@
 #include "stellar_network.h"
+#include "stellar_strkey.h"
 #include "stellar_utils.h"
 
 // Definir constantes estáticas
@@ -8,11 +9,61 @@ const char* StellarNetwork::FRIENDBOT_URL = "https://friendbot.stellar.org";
 const char* StellarNetwork::TESTNET_PASSPHRASE = "Test SDF Network ; September 2015";
 const char* StellarNetwork::MAINNET_PASSPHRASE = "Public Global Stellar Network ; September 2015";
 
+// pooledRequest(): HTTP 200 cuyo cuerpo no es JSON válido o no cabe en el
+// documento (los errores de HTTPClient van de -1 a -11)
+static const int HTTP_JSON_INVALID = -100;
+
+// Cabeceras de respuesta que HTTPClient debe conservar
+static const char* RESPONSE_HEADERS[] = { "Transfer-Encoding" };
+
+// ============================================
+// FILTROS DE RESPUESTA
+// ============================================
+// Solo estos campos llegan al JsonDocument: el resto (_links, signers,
+// envelope_xdr...) se descarta según se lee del socket
+
+static void accountFilter(JsonDocument& filter) {
+    filter["id"] = true;
+    filter["sequence"] = true;
+    filter["subentry_count"] = true;
+    
+    // Un elemento en el filtro se aplica a todos los del array
+    JsonObject balance = filter["balances"].createNestedObject();
+    balance["asset_type"] = true;
+    balance["asset_code"] = true;
+    balance["balance"] = true;
+}
+
+static void paymentsFilter(JsonDocument& filter) {
+    JsonObject record = filter["_embedded"]["records"].createNestedObject();
+    record["paging_token"] = true;
+    record["type"] = true;
+    record["from"] = true;
+    record["to"] = true;
+    record["amount"] = true;
+    record["asset_type"] = true;
+    record["asset_code"] = true;
+    record["created_at"] = true;
+}
+
+static void transactionFilter(JsonDocument& filter) {
+    filter["hash"] = true;
+    filter["ledger"] = true;
+    filter["successful"] = true;
+    filter["result_xdr"] = true;
+}
+
+static void errorFilter(JsonDocument& filter) {
+    filter["title"] = true;
+    filter["detail"] = true;
+    filter["extras"]["result_codes"] = true;
+}
+
 // ============================================
 // CONSTRUCTOR / DESTRUCTOR
 // ============================================
 
-StellarNetwork::StellarNetwork(NetworkType type) {
+StellarNetwork::StellarNetwork(NetworkType type) : connections(&tlsSessions), worker(nullptr), jobs(nullptr) {
     networkType = type;
     timeout = 30000;  // 30 segundos
     maxRetries = 3;
@@ -27,12 +78,14 @@ StellarNetwork::StellarNetwork(NetworkType type) {
         networkPassphrase = MAINNET_PASSPHRASE;
     }
     
-    StellarUtils::infoPrint("Network", 
-        type == STELLAR_TESTNET ? "Initialized (TESTNET)" : "Initialized (MAINNET)");
+    STELLAR_LOGI("Network", "Initialized (%s)", type == STELLAR_TESTNET ? "TESTNET" : "MAINNET");
 }
 
 StellarNetwork::~StellarNetwork() {
-    // Nada que limpiar
+    // Termina lo encolado antes de destruir el pool
+    stopWorker();
+    
+    // El pool cierra sus conexiones al destruirse
 }
 
 // ============================================
@@ -45,29 +98,33 @@ void StellarNetwork::setNetwork(NetworkType type) {
     if (type == STELLAR_TESTNET) {
         horizonUrl = TESTNET_HORIZON;
         networkPassphrase = TESTNET_PASSPHRASE;
-        StellarUtils::infoPrint("Network", "Switched to TESTNET");
+        STELLAR_LOGI("Network", "Switched to TESTNET");
     } else {
         horizonUrl = MAINNET_HORIZON;
         networkPassphrase = MAINNET_PASSPHRASE;
-        StellarUtils::infoPrint("Network", "Switched to MAINNET");
+        STELLAR_LOGI("Network", "Switched to MAINNET");
     }
+    
+    // Las conexiones abiertas son del host anterior
+    closeConnections();
 }
 
 void StellarNetwork::setHorizonURL(const char* url) {
     if (url) {
         horizonUrl = String(url);
-        StellarUtils::infoPrint("Network", ("Custom Horizon: " + horizonUrl).c_str());
+        closeConnections();
+        STELLAR_LOGI("Network", "Custom Horizon: %s", horizonUrl.c_str());
     }
 }
 
 void StellarNetwork::setTimeout(uint32_t seconds) {
     timeout = seconds * 1000;
-    StellarUtils::debugPrint("Network", ("Timeout set to " + String(seconds) + "s").c_str());
+    STELLAR_LOGD("Network", "Timeout set to %us", (unsigned)seconds);
 }
 
 void StellarNetwork::setMaxRetries(uint8_t count) {
     maxRetries = count;
-    StellarUtils::debugPrint("Network", ("Max retries: " + String(count)).c_str());
+    STELLAR_LOGD("Network", "Max retries: %u", (unsigned)count);
 }
 
 // ============================================
@@ -83,176 +140,244 @@ bool StellarNetwork::isConnected() const {
 // ============================================
 
 String StellarNetwork::httpGet(const char* endpoint) {
-    if (!isConnected()) {
-        lastError = "WiFi not connected";
-        StellarUtils::errorPrint("Network", lastError.c_str());
+    NetworkFuture future;
+    future.blocking = true;
+    
+    httpGetAsync(endpoint, future);
+    
+    if (!await(future)) {
         return "";
     }
     
-    String url = horizonUrl + String(endpoint);
-    StellarUtils::debugPrint("Network", ("GET " + url).c_str());
-    
-    return httpGetWithRetry(url.c_str());
+    return future.response;
 }
 
 String StellarNetwork::httpPost(const char* endpoint, const char* body) {
-    if (!isConnected()) {
-        lastError = "WiFi not connected";
-        StellarUtils::errorPrint("Network", lastError.c_str());
+    NetworkFuture future;
+    future.blocking = true;
+    
+    prepare(future);
+    future.body = body ? body : "";
+    future.post = true;
+    send(future, String(endpoint));
+    
+    if (!await(future)) {
+        return "";
+    }
+    
+    return future.response;
+}
+
+String StellarNetwork::httpPost(const char* endpoint, Base64FormStream& body) {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    prepare(future);
+    future.stream = &body;
+    send(future, String(endpoint));
+    
+    if (!await(future)) {
         return "";
     }
     
-    String url = horizonUrl + String(endpoint);
-    StellarUtils::debugPrint("Network", ("POST " + url).c_str());
+    return future.response;
+}
+
+bool StellarNetwork::httpGet(const char* endpoint, JsonDocument& doc, const JsonDocument& filter) {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    prepare(future);
+    future.doc = &doc;
+    future.filter = &filter;
+    send(future, String(endpoint));
     
-    return httpPostWithRetry(url.c_str(), body);
+    return await(future);
+}
+
+bool StellarNetwork::httpPost(const char* endpoint, Base64FormStream& body, JsonDocument& doc, const JsonDocument& filter) {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    prepare(future);
+    future.stream = &body;
+    future.doc = &doc;
+    future.filter = &filter;
+    send(future, String(endpoint));
+    
+    return await(future);
 }
 
 // ============================================
 // HTTP HELPERS CON RETRY
 // ============================================
 
-String StellarNetwork::httpGetWithRetry(const char* url) {
-    HTTPClient http;
-    WiFiClientSecure client;
-    String response = "";
-
-    // Permitir conexiones HTTPS sin verificar certificado (para IoT)
-    client.setInsecure();
-
-    for (uint8_t attempt = 0; attempt < maxRetries; attempt++) {
-        if (attempt > 0) {
-            uint32_t backoff = 1000 * (1 << attempt);  // Exponential backoff
-            StellarUtils::debugPrint("Network",
-                ("Retry #" + String(attempt + 1) + " after " + String(backoff) + "ms").c_str());
-            delay(backoff);
+int StellarNetwork::pooledRequest(const char* url, const char* body, Base64FormStream* stream,
+                                  String* response, JsonDocument* doc, const JsonDocument* filter,
+                                  String& error) {
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    
+    // El servidor puede cerrar una conexión keep-alive justo cuando se
+    // reutiliza: se repite una vez sobre una nueva sin contar como reintento
+    // (un submit repetido es idempotente: mismo hash de transacción)
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        bool reused = false;
+        HTTPClient* http = connections.acquire(url, timeout, &reused);
+        
+        if (!http) {
+            return HTTPC_ERROR_CONNECTION_REFUSED;
         }
-
-        http.begin(client, url);
-        http.setTimeout(timeout);
-        http.addHeader("Content-Type", "application/json");
-        http.addHeader("User-Agent", "Stellar-IoT-SDK/0.1.0");
         
-        int httpCode = http.GET();
+        http->addHeader("User-Agent", "Stellar-IoT-SDK/0.1.0");
+        http->collectHeaders(RESPONSE_HEADERS, 1);
         
-        if (httpCode == HTTP_CODE_OK) {
-            response = http.getString();
-            http.end();
-            lastError = "";
-            
-            StellarUtils::debugPrint("Network", "Request successful");
-            return response;
-            
-        } else if (httpCode > 0) {
-            // Obtener respuesta de error
-            response = http.getString();
-            parseError(response);
-            http.end();
+        if (stream) {
+            // Body generado mientras se envía (Content-Length precalculado)
+            http->addHeader("Content-Type", "application/x-www-form-urlencoded");
+            stream->rewind();
+            httpCode = http->sendRequest("POST", stream, stream->size());
+        } else if (body) {
+            http->addHeader("Content-Type", "application/x-www-form-urlencoded");
+            httpCode = http->sendRequest("POST", (uint8_t*)body, strlen(body));
+        } else {
+            http->addHeader("Content-Type", "application/json");
+            httpCode = http->GET();
+        }
+        
+        bool keep = httpCode > 0;
+        
+        // La respuesta se consume entera para poder reutilizar la conexión
+        if (httpCode > 0 && doc) {
+            WiFiClient* socket = http->getStreamPtr();
             
-            // No reintentar errores 4xx (client errors)
-            if (httpCode >= 400 && httpCode < 500) {
-                StellarUtils::errorPrint("Network", 
-                    ("HTTP " + String(httpCode) + ": " + lastError).c_str());
-                return "";
+            if (socket) {
+                bool chunked = http->header("Transfer-Encoding").equalsIgnoreCase("chunked");
+                HttpBodyStream bodyStream(*socket, http->getSize(), chunked, timeout);
+                
+                if (httpCode == HTTP_CODE_OK) {
+                    DeserializationError result = deserializeJson(*doc, bodyStream, DeserializationOption::Filter(*filter));
+                    
+                    if (bodyStream.failed()) {
+                        httpCode = HTTPC_ERROR_READ_TIMEOUT;
+                    } else if (result) {
+                        error = "Invalid JSON response: " + String(result.c_str());
+                        httpCode = HTTP_JSON_INVALID;
+                    }
+                } else {
+                    parseError(bodyStream, error);
+                }
+                
+                // Lo que el filtro no necesitó leer
+                keep = bodyStream.drain();
+            } else {
+                httpCode = HTTPC_ERROR_CONNECTION_LOST;
+                keep = false;
             }
-            
-        } else {
-            lastError = "HTTP request failed: " + http.errorToString(httpCode);
-            StellarUtils::errorPrint("Network", lastError.c_str());
+        } else if (httpCode > 0) {
+            *response = http->getString();
+        }
+        
+        connections.release(http, keep);
+        
+        if (httpCode > 0 || httpCode == HTTP_JSON_INVALID || !reused) {
+            break;
         }
         
-        http.end();
+        STELLAR_LOGD("Network", "Stale keep-alive connection, reconnecting");
     }
     
-    lastError = "Max retries exceeded";
-    StellarUtils::errorPrint("Network", lastError.c_str());
-    return "";
+    return httpCode;
 }
 
-String StellarNetwork::httpPostWithRetry(const char* url, const char* body) {
-    HTTPClient http;
-    WiFiClientSecure client;
-    String response = "";
-
-    // Permitir conexiones HTTPS sin verificar certificado (para IoT)
-    client.setInsecure();
-
+bool StellarNetwork::requestWithRetry(const char* url, const char* body, Base64FormStream* stream,
+                                      String* response, JsonDocument* doc, const JsonDocument* filter,
+                                      String& error) {
     for (uint8_t attempt = 0; attempt < maxRetries; attempt++) {
         if (attempt > 0) {
-            uint32_t backoff = 1000 * (1 << attempt);
-            StellarUtils::debugPrint("Network",
-                ("Retry #" + String(attempt + 1) + " after " + String(backoff) + "ms").c_str());
+            uint32_t backoff = 1000 * (1 << attempt);  // Exponential backoff
+            STELLAR_LOGD("Network", "Retry #%u after %lums", (unsigned)(attempt + 1), (unsigned long)backoff);
             delay(backoff);
         }
 
-        http.begin(client, url);
-        http.setTimeout(timeout);
-        http.addHeader("Content-Type", "application/x-www-form-urlencoded");
-        http.addHeader("User-Agent", "Stellar-IoT-SDK/0.1.0");
-        
-        int httpCode = http.POST(body);
+        int httpCode = pooledRequest(url, body, stream, response, doc, filter, error);
         
         if (httpCode == HTTP_CODE_OK) {
-            response = http.getString();
-            http.end();
-            lastError = "";
+            error = "";
             
-            StellarUtils::debugPrint("Network", "POST successful");
-            return response;
+            STELLAR_LOGD("Network", "%s successful", (body || stream) ? "POST" : "Request");
+            return true;
+            
+        } else if (httpCode == HTTP_JSON_INVALID) {
+            // El cuerpo llegó entero: repetir daría el mismo resultado
+            STELLAR_LOGE("Network", "%s", error.c_str());
+            return false;
             
         } else if (httpCode > 0) {
-            response = http.getString();
-            parseError(response);
-            http.end();
+            // Con doc el error ya se leyó del socket
+            if (response) {
+                parseError(*response, error);
+            }
             
-            // No reintentar errores 4xx
+            // No reintentar errores 4xx (client errors)
             if (httpCode >= 400 && httpCode < 500) {
-                StellarUtils::errorPrint("Network", 
-                    ("HTTP " + String(httpCode) + ": " + lastError).c_str());
-                return "";
+                STELLAR_LOGE("Network", "HTTP %d: %s", httpCode, error.c_str());
+                return false;
             }
             
         } else {
-            lastError = "HTTP request failed: " + http.errorToString(httpCode);
-            StellarUtils::errorPrint("Network", lastError.c_str());
+            error = "HTTP request failed: " + HTTPClient::errorToString(httpCode);
+            STELLAR_LOGE("Network", "%s", error.c_str());
         }
-        
-        http.end();
     }
     
-    lastError = "Max retries exceeded";
-    StellarUtils::errorPrint("Network", lastError.c_str());
-    return "";
+    error = "Max retries exceeded";
+    STELLAR_LOGE("Network", "%s", error.c_str());
+    return false;
 }
 
-void StellarNetwork::parseError(const String& response) {
-    DynamicJsonDocument doc(2048);
-    DeserializationError error = deserializeJson(doc, response);
+void StellarNetwork::parseError(const String& response, String& error) {
+    StaticJsonDocument<128> filter;
+    errorFilter(filter);
     
-    if (error) {
-        lastError = "Failed to parse error response";
+    DynamicJsonDocument doc(1024);
+    DeserializationError result = deserializeJson(doc, response, DeserializationOption::Filter(filter));
+    readError(doc, result, error);
+}
+
+void StellarNetwork::parseError(Stream& response, String& error) {
+    StaticJsonDocument<128> filter;
+    errorFilter(filter);
+    
+    DynamicJsonDocument doc(1024);
+    DeserializationError result = deserializeJson(doc, response, DeserializationOption::Filter(filter));
+    readError(doc, result, error);
+}
+
+void StellarNetwork::readError(JsonDocument& doc, DeserializationError result, String& error) {
+    if (result) {
+        error = "Failed to parse error response";
         return;
     }
     
     // Intentar extraer mensaje de error de Horizon
     if (doc.containsKey("title")) {
-        lastError = doc["title"].as<String>();
+        error = doc["title"].as<String>();
     } else if (doc.containsKey("detail")) {
-        lastError = doc["detail"].as<String>();
+        error = doc["detail"].as<String>();
     } else {
-        lastError = "Unknown error";
+        error = "Unknown error";
     }
 
     // Siempre intentar extraer result_codes si existen
     if (doc.containsKey("extras") && doc["extras"].containsKey("result_codes")) {
         JsonObject resultCodes = doc["extras"]["result_codes"];
         if (resultCodes.containsKey("transaction")) {
-            lastError += " [" + resultCodes["transaction"].as<String>() + "]";
+            error += " [" + resultCodes["transaction"].as<String>() + "]";
         }
         if (resultCodes.containsKey("operations")) {
             JsonArray ops = resultCodes["operations"];
             for (size_t i = 0; i < ops.size(); i++) {
-                lastError += " op[" + String(i) + "]:" + ops[i].as<String>();
+                error += " op[" + String(i) + "]:" + ops[i].as<String>();
             }
         }
     }
@@ -263,9 +388,9 @@ void StellarNetwork::parseError(const String& response) {
 // ============================================
 
 String StellarNetwork::getAccount(const char* accountId) {
-    if (!StellarUtils::isValidAddress(accountId) || accountId[0] != 'G') {
+    if (!StellarStrKey::isValid(accountId, STRKEY_ACCOUNT_ID)) {
         lastError = "Invalid account ID";
-        StellarUtils::errorPrint("Network", lastError.c_str());
+        STELLAR_LOGE("Network", "%s", lastError.c_str());
         return "";
     }
     
@@ -273,17 +398,43 @@ String StellarNetwork::getAccount(const char* accountId) {
     return httpGet(endpoint.c_str());
 }
 
+bool StellarNetwork::getAccount(const char* accountId, JsonDocument& doc) {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    getAccountAsync(accountId, doc, future);
+    return await(future);
+}
+
 String StellarNetwork::getAccountPayments(
     const char* accountId,
     const char* cursor,
     uint8_t limit
 ) {
-    if (!StellarUtils::isValidAddress(accountId) || accountId[0] != 'G') {
+    if (!StellarStrKey::isValid(accountId, STRKEY_ACCOUNT_ID)) {
         lastError = "Invalid account ID";
-        StellarUtils::errorPrint("Network", lastError.c_str());
+        STELLAR_LOGE("Network", "%s", lastError.c_str());
         return "";
     }
     
+    String endpoint = paymentsEndpoint(accountId, cursor, limit);
+    return httpGet(endpoint.c_str());
+}
+
+bool StellarNetwork::getAccountPayments(
+    const char* accountId,
+    const char* cursor,
+    uint8_t limit,
+    JsonDocument& doc
+) {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    getAccountPaymentsAsync(accountId, cursor, limit, doc, future);
+    return await(future);
+}
+
+String StellarNetwork::paymentsEndpoint(const char* accountId, const char* cursor, uint8_t limit) {
     String endpoint = "/accounts/" + String(accountId) + 
                       "/payments?order=desc&limit=" + String(limit);
     
@@ -291,32 +442,65 @@ String StellarNetwork::getAccountPayments(
         endpoint += "&cursor=" + String(cursor);
     }
     
-    return httpGet(endpoint.c_str());
+    return endpoint;
 }
 
 String StellarNetwork::submitTransaction(const char* txXdrBase64) {
     if (!txXdrBase64 || strlen(txXdrBase64) == 0) {
         lastError = "Empty transaction XDR";
-        StellarUtils::errorPrint("Network", lastError.c_str());
+        STELLAR_LOGE("Network", "%s", lastError.c_str());
         return "";
     }
     
-    StellarUtils::infoPrint("Network", "Submitting transaction...");
+    STELLAR_LOGI("Network", "Submitting transaction...");
 
     String body = "tx=" + StellarUtils::urlEncode(String(txXdrBase64));
     String response = httpPost("/transactions", body.c_str());
     
     if (response.length() > 0) {
-        StellarUtils::infoPrint("Network", "Transaction submitted successfully");
+        STELLAR_LOGI("Network", "Transaction submitted successfully");
+    }
+    
+    return response;
+}
+
+String StellarNetwork::submitTransaction(const uint8_t* envelope, size_t length) {
+    if (!envelope || length == 0) {
+        lastError = "Empty transaction XDR";
+        STELLAR_LOGE("Network", "%s", lastError.c_str());
+        return "";
+    }
+    
+    STELLAR_LOGI("Network", "Submitting transaction...");
+    
+    Base64FormStream body("tx", envelope, length);
+    String response = httpPost("/transactions", body);
+    
+    if (response.length() > 0) {
+        STELLAR_LOGI("Network", "Transaction submitted successfully");
     }
     
     return response;
 }
 
+bool StellarNetwork::submitTransaction(const uint8_t* envelope, size_t length, JsonDocument& doc) {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    submitTransactionAsync(envelope, length, doc, future);
+    bool success = await(future);
+    
+    if (success) {
+        STELLAR_LOGI("Network", "Transaction submitted successfully");
+    }
+    
+    return success;
+}
+
 String StellarNetwork::getTransaction(const char* txHash) {
     if (!txHash || strlen(txHash) != 64) {
         lastError = "Invalid transaction hash";
-        StellarUtils::errorPrint("Network", lastError.c_str());
+        STELLAR_LOGE("Network", "%s", lastError.c_str());
         return "";
     }
     
@@ -324,31 +508,378 @@ String StellarNetwork::getTransaction(const char* txHash) {
     return httpGet(endpoint.c_str());
 }
 
+bool StellarNetwork::getTransaction(const char* txHash, JsonDocument& doc) {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    getTransactionAsync(txHash, doc, future);
+    return await(future);
+}
+
 bool StellarNetwork::fundWithFriendbot(const char* accountId) {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    StaticJsonDocument<128> doc;
+    fundWithFriendbotAsync(accountId, doc, future);
+    bool success = await(future);
+    
+    if (success) {
+        STELLAR_LOGI("Network", "Account funded successfully (10,000 XLM)");
+    } else {
+        STELLAR_LOGE("Network", "Friendbot funding failed");
+    }
+    
+    return success;
+}
+
+// ============================================
+// PETICIONES ASÍNCRONAS
+// ============================================
+
+bool StellarNetwork::httpGetAsync(const char* endpoint, NetworkFuture& future) {
+    if (!prepare(future)) {
+        return false;
+    }
+    
+    return send(future, String(endpoint));
+}
+
+bool StellarNetwork::getAccountAsync(const char* accountId, JsonDocument& doc, NetworkFuture& future) {
+    if (!prepare(future)) {
+        return false;
+    }
+    
+    if (!StellarStrKey::isValid(accountId, STRKEY_ACCOUNT_ID)) {
+        return reject(future, "Invalid account ID");
+    }
+    
+    accountFilter(future.filterDoc);
+    future.filter = &future.filterDoc;
+    future.doc = &doc;
+    
+    return send(future, "/accounts/" + String(accountId));
+}
+
+bool StellarNetwork::getAccountPaymentsAsync(
+    const char* accountId,
+    const char* cursor,
+    uint8_t limit,
+    JsonDocument& doc,
+    NetworkFuture& future
+) {
+    if (!prepare(future)) {
+        return false;
+    }
+    
+    if (!StellarStrKey::isValid(accountId, STRKEY_ACCOUNT_ID)) {
+        return reject(future, "Invalid account ID");
+    }
+    
+    paymentsFilter(future.filterDoc);
+    future.filter = &future.filterDoc;
+    future.doc = &doc;
+    
+    return send(future, paymentsEndpoint(accountId, cursor, limit));
+}
+
+bool StellarNetwork::submitTransactionAsync(const uint8_t* envelope, size_t length, JsonDocument& doc, NetworkFuture& future) {
+    if (!prepare(future)) {
+        return false;
+    }
+    
+    if (!envelope || length == 0) {
+        return reject(future, "Empty transaction XDR");
+    }
+    
+    STELLAR_LOGI("Network", "Submitting transaction...");
+    
+    transactionFilter(future.filterDoc);
+    future.filter = &future.filterDoc;
+    future.doc = &doc;
+    
+    // El body "tx=..." se genera en el worker a partir del envelope
+    future.envelope = envelope;
+    future.envelopeLength = length;
+    
+    return send(future, String("/transactions"));
+}
+
+bool StellarNetwork::getTransactionAsync(const char* txHash, JsonDocument& doc, NetworkFuture& future) {
+    if (!prepare(future)) {
+        return false;
+    }
+    
+    if (!txHash || strlen(txHash) != 64) {
+        return reject(future, "Invalid transaction hash");
+    }
+    
+    transactionFilter(future.filterDoc);
+    future.filter = &future.filterDoc;
+    future.doc = &doc;
+    
+    return send(future, "/transactions/" + String(txHash));
+}
+
+bool StellarNetwork::fundWithFriendbotAsync(const char* accountId, JsonDocument& doc, NetworkFuture& future) {
+    if (!prepare(future)) {
+        return false;
+    }
+    
     if (networkType != STELLAR_TESTNET) {
-        lastError = "Friendbot only available on testnet";
-        StellarUtils::errorPrint("Network", lastError.c_str());
+        return reject(future, "Friendbot only available on testnet");
+    }
+    
+    if (!StellarStrKey::isValid(accountId, STRKEY_ACCOUNT_ID)) {
+        return reject(future, "Invalid account ID");
+    }
+    
+    if (!isConnected()) {
+        return reject(future, "WiFi not connected");
+    }
+    
+    STELLAR_LOGI("Network", "Funding account with Friendbot...");
+    
+    // La respuesta es la transacción de fondeo completa: basta con el hash
+    future.filterDoc["hash"] = true;
+    future.filter = &future.filterDoc;
+    future.doc = &doc;
+    
+    // Friendbot no está bajo la URL de Horizon
+    future.url = String(FRIENDBOT_URL) + "/?addr=" + String(accountId);
+    
+    return enqueue(future);
+}
+
+// ============================================
+// FUTURES
+// ============================================
+
+NetworkFuture::NetworkFuture() :
+    state(FUTURE_IDLE),
+    job(JOB_REQUEST),
+    success(false),
+    blocking(false),
+    post(false),
+    envelope(nullptr),
+    envelopeLength(0),
+    stream(nullptr),
+    doc(nullptr),
+    filter(nullptr),
+    callback(nullptr),
+    context(nullptr) {
+}
+
+bool NetworkFuture::wait(uint32_t timeoutMs) {
+    uint32_t start = millis();
+    
+    while (isPending()) {
+        if (millis() - start >= timeoutMs) {
+            return false;
+        }
+        
+        delay(1);
+    }
+    
+    return true;
+}
+
+void NetworkFuture::onComplete(NetworkCallback callback, void* context) {
+    this->callback = callback;
+    this->context = context;
+}
+
+bool StellarNetwork::prepare(NetworkFuture& future) {
+    // El worker todavía escribe en él
+    if (future.isPending()) {
+        STELLAR_LOGE("Network", "Future already has a request in progress");
         return false;
     }
     
-    if (!StellarUtils::isValidAddress(accountId) || accountId[0] != 'G') {
-        lastError = "Invalid account ID";
-        StellarUtils::errorPrint("Network", lastError.c_str());
+    future.setState(NetworkFuture::FUTURE_IDLE);
+    future.job = NetworkFuture::JOB_REQUEST;
+    future.success = false;
+    future.url = "";
+    future.body = "";
+    future.post = false;
+    future.envelope = nullptr;
+    future.envelopeLength = 0;
+    future.stream = nullptr;
+    future.doc = nullptr;
+    future.filter = nullptr;
+    future.filterDoc.clear();
+    future.response = "";
+    future.error = "";
+    
+    return true;
+}
+
+bool StellarNetwork::reject(NetworkFuture& future, const char* error) {
+    future.error = error;
+    future.success = false;
+    future.setState(NetworkFuture::FUTURE_DONE);
+    
+    STELLAR_LOGE("Network", "%s", error);
+    return false;
+}
+
+bool StellarNetwork::send(NetworkFuture& future, const String& endpoint) {
+    if (!isConnected()) {
+        return reject(future, "WiFi not connected");
+    }
+    
+    future.url = horizonUrl + endpoint;
+    
+    STELLAR_LOGD("Network", "%s %s", (future.post || future.envelope || future.stream) ? "POST" : "GET",
+                 future.url.c_str());
+    
+    return enqueue(future);
+}
+
+bool StellarNetwork::enqueue(NetworkFuture& future) {
+    future.setState(NetworkFuture::FUTURE_QUEUED);
+    
+    // Sin worker, o desde un callback en el propio worker: en línea
+    if (!worker || onWorker()) {
+        execute(future);
+        return true;
+    }
+    
+    // Las llamadas síncronas esperan hueco; las asíncronas no bloquean
+    NetworkFuture* job = &future;
+    if (xQueueSend(jobs, &job, future.blocking ? portMAX_DELAY : 0) != pdTRUE) {
+        return reject(future, "Request queue full");
+    }
+    
+    return true;
+}
+
+bool StellarNetwork::await(NetworkFuture& future) {
+    while (future.isPending()) {
+        delay(1);
+    }
+    
+    // El worker escribe en el future, nunca en lastError
+    lastError = future.error;
+    return future.success;
+}
+
+void StellarNetwork::closeConnections() {
+    NetworkFuture future;
+    future.blocking = true;
+    
+    prepare(future);
+    future.job = NetworkFuture::JOB_CLOSE_CONNECTIONS;
+    enqueue(future);
+    
+    while (future.isPending()) {
+        delay(1);
+    }
+}
+
+// ============================================
+// WORKER
+// ============================================
+
+bool StellarNetwork::startWorker(uint32_t stackSize, UBaseType_t priority, BaseType_t core) {
+    if (worker) {
+        return true;
+    }
+    
+    jobs = xQueueCreate(STELLAR_NET_QUEUE_SIZE, sizeof(NetworkFuture*));
+    if (!jobs) {
+        STELLAR_LOGE("Network", "Failed to create request queue");
+        return false;
+    }
+    
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreatePinnedToCore(workerTask, "stellar_net", stackSize, this, priority, &handle, core) != pdPASS) {
+        STELLAR_LOGE("Network", "Failed to start network worker");
+        vQueueDelete(jobs);
+        jobs = nullptr;
         return false;
     }
     
-    StellarUtils::infoPrint("Network", "Funding account with Friendbot...");
+    worker = handle;
     
-    String url = String(FRIENDBOT_URL) + "/?addr=" + String(accountId);
-    String response = httpGetWithRetry(url.c_str());
+    STELLAR_LOGI("Network", "Worker started (queue: %u)", (unsigned)STELLAR_NET_QUEUE_SIZE);
+    return true;
+}
+
+void StellarNetwork::stopWorker() {
+    // Desde un callback se bloquearía a sí mismo
+    if (!worker || onWorker()) {
+        return;
+    }
     
-    bool success = (response.length() > 0);
+    // Detrás de lo ya encolado: esas peticiones terminan
+    NetworkFuture* stop = nullptr;
+    xQueueSend(jobs, &stop, portMAX_DELAY);
     
-    if (success) {
-        StellarUtils::infoPrint("Network", "Account funded successfully (10,000 XLM)");
+    while (__atomic_load_n(&worker, __ATOMIC_ACQUIRE)) {
+        delay(1);
+    }
+    
+    vQueueDelete(jobs);
+    jobs = nullptr;
+    
+    STELLAR_LOGI("Network", "Worker stopped");
+}
+
+bool StellarNetwork::onWorker() const {
+    return worker && xTaskGetCurrentTaskHandle() == worker;
+}
+
+void StellarNetwork::workerTask(void* arg) {
+    static_cast<StellarNetwork*>(arg)->workerLoop();
+    vTaskDelete(nullptr);
+}
+
+void StellarNetwork::workerLoop() {
+    for (;;) {
+        NetworkFuture* job = nullptr;
+        
+        // Sin peticiones: liberar el heap de las conexiones ociosas
+        if (xQueueReceive(jobs, &job, pdMS_TO_TICKS(1000)) != pdTRUE) {
+            connections.closeIdle();
+            continue;
+        }
+        
+        if (!job) {
+            break;
+        }
+        
+        execute(*job);
+    }
+    
+    // stopWorker() espera a esto; después no se toca this
+    __atomic_store_n(&worker, nullptr, __ATOMIC_RELEASE);
+}
+
+void StellarNetwork::execute(NetworkFuture& job) {
+    job.setState(NetworkFuture::FUTURE_RUNNING);
+    
+    // Con doc la respuesta se parsea del socket; si no, va a job.response
+    String* response = job.doc ? nullptr : &job.response;
+    
+    if (job.job == NetworkFuture::JOB_CLOSE_CONNECTIONS) {
+        connections.closeAll();
+        job.success = true;
+        
+    } else if (job.envelope) {
+        Base64FormStream body("tx", job.envelope, job.envelopeLength);
+        job.success = requestWithRetry(job.url.c_str(), nullptr, &body,
+                                       response, job.doc, job.filter, job.error);
+        
     } else {
-        StellarUtils::errorPrint("Network", "Friendbot funding failed");
+        job.success = requestWithRetry(job.url.c_str(), job.post ? job.body.c_str() : nullptr, job.stream,
+                                       response, job.doc, job.filter, job.error);
     }
     
-    return success;
-}
\ No newline at end of file
+    if (job.callback) {
+        job.callback(job, job.context);
+    }
+    
+    // Tras FUTURE_DONE el dueño puede leerlo, reutilizarlo o destruirlo
+    job.setState(NetworkFuture::FUTURE_DONE);
+}
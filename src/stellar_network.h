@@ -3,9 +3,13 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WiFiClientSecure.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include "stellar_stream.h"
+#include "stellar_http_pool.h"
 
 /**
  * Cliente de red para Stellar Horizon API
@@ -15,13 +19,155 @@
  * - Llamadas HTTP GET/POST a Horizon
  * - Reintentos automáticos
  * - Manejo de errores
+ * - Conexiones HTTPS keep-alive reutilizadas entre peticiones
+ *   (ver StellarHttpPool): crear una sola instancia y mantenerla
+ * - Reanudación de sesiones TLS al reconectar (ver StellarTlsSessionCache)
+ * - Respuestas parseadas directo del socket con un filtro por endpoint
+ *   (ver las variantes con JsonDocument&): sin String con el cuerpo entero
+ *   ni DOM completo, la memoria por petición es la del documento
+ * - Peticiones asíncronas en una tarea propia (ver startWorker() y
+ *   NetworkFuture): loop() no se queda bloqueado durante los reintentos
  */
 
+// Capacidad de los JsonDocument para las respuestas filtradas.
+// Si no cabe, la petición falla con "NoMemory" (sin reintentar).
+#ifndef HORIZON_ACCOUNT_DOC_SIZE
+#define HORIZON_ACCOUNT_DOC_SIZE 2048       // ~20 balances
+#endif
+
+#ifndef HORIZON_TRANSACTION_DOC_SIZE
+#define HORIZON_TRANSACTION_DOC_SIZE 512
+#endif
+
+#ifndef HORIZON_PAYMENT_DOC_SIZE
+#define HORIZON_PAYMENT_DOC_SIZE 384        // Por registro de /payments
+#endif
+
+// Worker de red (startWorker())
+#ifndef STELLAR_NET_QUEUE_SIZE
+#define STELLAR_NET_QUEUE_SIZE 4            // Peticiones en espera
+#endif
+
+#ifndef STELLAR_NET_TASK_STACK
+#define STELLAR_NET_TASK_STACK 8192         // Handshake TLS + parseo
+#endif
+
+#ifndef STELLAR_NET_TASK_PRIORITY
+#define STELLAR_NET_TASK_PRIORITY 1         // La de loop()
+#endif
+
+#ifndef STELLAR_NET_TASK_CORE
+#define STELLAR_NET_TASK_CORE 0             // loop() corre en el core 1
+#endif
+
+#define STELLAR_NET_FILTER_SIZE 256         // Filtro propio de cada NetworkFuture
+
 enum NetworkType {
     STELLAR_TESTNET = 0,
     STELLAR_MAINNET = 1
 };
 
+class NetworkFuture;
+
+/**
+ * Fin de una petición asíncrona
+ * Se llama desde la tarea del worker (sin worker, desde la que lanzó la
+ * petición): copiar lo necesario o marcar un flag, sin bloquear ni usar
+ * el WebServer. No se llama si xxxAsync() devolvió false.
+ */
+typedef void (*NetworkCallback)(NetworkFuture& future, void* context);
+
+/**
+ * Resultado de una petición asíncrona (StellarNetwork::xxxAsync())
+ * 
+ * Lo crea quien llama y debe seguir vivo, igual que el JsonDocument de
+ * salida, hasta que isDone(): el worker escribe en ambos mientras tanto.
+ * Una vez terminado se puede reutilizar para otra petición.
+ * 
+ * Uso:
+ *   NetworkFuture request;
+ *   network.getAccountAsync(accountId, doc, request);
+ *   // en loop():
+ *   if (request.isDone() && request.succeeded()) { ... doc ... }
+ */
+class NetworkFuture {
+public:
+    NetworkFuture();
+    
+    bool isPending() const { return current() == FUTURE_QUEUED || current() == FUTURE_RUNNING; }
+    bool isDone() const { return current() == FUTURE_DONE; }
+    bool succeeded() const { return isDone() && success; }
+    
+    /**
+     * Espera a que termine cediendo la CPU
+     * 
+     * @param timeoutMs Máximo a esperar
+     * @return false si sigue en curso tras timeoutMs
+     */
+    bool wait(uint32_t timeoutMs);
+    
+    /**
+     * Callback al terminar (configurar antes de lanzar la petición)
+     */
+    void onComplete(NetworkCallback callback, void* context = nullptr);
+    
+    /**
+     * Error de la petición o string vacío
+     */
+    const String& getError() const { return error; }
+    
+    /**
+     * Cuerpo de la respuesta (httpGetAsync())
+     */
+    const String& getResponse() const { return response; }
+    
+private:
+    friend class StellarNetwork;
+    
+    enum State : uint8_t {
+        FUTURE_IDLE,
+        FUTURE_QUEUED,
+        FUTURE_RUNNING,
+        FUTURE_DONE
+    };
+    
+    enum Job : uint8_t {
+        JOB_REQUEST,
+        JOB_CLOSE_CONNECTIONS       // El pool solo se toca desde el worker
+    };
+    
+    State state;                    // Escrito con release: ver current()
+    Job job;
+    bool success;
+    bool blocking;                  // Llamada síncrona: espera hueco en la cola
+    
+    // Petición
+    String url;
+    String body;                    // POST form-encoded
+    bool post;
+    const uint8_t* envelope;        // POST tx=... (no se copia)
+    size_t envelopeLength;
+    Base64FormStream* stream;       // Solo llamadas síncronas
+    JsonDocument* doc;
+    const JsonDocument* filter;
+    StaticJsonDocument<STELLAR_NET_FILTER_SIZE> filterDoc;
+    
+    // Resultado
+    String response;
+    String error;
+    
+    NetworkCallback callback;
+    void* context;
+    
+    // Acquire: visto FUTURE_DONE, el resultado que escribió el worker también
+    State current() const { return __atomic_load_n(&state, __ATOMIC_ACQUIRE); }
+    void setState(State value) { __atomic_store_n(&state, value, __ATOMIC_RELEASE); }
+    
+    // La cola guarda su dirección: no copiable
+    NetworkFuture(const NetworkFuture&) = delete;
+    NetworkFuture& operator=(const NetworkFuture&) = delete;
+};
+
 class StellarNetwork {
 public:
     StellarNetwork(NetworkType type = STELLAR_TESTNET);
@@ -89,6 +235,37 @@ public:
      */
     String httpPost(const char* endpoint, const char* body);
     
+    /**
+     * Realiza HTTP POST a Horizon con el body generado en streaming
+     * 
+     * @param endpoint Endpoint
+     * @param body Stream del body (se rebobina en cada reintento)
+     * @return Respuesta JSON o string vacío si error
+     */
+    String httpPost(const char* endpoint, Base64FormStream& body);
+    
+    /**
+     * Realiza HTTP GET a Horizon y parsea la respuesta mientras llega
+     * 
+     * @param endpoint Endpoint
+     * @param doc Documento de salida
+     * @param filter Campos a conservar (DeserializationOption::Filter)
+     * @return true si HTTP 200 y JSON válido
+     */
+    bool httpGet(const char* endpoint, JsonDocument& doc, const JsonDocument& filter);
+    
+    /**
+     * Realiza HTTP POST con body en streaming y parsea la respuesta
+     * mientras llega
+     * 
+     * @param endpoint Endpoint
+     * @param body Stream del body (se rebobina en cada reintento)
+     * @param doc Documento de salida
+     * @param filter Campos a conservar
+     * @return true si HTTP 200 y JSON válido
+     */
+    bool httpPost(const char* endpoint, Base64FormStream& body, JsonDocument& doc, const JsonDocument& filter);
+    
     // ============================================
     // HORIZON API ESPECÍFICOS
     // ============================================
@@ -102,6 +279,17 @@ public:
      */
     String getAccount(const char* accountId);
     
+    /**
+     * Obtiene información de una cuenta, parseada en streaming
+     * Campos: id, sequence, subentry_count,
+     *         balances[] { asset_type, asset_code, balance }
+     * 
+     * @param accountId Public key de la cuenta (G...)
+     * @param doc Salida (HORIZON_ACCOUNT_DOC_SIZE)
+     * @return true si éxito
+     */
+    bool getAccount(const char* accountId, JsonDocument& doc);
+    
     /**
      * Obtiene pagos de una cuenta
      * GET /accounts/{account_id}/payments
@@ -117,6 +305,24 @@ public:
         uint8_t limit = 10
     );
     
+    /**
+     * Obtiene pagos de una cuenta, parseados en streaming
+     * Campos: _embedded.records[] { paging_token, type, from, to, amount,
+     *         asset_type, asset_code, created_at }
+     * 
+     * @param accountId Public key (G...)
+     * @param cursor Cursor para paginación (nullptr = más recientes)
+     * @param limit Número de resultados
+     * @param doc Salida (HORIZON_PAYMENT_DOC_SIZE * limit)
+     * @return true si éxito
+     */
+    bool getAccountPayments(
+        const char* accountId,
+        const char* cursor,
+        uint8_t limit,
+        JsonDocument& doc
+    );
+    
     /**
      * Envía transacción a la red
      * POST /transactions
@@ -126,6 +332,29 @@ public:
      */
     String submitTransaction(const char* txXdrBase64);
     
+    /**
+     * Envía transacción a la red desde el envelope binario
+     * El body "tx=..." se encodea (base64 + URL) directo al socket,
+     * sin construir Strings intermedios.
+     * 
+     * @param envelope TransactionEnvelope en XDR
+     * @param length Longitud del envelope
+     * @return JSON con resultado de la transacción
+     */
+    String submitTransaction(const uint8_t* envelope, size_t length);
+    
+    /**
+     * Envía transacción desde el envelope binario y parsea la respuesta
+     * en streaming
+     * Campos: hash, ledger, successful, result_xdr
+     * 
+     * @param envelope TransactionEnvelope en XDR
+     * @param length Longitud del envelope
+     * @param doc Salida (HORIZON_TRANSACTION_DOC_SIZE)
+     * @return true si Horizon aceptó la transacción
+     */
+    bool submitTransaction(const uint8_t* envelope, size_t length, JsonDocument& doc);
+    
     /**
      * Obtiene información de una transacción
      * GET /transactions/{hash}
@@ -135,6 +364,16 @@ public:
      */
     String getTransaction(const char* txHash);
     
+    /**
+     * Obtiene información de una transacción, parseada en streaming
+     * Campos: hash, ledger, successful, result_xdr
+     * 
+     * @param txHash Hash de la transacción
+     * @param doc Salida (HORIZON_TRANSACTION_DOC_SIZE)
+     * @return true si éxito
+     */
+    bool getTransaction(const char* txHash, JsonDocument& doc);
+    
     /**
      * Fondea cuenta en testnet usando Friendbot
      * Solo disponible en testnet
@@ -144,6 +383,82 @@ public:
      */
     bool fundWithFriendbot(const char* accountId);
     
+    // ============================================
+    // PETICIONES ASÍNCRONAS
+    // ============================================
+    // Vuelven al momento con la petición encolada; el resultado llega en
+    // future (y doc) cuando future.isDone(). Sin worker se ejecutan en la
+    // tarea que llama y terminan antes de volver.
+    // Devuelven false si se rechazó (argumentos, WiFi, cola llena): future
+    // ya está terminado con el error.
+    
+    /**
+     * GET a Horizon con la respuesta en future.getResponse()
+     */
+    bool httpGetAsync(const char* endpoint, NetworkFuture& future);
+    
+    /**
+     * getAccount() con doc (HORIZON_ACCOUNT_DOC_SIZE)
+     */
+    bool getAccountAsync(const char* accountId, JsonDocument& doc, NetworkFuture& future);
+    
+    /**
+     * getAccountPayments() con doc (HORIZON_PAYMENT_DOC_SIZE * limit)
+     */
+    bool getAccountPaymentsAsync(
+        const char* accountId,
+        const char* cursor,
+        uint8_t limit,
+        JsonDocument& doc,
+        NetworkFuture& future
+    );
+    
+    /**
+     * submitTransaction() con doc (HORIZON_TRANSACTION_DOC_SIZE)
+     * envelope no se copia: debe seguir vivo hasta que termine
+     */
+    bool submitTransactionAsync(const uint8_t* envelope, size_t length, JsonDocument& doc, NetworkFuture& future);
+    
+    /**
+     * getTransaction() con doc (HORIZON_TRANSACTION_DOC_SIZE)
+     */
+    bool getTransactionAsync(const char* txHash, JsonDocument& doc, NetworkFuture& future);
+    
+    /**
+     * fundWithFriendbot() con doc (solo el hash: 128 bytes bastan)
+     */
+    bool fundWithFriendbotAsync(const char* accountId, JsonDocument& doc, NetworkFuture& future);
+    
+    // ============================================
+    // WORKER
+    // ============================================
+    
+    /**
+     * Arranca la tarea que ejecuta las peticiones
+     * 
+     * Las peticiones (reintentos y backoff incluidos) corren en el worker
+     * una tras otra; los métodos síncronos las encolan y esperan. La
+     * configuración y getLastError() siguen siendo de la tarea que usa la
+     * red (loop()). Cada petición en espera ocupa solo su NetworkFuture.
+     * 
+     * @param stackSize Stack de la tarea en bytes
+     * @param priority Prioridad FreeRTOS
+     * @param core Core al que se fija (tskNO_AFFINITY = cualquiera)
+     * @return true si el worker está en marcha
+     */
+    bool startWorker(
+        uint32_t stackSize = STELLAR_NET_TASK_STACK,
+        UBaseType_t priority = STELLAR_NET_TASK_PRIORITY,
+        BaseType_t core = STELLAR_NET_TASK_CORE
+    );
+    
+    /**
+     * Termina las peticiones encoladas y para el worker
+     */
+    void stopWorker();
+    
+    bool hasWorker() const { return worker != nullptr; }
+    
     // ============================================
     // ESTADO
     // ============================================
@@ -162,6 +477,58 @@ public:
      */
     String getLastError() const { return lastError; }
     
+    // ============================================
+    // CONEXIONES
+    // ============================================
+    
+    /**
+     * Cierra las conexiones keep-alive inactivas (llamar desde loop())
+     * Con worker no hace nada: las cierra él mientras no hay peticiones
+     */
+    void closeIdleConnections() { if (!worker) connections.closeIdle(); }
+    
+    /**
+     * Cierra todas las conexiones (p.ej. antes de dormir o al perder WiFi)
+     */
+    void closeConnections();
+    
+    /**
+     * Configura cuánto tiempo se mantiene abierta una conexión sin uso
+     * 
+     * @param ms Milisegundos (default: STELLAR_HTTP_IDLE_TIMEOUT_MS)
+     */
+    void setIdleTimeout(uint32_t ms) { connections.setIdleTimeout(ms); }
+    
+    /**
+     * Contadores de reutilización del pool
+     */
+    const HttpPoolStats& getConnectionStats() const { return connections.getStats(); }
+    
+    /**
+     * Aciertos/fallos de reanudación de sesión TLS
+     */
+    const TlsSessionStats& getTlsSessionStats() const { return tlsSessions.getStats(); }
+    
+    /**
+     * Guarda las sesiones TLS en flash (reanudar tras deep sleep/reinicio)
+     * CUIDADO: sin cifrar, ver StellarTlsSessionCache
+     * 
+     * @return true si éxito
+     */
+    bool saveTlsSessions() { return tlsSessions.saveToFlash(); }
+    
+    /**
+     * Carga las sesiones TLS guardadas en flash
+     * 
+     * @return true si se cargó alguna
+     */
+    bool loadTlsSessions() { return tlsSessions.loadFromFlash(); }
+    
+    /**
+     * Caché de sesiones TLS (para conexiones propias, p.ej. StellarEventStream)
+     */
+    StellarTlsSessionCache& getTlsSessionCache() { return tlsSessions; }
+    
 private:
     NetworkType networkType;
     String horizonUrl;
@@ -169,6 +536,12 @@ private:
     uint32_t timeout;           // En milisegundos
     uint8_t maxRetries;
     String lastError;
+    StellarTlsSessionCache tlsSessions;     // Antes que el pool: sus clientes la usan
+    StellarHttpPool connections;
+    
+    // Worker (nullptr = peticiones en la tarea que llama)
+    TaskHandle_t worker;
+    QueueHandle_t jobs;             // NetworkFuture*; nullptr = parar
     
     // URLs por defecto
     static const char* TESTNET_HORIZON;
@@ -179,12 +552,35 @@ private:
     static const char* TESTNET_PASSPHRASE;
     static const char* MAINNET_PASSPHRASE;
     
-    // HTTP helpers con retry
-    String httpGetWithRetry(const char* url);
-    String httpPostWithRetry(const char* url, const char* body);
+    // Futures: preparar, rechazar, encolar y esperar (síncronos)
+    bool prepare(NetworkFuture& future);
+    bool reject(NetworkFuture& future, const char* error);
+    bool send(NetworkFuture& future, const String& endpoint);
+    bool enqueue(NetworkFuture& future);
+    bool await(NetworkFuture& future);
+    
+    // En el worker (o en línea sin él)
+    static void workerTask(void* arg);
+    void workerLoop();
+    bool onWorker() const;
+    void execute(NetworkFuture& job);
+    
+    // Reintentos comunes: respuesta en response o, con doc, parseada del socket
+    bool requestWithRetry(const char* url, const char* body, Base64FormStream* stream,
+                          String* response, JsonDocument* doc, const JsonDocument* filter,
+                          String& error);
+    
+    // Un intento sobre una conexión del pool (GET si no hay body ni stream)
+    int pooledRequest(const char* url, const char* body, Base64FormStream* stream,
+                      String* response, JsonDocument* doc, const JsonDocument* filter,
+                      String& error);
+    
+    String paymentsEndpoint(const char* accountId, const char* cursor, uint8_t limit);
     
     // Parse error desde respuesta Horizon
-    void parseError(const String& response);
+    static void parseError(const String& response, String& error);
+    static void parseError(Stream& response, String& error);
+    static void readError(JsonDocument& doc, DeserializationError result, String& error);
 };
 
 #endif // STELLAR_NETWORK_H
\ No newline at end of file
@@ -1,25 +1,36 @@
 #include "stellar_payment.h"
 #include "stellar_utils.h"
-
-// Forward declaration
-bool decodePublicKeyFromStellar(const char* stellarKey, uint8_t publicKey[32]);
+#include "stellar_xdr_schema.h"
+#include "stellar_strkey.h"
 
 // ============================================
 // CONSTRUCTOR / DESTRUCTOR
 // ============================================
 
+PaymentRequest::PaymentRequest() :
+    stage(PAYMENT_IDLE),
+    amount(0.0f),
+    envelopeSize(0) {
+    memo[0] = '\0';
+    result.success = false;
+    result.status = TX_UNKNOWN;
+    result.ledger = 0;
+    result.feeCharged = 0;
+}
+
 StellarPayment::StellarPayment(
     StellarKeypair* keypair,
     StellarNetwork* network,
     StellarAccount* account
-) {
+) : signer(keypair, network) {
     this->keypair = keypair;
     this->network = network;
     this->account = account;
     this->lastError = "";
     this->lastTxHash = "";
+    this->paymentTemplate.valid = false;
     
-    StellarUtils::infoPrint("Payment", "Payment manager initialized");
+    STELLAR_LOGI("Payment", "Payment manager initialized");
 }
 
 StellarPayment::~StellarPayment() {
@@ -39,60 +50,183 @@ PaymentResult StellarPayment::sendPayment(
     result.success = false;
     result.status = TX_UNKNOWN;
     result.ledger = 0;
+    result.feeCharged = 0;
     
-    StellarUtils::infoPrint("Payment", "Preparing payment transaction");
-    StellarUtils::debugPrint("Payment", ("To: " + String(destination)).c_str());
-    StellarUtils::debugPrint("Payment", ("Amount: " + String(amount, 7) + " XLM").c_str());
+    STELLAR_LOGI("Payment", "Preparing payment transaction");
+    STELLAR_LOGD("Payment", "To: %s", destination ? destination : "");
+    STELLAR_LOGD("Payment", "Amount: %.7f XLM", (double)amount);
     
-    // Validar parámetros
-    if (!validatePaymentParams(destination, amount, memo)) {
+    // Validar parámetros (el destino se decodifica una sola vez)
+    uint8_t destinationPublicKey[32];
+    if (!validatePaymentParams(destination, amount, memo, destinationPublicKey)) {
         result.error = lastError;
         return result;
     }
     
-    // Verificar que la cuenta fuente existe y tiene fondos
-    float balance = account->getBalance();
-    if (balance < 0) {
-        lastError = "Source account does not exist";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
+    // Construir transacción (envelope binario en stack)
+    uint8_t envelope[XDRSchema::PaymentEnvelope::MAX_SIZE];
+    size_t envelopeSize = buildPayment(destinationPublicKey, amount, memo, envelope);
+    
+    if (envelopeSize == 0) {
         result.error = lastError;
         return result;
     }
     
-    if (balance < amount + 0.00001f) {  // amount + fee
-        lastError = "Insufficient balance";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
-        result.error = lastError;
-        return result;
+    STELLAR_LOGD("Payment", "Transaction built, submitting...");
+    
+    return submitEnvelope(envelope, envelopeSize);
+}
+
+bool StellarPayment::sendPaymentAsync(
+    const char* destination,
+    float amount,
+    const char* memo,
+    PaymentRequest& request
+) {
+    // El worker todavía escribe en él
+    if (request.isPending()) {
+        STELLAR_LOGE("Payment", "Payment request already in progress");
+        return false;
     }
     
-    // Construir transacción
-    String txXdr = buildPaymentTransaction(destination, amount, memo);
+    STELLAR_LOGI("Payment", "Preparing payment transaction");
+    STELLAR_LOGD("Payment", "To: %s", destination ? destination : "");
+    STELLAR_LOGD("Payment", "Amount: %.7f XLM", (double)amount);
     
-    if (txXdr.length() == 0) {
-        result.error = lastError;
-        return result;
+    if (!validatePaymentParams(destination, amount, memo, request.destinationPublicKey)) {
+        finishPayment(request, lastError);
+        return false;
+    }
+    
+    memcpy(request.sourcePublicKey, keypair->getRawPublicKey(), 32);
+    request.amount = amount;
+    
+    size_t memoLength = memo ? strlen(memo) : 0;
+    if (memoLength > 0) {
+        memcpy(request.memo, memo, memoLength);
+    }
+    request.memo[memoLength] = '\0';
+    
+    // Balance y sequence frescos: la caché puede ser de antes del último pago
+    request.stage = PaymentRequest::PAYMENT_ACCOUNT;
+    
+    if (!network->getAccountAsync(keypair->getPublicKeyCStr(), request.doc, request.future)) {
+        lastError = "Failed to get account: " + request.future.getError();
+        finishPayment(request, lastError);
+        return false;
+    }
+    
+    return true;
+}
+
+bool StellarPayment::poll(PaymentRequest& request) {
+    if (!request.isPending()) {
+        return request.isDone();
+    }
+    
+    if (request.future.isPending()) {
+        return false;
+    }
+    
+    // Sequence y firma son de la cuenta que empezó el pago
+    if (memcmp(request.sourcePublicKey, keypair->getRawPublicKey(), 32) != 0) {
+        lastError = "Wallet changed during payment";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        finishPayment(request, lastError);
+        return true;
+    }
+    
+    if (request.stage == PaymentRequest::PAYMENT_ACCOUNT) {
+        if (!account->updateCacheFrom(request.future.succeeded(), request.doc, request.future.getError())) {
+            lastError = account->getLastError();
+            finishPayment(request, lastError);
+            return true;
+        }
+        
+        // Con la caché recién actualizada no hay más peticiones hasta el envío
+        const char* memo = request.memo[0] != '\0' ? request.memo : nullptr;
+        request.envelopeSize = buildPayment(request.destinationPublicKey, request.amount, memo, request.envelope);
+        
+        if (request.envelopeSize == 0) {
+            finishPayment(request, lastError);
+            return true;
+        }
+        
+        STELLAR_LOGD("Payment", "Transaction built, submitting...");
+        
+        request.stage = PaymentRequest::PAYMENT_SUBMIT;
+        
+        if (!network->submitTransactionAsync(request.envelope, request.envelopeSize, request.doc, request.future)) {
+            lastError = "Failed to submit transaction: " + request.future.getError();
+            finishPayment(request, lastError);
+            return true;
+        }
+        
+        return false;
     }
     
-    StellarUtils::debugPrint("Payment", "Transaction built, submitting...");
+    request.result = readSubmitResponse(request.future.succeeded(), request.doc, request.future.getError());
+    request.stage = PaymentRequest::PAYMENT_DONE;
     
-    // Enviar transacción
-    String response = network->submitTransaction(txXdr.c_str());
+    if (request.result.success) {
+        // Sequence consumido: la próxima lectura de la cuenta va a Horizon
+        account->invalidateCache();
+    }
     
-    if (response.length() == 0) {
-        lastError = "Failed to submit transaction: " + network->getLastError();
-        StellarUtils::errorPrint("Payment", lastError.c_str());
+    return true;
+}
+
+PaymentResult StellarPayment::submitTransaction(const StellarTransaction& transaction) {
+    STELLAR_LOGI("Payment", "Preparing transaction with %u operations", (unsigned)transaction.getOperationCount());
+    
+    size_t envelopeSize;
+    uint8_t* envelope = encodeTransaction(transaction, 0, &envelopeSize);
+    
+    if (!envelope) {
+        PaymentResult result;
+        result.success = false;
+        result.status = TX_UNKNOWN;
+        result.ledger = 0;
+        result.feeCharged = 0;
         result.error = lastError;
         return result;
     }
     
-    // Parsear respuesta
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, response);
+    STELLAR_LOGD("Payment", "Transaction built, submitting...");
+    
+    PaymentResult result = submitEnvelope(envelope, envelopeSize);
+    free(envelope);
+    
+    return result;
+}
+
+PaymentResult StellarPayment::submitEnvelope(const uint8_t* envelope, size_t envelopeSize) {
+    // Enviar transacción (base64 + URL encoding en streaming) y parsear
+    // la respuesta del socket: solo hash, ledger y result_xdr
+    // (el resultado se lee del result_xdr, no del JSON completo)
+    StaticJsonDocument<HORIZON_TRANSACTION_DOC_SIZE> doc;
+    
+    bool submitted = network->submitTransaction(envelope, envelopeSize, doc);
+    PaymentResult result = readSubmitResponse(submitted, doc, network->getLastError());
+    
+    if (result.success) {
+        // Refrescar caché de cuenta
+        account->refreshCache();
+    }
+    
+    return result;
+}
+
+PaymentResult StellarPayment::readSubmitResponse(bool submitted, JsonDocument& doc, const String& networkError) {
+    PaymentResult result;
+    result.success = false;
+    result.status = TX_UNKNOWN;
+    result.ledger = 0;
+    result.feeCharged = 0;
     
-    if (error) {
-        lastError = "Failed to parse submission response";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
+    if (!submitted) {
+        lastError = "Failed to submit transaction: " + networkError;
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
         result.error = lastError;
         return result;
     }
@@ -110,25 +244,34 @@ PaymentResult StellarPayment::sendPayment(
         
         lastTxHash = result.transactionHash;
         
-        StellarUtils::infoPrint("Payment", "Payment successful!");
-        StellarUtils::debugPrint("Payment", ("TX Hash: " + result.transactionHash).c_str());
+        XDRTransactionResult txResult;
+        if (decodeResultXdr(doc["result_xdr"].as<const char*>(), txResult)) {
+            result.feeCharged = txResult.feeCharged;
+            
+            if (txResult.code != TX_RESULT_SUCCESS) {
+                result.success = false;
+                result.status = TX_FAILED;
+                result.error = "Result code " + String(txResult.code);
+                
+                lastError = "Transaction failed: " + result.error;
+                STELLAR_LOGE("Payment", "%s", lastError.c_str());
+                return result;
+            }
+        }
         
-        // Refrescar caché de cuenta
-        account->refreshCache();
+        STELLAR_LOGI("Payment", "Payment successful!");
+        STELLAR_LOGD("Payment", "TX Hash: %s", result.transactionHash.c_str());
         
     } else {
         // Error
         result.success = false;
         result.status = TX_FAILED;
         
-        if (doc.containsKey("title")) {
-            result.error = doc["title"].as<String>();
-        } else {
-            result.error = "Unknown error";
-        }
+        // Los errores de Horizon (4xx) ya vienen en network->getLastError()
+        result.error = "Missing transaction hash";
         
         lastError = "Transaction failed: " + result.error;
-        StellarUtils::errorPrint("Payment", lastError.c_str());
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
     }
     
     return result;
@@ -140,58 +283,94 @@ String StellarPayment::buildPaymentTransaction(
     const char* memo,
     uint64_t sequenceNumber
 ) {
-    StellarUtils::debugPrint("Payment", "Building payment transaction");
+    uint8_t destinationPublicKey[32];
+    if (!decodeDestination(destination, destinationPublicKey)) {
+        return "";
+    }
+    
+    uint8_t envelope[XDRSchema::PaymentEnvelope::MAX_SIZE];
+    size_t envelopeSize = preparePaymentEnvelope(destinationPublicKey, amount, memo, sequenceNumber, envelope);
+    
+    if (envelopeSize == 0) {
+        return "";
+    }
+    
+    return StellarUtils::base64Encode(envelope, envelopeSize);
+}
+
+size_t StellarPayment::buildPayment(
+    const uint8_t destinationPublicKey[32],
+    float amount,
+    const char* memo,
+    uint8_t* envelope
+) {
+    // Verificar que la cuenta fuente existe y tiene fondos
+    float balance = account->getBalance();
+    if (balance < 0) {
+        lastError = "Source account does not exist";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return 0;
+    }
+    
+    if (balance < amount + 0.00001f) {  // amount + fee
+        lastError = "Insufficient balance";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return 0;
+    }
+    
+    return preparePaymentEnvelope(destinationPublicKey, amount, memo, 0, envelope);
+}
+
+size_t StellarPayment::preparePaymentEnvelope(
+    const uint8_t destinationPublicKey[32],
+    float amount,
+    const char* memo,
+    uint64_t sequenceNumber,
+    uint8_t* envelope
+) {
+    STELLAR_LOGD("Payment", "Building payment transaction");
     
     // Obtener sequence number si no se proporcionó
-    if (sequenceNumber == 0) {
-        sequenceNumber = account->getSequenceNumber();
-        
-        if (sequenceNumber == 0) {
-            lastError = "Failed to get sequence number";
-            StellarUtils::errorPrint("Payment", lastError.c_str());
-            return "";
-        }
-        
-        StellarUtils::debugPrint("Payment", 
-            ("Using sequence: " + String((unsigned long)sequenceNumber)).c_str());
-        
-        sequenceNumber++;  // IMPORTANTE: incrementar para la próxima TX
+    if (!resolveSequenceNumber(sequenceNumber)) {
+        return 0;
     }
     
     // Convertir amount a stroops
     int64_t amountStroops = StellarUtils::xlmToStroops(amount);
     
-    StellarUtils::debugPrint("Payment", 
-        ("Amount: " + String((long long)amountStroops) + " stroops").c_str());
+    STELLAR_LOGD("Payment", "Amount: %lld stroops", (long long)amountStroops);
     
     // Obtener source public key
     const uint8_t* sourcePublicKey = keypair->getRawPublicKey();
     
-    // Decodificar destination public key
-    uint8_t destinationPublicKey[32];
-    if (!decodePublicKeyFromStellar(destination, destinationPublicKey)) {
-        lastError = "Failed to decode destination address";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
-        return "";
-    }
-    
     // Construir transaction envelope
-    String txEnvelope = buildTransactionEnvelope(
+    size_t envelopeSize = buildTransactionEnvelope(
         sourcePublicKey,
         sequenceNumber,
         destinationPublicKey,
         amountStroops,
-        memo
+        memo,
+        envelope
     );
     
-    if (txEnvelope.length() == 0) {
+    if (envelopeSize == 0) {
         // lastError ya fue seteado en buildTransactionEnvelope
-        return "";
+        return 0;
     }
     
-    StellarUtils::infoPrint("Payment", "Transaction built successfully");
+    STELLAR_LOGI("Payment", "Transaction built successfully");
     
-    return txEnvelope;
+    return envelopeSize;
+}
+
+void StellarPayment::finishPayment(PaymentRequest& request, const String& error) {
+    request.result.success = false;
+    request.result.transactionHash = "";
+    request.result.status = TX_UNKNOWN;
+    request.result.error = error;
+    request.result.ledger = 0;
+    request.result.feeCharged = 0;
+    request.stage = PaymentRequest::PAYMENT_DONE;
 }
 
 // ============================================
@@ -211,17 +390,22 @@ TransactionStatus StellarPayment::getTransactionStatus(const char* txHash) {
         return TX_UNKNOWN;
     }
     
-    String response = network->getTransaction(txHash);
+    StaticJsonDocument<HORIZON_TRANSACTION_DOC_SIZE> doc;
     
-    if (response.length() == 0) {
+    if (!network->getTransaction(txHash, doc)) {
         return TX_UNKNOWN;
     }
     
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, response);
-    
-    if (error) {
-        return TX_UNKNOWN;
+    return readTransactionStatus(doc);
+}
+
+TransactionStatus StellarPayment::readTransactionStatus(JsonDocument& doc) {
+    // Preferir el resultado XDR: es la fuente de verdad de la red
+    XDRTransactionResult txResult;
+    if (decodeResultXdr(doc["result_xdr"].as<const char*>(), txResult)) {
+        bool successful = (txResult.code == TX_RESULT_SUCCESS ||
+                           txResult.code == TX_RESULT_FEE_BUMP_INNER_SUCCESS);
+        return successful ? TX_SUCCESS : TX_FAILED;
     }
     
     if (doc.containsKey("successful")) {
@@ -239,234 +423,428 @@ TransactionStatus StellarPayment::getTransactionStatus(const char* txHash) {
 bool StellarPayment::validatePaymentParams(
     const char* destination,
     float amount,
-    const char* memo
+    const char* memo,
+    uint8_t destinationPublicKey[32]
 ) {
-    // Validar destination
-    if (!destination || !StellarUtils::isValidAddress(destination)) {
-        lastError = "Invalid destination address";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
-        return false;
-    }
-    
-    if (destination[0] != 'G') {
-        lastError = "Destination must be a public key (starts with G)";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
+    // Validar y decodificar destination
+    if (!decodeDestination(destination, destinationPublicKey)) {
         return false;
     }
     
     // Validar amount
     if (!StellarUtils::isValidAmount(amount)) {
         lastError = "Invalid amount (must be positive and <= 922337203685.4775807 XLM)";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
         return false;
     }
     
     // Validar memo
     if (memo && !StellarUtils::isValidMemo(memo)) {
         lastError = "Memo too long (max 28 bytes)";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
         return false;
     }
     
     return true;
 }
 
-// ============================================
-// HELPER: Decodificar Public Key Stellar
-// ============================================
-
-bool decodePublicKeyFromStellar(const char* stellarKey, uint8_t publicKey[32]) {
-    // Esta función decodifica una clave pública Stellar (G...) a bytes
-    // Usa el mismo algoritmo que en stellar_keypair.cpp
-    
-    if (!stellarKey || strlen(stellarKey) != 56 || stellarKey[0] != 'G') {
+bool StellarPayment::decodeDestination(const char* destination, uint8_t publicKey[32]) {
+    if (destination && destination[0] != 'G' && destination[0] != '\0') {
+        lastError = "Destination must be a public key (starts with G)";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
         return false;
     }
     
-    // Tabla inversa base32
-    static const char STELLAR_BASE32_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    if (!StellarStrKey::decode(destination, STRKEY_ACCOUNT_ID, publicKey)) {
+        lastError = "Invalid destination address";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return false;
+    }
     
-    auto base32Index = [](char c) -> int {
-        if (c >= 'A' && c <= 'Z') return c - 'A';
-        if (c >= '2' && c <= '7') return c - '2' + 26;
-        return -1;
-    };
+    return true;
+}
+
+bool StellarPayment::resolveSequenceNumber(uint64_t& sequenceNumber) {
+    if (sequenceNumber != 0) {
+        return true;
+    }
     
-    // Decodificar base32
-    uint8_t decoded[35];
-    int decodedIdx = 0;
-    uint32_t buffer = 0;
-    int bitsLeft = 0;
+    sequenceNumber = account->getSequenceNumber();
     
-    for (size_t i = 0; i < 56; i++) {
-        int idx = base32Index(stellarKey[i]);
-        if (idx < 0) return false;
-        
-        buffer = (buffer << 5) | idx;
-        bitsLeft += 5;
-        
-        if (bitsLeft >= 8) {
-            decoded[decodedIdx++] = (buffer >> (bitsLeft - 8)) & 0xFF;
-            bitsLeft -= 8;
-        }
+    if (sequenceNumber == 0) {
+        lastError = "Failed to get sequence number";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return false;
     }
     
-    if (decodedIdx != 35) {
+    STELLAR_LOGD("Payment", "Using sequence: %llu", (unsigned long long)sequenceNumber);
+    
+    sequenceNumber++;  // IMPORTANTE: incrementar para la próxima TX
+    return true;
+}
+
+bool StellarPayment::decodeResultXdr(const char* resultXdr, XDRTransactionResult& result) {
+    if (!resultXdr || strlen(resultXdr) == 0) {
         return false;
     }
     
-    // Verificar checksum
-    uint16_t expectedChecksum = StellarUtils::crc16XModem(decoded, 33);
-    uint16_t actualChecksum = decoded[33] | (decoded[34] << 8);
+    // Un TransactionResult de pocas operaciones cabe holgado en 256 bytes;
+    // solo los resultados de transacciones multi-operación van al heap
+    uint8_t stackBuffer[256];
+    size_t capacity = (strlen(resultXdr) / 4) * 3;
+    uint8_t* buffer = capacity <= sizeof(stackBuffer) ? stackBuffer : (uint8_t*)malloc(capacity);
+    size_t length;
     
-    if (expectedChecksum != actualChecksum) {
+    if (!buffer) {
+        STELLAR_LOGE("Payment", "Out of memory decoding result_xdr");
         return false;
     }
     
-    // Verificar version byte (debe ser 0x30 para public key)
-    if (decoded[0] != 0x30) {
-        return false;
+    bool ok = XDRDecoder::decodeBase64(resultXdr, buffer, capacity, &length);
+    
+    if (ok) {
+        XDRDecoder decoder(buffer, length);
+        ok = decoder.decodeTransactionResult(result);
+    } else {
+        STELLAR_LOGE("Payment", "Invalid result_xdr");
     }
     
-    // Copiar los 32 bytes de la clave pública
-    memcpy(publicKey, decoded + 1, 32);
+    if (buffer != stackBuffer) {
+        free(buffer);
+    }
     
-    return true;
+    return ok;
 }
 
-String StellarPayment::buildTransactionEnvelope(
+size_t StellarPayment::buildTransactionEnvelope(
     const uint8_t* sourcePublicKey,
     uint64_t sequenceNumber,
     const uint8_t* destinationPublicKey,
     int64_t amountStroops,
-    const char* memo
+    const char* memo,
+    uint8_t* envelope
 ) {
-    StellarUtils::debugPrint("Payment", "Building transaction envelope");
+    STELLAR_LOGD("Payment", "Building transaction envelope");
+    
+    // Memo (máximo MAX_MEMO_LENGTH bytes)
+    size_t memoLength = memo ? strlen(memo) : 0;
+    if (memoLength > MAX_MEMO_LENGTH) {
+        lastError = "Memo too long (max 28 bytes)";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return 0;
+    }
+    
+    if (memcmp(sourcePublicKey, keypair->getRawPublicKey(), 32) != 0) {
+        lastError = "Source account does not match keypair";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return 0;
+    }
+    
+    if (!ensurePaymentTemplate()) {
+        return 0;
+    }
+    
+    const PaymentTemplate& tpl = paymentTemplate;
     
     // ============================================
-    // PASO 1: Construir Transaction
+    // PASO 1: Copiar template y parchear campos variables
     // ============================================
     
-    XDREncoder txEncoder;
+    XDRSchema::Memo::Value txMemo;
+    txMemo.type = memoLength > 0 ? MEMO_TEXT : MEMO_NONE;
+    txMemo.text.data = (const uint8_t*)memo;
+    txMemo.text.length = memoLength;
+    txMemo.id = 0;
+    txMemo.hash = nullptr;
     
-    // Source Account (MuxedAccount)
-    txEncoder.encodeUint32(0);  // KEY_TYPE_ED25519
-    txEncoder.append(sourcePublicKey, 32);
+    // Todo lo posterior al memo se desplaza según su tamaño real
+    size_t memoSize = XDRSchema::Memo::size(txMemo);
+    size_t shift = memoSize - 4;
+    size_t tailOffset = tpl.memoOffset + 4;
     
-    // Fee (en stroops)
-    txEncoder.encodeUint32(BASE_FEE);
+    memcpy(envelope, tpl.data, tpl.memoOffset);
+    XDRSchema::Memo::write(envelope + tpl.memoOffset, txMemo);
+    memcpy(envelope + tpl.memoOffset + memoSize, tpl.data + tailOffset, tpl.size - tailOffset);
     
-    // Sequence Number
-    txEncoder.encodeUint64(sequenceNumber);
+    XDRSchema::putUint64(envelope + tpl.sequenceOffset, sequenceNumber);
+    memcpy(envelope + tpl.destinationOffset + shift, destinationPublicKey, 32);
+    XDRSchema::putUint64(envelope + tpl.amountOffset + shift, (uint64_t)amountStroops);
     
-    // Time Bounds (opcional, usamos None)
-    txEncoder.encodeBool(false);  // No time bounds
+    size_t txSize = tpl.size + shift;
     
-    // Memo
-    if (memo && strlen(memo) > 0) {
-        txEncoder.encodeMemo(MEMO_TEXT, memo);
-    } else {
-        txEncoder.encodeMemo(MEMO_NONE);
-    }
+    // ============================================
+    // PASO 2: Transaction Hash
+    // ============================================
     
-    // Operations (array de 1 elemento)
-    txEncoder.encodeUint32(1);  // 1 operation
+    // Hash = SHA256(network_id + ENVELOPE_TYPE_TX + transaction)
+    // El envelope empieza con esos mismos bytes (ENVELOPE_TYPE_TX + transaction)
+    SHA256 sha;
+    signer.beginTransactionHash(sha);
+    sha.update(envelope, txSize);
     
-    // Source Account para la operación (opcional, None = usar source de TX)
-    txEncoder.encodeBool(false);  // No source account override
+    uint8_t txHash[32];
+    sha.finalize(txHash, 32);
+    
+    STELLAR_LOGD("Payment", "Transaction size: %u bytes", (unsigned)(txSize - 4));
+    STELLAR_LOGD_HEX("Payment", "TX Hash: ", txHash, 32);
     
-    // Operation Body
-    txEncoder.encodeUint32(PAYMENT);  // Operation type
+    // ============================================
+    // PASO 3: Firmar Transaction
+    // ============================================
     
-    // Payment Operation
-    txEncoder.encodePaymentOp(destinationPublicKey, amountStroops);
+    uint8_t signature[64];
+    if (!signer.sign(txHash, 32, signature)) {
+        lastError = "Failed to sign transaction";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return 0;
+    }
     
-    // Extension (reserved for future use)
-    txEncoder.encodeUint32(0);  // No extension
+    STELLAR_LOGD("Payment", "Transaction signed");
     
     // ============================================
-    // PASO 2: Calcular Transaction Hash
+    // PASO 4: Completar Transaction Envelope
     // ============================================
     
-    const uint8_t* txData = txEncoder.getData();
-    size_t txSize = txEncoder.getSize();
+    XDRSchema::DecoratedSignature::Value decorated;
+    decorated.hint = sourcePublicKey + 28;  // Últimos 4 bytes de la public key
+    decorated.signature = signature;
     
-    StellarUtils::debugPrint("Payment", 
-        ("Transaction size: " + String(txSize) + " bytes").c_str());
+    uint8_t* out = XDRSchema::putUint32(envelope + txSize, 1);  // 1 firma
+    out = XDRSchema::DecoratedSignature::write(out, decorated);
     
-    // Hash = SHA256(ENVELOPE_TYPE_TX + network_id + transaction)
-    // donde network_id = SHA256(passphrase)
-    const char* passphrase = network->getNetworkPassphrase();
+    size_t envelopeSize = out - envelope;
+    
+    STELLAR_LOGD("Payment", "Envelope size: %u bytes", (unsigned)envelopeSize);
+    
+    return envelopeSize;
+}
 
-    // 1. Calcular network_id = SHA256(passphrase)
-    uint8_t networkId[32];
-    StellarCrypto::sha256((const uint8_t*)passphrase, strlen(passphrase), networkId);
+bool StellarPayment::ensurePaymentTemplate() {
+    const uint8_t* sourcePublicKey = keypair->getRawPublicKey();
+    
+    if (paymentTemplate.valid &&
+        memcmp(paymentTemplate.sourcePublicKey, sourcePublicKey, 32) == 0) {
+        return true;
+    }
+    
+    STELLAR_LOGD("Payment", "Building payment template");
+    
+    PaymentTemplate& tpl = paymentTemplate;
+    tpl.valid = false;
+    
+    memcpy(tpl.sourcePublicKey, sourcePublicKey, 32);
+    
+    // Transaction de pago con campos variables en cero;
+    // los offsets se registran mientras se encodea
+    static const uint8_t ZERO_KEY[32] = {0};
+    
+    XDRSchema::MuxedAccount::Value source;
+    source.ed25519 = sourcePublicKey;
+    source.muxed = false;
+    source.id = 0;
+    
+    XDRSchema::Preconditions::Value cond;
+    cond.hasTimeBounds = false;  // Sin time bounds
+    cond.minTime = 0;
+    cond.maxTime = 0;
+    
+    XDRSchema::Memo::Value memo;
+    memo.type = MEMO_NONE;
+    memo.text.data = nullptr;
+    memo.text.length = 0;
+    memo.id = 0;
+    memo.hash = nullptr;
+    
+    XDRSchema::MuxedAccount::Value destination;
+    destination.ed25519 = ZERO_KEY;
+    destination.muxed = false;
+    destination.id = 0;
+    
+    XDRSchema::Asset::Value asset;
+    asset.type = ASSET_TYPE_NATIVE;
+    asset.issuer = nullptr;
+    
+    XDREncoder encoder(tpl.data, sizeof(tpl.data));
+    
+    encoder.encodeUint32(ENVELOPE_TYPE_TX);
+    XDRSchema::encode<XDRSchema::MuxedAccount>(encoder, source);
+    encoder.encodeUint32(BASE_FEE);
+    
+    tpl.sequenceOffset = encoder.getSize();
+    encoder.encodeUint64(0);
+    XDRSchema::encode<XDRSchema::Preconditions>(encoder, cond);
+    
+    tpl.memoOffset = encoder.getSize();
+    XDRSchema::encode<XDRSchema::Memo>(encoder, memo);
+    
+    encoder.encodeUint32(1);        // 1 operation
+    encoder.encodeBool(false);      // Sin source account override
+    encoder.encodeUint32(PAYMENT);
+    
+    tpl.destinationOffset = encoder.getSize() + 4;  // Después del key type
+    XDRSchema::encode<XDRSchema::MuxedAccount>(encoder, destination);
+    XDRSchema::encode<XDRSchema::Asset>(encoder, asset);
+    
+    tpl.amountOffset = encoder.getSize();
+    encoder.encodeInt64(0);
+    
+    encoder.encodeUint32(0);        // Extension
+    
+    if (encoder.hasOverflow()) {
+        lastError = "Payment template exceeds XDR buffer";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return false;
+    }
+    
+    tpl.size = encoder.getSize();
+    tpl.valid = true;
+    
+    return true;
+}
 
-    // 2. Construir tagged hash: networkId (32 bytes) + ENVELOPE_TYPE_TX (4 bytes) + tx
-    uint8_t envelopeTypePrefix[4] = {0x00, 0x00, 0x00, 0x02};  // ENVELOPE_TYPE_TX = 2
+String StellarPayment::buildTransaction(
+    const StellarTransaction& transaction,
+    uint64_t sequenceNumber
+) {
+    size_t envelopeSize;
+    uint8_t* envelope = encodeTransaction(transaction, sequenceNumber, &envelopeSize);
+    
+    if (!envelope) {
+        return "";
+    }
+    
+    String base64Envelope = StellarUtils::base64Encode(envelope, envelopeSize);
+    free(envelope);
+    
+    return base64Envelope;
+}
 
-    // 3. Calcular hash combinando los tres componentes (orden: networkId + type + tx)
-    size_t hashInputSize = 32 + 4 + txSize;
-    uint8_t* hashInput = new uint8_t[hashInputSize];
-    memcpy(hashInput, networkId, 32);
-    memcpy(hashInput + 32, envelopeTypePrefix, 4);
-    memcpy(hashInput + 36, txData, txSize);
+uint8_t* StellarPayment::encodeTransaction(
+    const StellarTransaction& transaction,
+    uint64_t sequenceNumber,
+    size_t* envelopeSize
+) {
+    STELLAR_LOGD("Payment", "Building multi-operation transaction");
+    
+    uint32_t operationCount = transaction.getOperationCount();
+    
+    if (operationCount == 0 || operationCount > StellarTransaction::MAX_OPERATIONS) {
+        lastError = "Transaction must have 1-100 operations";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return nullptr;
+    }
+    
+    if (!resolveSequenceNumber(sequenceNumber)) {
+        return nullptr;
+    }
+    
+    const uint8_t* sourcePublicKey = keypair->getRawPublicKey();
+    
+    XDRSchema::MultiOpTransaction::Value tx;
+    tx.sourceAccount.ed25519 = sourcePublicKey;
+    tx.sourceAccount.muxed = false;
+    tx.sourceAccount.id = 0;
+    tx.fee = BASE_FEE * operationCount;  // Fee mínimo por operación
+    tx.sequenceNumber = (int64_t)sequenceNumber;
+    tx.cond.hasTimeBounds = false;
+    tx.cond.minTime = 0;
+    tx.cond.maxTime = 0;
+    transaction.fillTransaction(tx);
+    
+    // Tamaño exacto conocido de antemano: una sola reserva en heap
+    // (100 operaciones no caben en stack)
+    size_t capacity = 4 + XDRSchema::MultiOpTransaction::size(tx) +
+                      4 + XDRSchema::DecoratedSignature::MAX_SIZE;
+    
+    uint8_t* envelope = (uint8_t*)malloc(capacity);
+    if (!envelope) {
+        lastError = "Out of memory building transaction";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return nullptr;
+    }
+    
+    // El envelope empieza con los mismos bytes que se hashean
+    // (ENVELOPE_TYPE_TX + transaction), así que se encodea una sola vez en su
+    // lugar final y el hash se alimenta mientras se escribe
+    SHA256 sha;
+    signer.beginTransactionHash(sha);
+    
+    XDREncoder envelopeEncoder(envelope, capacity);
+    envelopeEncoder.setHashSink(&sha);
+    
+    envelopeEncoder.encodeUint32(ENVELOPE_TYPE_TX);
+    XDRSchema::encode<XDRSchema::MultiOpTransaction>(envelopeEncoder, tx);
+    
+    if (!signEnvelope(envelopeEncoder, sha, sourcePublicKey)) {
+        free(envelope);
+        return nullptr;
+    }
+    
+    *envelopeSize = envelopeEncoder.getSize();
+    
+    STELLAR_LOGI("Payment", "Transaction built successfully");
+    
+    return envelope;
+}
 
+bool StellarPayment::signEnvelope(
+    XDREncoder& envelopeEncoder,
+    SHA256& sha,
+    const uint8_t* sourcePublicKey
+) {
+    envelopeEncoder.setHashSink(nullptr);
+    
+    if (envelopeEncoder.hasOverflow()) {
+        lastError = "Transaction exceeds XDR buffer";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return false;
+    }
+    
+    // ============================================
+    // Transaction Hash (ya alimentado)
+    // ============================================
+    
+    STELLAR_LOGD("Payment", "Transaction size: %u bytes", (unsigned)(envelopeEncoder.getSize() - 4));
+    
     uint8_t txHash[32];
-    StellarCrypto::sha256(hashInput, hashInputSize, txHash);
-    delete[] hashInput;
+    sha.finalize(txHash, 32);
     
-    StellarUtils::debugPrint("Payment", 
-        ("TX Hash: " + StellarUtils::hexEncode(txHash, 32)).c_str());
+    STELLAR_LOGD_HEX("Payment", "TX Hash: ", txHash, 32);
     
     // ============================================
-    // PASO 3: Firmar Transaction
+    // Firmar Transaction
     // ============================================
     
     uint8_t signature[64];
-    if (!keypair->sign(txHash, 32, signature)) {
+    if (!signer.sign(txHash, 32, signature)) {
         lastError = "Failed to sign transaction";
-        StellarUtils::errorPrint("Payment", lastError.c_str());
-        return "";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return false;
     }
     
-    StellarUtils::debugPrint("Payment", "Transaction signed");
+    STELLAR_LOGD("Payment", "Transaction signed");
     
     // ============================================
-    // PASO 4: Construir Transaction Envelope
+    // Completar Transaction Envelope
     // ============================================
     
-    XDREncoder envelopeEncoder;
-    
-    // Envelope type (ENVELOPE_TYPE_TX = 2)
-    envelopeEncoder.encodeUint32(2);
-    
-    // Transaction (copiar del txEncoder)
-    envelopeEncoder.append(txData, txSize);
-    
     // Signatures (array)
     envelopeEncoder.encodeUint32(1);  // 1 firma
     
     // Decorated Signature
-    // Hint (últimos 4 bytes de la public key)
-    envelopeEncoder.append(sourcePublicKey + 28, 4);
-    
-    // Signature (64 bytes)
-    envelopeEncoder.encodeBytes(signature, 64);
-    
-    // ============================================
-    // PASO 5: Convertir a Base64
-    // ============================================
+    XDRSchema::DecoratedSignature::Value decorated;
+    decorated.hint = sourcePublicKey + 28;  // Últimos 4 bytes de la public key
+    decorated.signature = signature;
     
-    const uint8_t* envelopeData = envelopeEncoder.getData();
-    size_t envelopeSize = envelopeEncoder.getSize();
+    XDRSchema::encode<XDRSchema::DecoratedSignature>(envelopeEncoder, decorated);
     
-    StellarUtils::debugPrint("Payment", 
-        ("Envelope size: " + String(envelopeSize) + " bytes").c_str());
-    
-    String base64Envelope = StellarUtils::base64Encode(envelopeData, envelopeSize);
+    if (envelopeEncoder.hasOverflow()) {
+        lastError = "Envelope exceeds XDR buffer";
+        STELLAR_LOGE("Payment", "%s", lastError.c_str());
+        return false;
+    }
     
-    StellarUtils::debugPrint("Payment", "Transaction envelope built successfully");
+    STELLAR_LOGD("Payment", "Envelope size: %u bytes", (unsigned)envelopeEncoder.getSize());
     
-    return base64Envelope;
-}
\ No newline at end of file
+    return true;
+}
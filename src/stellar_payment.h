@@ -7,6 +7,8 @@
 #include "stellar_account.h"
 #include "stellar_xdr.h"
 #include "stellar_crypto.h"
+#include "stellar_transaction.h"
+#include "stellar_signing.h"
 
 /**
  * Operaciones de pago en Stellar
@@ -31,6 +33,87 @@ struct PaymentResult {
     TransactionStatus status;
     String error;
     uint32_t ledger;
+    int64_t feeCharged;     // Fee cobrado en stroops (desde result_xdr)
+};
+
+/**
+ * Template de transacción de pago para una cuenta fuente
+ * 
+ * Transaction (ENVELOPE_TYPE_TX + tx) ya encodeada con source, fee,
+ * preconditions, memo NONE y cabecera de la operación. Cada pago solo
+ * copia el template y parchea sequence, destino y monto en offsets fijos.
+ */
+struct PaymentTemplate {
+    bool valid;
+    uint8_t sourcePublicKey[32];
+    
+    uint8_t data[4 + XDRSchema::PaymentTransaction::MAX_SIZE];
+    size_t size;
+    
+    // Offsets de los campos variables dentro de data
+    size_t sequenceOffset;
+    size_t memoOffset;          // Memo NONE (4 bytes) en el template
+    size_t destinationOffset;
+    size_t amountOffset;
+};
+
+/**
+ * Pago en curso de StellarPayment::sendPaymentAsync()
+ * 
+ * Dos peticiones en el worker de red: la cuenta fuente (balance y
+ * sequence frescos) y el envío. Entre ambas, poll() construye y firma la
+ * transacción en la tarea que lo llama. Lo crea quien llama y debe seguir
+ * vivo hasta que isDone(); después se puede reutilizar.
+ * 
+ * Uso:
+ *   PaymentRequest request;
+ *   payment.sendPaymentAsync(destination, amount, memo, request);
+ *   // en loop():
+ *   if (request.isPending() && payment.poll(request)) { ... request.getResult() ... }
+ */
+class PaymentRequest {
+public:
+    PaymentRequest();
+    
+    bool isPending() const { return stage == PAYMENT_ACCOUNT || stage == PAYMENT_SUBMIT; }
+    bool isDone() const { return stage == PAYMENT_DONE; }
+    
+    /**
+     * Resultado del pago (válido cuando isDone())
+     */
+    const PaymentResult& getResult() const { return result; }
+    
+private:
+    friend class StellarPayment;
+    
+    enum Stage : uint8_t {
+        PAYMENT_IDLE,
+        PAYMENT_ACCOUNT,                // Consultando la cuenta fuente
+        PAYMENT_SUBMIT,                 // Enviando la transacción
+        PAYMENT_DONE
+    };
+    
+    Stage stage;
+    
+    // Pago pedido
+    uint8_t sourcePublicKey[32];        // Si cambia el keypair, se aborta
+    uint8_t destinationPublicKey[32];
+    float amount;
+    char memo[29];                      // Máx 28 bytes; vacío = sin memo
+    
+    // Envelope firmado: el worker lo lee durante el envío
+    uint8_t envelope[XDRSchema::PaymentEnvelope::MAX_SIZE];
+    size_t envelopeSize;
+    
+    // Respuesta de la cuenta y luego la del envío
+    StaticJsonDocument<HORIZON_ACCOUNT_DOC_SIZE> doc;
+    NetworkFuture future;
+    
+    PaymentResult result;
+    
+    // El worker escribe en future y doc: no copiable
+    PaymentRequest(const PaymentRequest&) = delete;
+    PaymentRequest& operator=(const PaymentRequest&) = delete;
 };
 
 class StellarPayment {
@@ -60,6 +143,32 @@ public:
         const char* memo = nullptr
     );
     
+    /**
+     * Envía un pago simple en XLM sin bloquear
+     * Las peticiones corren en el worker de red (ver
+     * StellarNetwork::startWorker()); avanzar con poll()
+     * 
+     * @param destination Public key destino (G...)
+     * @param amount Cantidad en XLM (float)
+     * @param memo Memo de texto (opcional, máx 28 bytes)
+     * @param request Estado del pago (no debe estar en curso)
+     * @return false si se rechazó: request ya terminado con el error
+     */
+    bool sendPaymentAsync(
+        const char* destination,
+        float amount,
+        const char* memo,
+        PaymentRequest& request
+    );
+    
+    /**
+     * Avanza un pago de sendPaymentAsync() (llamar desde loop())
+     * 
+     * @param request Pago en curso
+     * @return true si terminó: resultado en request.getResult()
+     */
+    bool poll(PaymentRequest& request);
+    
     /**
      * Construye transacción de pago (sin enviar)
      * Útil para inspección o firma offline
@@ -77,6 +186,27 @@ public:
         uint64_t sequenceNumber = 0
     );
     
+    /**
+     * Firma y envía una transacción multi-operación
+     * Fee: BASE_FEE por operación
+     * 
+     * @param transaction Operaciones y memo (1-100 operaciones)
+     * @return Resultado del envío
+     */
+    PaymentResult submitTransaction(const StellarTransaction& transaction);
+    
+    /**
+     * Construye y firma una transacción multi-operación (sin enviar)
+     * 
+     * @param transaction Operaciones y memo
+     * @param sequenceNumber Sequence number (0 = auto)
+     * @return XDR del envelope en base64
+     */
+    String buildTransaction(
+        const StellarTransaction& transaction,
+        uint64_t sequenceNumber = 0
+    );
+    
     // ============================================
     // ESTADO DE TRANSACCIONES
     // ============================================
@@ -103,6 +233,15 @@ public:
      */
     TransactionStatus getTransactionStatus(const char* txHash);
     
+    /**
+     * Estado de una transacción ya consultada
+     * (respuesta de getTransaction()/getTransactionAsync())
+     * 
+     * @param doc Respuesta de Horizon (HORIZON_TRANSACTION_DOC_SIZE)
+     * @return Estado de la transacción
+     */
+    static TransactionStatus readTransactionStatus(JsonDocument& doc);
+    
     /**
      * Obtiene último error
      * 
@@ -114,6 +253,7 @@ private:
     StellarKeypair* keypair;
     StellarNetwork* network;
     StellarAccount* account;
+    SigningContext signer;
     String lastError;
     String lastTxHash;
     
@@ -122,24 +262,82 @@ private:
     static const uint32_t MAX_MEMO_LENGTH = 28;
     
     // Helpers privados
+    // Valida los parámetros y decodifica el destino (G...)
     bool validatePaymentParams(
         const char* destination,
         float amount,
-        const char* memo
+        const char* memo,
+        uint8_t destinationPublicKey[32]
     );
     
-    String buildTransactionEnvelope(
+    // Decodifica un destino G...; setea lastError si no es válido
+    bool decodeDestination(const char* destination, uint8_t publicKey[32]);
+    
+    // Escribe el envelope firmado de un pago en 'envelope'
+    // (PaymentEnvelope::MAX_SIZE bytes); devuelve su tamaño o 0 si error
+    size_t buildTransactionEnvelope(
         const uint8_t* sourcePublicKey,
         uint64_t sequenceNumber,
         const uint8_t* destinationPublicKey,
         int64_t amountStroops,
-        const char* memo
+        const char* memo,
+        uint8_t* envelope
+    );
+    
+    // Comprueba el balance y construye el envelope con la caché de la
+    // cuenta (tamaño o 0 si error)
+    size_t buildPayment(
+        const uint8_t destinationPublicKey[32],
+        float amount,
+        const char* memo,
+        uint8_t* envelope
+    );
+    
+    // Sequence, destino y envelope de un pago (tamaño o 0 si error)
+    size_t preparePaymentEnvelope(
+        const uint8_t destinationPublicKey[32],
+        float amount,
+        const char* memo,
+        uint64_t sequenceNumber,
+        uint8_t* envelope
     );
     
+    // Envelope firmado de una transacción multi-operación en heap
+    // (el llamador libera con free); nullptr si error
+    uint8_t* encodeTransaction(
+        const StellarTransaction& transaction,
+        uint64_t sequenceNumber,
+        size_t* envelopeSize
+    );
+    
+    // Template de pagos para el keypair y la red actuales
+    PaymentTemplate paymentTemplate;
+    
+    // Construye el template si falta o si cambió el keypair
+    bool ensurePaymentTemplate();
+    
+    // Obtiene el siguiente sequence number de la cuenta si no se dio uno
+    bool resolveSequenceNumber(uint64_t& sequenceNumber);
+    
+    // Cierra el hash, firma y agrega la firma al envelope
+    bool signEnvelope(XDREncoder& envelopeEncoder, SHA256& sha, const uint8_t* sourcePublicKey);
+    
+    // Envía un envelope ya firmado y procesa la respuesta de Horizon
+    PaymentResult submitEnvelope(const uint8_t* envelope, size_t envelopeSize);
+    
+    // Resultado de un envío a partir de la respuesta de Horizon
+    PaymentResult readSubmitResponse(bool submitted, JsonDocument& doc, const String& networkError);
+    
+    // Termina un pago asíncrono con error
+    void finishPayment(PaymentRequest& request, const String& error);
+    
     String signTransaction(
         const uint8_t* transactionHash,
         const uint8_t signature[64]
     );
+    
+    // Decodifica result_xdr (base64) sin pasar por un documento JSON grande
+    static bool decodeResultXdr(const char* resultXdr, XDRTransactionResult& result);
 };
 
 #endif // STELLAR_PAYMENT_H
\ No newline at end of file
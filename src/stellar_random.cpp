@@ -0,0 +1,212 @@
+#include "stellar_random.h"
+#include "stellar_utils.h"
+#include <ChaCha.h>
+#include <SHA256.h>
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// ============================================
+// FUENTES DE ENTROPÍA
+// ============================================
+
+bool HardwareEntropySource::getEntropy(uint8_t* buffer, size_t length) {
+    esp_fill_random(buffer, length);
+    return true;
+}
+
+DeterministicEntropySource::DeterministicEntropySource(const uint8_t* seed, size_t seedLength)
+    : counter(0) {
+    SHA256 sha;
+    sha.update(seed, seedLength);
+    sha.finalize(this->seed, 32);
+}
+
+DeterministicEntropySource::~DeterministicEntropySource() {
+    StellarUtils::secureZero(seed, sizeof(seed));
+}
+
+bool DeterministicEntropySource::getEntropy(uint8_t* buffer, size_t length) {
+    uint8_t block[32];
+
+    while (length > 0) {
+        uint8_t counterBytes[4] = {
+            (uint8_t)(counter >> 24),
+            (uint8_t)(counter >> 16),
+            (uint8_t)(counter >> 8),
+            (uint8_t)counter
+        };
+        counter++;
+
+        SHA256 sha;
+        sha.update(seed, 32);
+        sha.update(counterBytes, 4);
+        sha.finalize(block, 32);
+
+        size_t chunk = length < 32 ? length : 32;
+        memcpy(buffer, block, chunk);
+        buffer += chunk;
+        length -= chunk;
+    }
+
+    StellarUtils::secureZero(block, sizeof(block));
+    return true;
+}
+
+// ============================================
+// ESTADO DEL DRBG
+// ============================================
+
+static const size_t DRBG_KEY_SIZE = 32;
+
+static HardwareEntropySource hardwareSource;
+static EntropySource* entropySource = &hardwareSource;
+
+static uint8_t drbgKey[DRBG_KEY_SIZE];
+static uint8_t pool[STELLAR_RANDOM_POOL_SIZE];
+static size_t poolPosition = STELLAR_RANDOM_POOL_SIZE;  // Vacío
+
+static bool seeded = false;
+static uint32_t bytesSinceReseed = 0;
+static uint32_t lastReseedMillis = 0;
+static uint32_t reseedCount = 0;
+
+// Nuevo bloque de keystream; su inicio reemplaza la clave (borrado rápido)
+static void refillPool() {
+    static const uint8_t nonce[8] = {0};
+
+    ChaCha chacha(20);
+    chacha.setKey(drbgKey, DRBG_KEY_SIZE);
+    chacha.setIV(nonce, sizeof(nonce));
+
+    memset(pool, 0, sizeof(pool));
+    chacha.encrypt(pool, pool, sizeof(pool));
+    chacha.clear();
+
+    memcpy(drbgKey, pool, DRBG_KEY_SIZE);
+    StellarUtils::secureZero(pool, DRBG_KEY_SIZE);
+    poolPosition = DRBG_KEY_SIZE;
+}
+
+// Mutex recursivo: fill() y setEntropySource() resiembran con él tomado.
+// Se crea en el primer uso (estático local, inicialización segura entre tareas)
+static SemaphoreHandle_t drbgMutex() {
+    static SemaphoreHandle_t mutex = xSemaphoreCreateRecursiveMutex();
+    return mutex;
+}
+
+// Sección crítica del DRBG hasta salir del bloque
+class RandomLock {
+public:
+    RandomLock() : mutex(drbgMutex()) {
+        xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    }
+
+    ~RandomLock() {
+        xSemaphoreGiveRecursive(mutex);
+    }
+
+private:
+    SemaphoreHandle_t mutex;
+};
+
+static bool isReseedDue() {
+    if (!seeded || bytesSinceReseed >= STELLAR_RANDOM_RESEED_BYTES) {
+        return true;
+    }
+
+    // Con una fuente de test solo cuenta el volumen: la salida no depende del reloj
+    return entropySource == &hardwareSource &&
+           millis() - lastReseedMillis >= STELLAR_RANDOM_RESEED_MILLIS;
+}
+
+// ============================================
+// API
+// ============================================
+
+bool StellarRandom::reseed() {
+    RandomLock guard;
+
+    uint8_t entropy[DRBG_KEY_SIZE];
+
+    if (!entropySource->getEntropy(entropy, sizeof(entropy))) {
+        STELLAR_LOGE("Random", "Entropy source failed");
+        return false;
+    }
+
+    // La entropía se mezcla con la clave actual y el pool pendiente se descarta
+    for (size_t i = 0; i < DRBG_KEY_SIZE; i++) {
+        drbgKey[i] ^= entropy[i];
+    }
+    StellarUtils::secureZero(entropy, sizeof(entropy));
+
+    refillPool();
+
+    seeded = true;
+    bytesSinceReseed = 0;
+    lastReseedMillis = millis();
+    reseedCount++;
+
+    STELLAR_LOGD("Random", "DRBG reseeded (%u)", (unsigned)reseedCount);
+
+    return true;
+}
+
+void StellarRandom::fill(uint8_t* buffer, size_t length) {
+    RandomLock guard;
+
+    while (length > 0) {
+        if (isReseedDue() && !reseed()) {
+            if (!seeded) {
+                // Nunca entregar keystream de una clave sin sembrar
+                hardwareSource.getEntropy(buffer, length);
+                return;
+            }
+
+            // Se sigue con el estado actual y se reintenta en el próximo periodo
+            bytesSinceReseed = 0;
+            lastReseedMillis = millis();
+        }
+
+        if (poolPosition == STELLAR_RANDOM_POOL_SIZE) {
+            refillPool();
+        }
+
+        // La resiembra cae en el byte exacto: la salida no depende de cómo
+        // se troceen las peticiones
+        size_t chunk = STELLAR_RANDOM_POOL_SIZE - poolPosition;
+        if (chunk > length) {
+            chunk = length;
+        }
+        if (chunk > STELLAR_RANDOM_RESEED_BYTES - bytesSinceReseed) {
+            chunk = STELLAR_RANDOM_RESEED_BYTES - bytesSinceReseed;
+        }
+
+        // Lo entregado no se queda en memoria
+        memcpy(buffer, pool + poolPosition, chunk);
+        StellarUtils::secureZero(pool + poolPosition, chunk);
+
+        poolPosition += chunk;
+        bytesSinceReseed += chunk;
+        buffer += chunk;
+        length -= chunk;
+    }
+}
+
+void StellarRandom::setEntropySource(EntropySource* source) {
+    RandomLock guard;
+
+    entropySource = source ? source : &hardwareSource;
+
+    // Estado limpio: con la misma fuente determinista, la misma salida
+    StellarUtils::secureZero(drbgKey, sizeof(drbgKey));
+    StellarUtils::secureZero(pool, sizeof(pool));
+    poolPosition = STELLAR_RANDOM_POOL_SIZE;
+    seeded = false;
+
+    reseed();
+}
+
+uint32_t StellarRandom::getReseedCount() {
+    return reseedCount;
+}
@@ -0,0 +1,110 @@
+#ifndef STELLAR_RANDOM_H
+#define STELLAR_RANDOM_H
+
+#include <Arduino.h>
+
+/**
+ * Generador aleatorio (DRBG) sobre ChaCha20
+ *
+ * En lugar de pedir cada clave, salt o IV al RNG hardware, se genera un
+ * bloque de keystream ChaCha20 y se reparte desde un pool. Borrado rápido
+ * de clave: los primeros 32 bytes de cada bloque pasan a ser la nueva
+ * clave y lo entregado se borra del pool, así que capturar el estado no
+ * revela salidas anteriores.
+ *
+ * Se resiembra desde la fuente de entropía al arrancar, cada
+ * STELLAR_RANDOM_RESEED_BYTES bytes y cada STELLAR_RANDOM_RESEED_MILLIS ms.
+ * La fuente es intercambiable (determinista para tests y benchmarks).
+ *
+ * Seguro entre tareas: el estado va protegido por un mutex (la tarea de
+ * red en el core 0 también pide aleatorios para TLS).
+ */
+
+// Bytes de keystream por bloque (32 van a la clave siguiente)
+#ifndef STELLAR_RANDOM_POOL_SIZE
+#define STELLAR_RANDOM_POOL_SIZE 256
+#endif
+
+#ifndef STELLAR_RANDOM_RESEED_BYTES
+#define STELLAR_RANDOM_RESEED_BYTES 65536
+#endif
+
+#ifndef STELLAR_RANDOM_RESEED_MILLIS
+#define STELLAR_RANDOM_RESEED_MILLIS 60000
+#endif
+
+// ============================================
+// FUENTES DE ENTROPÍA
+// ============================================
+
+class EntropySource {
+public:
+    virtual ~EntropySource() {}
+
+    /**
+     * Llena buffer con entropía
+     *
+     * @return true si éxito
+     */
+    virtual bool getEntropy(uint8_t* buffer, size_t length) = 0;
+};
+
+/**
+ * RNG hardware del ESP32 (esp_fill_random)
+ * Entropía real con WiFi/BT activos o con la fuente del bootloader
+ */
+class HardwareEntropySource : public EntropySource {
+public:
+    bool getEntropy(uint8_t* buffer, size_t length) override;
+};
+
+/**
+ * Fuente reproducible para tests y benchmarks
+ * Salida = SHA256(SHA256(seed) || contador). NUNCA usar en producción
+ */
+class DeterministicEntropySource : public EntropySource {
+public:
+    DeterministicEntropySource(const uint8_t* seed, size_t seedLength);
+    ~DeterministicEntropySource();
+
+    bool getEntropy(uint8_t* buffer, size_t length) override;
+
+private:
+    uint8_t seed[32];
+    uint32_t counter;
+};
+
+// ============================================
+// DRBG
+// ============================================
+
+class StellarRandom {
+public:
+    /**
+     * Genera bytes aleatorios
+     * Resiembra automáticamente según el calendario
+     */
+    static void fill(uint8_t* buffer, size_t length);
+
+    /**
+     * Cambia la fuente de entropía y resiembra desde ella
+     * Con una fuente determinista la salida es reproducible.
+     *
+     * @param source Fuente (nullptr = hardware); debe seguir viva mientras se use
+     */
+    static void setEntropySource(EntropySource* source);
+
+    /**
+     * Fuerza una resiembra (p.ej. tras activar WiFi)
+     *
+     * @return true si la fuente entregó entropía
+     */
+    static bool reseed();
+
+    /**
+     * Reseeds hechas desde el arranque (diagnóstico)
+     */
+    static uint32_t getReseedCount();
+};
+
+#endif // STELLAR_RANDOM_H
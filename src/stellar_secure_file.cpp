@@ -0,0 +1,403 @@
+#include "stellar_secure_file.h"
+#include "stellar_utils.h"
+
+// Offsets del header
+static const size_t HEADER_VERSION_OFFSET = 4;
+static const size_t HEADER_NONCE_OFFSET = 5;
+static const size_t HEADER_SEGMENT_OFFSET = 12;
+static const size_t NONCE_PREFIX_SIZE = 7;
+
+static void writeUint32LE(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t readUint32LE(const uint8_t* in) {
+    return (uint32_t)in[0] |
+           ((uint32_t)in[1] << 8) |
+           ((uint32_t)in[2] << 16) |
+           ((uint32_t)in[3] << 24);
+}
+
+// IV = noncePrefix || índice (big-endian) || flag de último segmento
+static void segmentIV(const uint8_t header[SECURE_FILE_HEADER_SIZE], uint32_t index, bool last, uint8_t iv[12]) {
+    memcpy(iv, header + HEADER_NONCE_OFFSET, NONCE_PREFIX_SIZE);
+    iv[7] = (uint8_t)(index >> 24);
+    iv[8] = (uint8_t)(index >> 16);
+    iv[9] = (uint8_t)(index >> 8);
+    iv[10] = (uint8_t)index;
+    iv[11] = last ? 1 : 0;
+}
+
+static bool isSegmentSizeValid(size_t segmentSize) {
+    return segmentSize >= SECURE_FILE_MIN_SEGMENT_SIZE &&
+           segmentSize <= SECURE_FILE_MAX_SEGMENT_SIZE;
+}
+
+// ============================================
+// ESCRITURA
+// ============================================
+
+SecureFileWriter::SecureFileWriter()
+    : output(nullptr),
+      buffer(nullptr),
+      segmentSize(0),
+      buffered(0),
+      segmentIndex(0),
+      bytesWritten(0),
+      active(false) {
+    memset(key, 0, sizeof(key));
+    memset(header, 0, sizeof(header));
+}
+
+SecureFileWriter::~SecureFileWriter() {
+    release();
+}
+
+bool SecureFileWriter::begin(Print& output, const uint8_t key[32], size_t segmentSize) {
+    release();
+    lastError = "";
+
+    if (!isSegmentSizeValid(segmentSize)) {
+        return fail("Invalid segment size");
+    }
+
+    buffer = (uint8_t*)malloc(segmentSize + SECURE_FILE_TAG_SIZE);
+    if (!buffer) {
+        return fail("Out of memory for segment buffer");
+    }
+
+    this->output = &output;
+    this->segmentSize = segmentSize;
+    memcpy(this->key, key, 32);
+    buffered = 0;
+    segmentIndex = 0;
+    bytesWritten = 0;
+
+    // Prefijo de nonce aleatorio por archivo: la misma clave puede cifrar varios
+    writeUint32LE(header, SECURE_FILE_MAGIC);
+    header[HEADER_VERSION_OFFSET] = SECURE_FILE_VERSION;
+    StellarCrypto::randomBytes(header + HEADER_NONCE_OFFSET, NONCE_PREFIX_SIZE);
+    writeUint32LE(header + HEADER_SEGMENT_OFFSET, (uint32_t)segmentSize);
+
+    if (output.write(header, SECURE_FILE_HEADER_SIZE) != SECURE_FILE_HEADER_SIZE) {
+        return fail("Failed to write header");
+    }
+
+    active = true;
+
+    STELLAR_LOGD("SecureFile", "Writer started (%u byte segments)", (unsigned)segmentSize);
+
+    return true;
+}
+
+bool SecureFileWriter::write(const uint8_t* data, size_t length) {
+    if (!active) {
+        return fail("Writer not started");
+    }
+
+    while (length > 0) {
+        // Un segmento lleno solo se sella cuando llegan más datos:
+        // hasta entonces podría ser el último
+        if (buffered == segmentSize && !sealSegment(false)) {
+            return false;
+        }
+
+        size_t chunk = segmentSize - buffered;
+        if (chunk > length) {
+            chunk = length;
+        }
+
+        memcpy(buffer + buffered, data, chunk);
+        buffered += chunk;
+        bytesWritten += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+bool SecureFileWriter::finish() {
+    if (!active) {
+        return fail("Writer not started");
+    }
+
+    bool success = sealSegment(true);
+
+    if (success) {
+        STELLAR_LOGD("SecureFile", "Encrypted %u bytes in %u segments",
+                     (unsigned)bytesWritten, (unsigned)segmentIndex);
+    }
+
+    release();
+    return success;
+}
+
+bool SecureFileWriter::encryptStream(Stream& input, Print& output, const uint8_t key[32]) {
+    SecureFileWriter writer;
+
+    if (!writer.begin(output, key)) {
+        return false;
+    }
+
+    uint8_t chunk[128];
+
+    while (true) {
+        size_t n = input.readBytes(chunk, sizeof(chunk));
+        if (n == 0) {
+            break;
+        }
+
+        if (!writer.write(chunk, n)) {
+            StellarUtils::secureZero(chunk, sizeof(chunk));
+            return false;
+        }
+    }
+
+    StellarUtils::secureZero(chunk, sizeof(chunk));
+    return writer.finish();
+}
+
+bool SecureFileWriter::sealSegment(bool last) {
+    if (segmentIndex == UINT32_MAX) {
+        return fail("Too many segments");
+    }
+
+    uint8_t iv[12];
+    segmentIV(header, segmentIndex, last, iv);
+
+    AESGCMStream gcm;
+    gcm.begin(AESGCMStream::ENCRYPT, key, iv);
+    gcm.addAuthData(header, SECURE_FILE_HEADER_SIZE);
+    gcm.update(buffer, buffer, buffered);
+    gcm.finish(buffer + buffered);
+
+    size_t sealedLength = buffered + SECURE_FILE_TAG_SIZE;
+
+    if (output->write(buffer, sealedLength) != sealedLength) {
+        return fail("Failed to write segment");
+    }
+
+    segmentIndex++;
+    buffered = 0;
+
+    return true;
+}
+
+bool SecureFileWriter::fail(const char* message) {
+    lastError = message;
+    STELLAR_LOGE("SecureFile", "%s", message);
+    release();
+    return false;
+}
+
+void SecureFileWriter::release() {
+    if (buffer) {
+        StellarUtils::secureZero(buffer, segmentSize + SECURE_FILE_TAG_SIZE);
+        free(buffer);
+        buffer = nullptr;
+    }
+
+    StellarUtils::secureZero(key, sizeof(key));
+    output = nullptr;
+    buffered = 0;
+    active = false;
+}
+
+// ============================================
+// LECTURA
+// ============================================
+
+SecureFileReader::SecureFileReader()
+    : input(nullptr),
+      buffer(nullptr),
+      segmentSize(0),
+      segmentLength(0),
+      position(0),
+      segmentIndex(0),
+      lastSegment(false),
+      complete(false),
+      active(false) {
+    memset(key, 0, sizeof(key));
+    memset(header, 0, sizeof(header));
+}
+
+SecureFileReader::~SecureFileReader() {
+    release();
+}
+
+bool SecureFileReader::begin(Stream& input, const uint8_t key[32]) {
+    release();
+    lastError = "";
+    complete = false;
+
+    if (input.readBytes(header, SECURE_FILE_HEADER_SIZE) != SECURE_FILE_HEADER_SIZE) {
+        return fail("Truncated header");
+    }
+
+    if (readUint32LE(header) != SECURE_FILE_MAGIC) {
+        return fail("Invalid magic number");
+    }
+
+    if (header[HEADER_VERSION_OFFSET] != SECURE_FILE_VERSION) {
+        return fail("Unsupported version");
+    }
+
+    uint32_t size = readUint32LE(header + HEADER_SEGMENT_OFFSET);
+    if (!isSegmentSizeValid(size)) {
+        return fail("Invalid segment size");
+    }
+
+    buffer = (uint8_t*)malloc(size + SECURE_FILE_TAG_SIZE);
+    if (!buffer) {
+        return fail("Out of memory for segment buffer");
+    }
+
+    this->input = &input;
+    this->segmentSize = size;
+    memcpy(this->key, key, 32);
+    segmentLength = 0;
+    position = 0;
+    segmentIndex = 0;
+    lastSegment = false;
+    active = true;
+
+    return true;
+}
+
+int SecureFileReader::read(uint8_t* data, size_t length) {
+    if (complete) {
+        return 0;
+    }
+
+    if (!active) {
+        // Tras un fallo se mantiene el primer error
+        if (lastError.length() == 0) {
+            fail("Reader not started");
+        }
+        return -1;
+    }
+
+    size_t total = 0;
+
+    while (total < length) {
+        if (position == segmentLength) {
+            if (lastSegment) {
+                complete = true;
+                STELLAR_LOGD("SecureFile", "Decrypted %u segments", (unsigned)segmentIndex);
+                release();
+                break;
+            }
+
+            if (!openSegment()) {
+                return -1;
+            }
+
+            continue;
+        }
+
+        size_t chunk = segmentLength - position;
+        if (chunk > length - total) {
+            chunk = length - total;
+        }
+
+        memcpy(data + total, buffer + position, chunk);
+        position += chunk;
+        total += chunk;
+    }
+
+    return (int)total;
+}
+
+bool SecureFileReader::decryptStream(Stream& input, Print& output, const uint8_t key[32]) {
+    SecureFileReader reader;
+
+    if (!reader.begin(input, key)) {
+        return false;
+    }
+
+    uint8_t chunk[128];
+    bool success = true;
+
+    while (true) {
+        int n = reader.read(chunk, sizeof(chunk));
+
+        if (n < 0) {
+            success = false;
+            break;
+        }
+
+        if (n == 0) {
+            break;
+        }
+
+        if (output.write(chunk, n) != (size_t)n) {
+            STELLAR_LOGE("SecureFile", "Failed to write plaintext");
+            success = false;
+            break;
+        }
+    }
+
+    StellarUtils::secureZero(chunk, sizeof(chunk));
+    return success;
+}
+
+bool SecureFileReader::openSegment() {
+    if (segmentIndex == UINT32_MAX) {
+        return fail("Too many segments");
+    }
+
+    size_t sealedLength = input->readBytes(buffer, segmentSize + SECURE_FILE_TAG_SIZE);
+
+    if (sealedLength < SECURE_FILE_TAG_SIZE) {
+        return fail("Truncated file");
+    }
+
+    // Último si no llenó el segmento o no queda nada detrás
+    // (si alguien trunca el archivo, el flag del IV no coincide y el tag falla)
+    bool last = sealedLength < segmentSize + SECURE_FILE_TAG_SIZE || input->peek() < 0;
+    size_t length = sealedLength - SECURE_FILE_TAG_SIZE;
+
+    uint8_t iv[12];
+    segmentIV(header, segmentIndex, last, iv);
+
+    AESGCMStream gcm;
+    gcm.begin(AESGCMStream::DECRYPT, key, iv);
+    gcm.addAuthData(header, SECURE_FILE_HEADER_SIZE);
+    gcm.update(buffer, buffer, length);
+
+    if (!gcm.verify(buffer + length)) {
+        return fail("Segment authentication failed");
+    }
+
+    segmentIndex++;
+    segmentLength = length;
+    position = 0;
+    lastSegment = last;
+
+    return true;
+}
+
+bool SecureFileReader::fail(const char* message) {
+    lastError = message;
+    STELLAR_LOGE("SecureFile", "%s", message);
+    release();
+    return false;
+}
+
+void SecureFileReader::release() {
+    if (buffer) {
+        StellarUtils::secureZero(buffer, segmentSize + SECURE_FILE_TAG_SIZE);
+        free(buffer);
+        buffer = nullptr;
+    }
+
+    StellarUtils::secureZero(key, sizeof(key));
+    input = nullptr;
+    segmentLength = 0;
+    position = 0;
+    active = false;
+}
@@ -0,0 +1,164 @@
+#ifndef STELLAR_SECURE_FILE_H
+#define STELLAR_SECURE_FILE_H
+
+#include <Arduino.h>
+#include "stellar_crypto.h"
+
+/**
+ * Archivos cifrados por segmentos (AES-256-GCM)
+ *
+ * El plaintext se parte en segmentos de tamaño fijo y cada uno lleva su
+ * propio tag, así que se cifra y descifra con un buffer de un segmento:
+ * sirve para registros más grandes que el heap libre.
+ *
+ * Formato (little-endian):
+ *   Header (16 bytes): magic (4) | version (1) | noncePrefix (7) | segmentSize (4)
+ *   Segmentos: ciphertext (segmentSize, el último 0..segmentSize) | tag (16)
+ *
+ * IV del segmento i = noncePrefix || i (uint32 big-endian) || último (1 byte)
+ * El header va como auth data en todos los segmentos. El índice impide
+ * reordenar segmentos y el flag de último impide truncar el archivo.
+ */
+
+#define SECURE_FILE_MAGIC 0x53544C43     // "STLC" en ASCII
+#define SECURE_FILE_VERSION 1
+#define SECURE_FILE_HEADER_SIZE 16
+#define SECURE_FILE_TAG_SIZE 16
+#define SECURE_FILE_SEGMENT_SIZE 1024    // Buffer en heap: segmento + tag
+#define SECURE_FILE_MIN_SEGMENT_SIZE 64
+#define SECURE_FILE_MAX_SEGMENT_SIZE 16384
+
+// ============================================
+// ESCRITURA
+// ============================================
+
+class SecureFileWriter {
+public:
+    SecureFileWriter();
+    ~SecureFileWriter();
+
+    /**
+     * Escribe el header e inicia el cifrado
+     *
+     * @param output Destino (File de SPIFFS, cliente...)
+     * @param key Clave AES-256 (32 bytes)
+     * @param segmentSize Bytes de plaintext por segmento
+     * @return true si éxito
+     */
+    bool begin(Print& output, const uint8_t key[32], size_t segmentSize = SECURE_FILE_SEGMENT_SIZE);
+
+    /**
+     * Cifra datos; se escriben al completar cada segmento
+     */
+    bool write(const uint8_t* data, size_t length);
+
+    /**
+     * Cifra el último segmento (marcado como final)
+     * Sin finish() el archivo no se puede descifrar
+     */
+    bool finish();
+
+    /**
+     * Cifra todo un stream con un buffer de un segmento
+     *
+     * @param input Plaintext
+     * @param output Destino
+     * @param key Clave AES-256 (32 bytes)
+     * @return true si éxito
+     */
+    static bool encryptStream(Stream& input, Print& output, const uint8_t key[32]);
+
+    uint32_t getBytesWritten() const { return bytesWritten; }
+    String getLastError() const { return lastError; }
+
+private:
+    Print* output;
+    uint8_t key[32];
+    uint8_t header[SECURE_FILE_HEADER_SIZE];
+    uint8_t* buffer;          // segmentSize + tag
+    size_t segmentSize;
+    size_t buffered;
+    uint32_t segmentIndex;
+    uint32_t bytesWritten;    // Plaintext
+    bool active;
+    String lastError;
+
+    bool sealSegment(bool last);
+    bool fail(const char* message);
+    void release();
+
+    // Contiene la clave: no copiable
+    SecureFileWriter(const SecureFileWriter&) = delete;
+    SecureFileWriter& operator=(const SecureFileWriter&) = delete;
+};
+
+// ============================================
+// LECTURA
+// ============================================
+
+class SecureFileReader {
+public:
+    SecureFileReader();
+    ~SecureFileReader();
+
+    /**
+     * Lee y valida el header
+     *
+     * @param input Archivo cifrado (posicionado al inicio)
+     * @param key Clave AES-256 (32 bytes)
+     * @return true si el header es válido
+     */
+    bool begin(Stream& input, const uint8_t key[32]);
+
+    /**
+     * Lee plaintext ya autenticado
+     * Cada segmento se verifica entero antes de entregar sus bytes.
+     *
+     * @param data Buffer de salida
+     * @param length Máximo a leer
+     * @return Bytes leídos, 0 al terminar, -1 si el archivo está manipulado o truncado
+     */
+    int read(uint8_t* data, size_t length);
+
+    /**
+     * Descifra todo un stream con un buffer de un segmento
+     * Si falla, lo ya escrito en output debe descartarse.
+     *
+     * @param input Archivo cifrado
+     * @param output Destino del plaintext
+     * @param key Clave AES-256 (32 bytes)
+     * @return true si todo el archivo es auténtico
+     */
+    static bool decryptStream(Stream& input, Print& output, const uint8_t key[32]);
+
+    /**
+     * true si se leyó y verificó el segmento final
+     */
+    bool isComplete() const { return complete; }
+
+    String getLastError() const { return lastError; }
+
+private:
+    Stream* input;
+    uint8_t key[32];
+    uint8_t header[SECURE_FILE_HEADER_SIZE];
+    uint8_t* buffer;          // segmentSize + tag
+    size_t segmentSize;
+    size_t segmentLength;     // Plaintext del segmento actual
+    size_t position;
+    uint32_t segmentIndex;
+    bool lastSegment;
+    bool complete;
+    bool active;
+    String lastError;
+
+    bool openSegment();
+    bool fail(const char* message);
+    void release();
+
+    // Contiene la clave: no copiable
+    SecureFileReader(const SecureFileReader&) = delete;
+    SecureFileReader& operator=(const SecureFileReader&) = delete;
+};
+
+#endif // STELLAR_SECURE_FILE_H
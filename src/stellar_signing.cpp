@@ -0,0 +1,106 @@
+#include "stellar_signing.h"
+#include "stellar_crypto.h"
+#include "stellar_utils.h"
+
+// network_id = SHA256(passphrase) de las redes públicas
+// "Test SDF Network ; September 2015"
+static constexpr uint8_t TESTNET_NETWORK_ID[32] = {
+    0xce, 0xe0, 0x30, 0x2d, 0x59, 0x84, 0x4d, 0x32,
+    0xbd, 0xca, 0x91, 0x5c, 0x82, 0x03, 0xdd, 0x44,
+    0xb3, 0x3f, 0xbb, 0x7e, 0xdc, 0x19, 0x05, 0x1e,
+    0xa3, 0x7a, 0xbe, 0xdf, 0x28, 0xec, 0xd4, 0x72
+};
+
+// "Public Global Stellar Network ; September 2015"
+static constexpr uint8_t MAINNET_NETWORK_ID[32] = {
+    0x7a, 0xc3, 0x39, 0x97, 0x54, 0x4e, 0x31, 0x75,
+    0xd2, 0x66, 0xbd, 0x02, 0x24, 0x39, 0xb2, 0x2c,
+    0xdb, 0x16, 0x50, 0x8c, 0x01, 0x16, 0x3f, 0x26,
+    0xe5, 0xcb, 0x2a, 0x3e, 0x10, 0x45, 0xa9, 0x79
+};
+
+// ============================================
+// CONSTRUCTOR / DESTRUCTOR
+// ============================================
+
+SigningContext::SigningContext(const StellarKeypair* keypair, const StellarNetwork* network)
+    : keypair(keypair),
+      network(network),
+      hasNetworkId(false),
+      networkType(STELLAR_TESTNET),
+      hasExpandedKey(false) {
+}
+
+SigningContext::~SigningContext() {
+    StellarUtils::secureZero(&expandedKey, sizeof(expandedKey));
+}
+
+// ============================================
+// NETWORK ID
+// ============================================
+
+const uint8_t* SigningContext::networkIdFor(NetworkType type) {
+    switch (type) {
+        case STELLAR_TESTNET: return TESTNET_NETWORK_ID;
+        case STELLAR_MAINNET: return MAINNET_NETWORK_ID;
+        default:              return nullptr;
+    }
+}
+
+const uint8_t* SigningContext::getNetworkId() {
+    NetworkType type = network->getNetworkType();
+
+    if (hasNetworkId && networkType == type) {
+        return networkId;
+    }
+
+    const uint8_t* known = networkIdFor(type);
+
+    if (known) {
+        memcpy(networkId, known, 32);
+    } else {
+        const char* passphrase = network->getNetworkPassphrase();
+        StellarCrypto::sha256((const uint8_t*)passphrase, strlen(passphrase), networkId);
+    }
+
+    networkType = type;
+    hasNetworkId = true;
+
+    STELLAR_LOGD_HEX("Signing", "Network ID: ", networkId, 32);
+
+    return networkId;
+}
+
+void SigningContext::beginTransactionHash(SHA256& sha) {
+    sha.reset();
+    sha.update(getNetworkId(), 32);
+}
+
+// ============================================
+// FIRMA
+// ============================================
+
+bool SigningContext::sign(const uint8_t* data, size_t length, uint8_t signature[64]) {
+    if (!keypair) {
+        STELLAR_LOGE("Signing", "No keypair bound to signing context");
+        return false;
+    }
+
+    // SHA512(seed) una sola vez por clave: el keypair enlazado puede
+    // reemplazarse en sitio (fromSecret, deriveAccount, move)
+    if (!hasExpandedKey ||
+        memcmp(expandedKey.publicKey, keypair->getRawPublicKey(), 32) != 0) {
+        StellarEd25519::expandKey(
+            keypair->getRawSecretKey(),
+            keypair->getRawPublicKey(),
+            expandedKey
+        );
+        hasExpandedKey = true;
+
+        STELLAR_LOGD("Signing", "Signing key expanded");
+    }
+
+    StellarEd25519::sign(expandedKey, data, length, signature);
+
+    return true;
+}
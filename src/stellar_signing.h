@@ -0,0 +1,80 @@
+#ifndef STELLAR_SIGNING_H
+#define STELLAR_SIGNING_H
+
+#include <Arduino.h>
+#include <SHA256.h>
+#include "stellar_keypair.h"
+#include "stellar_network.h"
+#include "stellar_ed25519.h"
+
+/**
+ * Contexto de firma de transacciones
+ *
+ * Asociado a un keypair y una red, guarda todo lo que no cambia entre firmas:
+ * - network_id = SHA256(passphrase), constante para testnet/mainnet
+ * - Clave Ed25519 expandida (escalar + prefijo), calculada en la primera firma
+ *
+ * Así cada firma hace solo los dos SHA-512 y la multiplicación escalar
+ * propios de Ed25519, sin rehashear el passphrase ni el seed.
+ */
+class SigningContext {
+public:
+    SigningContext(const StellarKeypair* keypair, const StellarNetwork* network);
+    ~SigningContext();
+
+    /**
+     * Network id de la red actual (32 bytes)
+     * Se actualiza solo si cambia el tipo de red
+     */
+    const uint8_t* getNetworkId();
+
+    /**
+     * Inicia el hash de una transacción con el network id
+     * Hash = SHA256(network_id + ENVELOPE_TYPE_TX + transaction)
+     */
+    void beginTransactionHash(SHA256& sha);
+
+    /**
+     * Firma con la clave expandida
+     *
+     * @param data Datos a firmar (el hash de la transacción)
+     * @param length Longitud
+     * @param signature Buffer de salida (64 bytes)
+     * @return true si éxito
+     */
+    bool sign(const uint8_t* data, size_t length, uint8_t signature[64]);
+
+    /**
+     * Public key del keypair (32 bytes)
+     */
+    const uint8_t* getPublicKey() const { return keypair->getRawPublicKey(); }
+
+    /**
+     * Hint de la firma: últimos 4 bytes de la public key
+     */
+    const uint8_t* getSignatureHint() const { return keypair->getRawPublicKey() + 28; }
+
+    /**
+     * Network id precalculado de una red conocida
+     *
+     * @return 32 bytes o nullptr si no hay constante para esa red
+     */
+    static const uint8_t* networkIdFor(NetworkType type);
+
+private:
+    const StellarKeypair* keypair;
+    const StellarNetwork* network;
+
+    bool hasNetworkId;
+    NetworkType networkType;
+    uint8_t networkId[32];
+
+    bool hasExpandedKey;
+    Ed25519ExpandedKey expandedKey;
+
+    // Contiene la clave expandida: no copiable
+    SigningContext(const SigningContext&) = delete;
+    SigningContext& operator=(const SigningContext&) = delete;
+};
+
+#endif // STELLAR_SIGNING_H
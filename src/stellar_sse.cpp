@@ -0,0 +1,648 @@
+#include "stellar_sse.h"
+#include "stellar_strkey.h"
+#include "stellar_utils.h"
+
+// ============================================
+// LÍNEA "data:"
+// ============================================
+
+/**
+ * Valor de una línea "data:" leído directo del socket hasta el fin de
+ * línea, para deserializeJson(). Los bytes de un evento llegan seguidos:
+ * se espera hasta STELLAR_SSE_DATA_TIMEOUT_MS por cada uno.
+ */
+class SseDataStream : public Stream {
+public:
+    SseDataStream(Client& client, uint32_t timeoutMs)
+        : client(client), timeoutMs(timeoutMs), peeked(-1), terminator(0),
+          started(false), timedOut(false) {
+        // peek() ya espera por su cuenta
+        setTimeout(0);
+    }
+
+    int available() override {
+        return (peeked >= 0 || (!terminator && !timedOut && client.available() > 0)) ? 1 : 0;
+    }
+
+    int peek() override {
+        while (peeked < 0 && !terminator && !timedOut) {
+            int c = socketRead();
+
+            if (c < 0) {
+                timedOut = true;
+            } else if (c == '\r' || c == '\n') {
+                terminator = (char)c;
+            } else if (!started && c == ' ') {
+                // Un espacio tras ':' no es parte del valor
+                started = true;
+            } else {
+                started = true;
+                peeked = c;
+            }
+        }
+
+        return peeked;
+    }
+
+    int read() override {
+        int c = peek();
+        peeked = -1;
+        return c;
+    }
+
+    size_t write(uint8_t) override { return 0; }
+
+    /**
+     * Consume hasta el fin de línea
+     */
+    void drain() {
+        while (read() >= 0) {
+        }
+    }
+
+    /**
+     * '\r', '\n', o 0 si la línea se cortó (timeout o desconexión)
+     */
+    char lineEnd() const { return terminator; }
+
+private:
+    Client& client;
+    uint32_t timeoutMs;
+    int peeked;
+    char terminator;
+    bool started;
+    bool timedOut;
+
+    int socketRead() {
+        uint32_t start = millis();
+
+        for (;;) {
+            int c = client.read();
+
+            if (c >= 0) {
+                return c;
+            }
+
+            if (!client.connected() || millis() - start >= timeoutMs) {
+                return -1;
+            }
+
+            delay(1);
+        }
+    }
+};
+
+// ============================================
+// FILTROS DE EVENTO
+// ============================================
+// Solo estos campos de cada registro llegan al JsonDocument
+
+static void paymentFilter(JsonDocument& filter) {
+    filter["paging_token"] = true;
+    filter["type"] = true;
+    filter["from"] = true;
+    filter["to"] = true;
+    filter["amount"] = true;
+    filter["asset_type"] = true;
+    filter["asset_code"] = true;
+    filter["transaction_hash"] = true;
+    filter["created_at"] = true;
+
+    // create_account
+    filter["funder"] = true;
+    filter["account"] = true;
+    filter["starting_balance"] = true;
+}
+
+static void ledgerFilter(JsonDocument& filter) {
+    filter["paging_token"] = true;
+    filter["sequence"] = true;
+    filter["hash"] = true;
+    filter["closed_at"] = true;
+    filter["successful_transaction_count"] = true;
+    filter["failed_transaction_count"] = true;
+    filter["operation_count"] = true;
+    filter["base_fee_in_stroops"] = true;
+}
+
+static void transactionFilter(JsonDocument& filter) {
+    filter["paging_token"] = true;
+    filter["hash"] = true;
+    filter["ledger"] = true;
+    filter["successful"] = true;
+    filter["source_account"] = true;
+    filter["operation_count"] = true;
+    filter["created_at"] = true;
+}
+
+// ============================================
+// CONSTRUCTOR / DESTRUCTOR
+// ============================================
+
+StellarEventStream::StellarEventStream(StellarNetwork& network)
+    : network(network),
+      socket(nullptr),
+      type(STREAM_PAYMENTS),
+      active(false),
+      open(false),
+      retryDelay(STELLAR_SSE_RETRY_MS),
+      failedAttempts(0),
+      disconnectedAt(0),
+      lastActivity(0),
+      idleTimeout(0),
+      lineState(LINE_START),
+      skipLF(false),
+      fieldLength(0),
+      valueLength(0),
+      valueStarted(false),
+      paymentCallback(nullptr),
+      ledgerCallback(nullptr),
+      transactionCallback(nullptr),
+      paymentContext(nullptr),
+      ledgerContext(nullptr),
+      transactionContext(nullptr) {
+    cursor[0] = '\0';
+    lastEventId[0] = '\0';
+    memset(&stats, 0, sizeof(stats));
+    resetEvent();
+
+    client.setSessionCache(&network.getTlsSessionCache());
+}
+
+StellarEventStream::~StellarEventStream() {
+    stop();
+}
+
+// ============================================
+// CALLBACKS
+// ============================================
+
+void StellarEventStream::onPayment(PaymentEventCallback callback, void* context) {
+    paymentCallback = callback;
+    paymentContext = context;
+}
+
+void StellarEventStream::onLedger(LedgerEventCallback callback, void* context) {
+    ledgerCallback = callback;
+    ledgerContext = context;
+}
+
+void StellarEventStream::onTransaction(TransactionEventCallback callback, void* context) {
+    transactionCallback = callback;
+    transactionContext = context;
+}
+
+// ============================================
+// STREAMS
+// ============================================
+
+bool StellarEventStream::streamPayments(const char* accountId, const char* cursor) {
+    if (!StellarStrKey::isValid(accountId, STRKEY_ACCOUNT_ID)) {
+        lastError = "Invalid account ID";
+        STELLAR_LOGE("SSE", "%s", lastError.c_str());
+        return false;
+    }
+
+    return start(STREAM_PAYMENTS, "/accounts/" + String(accountId) + "/payments", cursor);
+}
+
+bool StellarEventStream::streamLedgers(const char* cursor) {
+    return start(STREAM_LEDGERS, "/ledgers", cursor);
+}
+
+bool StellarEventStream::streamTransactions(const char* accountId, const char* cursor) {
+    if (!accountId) {
+        return start(STREAM_TRANSACTIONS, "/transactions", cursor);
+    }
+
+    if (!StellarStrKey::isValid(accountId, STRKEY_ACCOUNT_ID)) {
+        lastError = "Invalid account ID";
+        STELLAR_LOGE("SSE", "%s", lastError.c_str());
+        return false;
+    }
+
+    return start(STREAM_TRANSACTIONS, "/accounts/" + String(accountId) + "/transactions", cursor);
+}
+
+bool StellarEventStream::start(StreamType streamType, const String& streamPath, const char* startCursor) {
+    if (!startCursor || startCursor[0] == '\0') {
+        startCursor = "now";
+    }
+
+    size_t cursorLength = strlen(startCursor);
+
+    if (cursorLength > STELLAR_SSE_ID_MAX) {
+        lastError = "Invalid cursor";
+        STELLAR_LOGE("SSE", "%s", lastError.c_str());
+        return false;
+    }
+
+    stop();
+
+    type = streamType;
+    path = streamPath;
+    memcpy(cursor, startCursor, cursorLength + 1);
+    lastEventId[0] = '\0';
+    retryDelay = STELLAR_SSE_RETRY_MS;
+    failedAttempts = 0;
+    active = true;
+
+    return connect();
+}
+
+void StellarEventStream::stop() {
+    if (open) {
+        disconnect();
+        STELLAR_LOGI("SSE", "Stream %s stopped", path.c_str());
+    }
+
+    active = false;
+}
+
+// ============================================
+// CONEXIÓN
+// ============================================
+
+bool StellarEventStream::connect() {
+    // Referencia del backoff si el intento falla
+    disconnectedAt = millis();
+
+    if (!network.isConnected()) {
+        lastError = "WiFi not connected";
+        return false;
+    }
+
+    // Reanudar tras el último evento recibido
+    const char* from = lastEventId[0] != '\0' ? lastEventId : cursor;
+    String url = String(network.getHorizonURL()) + path + "?cursor=" + String(from);
+
+    STELLAR_LOGD("SSE", "GET %s", url.c_str());
+
+    client.setIoTimeoutMs(network.getTimeout());
+
+    if (!http.begin(client, url)) {
+        lastError = "Invalid URL";
+        STELLAR_LOGE("SSE", "%s: %s", lastError.c_str(), url.c_str());
+        if (failedAttempts < 255) {
+            failedAttempts++;
+        }
+        stats.failures++;
+        return false;
+    }
+
+    // HTTP/1.0: sin chunked, el cuerpo es el stream hasta que se cierra
+    http.useHTTP10(true);
+    http.setReuse(false);
+    http.setTimeout(network.getTimeout());
+    http.addHeader("Accept", "text/event-stream");
+    http.addHeader("Cache-Control", "no-cache");
+    http.addHeader("User-Agent", "Stellar-IoT-SDK/0.1.0");
+
+    if (lastEventId[0] != '\0') {
+        http.addHeader("Last-Event-ID", lastEventId);
+    }
+
+    int httpCode = http.GET();
+    socket = (httpCode == HTTP_CODE_OK) ? http.getStreamPtr() : nullptr;
+
+    if (!socket) {
+        if (httpCode > 0) {
+            lastError = "HTTP " + String(httpCode);
+        } else {
+            lastError = "HTTP request failed: " + HTTPClient::errorToString(httpCode);
+        }
+
+        http.end();
+        if (failedAttempts < 255) {
+            failedAttempts++;
+        }
+        stats.failures++;
+
+        STELLAR_LOGE("SSE", "%s (attempt %u)", lastError.c_str(), (unsigned)failedAttempts);
+        return false;
+    }
+
+    open = true;
+    failedAttempts = 0;
+    lastActivity = millis();
+    lastError = "";
+    stats.connects++;
+
+    lineState = LINE_START;
+    skipLF = false;
+    resetEvent();
+
+    STELLAR_LOGI("SSE", "Streaming %s from %s", path.c_str(), from);
+    return true;
+}
+
+void StellarEventStream::disconnect() {
+    // Sin reuse: end() cierra el socket
+    http.end();
+
+    socket = nullptr;
+    open = false;
+    disconnectedAt = millis();
+}
+
+bool StellarEventStream::isConnected() {
+    return open && socket && (socket->connected() || socket->available() > 0);
+}
+
+void StellarEventStream::poll() {
+    if (!active) {
+        return;
+    }
+
+    if (!open) {
+        // retry del servidor, doblado por cada intento fallido
+        uint32_t wait = retryDelay;
+
+        for (uint8_t i = 0; i < failedAttempts && wait < STELLAR_SSE_RETRY_MAX_MS; i++) {
+            wait *= 2;
+        }
+
+        if (wait > STELLAR_SSE_RETRY_MAX_MS) {
+            wait = STELLAR_SSE_RETRY_MAX_MS;
+        }
+
+        if (millis() - disconnectedAt >= wait) {
+            connect();
+        }
+
+        return;
+    }
+
+    if (!network.isConnected()) {
+        lastError = "WiFi not connected";
+        STELLAR_LOGE("SSE", "%s", lastError.c_str());
+        disconnect();
+        return;
+    }
+
+    uint32_t start = millis();
+
+    while (socket->available() > 0 && millis() - start < STELLAR_SSE_POLL_BUDGET_MS) {
+        int c = socket->read();
+
+        if (c < 0) {
+            break;
+        }
+
+        lastActivity = millis();
+        processByte((uint8_t)c);
+    }
+
+    if (!socket->connected() && socket->available() == 0) {
+        STELLAR_LOGD("SSE", "Stream closed by server, reconnecting");
+        disconnect();
+        return;
+    }
+
+    if (idleTimeout > 0 && millis() - lastActivity >= idleTimeout) {
+        lastError = "Stream idle timeout";
+        STELLAR_LOGE("SSE", "%s", lastError.c_str());
+        disconnect();
+    }
+}
+
+void StellarEventStream::parse(Client& source) {
+    Client* previous = socket;
+    socket = &source;
+
+    while (source.available() > 0) {
+        int c = source.read();
+
+        if (c < 0) {
+            break;
+        }
+
+        processByte((uint8_t)c);
+    }
+
+    socket = previous;
+}
+
+// ============================================
+// PARSER
+// ============================================
+
+void StellarEventStream::resetEvent() {
+    eventName[0] = '\0';
+    hasData = false;
+    doc.clear();
+}
+
+void StellarEventStream::processByte(uint8_t c) {
+    // "\r\n" es un único fin de línea
+    if (skipLF) {
+        skipLF = false;
+
+        if (c == '\n') {
+            return;
+        }
+    }
+
+    if (c == '\r' || c == '\n') {
+        skipLF = (c == '\r');
+        endLine();
+        return;
+    }
+
+    if (lineState == LINE_START) {
+        if (c == ':') {
+            // Comentario (keep-alive)
+            lineState = LINE_SKIP;
+            return;
+        }
+
+        lineState = LINE_FIELD;
+        fieldLength = 0;
+    }
+
+    switch (lineState) {
+        case LINE_FIELD:
+            if (c == ':') {
+                field[fieldLength] = '\0';
+
+                if (strcmp(field, "data") == 0) {
+                    readData();
+                } else {
+                    lineState = LINE_VALUE;
+                    valueLength = 0;
+                    valueStarted = false;
+                }
+            } else if (fieldLength < STELLAR_SSE_FIELD_MAX) {
+                field[fieldLength++] = (char)c;
+            } else {
+                lineState = LINE_SKIP;
+            }
+            break;
+
+        case LINE_VALUE:
+            if (!valueStarted) {
+                valueStarted = true;
+
+                // Un espacio tras ':' no es parte del valor
+                if (c == ' ') {
+                    break;
+                }
+            }
+
+            if (valueLength < STELLAR_SSE_VALUE_MAX) {
+                value[valueLength++] = (char)c;
+            } else {
+                lineState = LINE_SKIP;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void StellarEventStream::endLine() {
+    switch (lineState) {
+        case LINE_START:
+            dispatch();
+            break;
+
+        case LINE_FIELD:
+            // Campo sin ':' = valor vacío
+            field[fieldLength] = '\0';
+            valueLength = 0;
+            value[0] = '\0';
+            processField();
+            break;
+
+        case LINE_VALUE:
+            value[valueLength] = '\0';
+            processField();
+            break;
+
+        default:
+            break;
+    }
+
+    lineState = LINE_START;
+}
+
+void StellarEventStream::processField() {
+    if (strcmp(field, "event") == 0) {
+        if (valueLength <= STELLAR_SSE_FIELD_MAX) {
+            memcpy(eventName, value, valueLength + 1);
+        }
+
+    } else if (strcmp(field, "id") == 0) {
+        if (valueLength <= STELLAR_SSE_ID_MAX) {
+            memcpy(lastEventId, value, valueLength + 1);
+        }
+
+    } else if (strcmp(field, "retry") == 0) {
+        if (valueLength > 0 && strspn(value, "0123456789") == valueLength) {
+            retryDelay = (uint32_t)strtoul(value, nullptr, 10);
+        }
+    }
+}
+
+void StellarEventStream::readData() {
+    SseDataStream data(*socket, STELLAR_SSE_DATA_TIMEOUT_MS);
+
+    // Los eventos "open"/"close" de Horizon traen un saludo, no un registro.
+    // Horizon envía cada registro en una sola línea: se ignoran las demás
+    bool record = !hasData && (eventName[0] == '\0' || strcmp(eventName, "message") == 0);
+
+    if (record) {
+        StaticJsonDocument<256> filter;
+
+        switch (type) {
+            case STREAM_PAYMENTS:     paymentFilter(filter); break;
+            case STREAM_LEDGERS:      ledgerFilter(filter); break;
+            case STREAM_TRANSACTIONS: transactionFilter(filter); break;
+        }
+
+        DeserializationError error = deserializeJson(doc, data, DeserializationOption::Filter(filter));
+
+        if (error) {
+            stats.dropped++;
+            STELLAR_LOGE("SSE", "Invalid event data: %s", error.c_str());
+        } else {
+            hasData = true;
+        }
+    }
+
+    data.drain();
+
+    if (data.lineEnd() == 0) {
+        // Línea cortada: lo que llegue después hasta el fin de línea se descarta
+        hasData = false;
+        lineState = LINE_SKIP;
+        return;
+    }
+
+    skipLF = (data.lineEnd() == '\r');
+    lineState = LINE_START;
+}
+
+void StellarEventStream::dispatch() {
+    if (!hasData) {
+        resetEvent();
+        return;
+    }
+
+    switch (type) {
+        case STREAM_PAYMENTS:
+            if (paymentCallback) {
+                // create_account no es un pago pero aparece en /payments
+                bool created = strcmp(doc["type"] | "", "create_account") == 0;
+
+                PaymentEvent event;
+                event.id = doc["paging_token"] | "";
+                event.type = doc["type"] | "";
+                event.from = created ? (doc["funder"] | "") : (doc["from"] | "");
+                event.to = created ? (doc["account"] | "") : (doc["to"] | "");
+                event.amount = created ? (doc["starting_balance"] | "") : (doc["amount"] | "");
+                event.assetType = created ? "native" : (doc["asset_type"] | "");
+                event.assetCode = doc["asset_code"] | "";
+                event.transactionHash = doc["transaction_hash"] | "";
+                event.createdAt = doc["created_at"] | "";
+
+                paymentCallback(event, paymentContext);
+            }
+            break;
+
+        case STREAM_LEDGERS:
+            if (ledgerCallback) {
+                LedgerEvent event;
+                event.id = doc["paging_token"] | "";
+                event.sequence = doc["sequence"].as<uint32_t>();
+                event.hash = doc["hash"] | "";
+                event.closedAt = doc["closed_at"] | "";
+                event.successfulTransactions = doc["successful_transaction_count"].as<uint32_t>();
+                event.failedTransactions = doc["failed_transaction_count"].as<uint32_t>();
+                event.operations = doc["operation_count"].as<uint32_t>();
+                event.baseFee = doc["base_fee_in_stroops"].as<uint32_t>();
+
+                ledgerCallback(event, ledgerContext);
+            }
+            break;
+
+        case STREAM_TRANSACTIONS:
+            if (transactionCallback) {
+                TransactionEvent event;
+                event.id = doc["paging_token"] | "";
+                event.hash = doc["hash"] | "";
+                event.ledger = doc["ledger"].as<uint32_t>();
+                event.successful = doc["successful"].as<bool>();
+                event.sourceAccount = doc["source_account"] | "";
+                event.operationCount = doc["operation_count"].as<uint32_t>();
+                event.createdAt = doc["created_at"] | "";
+
+                transactionCallback(event, transactionContext);
+            }
+            break;
+    }
+
+    stats.events++;
+    resetEvent();
+}
@@ -0,0 +1,266 @@
+#ifndef STELLAR_SSE_H
+#define STELLAR_SSE_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include "stellar_network.h"
+#include "stellar_tls.h"
+
+/**
+ * Cliente Server-Sent Events para los streams de Horizon
+ *
+ * En lugar de consultar /payments cada pocos segundos, mantiene abierta una
+ * conexión text/event-stream y Horizon empuja cada registro nuevo en cuanto
+ * cierra el ledger. poll() lee lo que haya llegado sin bloquear, parsea los
+ * eventos y llama al callback del tipo de stream.
+ *
+ * - Cada evento "data:" se deserializa directo del socket con un filtro de
+ *   campos: una transacción con su result_meta_xdr no se bufferiza entera
+ * - Guarda el id del último evento (paging_token) y al reconectar lo envía
+ *   como Last-Event-ID y cursor: no se pierden ni se repiten eventos
+ * - Reconecta solo, con el retry que indique el servidor y backoff
+ *   exponencial si falla
+ *
+ * La petición va en HTTP/1.0 para que el cuerpo llegue sin chunked: es el
+ * stream SSE tal cual hasta que se cierra la conexión.
+ *
+ * Cada stream abierto es una conexión TLS propia (~40 KB de heap); reanuda
+ * la sesión del host guardada por StellarNetwork.
+ *
+ * Uso:
+ *   StellarEventStream payments(network);
+ *   payments.onPayment(handlePayment, nullptr);
+ *   payments.streamPayments("GABC...");
+ *   // en loop():
+ *   payments.poll();
+ */
+
+#ifndef STELLAR_SSE_RETRY_MS
+#define STELLAR_SSE_RETRY_MS 1000           // Si el servidor no envía "retry:"
+#endif
+
+#ifndef STELLAR_SSE_RETRY_MAX_MS
+#define STELLAR_SSE_RETRY_MAX_MS 60000
+#endif
+
+#ifndef STELLAR_SSE_DOC_SIZE
+#define STELLAR_SSE_DOC_SIZE 768            // Registro filtrado
+#endif
+
+#ifndef STELLAR_SSE_POLL_BUDGET_MS
+#define STELLAR_SSE_POLL_BUDGET_MS 50       // Máximo por llamada a poll()
+#endif
+
+#ifndef STELLAR_SSE_DATA_TIMEOUT_MS
+#define STELLAR_SSE_DATA_TIMEOUT_MS 2000    // Resto de una línea "data:" ya empezada
+#endif
+
+#define STELLAR_SSE_ID_MAX 32               // paging_token
+#define STELLAR_SSE_FIELD_MAX 16
+#define STELLAR_SSE_VALUE_MAX 48
+
+enum StreamType {
+    STREAM_PAYMENTS = 0,
+    STREAM_LEDGERS = 1,
+    STREAM_TRANSACTIONS = 2
+};
+
+// Los const char* apuntan al evento recibido: solo válidos durante el
+// callback (copiarlos si hacen falta después)
+
+struct PaymentEvent {
+    const char* id;                 // paging_token
+    const char* type;               // payment, create_account, path_payment_strict_send...
+    const char* from;               // funder en create_account
+    const char* to;                 // account en create_account
+    const char* amount;             // starting_balance en create_account
+    const char* assetType;          // native, credit_alphanum4...
+    const char* assetCode;          // "" para XLM
+    const char* transactionHash;
+    const char* createdAt;
+};
+
+struct LedgerEvent {
+    const char* id;
+    uint32_t sequence;
+    const char* hash;
+    const char* closedAt;
+    uint32_t successfulTransactions;
+    uint32_t failedTransactions;
+    uint32_t operations;
+    uint32_t baseFee;               // En stroops
+};
+
+struct TransactionEvent {
+    const char* id;
+    const char* hash;
+    uint32_t ledger;
+    bool successful;
+    const char* sourceAccount;
+    uint32_t operationCount;
+    const char* createdAt;
+};
+
+typedef void (*PaymentEventCallback)(const PaymentEvent& event, void* context);
+typedef void (*LedgerEventCallback)(const LedgerEvent& event, void* context);
+typedef void (*TransactionEventCallback)(const TransactionEvent& event, void* context);
+
+struct EventStreamStats {
+    uint32_t events;        // Eventos entregados al callback
+    uint32_t dropped;       // Eventos con data inválida o que no cabe
+    uint32_t connects;      // Conexiones abiertas con éxito
+    uint32_t failures;      // Intentos de conexión fallidos
+};
+
+class StellarEventStream {
+public:
+    /**
+     * @param network Red de la que toma la URL de Horizon, el timeout y
+     *                la caché de sesiones TLS (debe seguir viva)
+     */
+    explicit StellarEventStream(StellarNetwork& network);
+    ~StellarEventStream();
+
+    // ============================================
+    // CALLBACKS
+    // ============================================
+
+    void onPayment(PaymentEventCallback callback, void* context = nullptr);
+    void onLedger(LedgerEventCallback callback, void* context = nullptr);
+    void onTransaction(TransactionEventCallback callback, void* context = nullptr);
+
+    // ============================================
+    // STREAMS
+    // ============================================
+
+    /**
+     * Pagos de una cuenta
+     * GET /accounts/{account_id}/payments
+     *
+     * @param accountId Public key (G...)
+     * @param cursor paging_token desde el que empezar ("now" = solo nuevos)
+     * @return true si se abrió la conexión (si no, poll() reintenta)
+     */
+    bool streamPayments(const char* accountId, const char* cursor = "now");
+
+    /**
+     * Ledgers cerrados
+     * GET /ledgers
+     */
+    bool streamLedgers(const char* cursor = "now");
+
+    /**
+     * Transacciones de una cuenta, o de toda la red con accountId = nullptr
+     * GET /accounts/{account_id}/transactions o /transactions
+     */
+    bool streamTransactions(const char* accountId = nullptr, const char* cursor = "now");
+
+    /**
+     * Lee los eventos recibidos y reconecta si hace falta
+     * No bloquea salvo al reconectar (handshake TLS): llamar desde loop()
+     */
+    void poll();
+
+    /**
+     * Cierra el stream (no reconecta hasta otro streamXxx())
+     */
+    void stop();
+
+    /**
+     * Parsea eventos ya recibidos por otro medio hasta agotar source
+     * (mismos callbacks y estado; sin conexión ni reconexión propias)
+     */
+    void parse(Client& source);
+
+    // ============================================
+    // ESTADO
+    // ============================================
+
+    bool isActive() const { return active; }
+    bool isConnected();
+
+    /**
+     * id del último evento recibido ("" si ninguno): cursor para reanudar
+     */
+    const char* getLastEventId() const { return lastEventId; }
+
+    /**
+     * Espera antes de reconectar: "retry:" del servidor o STELLAR_SSE_RETRY_MS
+     */
+    uint32_t getRetryDelay() const { return retryDelay; }
+
+    /**
+     * Cierra y reconecta si no llega nada en ms (0 = sin límite)
+     * Con /ledgers (un ledger cada ~5 s) 30000 detecta conexiones caídas
+     */
+    void setIdleTimeout(uint32_t ms) { idleTimeout = ms; }
+
+    String getLastError() const { return lastError; }
+    const EventStreamStats& getStats() const { return stats; }
+
+private:
+    enum LineState {
+        LINE_START,         // Inicio de línea (vacía = fin de evento)
+        LINE_FIELD,         // Nombre del campo hasta ':'
+        LINE_VALUE,
+        LINE_SKIP           // Comentario o línea que no cabe
+    };
+
+    StellarNetwork& network;
+    StellarTlsClient client;
+    HTTPClient http;
+    Client* socket;
+
+    StreamType type;
+    String path;
+    char cursor[STELLAR_SSE_ID_MAX + 1];
+    char lastEventId[STELLAR_SSE_ID_MAX + 1];
+    bool active;
+    bool open;
+
+    uint32_t retryDelay;            // Del servidor o STELLAR_SSE_RETRY_MS
+    uint8_t failedAttempts;
+    uint32_t disconnectedAt;
+    uint32_t lastActivity;
+    uint32_t idleTimeout;
+
+    // Parser del evento en curso
+    LineState lineState;
+    bool skipLF;                    // Línea terminada en '\r': ignorar un '\n'
+    char field[STELLAR_SSE_FIELD_MAX + 1];
+    uint8_t fieldLength;
+    char value[STELLAR_SSE_VALUE_MAX + 1];
+    uint8_t valueLength;
+    bool valueStarted;              // Ya se saltó el espacio tras ':'
+    char eventName[STELLAR_SSE_FIELD_MAX + 1];
+    bool hasData;
+    StaticJsonDocument<STELLAR_SSE_DOC_SIZE> doc;
+
+    PaymentEventCallback paymentCallback;
+    LedgerEventCallback ledgerCallback;
+    TransactionEventCallback transactionCallback;
+    void* paymentContext;
+    void* ledgerContext;
+    void* transactionContext;
+
+    EventStreamStats stats;
+    String lastError;
+
+    bool start(StreamType streamType, const String& streamPath, const char* startCursor);
+    bool connect();
+    void disconnect();
+    void resetEvent();
+
+    void processByte(uint8_t c);
+    void endLine();
+    void processField();
+    void readData();
+    void dispatch();
+
+    // Contiene el socket: no copiable
+    StellarEventStream(const StellarEventStream&) = delete;
+    StellarEventStream& operator=(const StellarEventStream&) = delete;
+};
+
+#endif // STELLAR_SSE_H
@@ -1,8 +1,10 @@
 #include "stellar_storage.h"
 #include "stellar_utils.h"
+#include <stddef.h>
 
 // Definir constante estática
 const char* SecureWallet::WALLET_PATH = "/wallet.dat";
+const char* SecureWallet::ACCOUNT_NODE_PATH = "/hdnode.dat";
 
 // ============================================
 // CONSTRUCTOR / DESTRUCTOR
@@ -21,36 +23,50 @@ SecureWallet::~SecureWallet() {
 // GUARDAR WALLET
 // ============================================
 
-bool SecureWallet::saveToFlash(const StellarKeypair* keypair, const char* password) {
+bool SecureWallet::saveToFlash(
+    const StellarKeypair* keypair,
+    const char* password,
+    uint32_t unlockMillis
+) {
     if (!keypair) {
-        StellarUtils::errorPrint("Storage", "Keypair is null");
+        STELLAR_LOGE("Storage", "Keypair is null");
         return false;
     }
     
     if (!isPasswordValid(password)) {
-        StellarUtils::errorPrint("Storage", "Password must be at least 8 characters");
+        STELLAR_LOGE("Storage", "Password must be at least 8 characters");
         return false;
     }
     
-    StellarUtils::infoPrint("Storage", "Saving wallet to flash");
+    STELLAR_LOGI("Storage", "Saving wallet to flash");
     
     // Inicializar SPIFFS si no está
     if (!SPIFFS.begin(true)) {
-        StellarUtils::errorPrint("Storage", "Failed to mount SPIFFS");
+        STELLAR_LOGE("Storage", "Failed to mount SPIFFS");
         return false;
     }
     
+    // Iteraciones para el tiempo de desbloqueo pedido en este dispositivo
+    uint32_t iterations = PBKDF2_ITERATIONS;
+    if (unlockMillis > 0) {
+        iterations = StellarCrypto::calibratePBKDF2(
+            unlockMillis,
+            PBKDF2_ITERATIONS,
+            PBKDF2_MAX_ITERATIONS
+        );
+    }
+    
     // Encriptar keypair
     StoredWallet wallet;
-    if (!encrypt(keypair, password, &wallet)) {
-        StellarUtils::errorPrint("Storage", "Encryption failed");
+    if (!encrypt(keypair, password, iterations, &wallet)) {
+        STELLAR_LOGE("Storage", "Encryption failed");
         return false;
     }
     
     // Abrir archivo para escritura
     File file = SPIFFS.open(WALLET_PATH, "w");
     if (!file) {
-        StellarUtils::errorPrint("Storage", "Failed to open file for writing");
+        STELLAR_LOGE("Storage", "Failed to open file for writing");
         return false;
     }
     
@@ -59,16 +75,16 @@ bool SecureWallet::saveToFlash(const StellarKeypair* keypair, const char* passwo
     file.close();
     
     if (written != sizeof(StoredWallet)) {
-        StellarUtils::errorPrint("Storage", "Failed to write complete wallet");
+        STELLAR_LOGE("Storage", "Failed to write complete wallet");
         SPIFFS.remove(WALLET_PATH);  // Limpiar archivo corrupto
         return false;
     }
     
     // Cachear public key
-    cachedPublicKey = keypair->getPublicKey();
+    cachedPublicKey = keypair->getPublicKeyCStr();
     
-    StellarUtils::infoPrint("Storage", "Wallet saved successfully");
-    StellarUtils::debugPrint("Storage", ("Size: " + String(sizeof(StoredWallet)) + " bytes").c_str());
+    STELLAR_LOGI("Storage", "Wallet saved successfully");
+    STELLAR_LOGD("Storage", "Size: %u bytes", (unsigned)sizeof(StoredWallet));
     
     return true;
 }
@@ -79,46 +95,87 @@ bool SecureWallet::saveToFlash(const StellarKeypair* keypair, const char* passwo
 
 StellarKeypair* SecureWallet::loadFromFlash(const char* password) {
     if (!isPasswordValid(password)) {
-        StellarUtils::errorPrint("Storage", "Password must be at least 8 characters");
+        STELLAR_LOGE("Storage", "Password must be at least 8 characters");
         return nullptr;
     }
     
-    StellarUtils::infoPrint("Storage", "Loading wallet from flash");
+    STELLAR_LOGI("Storage", "Loading wallet from flash");
     
     // Inicializar SPIFFS
     if (!SPIFFS.begin(false)) {
-        StellarUtils::errorPrint("Storage", "Failed to mount SPIFFS");
+        STELLAR_LOGE("Storage", "Failed to mount SPIFFS");
         return nullptr;
     }
     
     // Verificar que existe el archivo
     if (!SPIFFS.exists(WALLET_PATH)) {
-        StellarUtils::errorPrint("Storage", "Wallet file not found");
+        STELLAR_LOGE("Storage", "Wallet file not found");
         return nullptr;
     }
     
     // Abrir archivo
     File file = SPIFFS.open(WALLET_PATH, "r");
     if (!file) {
-        StellarUtils::errorPrint("Storage", "Failed to open wallet file");
+        STELLAR_LOGE("Storage", "Failed to open wallet file");
         return nullptr;
     }
     
-    // Verificar tamaño
+    // Verificar tamaño (formato actual o v1)
     size_t fileSize = file.size();
-    if (fileSize != sizeof(StoredWallet)) {
-        StellarUtils::errorPrint("Storage", "Invalid wallet file size");
+    if (fileSize != sizeof(StoredWallet) && fileSize != sizeof(StoredWalletV1)) {
+        STELLAR_LOGE("Storage", "Invalid wallet file size");
         file.close();
         return nullptr;
     }
     
     // Leer estructura
-    StoredWallet wallet;
-    size_t read = file.read((uint8_t*)&wallet, sizeof(StoredWallet));
+    uint8_t data[sizeof(StoredWallet)];
+    size_t read = file.read(data, fileSize);
     file.close();
     
-    if (read != sizeof(StoredWallet)) {
-        StellarUtils::errorPrint("Storage", "Failed to read complete wallet");
+    StellarKeypair* keypair = nullptr;
+    
+    if (read == fileSize) {
+        keypair = loadFromBytes(data, fileSize, password);
+    } else {
+        STELLAR_LOGE("Storage", "Failed to read complete wallet");
+    }
+    
+    // Limpiar memoria sensible
+    StellarUtils::secureZero(data, sizeof(data));
+    
+    return keypair;
+}
+
+StellarKeypair* SecureWallet::loadFromBytes(const uint8_t* data, size_t length, const char* password) {
+    if (!isPasswordValid(password)) {
+        STELLAR_LOGE("Storage", "Password must be at least 8 characters");
+        return nullptr;
+    }
+    
+    if (!data) {
+        return nullptr;
+    }
+    
+    StoredWallet wallet;
+    
+    if (length == sizeof(StoredWalletV1)) {
+        StoredWalletV1 legacy;
+        memcpy(&legacy, data, sizeof(StoredWalletV1));
+        
+        bool upgraded = upgradeLegacy(&legacy, &wallet);
+        StellarUtils::secureZero(&legacy, sizeof(StoredWalletV1));
+        
+        if (!upgraded) {
+            STELLAR_LOGE("Storage", "Failed to read legacy wallet");
+            return nullptr;
+        }
+        
+        STELLAR_LOGI("Storage", "Legacy wallet (v1): save it again to calibrate PBKDF2");
+    } else if (length == sizeof(StoredWallet)) {
+        memcpy(&wallet, data, sizeof(StoredWallet));
+    } else {
+        STELLAR_LOGE("Storage", "Invalid wallet file size");
         return nullptr;
     }
     
@@ -126,10 +183,10 @@ StellarKeypair* SecureWallet::loadFromFlash(const char* password) {
     StellarKeypair* keypair = decrypt(&wallet, password);
     
     if (keypair) {
-        StellarUtils::infoPrint("Storage", "Wallet loaded successfully");
-        StellarUtils::debugPrint("Storage", ("Public: " + keypair->getPublicKey()).c_str());
+        STELLAR_LOGI("Storage", "Wallet loaded successfully");
+        STELLAR_LOGD("Storage", "Public: %s", keypair->getPublicKeyCStr());
     } else {
-        StellarUtils::errorPrint("Storage", "Decryption failed - wrong password?");
+        STELLAR_LOGE("Storage", "Decryption failed - wrong password?");
     }
     
     // Limpiar memoria sensible
@@ -150,29 +207,196 @@ bool SecureWallet::existsInFlash() {
     return SPIFFS.exists(WALLET_PATH);
 }
 
+// ============================================
+// NODO HD (SEP-0005)
+// ============================================
+
+bool SecureWallet::saveAccountNode(const char* password, uint32_t unlockMillis) {
+    if (!isPasswordValid(password)) {
+        STELLAR_LOGE("Storage", "Password must be at least 8 characters");
+        return false;
+    }
+    
+    uint8_t node[HD_ACCOUNT_NODE_SIZE];
+    if (!StellarKeypair::getAccountNode(node)) {
+        STELLAR_LOGE("Storage", "No account node cached");
+        return false;
+    }
+    
+    STELLAR_LOGI("Storage", "Saving account node to flash");
+    
+    if (!SPIFFS.begin(true)) {
+        STELLAR_LOGE("Storage", "Failed to mount SPIFFS");
+        StellarUtils::secureZero(node, sizeof(node));
+        return false;
+    }
+    
+    uint32_t iterations = PBKDF2_ITERATIONS;
+    if (unlockMillis > 0) {
+        iterations = StellarCrypto::calibratePBKDF2(
+            unlockMillis,
+            PBKDF2_ITERATIONS,
+            PBKDF2_MAX_ITERATIONS
+        );
+    }
+    
+    // Mismo esquema que el wallet: PBKDF2 -> AES-256-GCM
+    StoredAccountNode stored;
+    memset(&stored, 0, sizeof(StoredAccountNode));
+    stored.magic = STORAGE_MAGIC;
+    stored.version = ACCOUNT_NODE_VERSION;
+    stored.iterations = iterations;
+    StellarCrypto::randomBytes(stored.salt, 16);
+    StellarCrypto::randomBytes(stored.iv, 12);
+    
+    uint8_t key[32];
+    bool encrypted = StellarCrypto::deriveKeyPBKDF2(password, stored.salt, iterations, key) &&
+                     StellarCrypto::encryptAES256GCM(node, sizeof(node), key, stored.iv,
+                                                     stored.ciphertext, stored.tag);
+    
+    StellarUtils::secureZero(key, sizeof(key));
+    StellarUtils::secureZero(node, sizeof(node));
+    
+    if (!encrypted) {
+        STELLAR_LOGE("Storage", "Encryption failed");
+        return false;
+    }
+    
+    stored.checksum = StellarUtils::crc16XModem(
+        (const uint8_t*)&stored,
+        offsetof(StoredAccountNode, checksum)
+    );
+    
+    File file = SPIFFS.open(ACCOUNT_NODE_PATH, "w");
+    if (!file) {
+        STELLAR_LOGE("Storage", "Failed to open file for writing");
+        return false;
+    }
+    
+    size_t written = file.write((uint8_t*)&stored, sizeof(StoredAccountNode));
+    file.close();
+    
+    if (written != sizeof(StoredAccountNode)) {
+        STELLAR_LOGE("Storage", "Failed to write complete account node");
+        SPIFFS.remove(ACCOUNT_NODE_PATH);
+        return false;
+    }
+    
+    STELLAR_LOGI("Storage", "Account node saved successfully");
+    
+    return true;
+}
+
+bool SecureWallet::loadAccountNode(const char* password) {
+    if (!isPasswordValid(password)) {
+        STELLAR_LOGE("Storage", "Password must be at least 8 characters");
+        return false;
+    }
+    
+    STELLAR_LOGI("Storage", "Loading account node from flash");
+    
+    if (!SPIFFS.begin(false)) {
+        STELLAR_LOGE("Storage", "Failed to mount SPIFFS");
+        return false;
+    }
+    
+    if (!SPIFFS.exists(ACCOUNT_NODE_PATH)) {
+        STELLAR_LOGE("Storage", "Account node file not found");
+        return false;
+    }
+    
+    File file = SPIFFS.open(ACCOUNT_NODE_PATH, "r");
+    if (!file) {
+        STELLAR_LOGE("Storage", "Failed to open account node file");
+        return false;
+    }
+    
+    StoredAccountNode stored;
+    size_t read = 0;
+    
+    if (file.size() == sizeof(StoredAccountNode)) {
+        read = file.read((uint8_t*)&stored, sizeof(StoredAccountNode));
+    }
+    file.close();
+    
+    if (read != sizeof(StoredAccountNode)) {
+        STELLAR_LOGE("Storage", "Invalid account node file size");
+        return false;
+    }
+    
+    uint16_t expectedChecksum = StellarUtils::crc16XModem(
+        (const uint8_t*)&stored,
+        offsetof(StoredAccountNode, checksum)
+    );
+    
+    if (stored.magic != STORAGE_MAGIC || stored.version != ACCOUNT_NODE_VERSION ||
+        stored.checksum != expectedChecksum) {
+        STELLAR_LOGE("Storage", "Invalid account node header - file corrupted");
+        return false;
+    }
+    
+    if (stored.iterations < PBKDF2_ITERATIONS || stored.iterations > PBKDF2_MAX_ITERATIONS) {
+        STELLAR_LOGE("Storage", "Invalid PBKDF2 iteration count");
+        return false;
+    }
+    
+    uint8_t key[32];
+    uint8_t node[HD_ACCOUNT_NODE_SIZE];
+    
+    bool decrypted = StellarCrypto::deriveKeyPBKDF2(password, stored.salt, stored.iterations, key) &&
+                     StellarCrypto::decryptAES256GCM(stored.ciphertext, sizeof(node), key, stored.iv,
+                                                     stored.tag, node);
+    
+    if (decrypted) {
+        StellarKeypair::setAccountNode(node);
+        STELLAR_LOGI("Storage", "Account node loaded successfully");
+    } else {
+        STELLAR_LOGE("Storage", "Decryption failed - wrong password?");
+    }
+    
+    StellarUtils::secureZero(key, sizeof(key));
+    StellarUtils::secureZero(node, sizeof(node));
+    StellarUtils::secureZero(&stored, sizeof(StoredAccountNode));
+    
+    return decrypted;
+}
+
+bool SecureWallet::accountNodeExistsInFlash() {
+    if (!SPIFFS.begin(false)) {
+        return false;
+    }
+    
+    return SPIFFS.exists(ACCOUNT_NODE_PATH);
+}
+
 // ============================================
 // BORRAR
 // ============================================
 
 bool SecureWallet::deleteFromFlash() {
-    StellarUtils::infoPrint("Storage", "Deleting wallet from flash");
+    STELLAR_LOGI("Storage", "Deleting wallet from flash");
     
     if (!SPIFFS.begin(false)) {
-        StellarUtils::errorPrint("Storage", "Failed to mount SPIFFS");
+        STELLAR_LOGE("Storage", "Failed to mount SPIFFS");
         return false;
     }
     
+    // El nodo HD deriva las mismas cuentas: se borra con el wallet
+    if (SPIFFS.exists(ACCOUNT_NODE_PATH)) {
+        SPIFFS.remove(ACCOUNT_NODE_PATH);
+    }
+    
     if (!SPIFFS.exists(WALLET_PATH)) {
-        StellarUtils::errorPrint("Storage", "Wallet file not found");
+        STELLAR_LOGE("Storage", "Wallet file not found");
         return false;
     }
     
     bool success = SPIFFS.remove(WALLET_PATH);
     
     if (success) {
-        StellarUtils::infoPrint("Storage", "Wallet deleted successfully");
+        STELLAR_LOGI("Storage", "Wallet deleted successfully");
     } else {
-        StellarUtils::errorPrint("Storage", "Failed to delete wallet");
+        STELLAR_LOGE("Storage", "Failed to delete wallet");
     }
     
     return success;
@@ -185,21 +409,24 @@ bool SecureWallet::deleteFromFlash() {
 bool SecureWallet::encrypt(
     const StellarKeypair* keypair,
     const char* password,
+    uint32_t iterations,
     StoredWallet* output
 ) {
-    StellarUtils::debugPrint("Storage", "Encrypting keypair");
+    STELLAR_LOGD("Storage", "Encrypting keypair");
     
-    // Inicializar estructura
+    // Inicializar estructura (padding incluido: entra en el checksum)
+    memset(output, 0, sizeof(StoredWallet));
     output->magic = STORAGE_MAGIC;
     output->version = STORAGE_VERSION;
+    output->iterations = iterations;
     
     // Generar salt aleatorio
     StellarCrypto::randomBytes(output->salt, 16);
     
     // Derivar encryption key con PBKDF2
     uint8_t key[32];
-    if (!StellarCrypto::deriveKeyPBKDF2(password, output->salt, PBKDF2_ITERATIONS, key)) {
-        StellarUtils::errorPrint("Storage", "Key derivation failed");
+    if (!StellarCrypto::deriveKeyPBKDF2(password, output->salt, iterations, key)) {
+        STELLAR_LOGE("Storage", "Key derivation failed");
         return false;
     }
     
@@ -218,7 +445,7 @@ bool SecureWallet::encrypt(
     )) {
         // Limpiar key sensible
         StellarUtils::secureZero(key, 32);
-        StellarUtils::errorPrint("Storage", "Encryption failed");
+        STELLAR_LOGE("Storage", "Encryption failed");
         return false;
     }
     
@@ -231,7 +458,7 @@ bool SecureWallet::encrypt(
     // Calcular checksum de toda la estructura (excepto el checksum mismo)
     output->checksum = calculateChecksum(output);
     
-    StellarUtils::debugPrint("Storage", "Encryption complete");
+    STELLAR_LOGD("Storage", "Encryption complete");
     
     return true;
 }
@@ -240,31 +467,37 @@ StellarKeypair* SecureWallet::decrypt(
     const StoredWallet* input,
     const char* password
 ) {
-    StellarUtils::debugPrint("Storage", "Decrypting keypair");
+    STELLAR_LOGD("Storage", "Decrypting keypair");
     
     // Verificar magic number
     if (input->magic != STORAGE_MAGIC) {
-        StellarUtils::errorPrint("Storage", "Invalid magic number");
+        STELLAR_LOGE("Storage", "Invalid magic number");
         return nullptr;
     }
     
     // Verificar versión
     if (input->version != STORAGE_VERSION) {
-        StellarUtils::errorPrint("Storage", "Unsupported version");
+        STELLAR_LOGE("Storage", "Unsupported version");
         return nullptr;
     }
     
     // Verificar checksum
     uint16_t expectedChecksum = calculateChecksum(input);
     if (input->checksum != expectedChecksum) {
-        StellarUtils::errorPrint("Storage", "Checksum mismatch - file corrupted");
+        STELLAR_LOGE("Storage", "Checksum mismatch - file corrupted");
+        return nullptr;
+    }
+    
+    // Iteraciones guardadas en el header (cubiertas por el checksum)
+    if (input->iterations < PBKDF2_ITERATIONS || input->iterations > PBKDF2_MAX_ITERATIONS) {
+        STELLAR_LOGE("Storage", "Invalid PBKDF2 iteration count");
         return nullptr;
     }
     
     // Derivar encryption key
     uint8_t key[32];
-    if (!StellarCrypto::deriveKeyPBKDF2(password, input->salt, PBKDF2_ITERATIONS, key)) {
-        StellarUtils::errorPrint("Storage", "Key derivation failed");
+    if (!StellarCrypto::deriveKeyPBKDF2(password, input->salt, input->iterations, key)) {
+        STELLAR_LOGE("Storage", "Key derivation failed");
         return nullptr;
     }
     
@@ -281,45 +514,68 @@ StellarKeypair* SecureWallet::decrypt(
         // Limpiar datos sensibles
         StellarUtils::secureZero(key, 32);
         StellarUtils::secureZero(decryptedSecret, 32);
-        StellarUtils::errorPrint("Storage", "Decryption failed - wrong password");
+        STELLAR_LOGE("Storage", "Decryption failed - wrong password");
         return nullptr;
     }
     
     // Limpiar key
     StellarUtils::secureZero(key, 32);
     
-    // Crear keypair temporal para obtener el formato Stellar
-    StellarKeypair tempKp;
-    memcpy((void*)tempKp.getRawSecretKey(), decryptedSecret, 32);
-    String secretKeyStr = tempKp.getSecretKey();
+    // Crear keypair desde los bytes (sin pasar por la forma S...)
+    StellarKeypair* keypair = new StellarKeypair();
+    bool created = StellarKeypair::fromRawSecret(decryptedSecret, *keypair);
     
     // Limpiar secret key temporal
     StellarUtils::secureZero(decryptedSecret, 32);
     
-    // Crear keypair final desde secret key
-    StellarKeypair* keypair = StellarKeypair::fromSecret(secretKeyStr.c_str());
-    
-    if (!keypair) {
-        StellarUtils::errorPrint("Storage", "Failed to create keypair from decrypted data");
+    if (!created) {
+        STELLAR_LOGE("Storage", "Failed to create keypair from decrypted data");
+        delete keypair;
         return nullptr;
     }
     
     // Verificar que el public key coincida
     const uint8_t* derivedPublicKey = keypair->getRawPublicKey();
     if (memcmp(derivedPublicKey, input->publicKey, 32) != 0) {
-        StellarUtils::errorPrint("Storage", "Public key mismatch - data corrupted");
+        STELLAR_LOGE("Storage", "Public key mismatch - data corrupted");
         delete keypair;
         return nullptr;
     }
     
-    StellarUtils::debugPrint("Storage", "Decryption complete");
+    STELLAR_LOGD("Storage", "Decryption complete");
     
     return keypair;
 }
 
+bool SecureWallet::upgradeLegacy(const StoredWalletV1* legacy, StoredWallet* wallet) {
+    if (legacy->magic != STORAGE_MAGIC || legacy->version != STORAGE_VERSION_LEGACY) {
+        STELLAR_LOGE("Storage", "Invalid legacy wallet header");
+        return false;
+    }
+    
+    size_t dataSize = offsetof(StoredWalletV1, checksum);
+    if (legacy->checksum != StellarUtils::crc16XModem((const uint8_t*)legacy, dataSize)) {
+        STELLAR_LOGE("Storage", "Checksum mismatch - file corrupted");
+        return false;
+    }
+    
+    memset(wallet, 0, sizeof(StoredWallet));
+    wallet->magic = STORAGE_MAGIC;
+    wallet->version = STORAGE_VERSION;
+    wallet->iterations = PBKDF2_ITERATIONS;
+    memcpy(wallet->salt, legacy->salt, sizeof(wallet->salt));
+    memcpy(wallet->iv, legacy->iv, sizeof(wallet->iv));
+    memcpy(wallet->ciphertext, legacy->ciphertext, sizeof(wallet->ciphertext));
+    memcpy(wallet->tag, legacy->tag, sizeof(wallet->tag));
+    memcpy(wallet->publicKey, legacy->publicKey, sizeof(wallet->publicKey));
+    wallet->checksum = calculateChecksum(wallet);
+    
+    return true;
+}
+
 uint16_t SecureWallet::calculateChecksum(const StoredWallet* wallet) {
-    // Calcular checksum de todo excepto el campo checksum
-    size_t dataSize = sizeof(StoredWallet) - sizeof(uint16_t);
+    // Calcular checksum de todo lo anterior al campo checksum
+    size_t dataSize = offsetof(StoredWallet, checksum);
     return StellarUtils::crc16XModem((const uint8_t*)wallet, dataSize);
 }
 
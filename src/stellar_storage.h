@@ -11,15 +11,20 @@
  * 
  * Características:
  * - Encriptación AES-256-GCM
- * - Derivación de clave con PBKDF2 (10000 iteraciones)
+ * - Derivación de clave con PBKDF2 (iteraciones calibradas por dispositivo)
  * - Almacenamiento en SPIFFS (flash)
  * - Salt único por wallet
  * - Verificación de integridad con authentication tag
+ * - Nodo HD m/44'/148' (SEP-0005) en un archivo aparte, mismo esquema
  */
 
 #define STORAGE_MAGIC 0x53544C52  // "STLR" en ASCII
-#define STORAGE_VERSION 1
-#define PBKDF2_ITERATIONS 10000
+#define STORAGE_VERSION 2
+#define STORAGE_VERSION_LEGACY 1      // Sin iteraciones en el header (fijas)
+#define PBKDF2_ITERATIONS 10000       // Mínimo; valor fijo de los wallets v1
+#define PBKDF2_MAX_ITERATIONS 10000000
+#define PBKDF2_TARGET_MILLIS 1000     // Tiempo de desbloqueo objetivo al guardar
+#define ACCOUNT_NODE_VERSION 1
 
 class SecureWallet {
 public:
@@ -33,11 +38,19 @@ public:
     /**
      * Guarda keypair encriptado en flash (SPIFFS)
      * 
+     * Las iteraciones de PBKDF2 se calibran para que desbloquear tarde
+     * unlockMillis en este dispositivo, y se guardan en el header.
+     * 
      * @param keypair Keypair a guardar
      * @param password Password para encriptar (min 8 caracteres)
+     * @param unlockMillis Tiempo de desbloqueo objetivo (0 = PBKDF2_ITERATIONS fijas)
      * @return true si éxito
      */
-    bool saveToFlash(const StellarKeypair* keypair, const char* password);
+    bool saveToFlash(
+        const StellarKeypair* keypair,
+        const char* password,
+        uint32_t unlockMillis = PBKDF2_TARGET_MILLIS
+    );
     
     // ============================================
     // CARGAR WALLET
@@ -51,6 +64,16 @@ public:
      */
     static StellarKeypair* loadFromFlash(const char* password);
     
+    /**
+     * Desencripta un wallet ya leído (formato actual o v1)
+     * 
+     * @param data Contenido del archivo del wallet
+     * @param length Tamaño (StoredWallet o StoredWalletV1)
+     * @param password Password para desencriptar
+     * @return Keypair o nullptr si falla
+     */
+    static StellarKeypair* loadFromBytes(const uint8_t* data, size_t length, const char* password);
+    
     // ============================================
     // VERIFICACIÓN
     // ============================================
@@ -78,12 +101,46 @@ public:
      */
     String getCachedPublicKey() const { return cachedPublicKey; }
     
+    // ============================================
+    // NODO HD (SEP-0005)
+    // ============================================
+    
+    /**
+     * Guarda cifrado el nodo m/44'/148' en caché (StellarKeypair)
+     * Tras reiniciar, derivar cuentas no necesita el mnemonic ni las
+     * 2048 rondas de la seed BIP39
+     * 
+     * @param password Password para encriptar (min 8 caracteres)
+     * @param unlockMillis Tiempo de desbloqueo objetivo (0 = PBKDF2_ITERATIONS fijas)
+     * @return true si éxito
+     */
+    static bool saveAccountNode(
+        const char* password,
+        uint32_t unlockMillis = PBKDF2_TARGET_MILLIS
+    );
+    
+    /**
+     * Carga el nodo desde flash y lo deja en caché
+     * (ver StellarKeypair::deriveAccount)
+     * 
+     * @param password Password para desencriptar
+     * @return true si éxito
+     */
+    static bool loadAccountNode(const char* password);
+    
+    /**
+     * Verifica si existe nodo HD en flash
+     * 
+     * @return true si existe
+     */
+    static bool accountNodeExistsInFlash();
+    
     // ============================================
     // BORRAR
     // ============================================
     
     /**
-     * Elimina wallet del flash
+     * Elimina wallet (y nodo HD si existe) del flash
      * CUIDADO: Esta acción es irreversible
      * 
      * @return true si éxito
@@ -97,21 +154,48 @@ private:
     struct StoredWallet {
         uint32_t magic;           // 4 bytes: MAGIC number
         uint8_t version;          // 1 byte: versión del formato
+        uint32_t iterations;      // 4 bytes: iteraciones de PBKDF2
         uint8_t salt[16];         // 16 bytes: salt para PBKDF2
         uint8_t iv[12];           // 12 bytes: IV para AES-GCM
         uint8_t ciphertext[32];   // 32 bytes: secret key encriptada
         uint8_t tag[16];          // 16 bytes: authentication tag
         uint8_t publicKey[32];    // 32 bytes: public key (plaintext)
         uint16_t checksum;        // 2 bytes: checksum de validación
-    };  // Total: 115 bytes
+    };  // Total: 119 bytes (+ padding)
+    
+    // Formato v1 (PBKDF2_ITERATIONS fijas), solo lectura
+    struct StoredWalletV1 {
+        uint32_t magic;
+        uint8_t version;
+        uint8_t salt[16];
+        uint8_t iv[12];
+        uint8_t ciphertext[32];
+        uint8_t tag[16];
+        uint8_t publicKey[32];
+        uint16_t checksum;
+    };
+    
+    // Nodo HD cifrado
+    struct StoredAccountNode {
+        uint32_t magic;           // 4 bytes: MAGIC number
+        uint8_t version;          // 1 byte: ACCOUNT_NODE_VERSION
+        uint32_t iterations;      // 4 bytes: iteraciones de PBKDF2
+        uint8_t salt[16];         // 16 bytes: salt para PBKDF2
+        uint8_t iv[12];           // 12 bytes: IV para AES-GCM
+        uint8_t ciphertext[64];   // 64 bytes: clave || chain code
+        uint8_t tag[16];          // 16 bytes: authentication tag
+        uint16_t checksum;        // 2 bytes: checksum de validación
+    };
     
-    // Path del archivo en SPIFFS
+    // Paths de los archivos en SPIFFS
     static const char* WALLET_PATH;
+    static const char* ACCOUNT_NODE_PATH;
     
     // Encriptar keypair
     bool encrypt(
         const StellarKeypair* keypair,
         const char* password,
+        uint32_t iterations,
         StoredWallet* output
     );
     
@@ -121,6 +205,9 @@ private:
         const char* password
     );
     
+    // Convierte un wallet v1 válido al formato actual
+    static bool upgradeLegacy(const StoredWalletV1* legacy, StoredWallet* wallet);
+    
     // Calcular checksum de la estructura
     static uint16_t calculateChecksum(const StoredWallet* wallet);
     
@@ -0,0 +1,441 @@
+#include "stellar_stream.h"
+#include <limits.h>
+
+static const char BASE64_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789+/";
+
+// Los únicos caracteres base64 que no son seguros en un form: '+', '/', '='
+static const uint8_t BASE64_PLUS = 62;
+static const uint8_t BASE64_SLASH = 63;
+static const size_t ESCAPED_LENGTH = 3;   // "%XX"
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+Base64FormStream::Base64FormStream(const char* fieldName, const uint8_t* data, size_t length)
+    : fieldName(fieldName ? fieldName : ""),
+      data(data),
+      length(data ? length : 0) {
+    fieldLength = strlen(this->fieldName);
+    encodedSize = fieldLength + 1 + computeEncodedSize(this->data, this->length);
+    rewind();
+}
+
+void Base64FormStream::rewind() {
+    produced = 0;
+    inputPosition = 0;
+    pendingLength = 0;
+    pendingIndex = 0;
+}
+
+// ============================================
+// STREAM
+// ============================================
+
+int Base64FormStream::available() {
+    size_t remaining = encodedSize - produced;
+    return remaining > INT_MAX ? INT_MAX : (int)remaining;
+}
+
+int Base64FormStream::peek() {
+    // "name="
+    if (produced < fieldLength) {
+        return (uint8_t)fieldName[produced];
+    }
+
+    if (produced == fieldLength) {
+        return '=';
+    }
+
+    if (pendingIndex >= pendingLength && !fillPending()) {
+        return -1;
+    }
+
+    return (uint8_t)pending[pendingIndex];
+}
+
+int Base64FormStream::read() {
+    int c = peek();
+
+    if (c >= 0) {
+        produced++;
+
+        if (produced > fieldLength + 1) {
+            pendingIndex++;
+        }
+    }
+
+    return c;
+}
+
+size_t Base64FormStream::readBytes(char* buffer, size_t count) {
+    size_t copied = 0;
+
+    // Prefijo byte a byte (unos pocos caracteres)
+    while (copied < count && produced <= fieldLength) {
+        buffer[copied++] = (char)read();
+    }
+
+    // Cuerpo por grupos completos
+    while (copied < count) {
+        if (pendingIndex >= pendingLength && !fillPending()) {
+            break;
+        }
+
+        size_t chunk = pendingLength - pendingIndex;
+        if (chunk > count - copied) {
+            chunk = count - copied;
+        }
+
+        memcpy(buffer + copied, pending + pendingIndex, chunk);
+        pendingIndex += chunk;
+        produced += chunk;
+        copied += chunk;
+    }
+
+    return copied;
+}
+
+// ============================================
+// ENCODING
+// ============================================
+
+bool Base64FormStream::fillPending() {
+    if (inputPosition >= length) {
+        return false;
+    }
+
+    size_t available = length - inputPosition;
+    size_t groupLength = available < 3 ? available : 3;
+
+    uint8_t b0 = data[inputPosition];
+    uint8_t b1 = groupLength > 1 ? data[inputPosition + 1] : 0;
+    uint8_t b2 = groupLength > 2 ? data[inputPosition + 2] : 0;
+    inputPosition += groupLength;
+
+    uint8_t sextets[4];
+    sextets[0] = b0 >> 2;
+    sextets[1] = ((b0 & 0x03) << 4) | (b1 >> 4);
+    sextets[2] = ((b1 & 0x0f) << 2) | (b2 >> 6);
+    sextets[3] = b2 & 0x3f;
+
+    pendingLength = 0;
+    pendingIndex = 0;
+
+    for (size_t i = 0; i < 4; i++) {
+        // Padding: grupo de 1 byte -> 2 chars, de 2 bytes -> 3 chars
+        if (i > groupLength) {
+            memcpy(pending + pendingLength, "%3D", ESCAPED_LENGTH);
+            pendingLength += ESCAPED_LENGTH;
+        } else if (sextets[i] == BASE64_PLUS) {
+            memcpy(pending + pendingLength, "%2B", ESCAPED_LENGTH);
+            pendingLength += ESCAPED_LENGTH;
+        } else if (sextets[i] == BASE64_SLASH) {
+            memcpy(pending + pendingLength, "%2F", ESCAPED_LENGTH);
+            pendingLength += ESCAPED_LENGTH;
+        } else {
+            pending[pendingLength++] = BASE64_CHARS[sextets[i]];
+        }
+    }
+
+    return true;
+}
+
+size_t Base64FormStream::computeEncodedSize(const uint8_t* data, size_t length) {
+    size_t fullGroups = length / 3;
+    size_t remainder = length % 3;
+    size_t size = fullGroups * 4;
+
+    // Cada '+' o '/' se escapa como %XX (+2 bytes)
+    for (size_t g = 0; g < fullGroups; g++) {
+        const uint8_t* p = data + g * 3;
+        uint8_t sextets[4] = {
+            (uint8_t)(p[0] >> 2),
+            (uint8_t)(((p[0] & 0x03) << 4) | (p[1] >> 4)),
+            (uint8_t)(((p[1] & 0x0f) << 2) | (p[2] >> 6)),
+            (uint8_t)(p[2] & 0x3f)
+        };
+
+        for (size_t i = 0; i < 4; i++) {
+            if (sextets[i] >= BASE64_PLUS) {
+                size += ESCAPED_LENGTH - 1;
+            }
+        }
+    }
+
+    if (remainder > 0) {
+        const uint8_t* p = data + fullGroups * 3;
+        uint8_t b1 = remainder > 1 ? p[1] : 0;
+        uint8_t sextets[3] = {
+            (uint8_t)(p[0] >> 2),
+            (uint8_t)(((p[0] & 0x03) << 4) | (b1 >> 4)),
+            (uint8_t)((b1 & 0x0f) << 2)
+        };
+
+        // remainder + 1 chars de datos, el resto del grupo es "%3D"
+        for (size_t i = 0; i <= remainder; i++) {
+            size += (sextets[i] >= BASE64_PLUS) ? ESCAPED_LENGTH : 1;
+        }
+        size += (3 - remainder) * ESCAPED_LENGTH;
+    }
+
+    return size;
+}
+
+// ============================================
+// HttpBodyStream
+// ============================================
+
+// Límite de una línea de control chunked (tamaño + extensiones, trailers)
+static const size_t CHUNK_LINE_MAX = 256;
+
+// Dígitos hex de un tamaño de chunk (0x0FFFFFFF cabe en int32_t)
+static const size_t CHUNK_SIZE_DIGITS = 7;
+
+static int hexValue(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+HttpBodyStream::HttpBodyStream(Client& client, int contentLength, bool chunked, uint32_t timeoutMs)
+    : client(client),
+      chunked(chunked),
+      timeoutMs(timeoutMs),
+      remaining(chunked || contentLength < 0 ? -1 : contentLength),
+      firstChunk(true),
+      peeked(-1),
+      consumed(0) {
+    if (chunked) {
+        state = BODY_CHUNK_HEADER;
+    } else {
+        state = (remaining == 0) ? BODY_DONE : BODY_DATA;
+    }
+
+    // read() ya espera por su cuenta: timedRead() no debe sumar otro timeout
+    setTimeout(0);
+}
+
+int HttpBodyStream::socketRead() {
+    uint32_t start = millis();
+
+    for (;;) {
+        int c = client.read();
+
+        if (c >= 0) {
+            return c;
+        }
+
+        if (!client.connected() || millis() - start >= timeoutMs) {
+            return -1;
+        }
+
+        delay(1);
+    }
+}
+
+void HttpBodyStream::advance(size_t count) {
+    consumed += count;
+
+    if (remaining < 0) {
+        return;
+    }
+
+    remaining -= (int32_t)count;
+
+    if (remaining == 0) {
+        state = chunked ? BODY_CHUNK_HEADER : BODY_DONE;
+    }
+}
+
+bool HttpBodyStream::readLine(size_t& length) {
+    length = 0;
+
+    for (;;) {
+        int c = socketRead();
+
+        if (c < 0 || length > CHUNK_LINE_MAX) {
+            return false;
+        }
+
+        if (c == '\n') {
+            return true;
+        }
+
+        if (c != '\r') {
+            length++;
+        }
+    }
+}
+
+bool HttpBodyStream::readChunkHeader() {
+    size_t length = 0;
+
+    // Cada chunk salvo el primero va detrás del CRLF del anterior
+    if (!firstChunk && (!readLine(length) || length != 0)) {
+        return false;
+    }
+
+    firstChunk = false;
+
+    // "1a2b[;extension]\r\n"
+    uint32_t size = 0;
+    size_t digits = 0;
+    bool extension = false;
+
+    for (;;) {
+        int c = socketRead();
+
+        if (c < 0 || ++length > CHUNK_LINE_MAX) {
+            return false;
+        }
+
+        if (c == '\n') {
+            break;
+        }
+
+        int value = hexValue(c);
+
+        if (extension || value < 0) {
+            extension = true;
+            continue;
+        }
+
+        if (++digits > CHUNK_SIZE_DIGITS) {
+            return false;
+        }
+
+        size = (size << 4) | (uint32_t)value;
+    }
+
+    if (digits == 0) {
+        return false;
+    }
+
+    if (size > 0) {
+        remaining = (int32_t)size;
+        state = BODY_DATA;
+        return true;
+    }
+
+    // Último chunk: trailers opcionales hasta una línea vacía
+    do {
+        if (!readLine(length)) {
+            return false;
+        }
+    } while (length > 0);
+
+    state = BODY_DONE;
+    return true;
+}
+
+int HttpBodyStream::nextByte() {
+    if (state == BODY_CHUNK_HEADER && !readChunkHeader()) {
+        state = BODY_ERROR;
+    }
+
+    if (state != BODY_DATA) {
+        return -1;
+    }
+
+    int c = socketRead();
+
+    if (c < 0) {
+        // Sin Content-Length el cuerpo termina cuando el servidor cierra
+        state = (remaining < 0 && !client.connected()) ? BODY_DONE : BODY_ERROR;
+        return -1;
+    }
+
+    advance(1);
+    return c;
+}
+
+int HttpBodyStream::available() {
+    if (peeked >= 0) {
+        return 1;
+    }
+
+    if (state == BODY_DONE || state == BODY_ERROR) {
+        return 0;
+    }
+
+    // Con chunked puede incluir cabeceras de chunk: es una cota
+    int pending = client.available();
+
+    if (state == BODY_DATA && remaining >= 0 && pending > remaining) {
+        pending = remaining;
+    }
+
+    return pending;
+}
+
+int HttpBodyStream::read() {
+    if (peeked >= 0) {
+        int c = peeked;
+        peeked = -1;
+        return c;
+    }
+
+    return nextByte();
+}
+
+int HttpBodyStream::peek() {
+    if (peeked < 0) {
+        peeked = nextByte();
+    }
+
+    return peeked;
+}
+
+size_t HttpBodyStream::readBytes(char* buffer, size_t count) {
+    size_t copied = 0;
+
+    if (count > 0 && peeked >= 0) {
+        buffer[copied++] = (char)peeked;
+        peeked = -1;
+    }
+
+    while (copied < count) {
+        // Lo que ya está en el socket se copia de golpe
+        if (state == BODY_DATA && client.available() > 0) {
+            size_t chunk = count - copied;
+
+            if (remaining >= 0 && chunk > (size_t)remaining) {
+                chunk = (size_t)remaining;
+            }
+
+            int received = client.read((uint8_t*)buffer + copied, chunk);
+
+            if (received > 0) {
+                copied += (size_t)received;
+                advance((size_t)received);
+                continue;
+            }
+        }
+
+        int c = nextByte();
+
+        if (c < 0) {
+            break;
+        }
+
+        buffer[copied++] = (char)c;
+    }
+
+    return copied;
+}
+
+bool HttpBodyStream::drain() {
+    char discard[64];
+
+    peeked = -1;
+
+    while (readBytes(discard, sizeof(discard)) > 0) {
+    }
+
+    return state == BODY_DONE;
+}
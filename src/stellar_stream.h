@@ -0,0 +1,157 @@
+#ifndef STELLAR_STREAM_H
+#define STELLAR_STREAM_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+/**
+ * Streams para el cuerpo de las peticiones y respuestas HTTP
+ *
+ * HTTPClient::sendRequest() acepta un Stream y su tamaño, así que el
+ * cuerpo se genera a medida que el socket lo consume en lugar de
+ * construirse antes como String. En sentido contrario, deserializeJson()
+ * lee de un Stream: la respuesta se parsea según llega del socket.
+ */
+
+/**
+ * Cuerpo application/x-www-form-urlencoded con un único campo cuyo valor
+ * es base64 de bytes binarios: "name=" + urlEncode(base64(data))
+ *
+ * Encodea en una sola pasada directo al buffer de lectura del cliente HTTP,
+ * sin Strings intermedios y con memoria extra constante (un grupo base64).
+ *
+ * Uso:
+ *   Base64FormStream body("tx", envelope, envelopeSize);
+ *   http.sendRequest("POST", &body, body.size());
+ */
+class Base64FormStream : public Stream {
+public:
+    /**
+     * @param fieldName Nombre del campo (no se escapa, debe ser seguro)
+     * @param data Bytes a encodear (deben seguir vivos mientras se lee)
+     * @param length Longitud de data
+     */
+    Base64FormStream(const char* fieldName, const uint8_t* data, size_t length);
+
+    /**
+     * Tamaño total del cuerpo (para Content-Length)
+     * Se calcula en el constructor sin generar la salida
+     */
+    size_t size() const { return encodedSize; }
+
+    /**
+     * Vuelve al inicio (para reintentar la petición)
+     */
+    void rewind();
+
+    // Stream
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char* buffer, size_t length) override;
+
+    // Solo lectura
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    const char* fieldName;
+    size_t fieldLength;
+    const uint8_t* data;
+    size_t length;
+    size_t encodedSize;
+
+    size_t produced;        // Bytes de salida ya entregados
+    size_t inputPosition;   // Siguiente byte de data a encodear
+
+    // Un grupo base64 (4 chars) escapado ocupa como máximo 12 bytes
+    char pending[12];
+    uint8_t pendingLength;
+    uint8_t pendingIndex;
+
+    bool fillPending();
+    static size_t computeEncodedSize(const uint8_t* data, size_t length);
+};
+
+/**
+ * Cuerpo de una respuesta HTTP leído directo del socket
+ *
+ * Entrega solo los bytes del cuerpo: respeta Content-Length y decodifica
+ * Transfer-Encoding: chunked (HTTPClient solo lo hace en getString() y
+ * writeToStream(), que necesitan el cuerpo entero o un destino).
+ *
+ * read() espera hasta el timeout a que lleguen bytes, así que el parser
+ * puede ir por delante de la red. Tras parsear hay que llamar a drain():
+ * lo que quede (campos descartados por el filtro, terminador chunked)
+ * debe consumirse para reutilizar la conexión keep-alive.
+ *
+ * Uso:
+ *   HttpBodyStream body(*http.getStreamPtr(), http.getSize(), chunked, 5000);
+ *   deserializeJson(doc, body, DeserializationOption::Filter(filter));
+ *   bool reusable = body.drain();
+ */
+class HttpBodyStream : public Stream {
+public:
+    /**
+     * @param client Socket de la respuesta (cabeceras ya leídas)
+     * @param contentLength Content-Length, o -1 si no viene (hasta cerrar)
+     * @param chunked true si Transfer-Encoding: chunked (ignora contentLength)
+     * @param timeoutMs Espera máxima por cada byte
+     */
+    HttpBodyStream(Client& client, int contentLength, bool chunked, uint32_t timeoutMs);
+
+    /**
+     * Consume el resto del cuerpo
+     *
+     * @return true si el cuerpo terminó bien (la conexión puede reutilizarse)
+     */
+    bool drain();
+
+    /**
+     * true si se leyó el cuerpo completo
+     */
+    bool finished() const { return state == BODY_DONE; }
+
+    /**
+     * true si el cuerpo se cortó (timeout, desconexión, chunk inválido)
+     */
+    bool failed() const { return state == BODY_ERROR; }
+
+    /**
+     * Bytes del cuerpo entregados hasta ahora
+     */
+    size_t position() const { return consumed; }
+
+    // Stream
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char* buffer, size_t length) override;
+
+    // Solo lectura
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    enum BodyState {
+        BODY_DATA,          // Dentro del cuerpo o de un chunk
+        BODY_CHUNK_HEADER,  // Esperando "tamaño[;ext]\r\n"
+        BODY_DONE,
+        BODY_ERROR
+    };
+
+    Client& client;
+    bool chunked;
+    uint32_t timeoutMs;
+    int32_t remaining;      // Bytes del cuerpo/chunk actual, -1 = hasta cerrar
+    bool firstChunk;
+    int peeked;             // Byte leído por peek() o -1
+    size_t consumed;
+    BodyState state;
+
+    int nextByte();
+    int socketRead();
+    void advance(size_t count);
+    bool readChunkHeader();
+    bool readLine(size_t& length);
+};
+
+#endif // STELLAR_STREAM_H
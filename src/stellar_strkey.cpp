@@ -0,0 +1,270 @@
+#include "stellar_strkey.h"
+#include "stellar_utils.h"
+
+// Alfabeto base32 de Stellar (RFC 4648, sin padding)
+static const char BASE32_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+// Tabla inversa: valor 0-31 o 0x80 si el carácter no es base32
+static const uint8_t BASE32_INVALID = 0x80;
+
+static const uint8_t BASE32_DECODE[256] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+};
+
+// version (1) + payload + checksum (2)
+static const size_t ED25519_RAW_LENGTH = 1 + 32 + 2;
+static const size_t MUXED_RAW_LENGTH = 1 + 40 + 2;
+
+// ============================================
+// CODIFICACIÓN
+// ============================================
+
+void StellarStrKey::encodePayload(uint8_t version, const uint8_t* payload, size_t payloadLength, char* output) {
+    uint8_t raw[MUXED_RAW_LENGTH];
+    size_t rawLength = payloadLength + 3;
+
+    raw[0] = version;
+    memcpy(raw + 1, payload, payloadLength);
+
+    uint16_t checksum = StellarUtils::crc16XModem(raw, payloadLength + 1);
+    raw[payloadLength + 1] = checksum & 0xFF;          // Low byte primero
+    raw[payloadLength + 2] = (checksum >> 8) & 0xFF;
+
+    // Grupos de 5 bytes -> 8 caracteres
+    size_t out = 0;
+    size_t i = 0;
+
+    for (; i + 5 <= rawLength; i += 5) {
+        uint64_t group = ((uint64_t)raw[i] << 32) |
+                         ((uint64_t)raw[i + 1] << 24) |
+                         ((uint64_t)raw[i + 2] << 16) |
+                         ((uint64_t)raw[i + 3] << 8) |
+                         (uint64_t)raw[i + 4];
+
+        for (int shift = 35; shift >= 0; shift -= 5) {
+            output[out++] = BASE32_ALPHABET[(group >> shift) & 0x1F];
+        }
+    }
+
+    // Resto (muxed: 3 bytes -> 5 caracteres, 1 bit de relleno a cero)
+    if (i < rawLength) {
+        size_t bits = (rawLength - i) * 8;
+        size_t chars = (bits + 4) / 5;
+        uint64_t group = 0;
+
+        for (; i < rawLength; i++) {
+            group = (group << 8) | raw[i];
+        }
+
+        group <<= chars * 5 - bits;
+
+        for (size_t c = chars; c > 0; c--) {
+            output[out++] = BASE32_ALPHABET[(group >> ((c - 1) * 5)) & 0x1F];
+        }
+    }
+
+    output[out] = '\0';
+
+    StellarUtils::secureZero(raw, sizeof(raw));
+}
+
+void StellarStrKey::encode(StrKeyType type, const uint8_t key[32], char* output) {
+    encodePayload((uint8_t)type, key, 32, output);
+}
+
+void StellarStrKey::encodeMuxed(const uint8_t key[32], uint64_t id, char* output) {
+    // Payload muxed: public key + id (big-endian)
+    uint8_t payload[40];
+    memcpy(payload, key, 32);
+
+    for (int i = 0; i < 8; i++) {
+        payload[32 + i] = (uint8_t)(id >> (56 - 8 * i));
+    }
+
+    encodePayload(STRKEY_MUXED_ACCOUNT, payload, sizeof(payload), output);
+}
+
+String StellarStrKey::encode(StrKeyType type, const uint8_t key[32]) {
+    char output[STRKEY_MAX_LENGTH + 1];
+    encode(type, key, output);
+
+    String encoded(output);
+    StellarUtils::secureZero(output, sizeof(output));
+
+    return encoded;
+}
+
+// ============================================
+// DECODIFICACIÓN
+// ============================================
+
+bool StellarStrKey::decodePayload(const char* encoded, uint8_t* version, uint8_t* payload, size_t* payloadLength) {
+    if (!encoded) {
+        return false;
+    }
+
+    size_t length = strnlen(encoded, STRKEY_MAX_LENGTH + 1);
+    if (length != STRKEY_ED25519_LENGTH && length != STRKEY_MUXED_LENGTH) {
+        return false;
+    }
+
+    uint8_t raw[MUXED_RAW_LENGTH];
+    size_t rawLength = length * 5 / 8;
+    uint8_t invalid = 0;
+    size_t out = 0;
+    size_t i = 0;
+
+    // 8 caracteres -> 5 bytes; los inválidos se acumulan y se miran al final
+    for (; i + 8 <= length; i += 8) {
+        uint64_t group = 0;
+
+        for (size_t c = 0; c < 8; c++) {
+            uint8_t value = BASE32_DECODE[(uint8_t)encoded[i + c]];
+            invalid |= value;
+            group = (group << 5) | (value & 0x1F);
+        }
+
+        raw[out++] = (uint8_t)(group >> 32);
+        raw[out++] = (uint8_t)(group >> 24);
+        raw[out++] = (uint8_t)(group >> 16);
+        raw[out++] = (uint8_t)(group >> 8);
+        raw[out++] = (uint8_t)group;
+    }
+
+    // Resto: los bits de relleno deben ser cero (forma canónica)
+    bool canonical = true;
+
+    if (i < length) {
+        size_t bits = (length - i) * 5;
+        size_t padding = bits % 8;
+        uint64_t group = 0;
+
+        for (; i < length; i++) {
+            uint8_t value = BASE32_DECODE[(uint8_t)encoded[i]];
+            invalid |= value;
+            group = (group << 5) | (value & 0x1F);
+        }
+
+        canonical = (group & ((1u << padding) - 1)) == 0;
+        group >>= padding;
+
+        for (size_t b = bits / 8; b > 0; b--) {
+            raw[out++] = (uint8_t)(group >> ((b - 1) * 8));
+        }
+    }
+
+    bool valid = canonical && !(invalid & BASE32_INVALID) && out == rawLength;
+
+    // El version byte determina la longitud
+    if (valid) {
+        uint8_t type = raw[0];
+        valid = ((type == STRKEY_ACCOUNT_ID || type == STRKEY_SEED) && rawLength == ED25519_RAW_LENGTH) ||
+                (type == STRKEY_MUXED_ACCOUNT && rawLength == MUXED_RAW_LENGTH);
+    }
+
+    if (valid) {
+        uint16_t expected = StellarUtils::crc16XModem(raw, rawLength - 2);
+        uint16_t actual = raw[rawLength - 2] | (raw[rawLength - 1] << 8);
+        valid = (expected == actual);
+    }
+
+    if (valid) {
+        *version = raw[0];
+        *payloadLength = rawLength - 3;
+
+        if (payload) {
+            memcpy(payload, raw + 1, *payloadLength);
+        }
+    }
+
+    StellarUtils::secureZero(raw, sizeof(raw));
+    return valid;
+}
+
+bool StellarStrKey::decode(const char* encoded, StrKeyType type, uint8_t key[32]) {
+    uint8_t version;
+    size_t length;
+    uint8_t payload[40];
+
+    bool valid = decodePayload(encoded, &version, payload, &length) &&
+                 version == (uint8_t)type &&
+                 length == 32;
+
+    if (valid) {
+        memcpy(key, payload, 32);
+    }
+
+    StellarUtils::secureZero(payload, sizeof(payload));
+    return valid;
+}
+
+bool StellarStrKey::decodeMuxed(const char* encoded, uint8_t key[32], uint64_t* id) {
+    uint8_t version;
+    size_t length;
+    uint8_t payload[40];
+
+    if (!decodePayload(encoded, &version, payload, &length) || version != STRKEY_MUXED_ACCOUNT) {
+        return false;
+    }
+
+    memcpy(key, payload, 32);
+
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | payload[32 + i];
+    }
+
+    if (id) {
+        *id = value;
+    }
+
+    return true;
+}
+
+bool StellarStrKey::decodeAccount(const char* encoded, uint8_t key[32], bool* muxed, uint64_t* id) {
+    if (encoded && encoded[0] == 'M') {
+        if (!decodeMuxed(encoded, key, id)) {
+            return false;
+        }
+
+        if (muxed) *muxed = true;
+        return true;
+    }
+
+    if (!decode(encoded, STRKEY_ACCOUNT_ID, key)) {
+        return false;
+    }
+
+    if (muxed) *muxed = false;
+    if (id) *id = 0;
+    return true;
+}
+
+bool StellarStrKey::isValid(const char* encoded) {
+    uint8_t version;
+    size_t length;
+
+    return decodePayload(encoded, &version, nullptr, &length);
+}
+
+bool StellarStrKey::isValid(const char* encoded, StrKeyType type) {
+    uint8_t version;
+    size_t length;
+
+    return decodePayload(encoded, &version, nullptr, &length) && version == (uint8_t)type;
+}
@@ -0,0 +1,91 @@
+#ifndef STELLAR_STRKEY_H
+#define STELLAR_STRKEY_H
+
+#include <Arduino.h>
+
+/**
+ * Codec StrKey (SEP-23): direcciones y claves Stellar en texto
+ *
+ * base32(version || payload || CRC16-XModem little-endian)
+ *
+ * Decodificación con una tabla de 256 entradas: caracteres, longitud,
+ * bits de relleno, version byte y checksum se validan en una sola pasada.
+ * Solo acepta la forma canónica (relleno a cero, sin minúsculas).
+ */
+
+enum StrKeyType {
+    STRKEY_ACCOUNT_ID = 6 << 3,     // 'G' - public key Ed25519
+    STRKEY_MUXED_ACCOUNT = 12 << 3, // 'M' - public key + id de 64 bits
+    STRKEY_SEED = 18 << 3           // 'S' - secret key Ed25519
+};
+
+#define STRKEY_ED25519_LENGTH 56    // G... / S...
+#define STRKEY_MUXED_LENGTH 69      // M...
+#define STRKEY_MAX_LENGTH 69
+
+class StellarStrKey {
+public:
+    /**
+     * Codifica una clave Ed25519 (G o S)
+     *
+     * @param type STRKEY_ACCOUNT_ID o STRKEY_SEED
+     * @param key 32 bytes
+     * @param output Buffer de STRKEY_ED25519_LENGTH + 1 caracteres
+     */
+    static void encode(StrKeyType type, const uint8_t key[32], char* output);
+
+    /**
+     * Codifica una cuenta muxed (M)
+     *
+     * @param key Public key (32 bytes)
+     * @param id Id de la subcuenta
+     * @param output Buffer de STRKEY_MUXED_LENGTH + 1 caracteres
+     */
+    static void encodeMuxed(const uint8_t key[32], uint64_t id, char* output);
+
+    /**
+     * Igual que encode() pero devuelve String
+     */
+    static String encode(StrKeyType type, const uint8_t key[32]);
+
+    /**
+     * Decodifica una clave Ed25519 del tipo esperado
+     *
+     * @param encoded Texto (56 caracteres)
+     * @param type STRKEY_ACCOUNT_ID o STRKEY_SEED
+     * @param key Salida (32 bytes)
+     * @return true si el formato, el tipo y el checksum son válidos
+     */
+    static bool decode(const char* encoded, StrKeyType type, uint8_t key[32]);
+
+    /**
+     * Decodifica una cuenta muxed (M)
+     */
+    static bool decodeMuxed(const char* encoded, uint8_t key[32], uint64_t* id);
+
+    /**
+     * Decodifica un destino que puede ser G o M
+     *
+     * @param muxed true si era M
+     * @param id Id de la subcuenta (0 si G)
+     */
+    static bool decodeAccount(const char* encoded, uint8_t key[32], bool* muxed, uint64_t* id);
+
+    /**
+     * Valida sin decodificar nada hacia fuera (G, S o M)
+     */
+    static bool isValid(const char* encoded);
+
+    /**
+     * Valida y comprueba el tipo
+     */
+    static bool isValid(const char* encoded, StrKeyType type);
+
+private:
+    // Decodifica y valida; payload recibe 32 o 40 bytes según el tipo
+    static bool decodePayload(const char* encoded, uint8_t* version, uint8_t* payload, size_t* payloadLength);
+
+    static void encodePayload(uint8_t version, const uint8_t* payload, size_t payloadLength, char* output);
+};
+
+#endif // STELLAR_STRKEY_H
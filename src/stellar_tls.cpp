@@ -0,0 +1,677 @@
+#include "stellar_tls.h"
+#include "stellar_crypto.h"
+#include "stellar_utils.h"
+#include <WiFi.h>
+#include <SPIFFS.h>
+#include <mbedtls/error.h>
+#include <lwip/sockets.h>
+#include <errno.h>
+
+// mbedTLS 3.x renombra los campos de mbedtls_ssl_session (private_xxx) y no
+// ofrece otra forma de saber si el handshake reanudó la sesión. En 2.x la
+// macro no existe y los campos son públicos
+#ifndef MBEDTLS_PRIVATE
+#define MBEDTLS_PRIVATE(member) member
+#endif
+
+#define TLS_SESSIONS_PATH "/tls_sessions.dat"
+#define TLS_SESSIONS_MAGIC 0x53534C54   // "TLSS"
+#define TLS_SESSIONS_VERSION 1
+
+struct TlsSessionFileHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t count;
+    uint16_t reserved;
+};
+
+// mbedTLS toma el aleatorio del DRBG del SDK (sin entropy + ctr_drbg propios)
+static int tlsRandom(void*, unsigned char* output, size_t length) {
+    StellarCrypto::randomBytes(output, length);
+    return 0;
+}
+
+static bool isWouldBlock(int ret) {
+    return ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+}
+
+// Sección crítica de la caché hasta salir del bloque
+class SessionCacheLock {
+public:
+    explicit SessionCacheLock(SemaphoreHandle_t mutex) : mutex(mutex) {
+        xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    }
+
+    ~SessionCacheLock() {
+        xSemaphoreGiveRecursive(mutex);
+    }
+
+private:
+    SemaphoreHandle_t mutex;
+};
+
+// ============================================
+// CACHÉ DE SESIONES
+// ============================================
+
+StellarTlsSessionCache::StellarTlsSessionCache() {
+    lock = xSemaphoreCreateRecursiveMutex();
+
+    for (size_t i = 0; i < STELLAR_TLS_SESSION_CACHE_SIZE; i++) {
+        entries[i].host[0] = '\0';
+        entries[i].lastUsed = 0;
+        mbedtls_ssl_session_init(&entries[i].session);
+    }
+
+    resetStats();
+}
+
+StellarTlsSessionCache::~StellarTlsSessionCache() {
+    clear();
+    vSemaphoreDelete(lock);
+}
+
+void StellarTlsSessionCache::release(Entry& entry) {
+    // mbedtls_ssl_session_free borra también el master secret
+    mbedtls_ssl_session_free(&entry.session);
+    mbedtls_ssl_session_init(&entry.session);
+    entry.host[0] = '\0';
+}
+
+StellarTlsSessionCache::Entry* StellarTlsSessionCache::find(const char* host) {
+    for (size_t i = 0; i < STELLAR_TLS_SESSION_CACHE_SIZE; i++) {
+        if (entries[i].host[0] != '\0' && strcmp(entries[i].host, host) == 0) {
+            return &entries[i];
+        }
+    }
+
+    return nullptr;
+}
+
+StellarTlsSessionCache::Entry* StellarTlsSessionCache::slotFor(const char* host) {
+    Entry* entry = find(host);
+    if (entry) {
+        return entry;
+    }
+
+    // Slot libre o el usado hace más tiempo
+    entry = &entries[0];
+    for (size_t i = 0; i < STELLAR_TLS_SESSION_CACHE_SIZE; i++) {
+        if (entries[i].host[0] == '\0') {
+            entry = &entries[i];
+            break;
+        }
+
+        if ((int32_t)(entries[i].lastUsed - entry->lastUsed) < 0) {
+            entry = &entries[i];
+        }
+    }
+
+    release(*entry);
+    memcpy(entry->host, host, strlen(host) + 1);
+    return entry;
+}
+
+bool StellarTlsSessionCache::apply(const char* host, mbedtls_ssl_context* ssl) {
+    SessionCacheLock guard(lock);
+
+    Entry* entry = find(host);
+    if (!entry) {
+        return false;
+    }
+
+    int ret = mbedtls_ssl_set_session(ssl, &entry->session);
+    if (ret != 0) {
+        STELLAR_LOGD("TLS", "Cached session for %s not usable (-0x%04x)", host, -ret);
+        release(*entry);
+        return false;
+    }
+
+    entry->lastUsed = millis();
+    return true;
+}
+
+bool StellarTlsSessionCache::update(const char* host, const mbedtls_ssl_context* ssl, bool offered) {
+    if (!host || strlen(host) > STELLAR_TLS_HOST_MAX) {
+        return false;
+    }
+
+    SessionCacheLock guard(lock);
+
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+
+    if (mbedtls_ssl_get_session(ssl, &session) != 0) {
+        mbedtls_ssl_session_free(&session);
+        return false;
+    }
+
+    // Handshake abreviado = mismo master secret que la sesión ofrecida
+    Entry* entry = find(host);
+    bool hit = offered && entry &&
+               memcmp(entry->session.MBEDTLS_PRIVATE(master), session.MBEDTLS_PRIVATE(master),
+                      sizeof(session.MBEDTLS_PRIVATE(master))) == 0;
+
+    if (hit) {
+        stats.hits++;
+    } else {
+        stats.misses++;
+        if (offered) stats.rejected++;
+    }
+
+    // La entrada pasa a ser dueña del ticket y el certificado de session
+    entry = slotFor(host);
+    mbedtls_ssl_session_free(&entry->session);
+    entry->session = session;
+    entry->lastUsed = millis();
+
+    return hit;
+}
+
+void StellarTlsSessionCache::remove(const char* host) {
+    SessionCacheLock guard(lock);
+
+    Entry* entry = find(host);
+    if (entry) {
+        release(*entry);
+    }
+}
+
+void StellarTlsSessionCache::clear() {
+    SessionCacheLock guard(lock);
+
+    for (size_t i = 0; i < STELLAR_TLS_SESSION_CACHE_SIZE; i++) {
+        release(entries[i]);
+    }
+}
+
+size_t StellarTlsSessionCache::size() const {
+    SessionCacheLock guard(lock);
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < STELLAR_TLS_SESSION_CACHE_SIZE; i++) {
+        if (entries[i].host[0] != '\0') count++;
+    }
+
+    return count;
+}
+
+void StellarTlsSessionCache::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ============================================
+// PERSISTENCIA
+// ============================================
+
+bool StellarTlsSessionCache::saveToFlash() {
+    if (!SPIFFS.begin(true)) {
+        STELLAR_LOGE("TLS", "Failed to mount SPIFFS");
+        return false;
+    }
+
+    uint8_t* blob = (uint8_t*)malloc(STELLAR_TLS_SESSION_MAX_BYTES);
+    if (!blob) {
+        STELLAR_LOGE("TLS", "Out of memory");
+        return false;
+    }
+
+    SessionCacheLock guard(lock);
+
+    File file = SPIFFS.open(TLS_SESSIONS_PATH, "w");
+    if (!file) {
+        STELLAR_LOGE("TLS", "Failed to open file for writing");
+        free(blob);
+        return false;
+    }
+
+    TlsSessionFileHeader header;
+    header.magic = TLS_SESSIONS_MAGIC;
+    header.version = TLS_SESSIONS_VERSION;
+    header.count = (uint8_t)size();
+    header.reserved = 0;
+
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+
+    // Por entrada: longitud + host, longitud + sesión serializada, CRC16
+    for (size_t i = 0; ok && i < STELLAR_TLS_SESSION_CACHE_SIZE; i++) {
+        Entry& entry = entries[i];
+        if (entry.host[0] == '\0') continue;
+
+        size_t length = 0;
+        if (mbedtls_ssl_session_save(&entry.session, blob, STELLAR_TLS_SESSION_MAX_BYTES, &length) != 0) {
+            STELLAR_LOGE("TLS", "Session for %s too large to save", entry.host);
+            ok = false;
+            break;
+        }
+
+        uint8_t hostLength = (uint8_t)strlen(entry.host);
+        uint16_t blobLength = (uint16_t)length;
+        uint16_t checksum = StellarUtils::crc16XModem(blob, length);
+
+        ok = file.write(&hostLength, 1) == 1 &&
+             file.write((const uint8_t*)entry.host, hostLength) == hostLength &&
+             file.write((const uint8_t*)&blobLength, 2) == 2 &&
+             file.write(blob, length) == length &&
+             file.write((const uint8_t*)&checksum, 2) == 2;
+    }
+
+    file.close();
+
+    StellarUtils::secureZero(blob, STELLAR_TLS_SESSION_MAX_BYTES);
+    free(blob);
+
+    if (!ok) {
+        STELLAR_LOGE("TLS", "Failed to write TLS sessions");
+        SPIFFS.remove(TLS_SESSIONS_PATH);
+        return false;
+    }
+
+    STELLAR_LOGI("TLS", "Saved %u TLS session(s)", (unsigned)header.count);
+    return true;
+}
+
+bool StellarTlsSessionCache::loadFromFlash() {
+    if (!SPIFFS.begin(false) || !SPIFFS.exists(TLS_SESSIONS_PATH)) {
+        return false;
+    }
+
+    File file = SPIFFS.open(TLS_SESSIONS_PATH, "r");
+    if (!file) {
+        STELLAR_LOGE("TLS", "Failed to open TLS sessions");
+        return false;
+    }
+
+    TlsSessionFileHeader header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != TLS_SESSIONS_MAGIC ||
+        header.version != TLS_SESSIONS_VERSION) {
+        STELLAR_LOGE("TLS", "Invalid TLS sessions file");
+        file.close();
+        return false;
+    }
+
+    uint8_t* blob = (uint8_t*)malloc(STELLAR_TLS_SESSION_MAX_BYTES);
+    if (!blob) {
+        STELLAR_LOGE("TLS", "Out of memory");
+        file.close();
+        return false;
+    }
+
+    SessionCacheLock guard(lock);
+
+    clear();
+
+    size_t loaded = 0;
+
+    for (uint8_t i = 0; i < header.count; i++) {
+        char host[STELLAR_TLS_HOST_MAX + 1];
+        uint8_t hostLength = 0;
+        uint16_t blobLength = 0;
+        uint16_t checksum = 0;
+
+        if (file.read(&hostLength, 1) != 1 || hostLength == 0 || hostLength > STELLAR_TLS_HOST_MAX ||
+            file.read((uint8_t*)host, hostLength) != hostLength ||
+            file.read((uint8_t*)&blobLength, 2) != 2 || blobLength > STELLAR_TLS_SESSION_MAX_BYTES ||
+            file.read(blob, blobLength) != blobLength ||
+            file.read((uint8_t*)&checksum, 2) != 2) {
+            STELLAR_LOGE("TLS", "Truncated TLS sessions file");
+            break;
+        }
+
+        host[hostLength] = '\0';
+
+        if (checksum != StellarUtils::crc16XModem(blob, blobLength)) {
+            STELLAR_LOGE("TLS", "Corrupted session for %s", host);
+            continue;
+        }
+
+        // Una sesión de otra versión de mbedTLS no se carga: handshake completo
+        Entry* entry = slotFor(host);
+        if (mbedtls_ssl_session_load(&entry->session, blob, blobLength) != 0) {
+            STELLAR_LOGD("TLS", "Discarding incompatible session for %s", host);
+            release(*entry);
+            continue;
+        }
+
+        entry->lastUsed = millis();
+        loaded++;
+    }
+
+    file.close();
+
+    StellarUtils::secureZero(blob, STELLAR_TLS_SESSION_MAX_BYTES);
+    free(blob);
+
+    STELLAR_LOGI("TLS", "Loaded %u TLS session(s)", (unsigned)loaded);
+    return loaded > 0;
+}
+
+void StellarTlsSessionCache::deleteFromFlash() {
+    if (SPIFFS.begin(false) && SPIFFS.exists(TLS_SESSIONS_PATH)) {
+        SPIFFS.remove(TLS_SESSIONS_PATH);
+    }
+}
+
+// ============================================
+// CLIENTE - CONEXIÓN
+// ============================================
+
+StellarTlsClient::StellarTlsClient()
+    : initialized(false),
+      active(false),
+      resumed(false),
+      peeked(-1),
+      handshakeTimeout(STELLAR_TLS_HANDSHAKE_TIMEOUT_MS),
+      ioTimeout(30000),
+      sessions(nullptr) {
+    mbedtls_net_init(&net);
+}
+
+StellarTlsClient::~StellarTlsClient() {
+    stop();
+}
+
+void StellarTlsClient::fail(const char* step, int error) {
+#if STELLAR_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_ERROR
+    char message[96];
+    mbedtls_strerror(error, message, sizeof(message));
+    STELLAR_LOGE("TLS", "%s failed: -0x%04x %s", step, -error, message);
+#else
+    // Sin log de errores no hay nada que traducir
+    (void)step;
+    (void)error;
+#endif
+}
+
+bool StellarTlsClient::openSocket(const char* host, uint16_t port, int32_t timeout) {
+    IPAddress address;
+    if (!WiFi.hostByName(host, address)) {
+        STELLAR_LOGE("TLS", "DNS lookup failed for %s", host);
+        return false;
+    }
+
+    int fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        STELLAR_LOGE("TLS", "Failed to create socket");
+        return false;
+    }
+
+    // No bloqueante: connect con timeout y lecturas que no congelan el loop
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = (uint32_t)address;
+    addr.sin_port = htons(port);
+
+    int res = lwip_connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+    if (res < 0 && errno != EINPROGRESS) {
+        STELLAR_LOGE("TLS", "Connect to %s failed (errno %d)", host, errno);
+        lwip_close(fd);
+        return false;
+    }
+
+    fd_set fdset;
+    FD_ZERO(&fdset);
+    FD_SET(fd, &fdset);
+
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+
+    int sockerr = 0;
+    socklen_t length = sizeof(sockerr);
+
+    if (lwip_select(fd + 1, nullptr, &fdset, nullptr, &tv) <= 0 ||
+        lwip_getsockopt(fd, SOL_SOCKET, SO_ERROR, &sockerr, &length) < 0 ||
+        sockerr != 0) {
+        STELLAR_LOGE("TLS", "Connect to %s timed out or failed", host);
+        lwip_close(fd);
+        return false;
+    }
+
+    // Peticiones pequeñas: sin esperar a Nagle
+    int one = 1;
+    lwip_setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    net.fd = fd;
+    return true;
+}
+
+bool StellarTlsClient::handshake(const char* host) {
+    mbedtls_ssl_init(&ssl);
+    mbedtls_ssl_config_init(&config);
+    initialized = true;
+
+    int ret = mbedtls_ssl_config_defaults(
+        &config,
+        MBEDTLS_SSL_IS_CLIENT,
+        MBEDTLS_SSL_TRANSPORT_STREAM,
+        MBEDTLS_SSL_PRESET_DEFAULT
+    );
+    if (ret != 0) {
+        fail("TLS config", ret);
+        return false;
+    }
+
+    // Sin verificar certificado, igual que WiFiClientSecure::setInsecure()
+    mbedtls_ssl_conf_authmode(&config, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&config, tlsRandom, nullptr);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&config, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+    if ((ret = mbedtls_ssl_setup(&ssl, &config)) != 0 ||
+        (ret = mbedtls_ssl_set_hostname(&ssl, host)) != 0) {
+        fail("TLS setup", ret);
+        return false;
+    }
+
+    mbedtls_ssl_set_bio(&ssl, &net, mbedtls_net_send, mbedtls_net_recv, nullptr);
+
+    bool offered = sessions && sessions->apply(host, &ssl);
+    uint32_t start = millis();
+
+    while ((ret = mbedtls_ssl_handshake(&ssl)) != 0) {
+        if (!isWouldBlock(ret) || millis() - start > handshakeTimeout) {
+            // La sesión ofrecida podría ser la causa: la próxima vez, completo
+            if (offered) sessions->remove(host);
+
+            if (isWouldBlock(ret)) {
+                STELLAR_LOGE("TLS", "Handshake with %s timed out", host);
+            } else {
+                fail("TLS handshake", ret);
+            }
+            return false;
+        }
+
+        delay(2);
+    }
+
+    resumed = sessions && sessions->update(host, &ssl, offered);
+
+    STELLAR_LOGD("TLS", "%s handshake with %s in %lums",
+                 resumed ? "Abbreviated" : "Full", host, (unsigned long)(millis() - start));
+
+    return true;
+}
+
+int StellarTlsClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port, (int32_t)handshakeTimeout);
+}
+
+int StellarTlsClient::connect(IPAddress ip, uint16_t port, int32_t timeout) {
+    return connect(ip.toString().c_str(), port, timeout);
+}
+
+int StellarTlsClient::connect(const char* host, uint16_t port) {
+    return connect(host, port, (int32_t)handshakeTimeout);
+}
+
+int StellarTlsClient::connect(const char* host, uint16_t port, int32_t timeout) {
+    stop();
+    resumed = false;
+
+    if (!host || timeout <= 0) {
+        return 0;
+    }
+
+    if (!openSocket(host, port, timeout) || !handshake(host)) {
+        stop();
+        return 0;
+    }
+
+    active = true;
+    return 1;
+}
+
+void StellarTlsClient::stop() {
+    if (initialized) {
+        // Aviso de cierre al servidor (sin esperar respuesta)
+        if (active) {
+            mbedtls_ssl_close_notify(&ssl);
+        }
+
+        mbedtls_ssl_free(&ssl);
+        mbedtls_ssl_config_free(&config);
+        initialized = false;
+    }
+
+    mbedtls_net_free(&net);
+    active = false;
+    peeked = -1;
+}
+
+// ============================================
+// CLIENTE - DATOS
+// ============================================
+
+int StellarTlsClient::readRecord(uint8_t* buf, size_t size) {
+    int ret = mbedtls_ssl_read(&ssl, buf, size);
+
+    if (ret > 0 || (ret == 0 && size == 0)) {
+        return ret;
+    }
+
+    if (isWouldBlock(ret)) {
+        return 0;
+    }
+
+    // close_notify o EOF: el servidor cerró (fin normal de keep-alive)
+    if (ret != 0 && ret != MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY && ret != MBEDTLS_ERR_SSL_CONN_EOF) {
+        fail("TLS read", ret);
+    }
+
+    active = false;
+    return -1;
+}
+
+int StellarTlsClient::available() {
+    int pending = peeked >= 0 ? 1 : 0;
+
+    if (!initialized) {
+        return pending;
+    }
+
+    // Procesa el siguiente registro sin consumir datos (detecta cierres)
+    if (active && mbedtls_ssl_get_bytes_avail(&ssl) == 0) {
+        readRecord(nullptr, 0);
+    }
+
+    return pending + (int)mbedtls_ssl_get_bytes_avail(&ssl);
+}
+
+int StellarTlsClient::read(uint8_t* buf, size_t size) {
+    if (!buf || size == 0 || available() <= 0) {
+        return -1;
+    }
+
+    size_t count = 0;
+
+    if (peeked >= 0) {
+        buf[count++] = (uint8_t)peeked;
+        peeked = -1;
+    }
+
+    if (count < size && mbedtls_ssl_get_bytes_avail(&ssl) > 0) {
+        int ret = readRecord(buf + count, size - count);
+        if (ret > 0) {
+            count += ret;
+        }
+    }
+
+    return count > 0 ? (int)count : -1;
+}
+
+int StellarTlsClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int StellarTlsClient::peek() {
+    if (peeked < 0 && initialized && available() > 0) {
+        uint8_t c;
+        if (readRecord(&c, 1) == 1) {
+            peeked = c;
+        }
+    }
+
+    return peeked;
+}
+
+size_t StellarTlsClient::write(const uint8_t* buf, size_t size) {
+    if (!active || !buf) {
+        return 0;
+    }
+
+    size_t sent = 0;
+    uint32_t start = millis();
+
+    while (sent < size) {
+        int ret = mbedtls_ssl_write(&ssl, buf + sent, size - sent);
+
+        if (ret > 0) {
+            sent += ret;
+            start = millis();
+            continue;
+        }
+
+        if (!isWouldBlock(ret)) {
+            fail("TLS write", ret);
+            active = false;
+            break;
+        }
+
+        if (millis() - start > ioTimeout) {
+            STELLAR_LOGE("TLS", "Write timed out");
+            break;
+        }
+
+        delay(1);
+    }
+
+    return sent;
+}
+
+size_t StellarTlsClient::write(uint8_t data) {
+    return write(&data, 1);
+}
+
+void StellarTlsClient::flush() {
+    // mbedtls_ssl_write ya envía cada registro completo
+}
+
+uint8_t StellarTlsClient::connected() {
+    if (!initialized) {
+        return 0;
+    }
+
+    if (active) {
+        available();
+    }
+
+    return active || peeked >= 0 || mbedtls_ssl_get_bytes_avail(&ssl) > 0;
+}
@@ -0,0 +1,191 @@
+#ifndef STELLAR_TLS_H
+#define STELLAR_TLS_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/net_sockets.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * Cliente TLS con reanudación de sesión
+ *
+ * WiFiClientSecure hace un handshake completo (ECDHE + firma del servidor)
+ * en cada conexión y no expone la sesión. StellarTlsClient es el mismo
+ * cliente mbedTLS sin verificación de certificado (igual que setInsecure())
+ * pero ofrece al servidor la sesión anterior del host: session ticket o
+ * session ID. Si la acepta, el handshake abreviado se ahorra el intercambio
+ * de claves y la verificación de firmas.
+ *
+ * StellarTlsSessionCache guarda una sesión por host en RAM, cuenta aciertos
+ * y fallos, y opcionalmente la persiste en flash para reanudar tras un
+ * deep sleep o un reinicio. Es segura entre tareas: la usan a la vez el
+ * worker de StellarNetwork y los clientes de loop() (StellarEventStream).
+ *
+ * CUIDADO: una sesión contiene el master secret. El archivo en flash no va
+ * cifrado; no usar saveToFlash() si la flash puede leerse.
+ */
+
+#ifndef STELLAR_TLS_SESSION_CACHE_SIZE
+#define STELLAR_TLS_SESSION_CACHE_SIZE 2        // Horizon + Friendbot
+#endif
+
+#ifndef STELLAR_TLS_HANDSHAKE_TIMEOUT_MS
+#define STELLAR_TLS_HANDSHAKE_TIMEOUT_MS 15000
+#endif
+
+#define STELLAR_TLS_HOST_MAX 64
+#define STELLAR_TLS_SESSION_MAX_BYTES 4096      // Sesión serializada (incluye el certificado)
+
+struct TlsSessionStats {
+    uint32_t hits;          // Handshakes abreviados
+    uint32_t misses;        // Handshakes completos (sin sesión o rechazada)
+    uint32_t rejected;      // ...de ellos, con sesión ofrecida
+};
+
+// ============================================
+// CACHÉ DE SESIONES
+// ============================================
+
+class StellarTlsSessionCache {
+public:
+    StellarTlsSessionCache();
+    ~StellarTlsSessionCache();
+
+    /**
+     * Ofrece la sesión guardada del host (antes del handshake)
+     *
+     * @return true si había sesión y se ofreció
+     */
+    bool apply(const char* host, mbedtls_ssl_context* ssl);
+
+    /**
+     * Guarda la sesión negociada y cuenta acierto/fallo (tras el handshake)
+     *
+     * @param offered Resultado de apply()
+     * @return true si el servidor reanudó la sesión ofrecida
+     */
+    bool update(const char* host, const mbedtls_ssl_context* ssl, bool offered);
+
+    /**
+     * Olvida la sesión de un host (handshake fallido)
+     */
+    void remove(const char* host);
+
+    /**
+     * Borra todas las sesiones
+     */
+    void clear();
+
+    /**
+     * Guarda las sesiones en flash (/tls_sessions.dat)
+     *
+     * @return true si éxito
+     */
+    bool saveToFlash();
+
+    /**
+     * Carga las sesiones guardadas en flash (reemplaza las de RAM)
+     *
+     * @return true si éxito
+     */
+    bool loadFromFlash();
+
+    /**
+     * Elimina el archivo de sesiones
+     */
+    static void deleteFromFlash();
+
+    size_t size() const;
+
+    const TlsSessionStats& getStats() const { return stats; }
+    void resetStats();
+
+private:
+    struct Entry {
+        char host[STELLAR_TLS_HOST_MAX + 1];    // "" = libre
+        mbedtls_ssl_session session;
+        uint32_t lastUsed;
+    };
+
+    Entry entries[STELLAR_TLS_SESSION_CACHE_SIZE];
+    TlsSessionStats stats;
+    SemaphoreHandle_t lock;         // Recursivo: loadFromFlash() llama a clear()
+
+    Entry* find(const char* host);
+    Entry* slotFor(const char* host);
+    static void release(Entry& entry);
+
+    // Contiene master secrets: no copiable
+    StellarTlsSessionCache(const StellarTlsSessionCache&) = delete;
+    StellarTlsSessionCache& operator=(const StellarTlsSessionCache&) = delete;
+};
+
+// ============================================
+// CLIENTE
+// ============================================
+
+class StellarTlsClient : public WiFiClient {
+public:
+    StellarTlsClient();
+    ~StellarTlsClient();
+
+    /**
+     * Caché de sesiones a usar (nullptr = siempre handshake completo)
+     */
+    void setSessionCache(StellarTlsSessionCache* cache) { sessions = cache; }
+
+    void setHandshakeTimeout(uint32_t ms) { handshakeTimeout = ms; }
+
+    /**
+     * Espera máxima de una escritura bloqueada (ms). No se usa setTimeout():
+     * HTTPClient la llama a través de WiFiClient* y no es virtual
+     */
+    void setIoTimeoutMs(uint32_t ms) { ioTimeout = ms; }
+
+    /**
+     * true si el último handshake reanudó una sesión
+     */
+    bool lastHandshakeResumed() const { return resumed; }
+
+    // Interfaz WiFiClient (la usa HTTPClient)
+    int connect(IPAddress ip, uint16_t port);
+    int connect(IPAddress ip, uint16_t port, int32_t timeout);
+    int connect(const char* host, uint16_t port);
+    int connect(const char* host, uint16_t port, int32_t timeout);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* buf, size_t size);
+    int available();
+    int read();
+    int read(uint8_t* buf, size_t size);
+    int peek();
+    void flush();
+    void stop();
+    uint8_t connected();
+
+    operator bool() { return connected(); }
+
+private:
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config config;
+    mbedtls_net_context net;
+    bool initialized;
+    bool active;
+    bool resumed;
+    int peeked;                 // Byte leído por peek() o -1
+    uint32_t handshakeTimeout;
+    uint32_t ioTimeout;
+    StellarTlsSessionCache* sessions;
+
+    bool openSocket(const char* host, uint16_t port, int32_t timeout);
+    bool handshake(const char* host);
+    int readRecord(uint8_t* buf, size_t size);
+    void fail(const char* step, int error);
+
+    // Contiene el contexto TLS: no copiable
+    StellarTlsClient(const StellarTlsClient&) = delete;
+    StellarTlsClient& operator=(const StellarTlsClient&) = delete;
+};
+
+#endif // STELLAR_TLS_H
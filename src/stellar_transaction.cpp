@@ -0,0 +1,373 @@
+#include "stellar_transaction.h"
+#include "stellar_strkey.h"
+#include "stellar_utils.h"
+
+// ============================================
+// ASSETS
+// ============================================
+
+StellarAsset StellarAsset::native() {
+    StellarAsset asset;
+    asset.type = ASSET_TYPE_NATIVE;
+    memset(asset.code, 0, sizeof(asset.code));
+    memset(asset.issuer, 0, sizeof(asset.issuer));
+    return asset;
+}
+
+bool StellarAsset::credit(const char* code, const char* issuer, StellarAsset& asset) {
+    size_t codeLength = code ? strlen(code) : 0;
+
+    if (codeLength == 0 || codeLength > 12) {
+        STELLAR_LOGE("Transaction", "Asset code must be 1-12 characters");
+        return false;
+    }
+
+    for (size_t i = 0; i < codeLength; i++) {
+        if (!isalnum((unsigned char)code[i])) {
+            STELLAR_LOGE("Transaction", "Asset code must be alphanumeric");
+            return false;
+        }
+    }
+
+    if (!StellarStrKey::decode(issuer, STRKEY_ACCOUNT_ID, asset.issuer)) {
+        STELLAR_LOGE("Transaction", "Invalid asset issuer");
+        return false;
+    }
+
+    asset.type = codeLength <= 4 ? ASSET_TYPE_CREDIT_ALPHANUM4 : ASSET_TYPE_CREDIT_ALPHANUM12;
+    memset(asset.code, 0, sizeof(asset.code));
+    memcpy(asset.code, code, codeLength);
+
+    return true;
+}
+
+// ============================================
+// CONSTRUCTOR / DESTRUCTOR
+// ============================================
+
+StellarTransaction::StellarTransaction() : operationCount(0) {
+    clearMemo();
+}
+
+StellarTransaction::~StellarTransaction() {
+    // El buffer de operaciones lo libera XDREncoder
+}
+
+void StellarTransaction::clear() {
+    operations.reset();
+    operationCount = 0;
+    clearMemo();
+    lastError = "";
+}
+
+// ============================================
+// OPERACIONES
+// ============================================
+
+bool StellarTransaction::addOperation(const XDRSchema::AnyOperation::Value& operation) {
+    if (operationCount >= MAX_OPERATIONS) {
+        return fail("Too many operations (max 100)");
+    }
+
+    if (!XDRSchema::AnyOperation::isSupported(operation.type)) {
+        return fail("Unsupported operation type");
+    }
+
+    if (!XDRSchema::encode<XDRSchema::AnyOperation>(operations, operation)) {
+        return fail("Out of memory encoding operation");
+    }
+
+    operationCount++;
+
+    STELLAR_LOGD("Transaction", "Operation %u added (type %d)", (unsigned)operationCount, (int)operation.type);
+
+    return true;
+}
+
+bool StellarTransaction::addPayment(
+    const char* destination,
+    int64_t amount,
+    const StellarAsset& asset
+) {
+    if (amount <= 0) {
+        return fail("Invalid payment amount");
+    }
+
+    uint8_t destinationKey[32];
+    XDRSchema::AnyOperation::Value operation;
+    operation.hasSourceAccount = false;
+    operation.type = PAYMENT;
+
+    XDRSchema::PaymentOp::Value& payment = operation.body.payment;
+    if (!decodeMuxedDestination(destination, destinationKey, payment.destination)) {
+        return false;
+    }
+    toSchemaAsset(asset, payment.asset);
+    payment.amount = amount;
+
+    return addOperation(operation);
+}
+
+bool StellarTransaction::addCreateAccount(const char* destination, int64_t startingBalance) {
+    if (startingBalance <= 0) {
+        return fail("Invalid starting balance");
+    }
+
+    uint8_t destinationKey[32];
+    if (!decodeDestination(destination, destinationKey)) {
+        return false;
+    }
+
+    XDRSchema::AnyOperation::Value operation;
+    operation.hasSourceAccount = false;
+    operation.type = CREATE_ACCOUNT;
+    operation.body.createAccount.destination = destinationKey;
+    operation.body.createAccount.startingBalance = startingBalance;
+
+    return addOperation(operation);
+}
+
+bool StellarTransaction::addChangeTrust(const StellarAsset& asset, int64_t limit) {
+    if (asset.type == ASSET_TYPE_NATIVE) {
+        return fail("Cannot create trustline to native asset");
+    }
+
+    if (limit < 0) {
+        return fail("Invalid trustline limit");
+    }
+
+    XDRSchema::AnyOperation::Value operation;
+    operation.hasSourceAccount = false;
+    operation.type = CHANGE_TRUST;
+    toSchemaAsset(asset, operation.body.changeTrust.line);
+    operation.body.changeTrust.limit = limit;
+
+    return addOperation(operation);
+}
+
+bool StellarTransaction::addManageData(const char* name, const uint8_t* value, size_t valueLength) {
+    size_t nameLength = name ? strlen(name) : 0;
+
+    if (nameLength == 0 || nameLength > XDRSchema::ManageDataOp::MAX_NAME_LENGTH) {
+        return fail("Data name must be 1-64 bytes");
+    }
+
+    if (value && valueLength > XDRSchema::ManageDataOp::MAX_VALUE_LENGTH) {
+        return fail("Data value too long (max 64 bytes)");
+    }
+
+    XDRSchema::AnyOperation::Value operation;
+    operation.hasSourceAccount = false;
+    operation.type = MANAGE_DATA;
+
+    XDRSchema::ManageDataOp::Value& data = operation.body.manageData;
+    data.name.data = (const uint8_t*)name;
+    data.name.length = nameLength;
+    data.hasValue = (value != nullptr);
+    data.value.data = value;
+    data.value.length = value ? valueLength : 0;
+
+    return addOperation(operation);
+}
+
+bool StellarTransaction::addPathPaymentStrictReceive(
+    const StellarAsset& sendAsset,
+    int64_t sendMax,
+    const char* destination,
+    const StellarAsset& destAsset,
+    int64_t destAmount,
+    const StellarAsset* path,
+    size_t pathLength
+) {
+    if (sendMax <= 0 || destAmount <= 0) {
+        return fail("Invalid path payment amount");
+    }
+
+    uint8_t destinationKey[32];
+    XDRSchema::AnyOperation::Value operation;
+    operation.hasSourceAccount = false;
+    operation.type = PATH_PAYMENT_STRICT_RECEIVE;
+
+    XDRSchema::PathPaymentStrictReceiveOp::Value& op = operation.body.pathPaymentStrictReceive;
+    if (!decodeMuxedDestination(destination, destinationKey, op.destination)) {
+        return false;
+    }
+
+    toSchemaAsset(sendAsset, op.sendAsset);
+    op.sendMax = sendMax;
+    toSchemaAsset(destAsset, op.destAsset);
+    op.destAmount = destAmount;
+
+    if (!fillPath(op.path, path, pathLength)) {
+        return false;
+    }
+
+    return addOperation(operation);
+}
+
+bool StellarTransaction::addPathPaymentStrictSend(
+    const StellarAsset& sendAsset,
+    int64_t sendAmount,
+    const char* destination,
+    const StellarAsset& destAsset,
+    int64_t destMin,
+    const StellarAsset* path,
+    size_t pathLength
+) {
+    if (sendAmount <= 0 || destMin <= 0) {
+        return fail("Invalid path payment amount");
+    }
+
+    uint8_t destinationKey[32];
+    XDRSchema::AnyOperation::Value operation;
+    operation.hasSourceAccount = false;
+    operation.type = PATH_PAYMENT_STRICT_SEND;
+
+    XDRSchema::PathPaymentStrictSendOp::Value& op = operation.body.pathPaymentStrictSend;
+    if (!decodeMuxedDestination(destination, destinationKey, op.destination)) {
+        return false;
+    }
+
+    toSchemaAsset(sendAsset, op.sendAsset);
+    op.sendAmount = sendAmount;
+    toSchemaAsset(destAsset, op.destAsset);
+    op.destMin = destMin;
+
+    if (!fillPath(op.path, path, pathLength)) {
+        return false;
+    }
+
+    return addOperation(operation);
+}
+
+// ============================================
+// MEMO
+// ============================================
+
+bool StellarTransaction::setMemoText(const char* text) {
+    size_t length = text ? strlen(text) : 0;
+
+    if (length > XDRSchema::Memo::MAX_TEXT_LENGTH) {
+        return fail("Memo too long (max 28 bytes)");
+    }
+
+    memoType = MEMO_TEXT;
+    memset(memoText, 0, sizeof(memoText));
+    if (length > 0) {
+        memcpy(memoText, text, length);
+    }
+
+    return true;
+}
+
+void StellarTransaction::setMemoId(uint64_t id) {
+    memoType = MEMO_ID;
+    memoId = id;
+}
+
+bool StellarTransaction::setMemoHash(const uint8_t* hash) {
+    if (!hash) {
+        return fail("Invalid memo hash");
+    }
+
+    memoType = MEMO_HASH;
+    memcpy(memoHash, hash, 32);
+    return true;
+}
+
+bool StellarTransaction::setMemoReturn(const uint8_t* hash) {
+    if (!hash) {
+        return fail("Invalid memo hash");
+    }
+
+    memoType = MEMO_RETURN;
+    memcpy(memoHash, hash, 32);
+    return true;
+}
+
+void StellarTransaction::clearMemo() {
+    memoType = MEMO_NONE;
+    memoId = 0;
+    memset(memoText, 0, sizeof(memoText));
+    memset(memoHash, 0, sizeof(memoHash));
+}
+
+// ============================================
+// ENCODING
+// ============================================
+
+void StellarTransaction::fillTransaction(XDRSchema::MultiOpTransaction::Value& tx) const {
+    tx.memo.type = memoType;
+    tx.memo.text.data = (const uint8_t*)memoText;
+    tx.memo.text.length = (memoType == MEMO_TEXT) ? strlen(memoText) : 0;
+    tx.memo.id = memoId;
+    tx.memo.hash = memoHash;
+
+    // Operaciones ya encodeadas: se copian tal cual
+    tx.operationCount = operationCount;
+    tx.operations = nullptr;
+    tx.encodedOperations.data = operations.getData();
+    tx.encodedOperations.length = operations.getSize();
+}
+
+// ============================================
+// HELPERS PRIVADOS
+// ============================================
+
+bool StellarTransaction::fail(const char* message) {
+    lastError = message;
+    STELLAR_LOGE("Transaction", "%s", message);
+    return false;
+}
+
+bool StellarTransaction::decodeDestination(const char* address, uint8_t publicKey[32]) {
+    if (!StellarStrKey::decode(address, STRKEY_ACCOUNT_ID, publicKey)) {
+        return fail("Invalid destination address");
+    }
+
+    return true;
+}
+
+bool StellarTransaction::decodeMuxedDestination(
+    const char* address,
+    uint8_t publicKey[32],
+    XDRSchema::MuxedAccount::Value& out
+) {
+    if (!StellarStrKey::decodeAccount(address, publicKey, &out.muxed, &out.id)) {
+        return fail("Invalid destination address");
+    }
+
+    out.ed25519 = publicKey;
+    return true;
+}
+
+bool StellarTransaction::fillPath(
+    XDRSchema::AssetPath::Value& out,
+    const StellarAsset* path,
+    size_t pathLength
+) {
+    if (pathLength > MAX_PATH_LENGTH || (pathLength > 0 && !path)) {
+        return fail("Invalid asset path (max 5 assets)");
+    }
+
+    out.count = pathLength;
+
+    for (size_t i = 0; i < pathLength; i++) {
+        toSchemaAsset(path[i], out.assets[i]);
+    }
+
+    return true;
+}
+
+void StellarTransaction::toSchemaAsset(const StellarAsset& asset, XDRSchema::Asset::Value& out) {
+    out.type = asset.type;
+    memset(out.code, 0, sizeof(out.code));
+
+    if (asset.type == ASSET_TYPE_NATIVE) {
+        out.issuer = nullptr;
+        return;
+    }
+
+    memcpy(out.code, asset.code, strlen(asset.code));
+    out.issuer = asset.issuer;
+}
@@ -0,0 +1,200 @@
+#ifndef STELLAR_TRANSACTION_H
+#define STELLAR_TRANSACTION_H
+
+#include <Arduino.h>
+#include "stellar_xdr.h"
+#include "stellar_xdr_schema.h"
+
+/**
+ * Transacciones multi-operación
+ *
+ * Acumula hasta 100 operaciones (pagos, path payments, create account,
+ * change trust, manage data) y un memo de cualquier tipo. Cada operación
+ * se encodea a XDR al agregarla, así que la transacción solo guarda los
+ * bytes finales y StellarPayment los firma y envía en un solo envelope.
+ *
+ * Uso:
+ *   StellarTransaction tx;
+ *   tx.addPayment("GABC...", 1000000);
+ *   tx.addPayment("GDEF...", 2500000);
+ *   tx.setMemoId(42);
+ *   payment.submitTransaction(tx);
+ *
+ * Los montos van en stroops (1 XLM = 10,000,000 stroops).
+ */
+
+/**
+ * Asset clásico (XLM o token alphanum4/12)
+ */
+struct StellarAsset {
+    AssetType type;
+    char code[13];          // Null-terminated
+    uint8_t issuer[32];     // Clave pública del emisor
+
+    /**
+     * Asset nativo (XLM)
+     */
+    static StellarAsset native();
+
+    /**
+     * Asset emitido por una cuenta
+     *
+     * @param code Código (1-12 caracteres alfanuméricos)
+     * @param issuer Public key del emisor (G...)
+     * @param asset Asset resultante
+     * @return true si el código y el emisor son válidos
+     */
+    static bool credit(const char* code, const char* issuer, StellarAsset& asset);
+};
+
+class StellarTransaction {
+public:
+    static const uint32_t MAX_OPERATIONS = XDRSchema::MAX_OPERATIONS;
+    static const size_t MAX_PATH_LENGTH = XDRSchema::AssetPath::MAX_ASSETS;
+
+    StellarTransaction();
+    ~StellarTransaction();
+
+    // ============================================
+    // OPERACIONES
+    // ============================================
+
+    /**
+     * Agrega un pago
+     *
+     * @param destination Cuenta destino (G... o muxed M...)
+     * @param amount Cantidad en stroops
+     * @param asset Asset a enviar (XLM por defecto)
+     */
+    bool addPayment(
+        const char* destination,
+        int64_t amount,
+        const StellarAsset& asset = StellarAsset::native()
+    );
+
+    /**
+     * Crea y fondea una cuenta nueva
+     *
+     * @param destination Public key de la cuenta nueva (G...)
+     * @param startingBalance Balance inicial en stroops
+     */
+    bool addCreateAccount(const char* destination, int64_t startingBalance);
+
+    /**
+     * Crea, modifica o elimina (limit = 0) una trustline
+     *
+     * @param asset Asset (no native)
+     * @param limit Límite en stroops (INT64_MAX = sin límite)
+     */
+    bool addChangeTrust(const StellarAsset& asset, int64_t limit = INT64_MAX);
+
+    /**
+     * Escribe o elimina (value = nullptr) una entrada de datos de la cuenta
+     *
+     * @param name Nombre (1-64 bytes)
+     * @param value Valor (hasta 64 bytes) o nullptr para eliminar
+     * @param valueLength Longitud del valor
+     */
+    bool addManageData(const char* name, const uint8_t* value, size_t valueLength);
+
+    /**
+     * Path payment recibiendo una cantidad exacta
+     *
+     * @param sendAsset Asset que se envía
+     * @param sendMax Máximo a gastar en stroops
+     * @param destination Cuenta destino (G... o muxed M...)
+     * @param destAsset Asset que recibe el destino
+     * @param destAmount Cantidad exacta a recibir en stroops
+     * @param path Assets intermedios (hasta 5)
+     * @param pathLength Número de assets intermedios
+     */
+    bool addPathPaymentStrictReceive(
+        const StellarAsset& sendAsset,
+        int64_t sendMax,
+        const char* destination,
+        const StellarAsset& destAsset,
+        int64_t destAmount,
+        const StellarAsset* path = nullptr,
+        size_t pathLength = 0
+    );
+
+    /**
+     * Path payment enviando una cantidad exacta
+     *
+     * @param sendAsset Asset que se envía
+     * @param sendAmount Cantidad exacta a enviar en stroops
+     * @param destination Cuenta destino (G... o muxed M...)
+     * @param destAsset Asset que recibe el destino
+     * @param destMin Mínimo a recibir en stroops
+     * @param path Assets intermedios (hasta 5)
+     * @param pathLength Número de assets intermedios
+     */
+    bool addPathPaymentStrictSend(
+        const StellarAsset& sendAsset,
+        int64_t sendAmount,
+        const char* destination,
+        const StellarAsset& destAsset,
+        int64_t destMin,
+        const StellarAsset* path = nullptr,
+        size_t pathLength = 0
+    );
+
+    /**
+     * Agrega una operación ya descrita con el esquema XDR
+     * (permite source account por operación)
+     */
+    bool addOperation(const XDRSchema::AnyOperation::Value& operation);
+
+    // ============================================
+    // MEMO
+    // ============================================
+
+    bool setMemoText(const char* text);
+    void setMemoId(uint64_t id);
+    bool setMemoHash(const uint8_t* hash);
+    bool setMemoReturn(const uint8_t* hash);
+    void clearMemo();
+
+    // ============================================
+    // ESTADO
+    // ============================================
+
+    uint32_t getOperationCount() const { return operationCount; }
+
+    /**
+     * Elimina operaciones y memo
+     */
+    void clear();
+
+    /**
+     * Completa memo y operaciones de una transacción a encodear
+     * (source, fee, sequence y preconditions los pone StellarPayment)
+     */
+    void fillTransaction(XDRSchema::MultiOpTransaction::Value& tx) const;
+
+    String getLastError() const { return lastError; }
+
+private:
+    XDREncoder operations;
+    uint32_t operationCount;
+
+    MemoType memoType;
+    char memoText[XDRSchema::Memo::MAX_TEXT_LENGTH + 1];
+    uint64_t memoId;
+    uint8_t memoHash[32];
+
+    String lastError;
+
+    bool fail(const char* message);
+    bool decodeDestination(const char* address, uint8_t publicKey[32]);
+    // G... o M... (cuenta muxed); out.ed25519 apunta a publicKey
+    bool decodeMuxedDestination(const char* address, uint8_t publicKey[32], XDRSchema::MuxedAccount::Value& out);
+    bool fillPath(XDRSchema::AssetPath::Value& out, const StellarAsset* path, size_t pathLength);
+    static void toSchemaAsset(const StellarAsset& asset, XDRSchema::Asset::Value& out);
+
+    // No copiable: las operaciones tienen un solo buffer
+    StellarTransaction(const StellarTransaction&) = delete;
+    StellarTransaction& operator=(const StellarTransaction&) = delete;
+};
+
+#endif // STELLAR_TRANSACTION_H
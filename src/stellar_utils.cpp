@@ -1,4 +1,5 @@
 #include "stellar_utils.h"
+#include "stellar_strkey.h"
 #include <esp_system.h>
 #include <esp_heap_caps.h>
 
@@ -212,19 +213,58 @@ String StellarUtils::urlEncode(const String& str) {
 // CHECKSUMS
 // ============================================
 
+// Tablas slice-by-4 generadas en compilación (2 KB en flash)
+// CRC16_TABLE[k][x] = CRC de x seguido de k bytes a cero
+static constexpr uint16_t CRC16_POLY = 0x1021;
+
+static constexpr uint16_t crc16Shift(uint16_t crc, int bits) {
+    return bits == 0 ? crc :
+           crc16Shift((crc & 0x8000) ? (uint16_t)((crc << 1) ^ CRC16_POLY) : (uint16_t)(crc << 1), bits - 1);
+}
+
+static constexpr uint16_t crc16Entry(unsigned slice, unsigned value) {
+    return slice == 0 ? crc16Shift((uint16_t)(value << 8), 8) :
+           (uint16_t)((crc16Entry(slice - 1, value) << 8) ^
+                      crc16Shift((uint16_t)(crc16Entry(slice - 1, value) & 0xFF00), 8));
+}
+
+template<unsigned... I> struct Crc16Indices {};
+template<unsigned N, unsigned... I> struct Crc16MakeIndices : Crc16MakeIndices<N - 1, N - 1, I...> {};
+template<unsigned... I> struct Crc16MakeIndices<0, I...> { typedef Crc16Indices<I...> type; };
+
+template<typename T> struct Crc16Tables;
+template<unsigned... I> struct Crc16Tables<Crc16Indices<I...>> {
+    static constexpr uint16_t value[4][256] = {
+        { crc16Entry(0, I)... },
+        { crc16Entry(1, I)... },
+        { crc16Entry(2, I)... },
+        { crc16Entry(3, I)... }
+    };
+};
+
+template<unsigned... I>
+constexpr uint16_t Crc16Tables<Crc16Indices<I...>>::value[4][256];
+
+typedef Crc16Tables<Crc16MakeIndices<256>::type> Crc16Table;
+
+static_assert(Crc16Table::value[0][1] == CRC16_POLY, "CRC16 table generation");
+
 uint16_t StellarUtils::crc16XModem(const uint8_t* data, size_t length) {
+    const uint16_t (*table)[256] = Crc16Table::value;
     uint16_t crc = 0x0000;
     
-    for (size_t i = 0; i < length; i++) {
-        crc ^= (uint16_t)data[i] << 8;
-        
-        for (int j = 0; j < 8; j++) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ 0x1021;
-            } else {
-                crc = crc << 1;
-            }
-        }
+    // 4 bytes por iteración: el CRC se mezcla con los dos primeros
+    while (length >= 4) {
+        crc = table[3][(crc >> 8) ^ data[0]] ^
+              table[2][(crc & 0xFF) ^ data[1]] ^
+              table[1][data[2]] ^
+              table[0][data[3]];
+        data += 4;
+        length -= 4;
+    }
+    
+    while (length--) {
+        crc = (crc << 8) ^ table[0][(crc >> 8) ^ *data++];
     }
     
     return crc;
@@ -235,24 +275,8 @@ uint16_t StellarUtils::crc16XModem(const uint8_t* data, size_t length) {
 // ============================================
 
 bool StellarUtils::isValidAddress(const char* address) {
-    if (!address) return false;
-    
-    size_t len = strlen(address);
-    if (len != 56) return false;
-    
-    // Debe empezar con G (public) o S (secret)
-    char first = address[0];
-    if (first != 'G' && first != 'S') return false;
-    
-    // Verificar caracteres base32 válidos
-    const char* validChars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
-    for (size_t i = 1; i < len; i++) {
-        if (!strchr(validChars, address[i])) {
-            return false;
-        }
-    }
-    
-    return true;
+    // G (public), S (secret) o M (muxed) con checksum correcto
+    return StellarStrKey::isValid(address);
 }
 
 bool StellarUtils::isValidAmount(float xlm) {
@@ -331,6 +355,54 @@ void StellarUtils::infoPrint(const char* tag, const char* info) {
     #endif
 }
 
+// Prefijo común: [LEVEL][millis][tag]
+static void logPrefix(const char* level, const char* tag) {
+    Serial.print("[");
+    Serial.print(level);
+    Serial.print("][");
+    Serial.print(millis());
+    Serial.print("][");
+    Serial.print(tag);
+    Serial.print("] ");
+}
+
+void StellarUtils::logPrintf(const char* level, const char* tag, const char* format, ...) {
+    char message[STELLAR_LOG_BUFFER_SIZE];
+    
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);  // Trunca si no cabe
+    va_end(args);
+    
+    logPrefix(level, tag);
+    Serial.println(message);
+}
+
+void StellarUtils::logHex(const char* level, const char* tag, const char* label,
+                          const uint8_t* data, size_t length) {
+    static const char HEX_CHARS[] = "0123456789abcdef";
+    
+    logPrefix(level, tag);
+    Serial.print(label);
+    
+    // Por bloques en un buffer fijo
+    char chunk[64];
+    size_t used = 0;
+    
+    for (size_t i = 0; i < length; i++) {
+        chunk[used++] = HEX_CHARS[data[i] >> 4];
+        chunk[used++] = HEX_CHARS[data[i] & 0x0F];
+        
+        if (used == sizeof(chunk)) {
+            Serial.write((const uint8_t*)chunk, used);
+            used = 0;
+        }
+    }
+    
+    Serial.write((const uint8_t*)chunk, used);
+    Serial.println();
+}
+
 // ============================================
 // HELPERS DE MEMORIA
 // ============================================
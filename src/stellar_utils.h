@@ -20,7 +20,7 @@ public:
     static uint16_t crc16XModem(const uint8_t* data, size_t length);
     
     // VALIDACIÓN
-    static bool isValidAddress(const char* address);
+    static bool isValidAddress(const char* address);  // StrKey G/S/M con checksum
     static bool isValidAmount(float xlm);
     static bool isValidMemo(const char* memo);
     
@@ -30,10 +30,61 @@ public:
     static void errorPrint(const char* tag, const char* error);
     static void infoPrint(const char* tag, const char* info);
     
+    // Backend de los macros STELLAR_LOG*: formatea en buffer fijo (sin heap)
+    static void logPrintf(const char* level, const char* tag, const char* format, ...)
+        __attribute__((format(printf, 3, 4)));
+    static void logHex(const char* level, const char* tag, const char* label,
+                       const uint8_t* data, size_t length);
+    
     // HELPERS DE MEMORIA
     static void secureZero(void* buffer, size_t size);
     static uint32_t getFreeHeap();
     static String getMemoryInfo();
 };
 
-#endif
\ No newline at end of file
+// ============================================
+// LOGGING
+// ============================================
+//
+// Filtrado por nivel en compilación: los logs deshabilitados no evalúan
+// sus argumentos, así que no construyen Strings ni formatean nada.
+// Los habilitados formatean con printf en un buffer fijo en stack.
+//
+//   STELLAR_LOGD("Payment", "Amount: %lld stroops", (long long)amount);
+//   STELLAR_LOGD_HEX("Payment", "TX Hash: ", txHash, 32);
+
+#ifndef STELLAR_LOG_LEVEL
+#ifdef CORE_DEBUG_LEVEL
+#define STELLAR_LOG_LEVEL CORE_DEBUG_LEVEL
+#else
+#define STELLAR_LOG_LEVEL 0
+#endif
+#endif
+
+#ifndef STELLAR_LOG_BUFFER_SIZE
+#define STELLAR_LOG_BUFFER_SIZE 128
+#endif
+
+#define STELLAR_LOG_NONE(...) do {} while (0)
+
+#if STELLAR_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_ERROR
+#define STELLAR_LOGE(tag, format, ...) StellarUtils::logPrintf("ERROR", tag, format, ##__VA_ARGS__)
+#else
+#define STELLAR_LOGE(tag, format, ...) STELLAR_LOG_NONE()
+#endif
+
+#if STELLAR_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO
+#define STELLAR_LOGI(tag, format, ...) StellarUtils::logPrintf("INFO", tag, format, ##__VA_ARGS__)
+#else
+#define STELLAR_LOGI(tag, format, ...) STELLAR_LOG_NONE()
+#endif
+
+#if STELLAR_LOG_LEVEL >= ARDUHAL_LOG_LEVEL_DEBUG
+#define STELLAR_LOGD(tag, format, ...) StellarUtils::logPrintf("DEBUG", tag, format, ##__VA_ARGS__)
+#define STELLAR_LOGD_HEX(tag, label, data, length) StellarUtils::logHex("DEBUG", tag, label, data, length)
+#else
+#define STELLAR_LOGD(tag, format, ...) STELLAR_LOG_NONE()
+#define STELLAR_LOGD_HEX(tag, label, data, length) STELLAR_LOG_NONE()
+#endif
+
+#endif
@@ -283,6 +283,12 @@ button svg{flex-shrink:0;opacity:.85}
             <path d="M7 11V7a5 5 0 0 1 10 0v4"/>
           </svg>Crypto Tests
         </button>
+        <button class="bg" onclick="cmd('/api/crypto/bench','GET','crypto bench')">
+          <svg width="12" height="12" viewBox="0 0 24 24" fill="none" stroke="currentColor" stroke-width="2">
+            <circle cx="12" cy="12" r="10"/>
+            <polyline points="12 6 12 12 16 14"/>
+          </svg>Crypto Bench
+        </button>
         <button class="bg" onclick="cmd('/api/memory','GET','memory')">
           <svg width="12" height="12" viewBox="0 0 24 24" fill="none" stroke="currentColor" stroke-width="2">
             <rect x="4" y="4" width="16" height="16" rx="2"/>
@@ -437,7 +443,13 @@ document.addEventListener('keydown', e => {
 async function apiFetch(url, method, body) {
   const opts = { method: method || 'GET', headers: { 'Content-Type': 'application/json' } };
   if (body) opts.body = JSON.stringify(body);
-  const r = await fetch(url, opts);
+  let r = await fetch(url, opts);
+  // 202: the ESP32 is still talking to Horizon, ask again shortly
+  const poll = url + (url.indexOf('?') < 0 ? '?' : '&') + 'poll=1';
+  while (r.status === 202) {
+    await new Promise(res => setTimeout(res, 500));
+    r = await fetch(poll);
+  }
   return r.json();
 }
 
@@ -549,7 +561,9 @@ StellarWebServer::StellarWebServer(
     _keypair(keypair),
     _network(network),
     _account(account),
-    _payment(payment)
+    _payment(payment),
+    _job(JOB_NONE),
+    _requestDoc(nullptr)
 {}
 
 // ============================================================
@@ -586,10 +600,12 @@ void StellarWebServer::_setupRoutes() {
     _server.on("/api/network/info",    HTTP_GET, [this]() { _handleNetworkInfo();    });
 
     _server.on("/api/pay/send",       HTTP_POST, [this]() { _handlePaySend();        });
+    _server.on("/api/pay/send",       HTTP_GET,  [this]() { _handlePaySendPoll();    });
     _server.on("/api/pay/status",     HTTP_GET,  [this]() { _handlePayStatus();      });
     _server.on("/api/pay/history",    HTTP_GET,  [this]() { _handlePayHistory();     });
 
     _server.on("/api/crypto/test",    HTTP_GET,  [this]() { _handleCryptoTest();     });
+    _server.on("/api/crypto/bench",   HTTP_GET,  [this]() { _handleCryptoBench();    });
     _server.on("/api/memory",         HTTP_GET,  [this]() { _handleMemory();         });
 }
 
@@ -625,9 +641,79 @@ void StellarWebServer::_sendJson(bool success, const String& message,
     _server.send(200, "application/json", json);
 }
 
+void StellarWebServer::_sendPending() {
+    _server.sendHeader("Access-Control-Allow-Origin", "*");
+    _server.send(202, "application/json", "{\"success\":true,\"pending\":true}");
+}
+
+bool StellarWebServer::_runJob(DashboardJob job) {
+    if (_server.hasArg("poll")) {
+        if (_job != job) {
+            _sendJson(false, "", "", "No request in progress");
+            return false;
+        }
+        if (_request.isPending()) {
+            _sendPending();
+            return false;
+        }
+        _job = JOB_NONE;
+        return true;
+    }
+
+    // The worker still writes into _request and _requestDoc
+    if (_request.isPending()) {
+        _sendJson(false, "", "", "Another network request is in progress");
+        return false;
+    }
+
+    _ensureManagers();
+    StellarNetwork& network = **_network;
+
+    size_t docSize = HORIZON_ACCOUNT_DOC_SIZE;
+    if (job == JOB_FUND)    docSize = 128;     // Only the funding tx hash
+    if (job == JOB_STATUS)  docSize = HORIZON_TRANSACTION_DOC_SIZE;
+    if (job == JOB_HISTORY) docSize = HORIZON_PAYMENT_DOC_SIZE * 10;
+
+    delete _requestDoc;
+    _requestDoc = new DynamicJsonDocument(docSize);
+
+    const char* accountId = *_keypair ? (*_keypair)->getPublicKeyCStr() : nullptr;
+    switch (job) {
+        case JOB_TEST:
+            // Use a known funded Stellar testnet account for the ping
+            network.getAccountAsync("GBY5AZJYQNUD22NLNEX23NWIFWALIGDRQY2X7W6TPNYHJWY6TCV7W64I",
+                                    *_requestDoc, _request);
+            break;
+        case JOB_FUND:
+            network.fundWithFriendbotAsync(accountId, *_requestDoc, _request);
+            break;
+        case JOB_STATUS:
+            network.getTransactionAsync((*_payment)->getLastTransactionHash().c_str(),
+                                        *_requestDoc, _request);
+            break;
+        case JOB_HISTORY:
+            network.getAccountPaymentsAsync(accountId, nullptr, 10, *_requestDoc, _request);
+            break;
+        default:
+            network.getAccountAsync(accountId, *_requestDoc, _request);
+            break;
+    }
+
+    // Rejected, or run inline without a worker: the result is already here
+    if (_request.isDone()) {
+        _job = JOB_NONE;
+        return true;
+    }
+
+    _job = job;
+    _sendPending();
+    return false;
+}
+
 void StellarWebServer::_ensureManagers() {
     if (!*_network) {
         *_network = new StellarNetwork(STELLAR_TESTNET);
+        (*_network)->startWorker();
     }
     if (*_keypair && !*_account) {
         *_account = new StellarAccount(*_keypair, *_network);
@@ -660,7 +746,7 @@ void StellarWebServer::_handleStatus() {
     json += ",\"wallet\":";
     json += (*_keypair != nullptr) ? "true" : "false";
     if (*_keypair) {
-        json += ",\"publicKey\":\""; json += (*_keypair)->getPublicKey(); json += "\"";
+        json += ",\"publicKey\":\""; json += (*_keypair)->getPublicKeyCStr(); json += "\"";
     }
     json += "}";
     _server.sendHeader("Access-Control-Allow-Origin", "*");
@@ -673,7 +759,7 @@ void StellarWebServer::_handleWalletNew() {
     _cleanupDependents();
     if (*_keypair) { delete *_keypair; *_keypair = nullptr; }
 
-    *_keypair = StellarKeypair::generate();
+    *_keypair = StellarKeypair::generateWithMnemonic();
     if (!*_keypair) {
         _sendJson(false, "", "", "Failed to generate wallet");
         return;
@@ -767,6 +853,8 @@ void StellarWebServer::_handleWalletImport() {
     _cleanupDependents();
     if (*_keypair) { delete *_keypair; *_keypair = nullptr; }
 
+    // El nodo HD en caché es de la wallet anterior
+    StellarKeypair::clearAccountNode();
     *_keypair = StellarKeypair::fromSecret(secretKey.c_str());
     if (!*_keypair) {
         _sendJson(false, "", "", "Invalid secret key");
@@ -783,18 +871,17 @@ void StellarWebServer::_handleNetworkTest() {
         _sendJson(false, "", "", "WiFi not connected");
         return;
     }
-    StellarNetwork network(STELLAR_TESTNET);
-    // Use a known funded Stellar testnet account for the ping
-    String response = network.getAccount("GBY5AZJYQNUD22NLNEX23NWIFWALIGDRQY2X7W6TPNYHJWY6TCV7W64I");
-    if (response.length() > 0) {
+    if (!_runJob(JOB_TEST)) return;
+
+    if (_request.succeeded()) {
         String data = "Horizon URL: ";
-        data += network.getHorizonURL();
+        data += (*_network)->getHorizonURL();
         data += "\nWiFi IP:     ";
         data += WiFi.localIP().toString();
         data += "\nStatus:      Connected";
         _sendJson(true, "Horizon connection successful!", data);
     } else {
-        _sendJson(false, "", "", "Connection failed: " + network.getLastError());
+        _sendJson(false, "", "", "Connection failed: " + _request.getError());
     }
 }
 
@@ -807,33 +894,30 @@ void StellarWebServer::_handleNetworkFund() {
         _sendJson(false, "", "", "WiFi not connected");
         return;
     }
-    StellarNetwork network(STELLAR_TESTNET);
-    String pubKey = (*_keypair)->getPublicKey();
-    if (network.fundWithFriendbot(pubKey.c_str())) {
-        String data = "Account: " + pubKey + "\nBalance: 10,000 XLM (testnet)";
+    if (!_runJob(JOB_FUND)) return;
+
+    if (_request.succeeded()) {
+        // Cached balance predates the funding
+        if (*_account) (*_account)->invalidateCache();
+
+        String data = "Account: " + (*_keypair)->getPublicKey() + "\nBalance: 10,000 XLM (testnet)";
         _sendJson(true, "Account funded via Friendbot!", data);
     } else {
-        _sendJson(false, "", "", "Funding failed: " + network.getLastError());
+        _sendJson(false, "", "", "Funding failed: " + _request.getError());
     }
 }
 
 void StellarWebServer::_handleNetworkBalance() {
     if (!*_keypair) { _sendJson(false, "", "", "No wallet loaded"); return; }
     if (!WiFi.isConnected()) { _sendJson(false, "", "", "WiFi not connected"); return; }
+    if (!_runJob(JOB_BALANCE)) return;
 
-    StellarNetwork network(STELLAR_TESTNET);
-    String response = network.getAccount((*_keypair)->getPublicKey().c_str());
-    if (response.length() == 0) {
+    if (!_request.succeeded()) {
         _sendJson(false, "", "", "Query failed. Account may not be funded yet. Use Friendbot first.");
         return;
     }
-    DynamicJsonDocument doc(4096);
-    if (deserializeJson(doc, response)) {
-        _sendJson(false, "", "", "Failed to parse Horizon response");
-        return;
-    }
     String data;
-    for (JsonObject b : doc["balances"].as<JsonArray>()) {
+    for (JsonObject b : (*_requestDoc)["balances"].as<JsonArray>()) {
         String assetType = b["asset_type"].as<String>();
         String amount    = b["balance"].as<String>();
         if (assetType == "native") {
@@ -848,18 +932,13 @@ void StellarWebServer::_handleNetworkBalance() {
 void StellarWebServer::_handleNetworkInfo() {
     if (!*_keypair) { _sendJson(false, "", "", "No wallet loaded"); return; }
     if (!WiFi.isConnected()) { _sendJson(false, "", "", "WiFi not connected"); return; }
+    if (!_runJob(JOB_INFO)) return;
 
-    StellarNetwork network(STELLAR_TESTNET);
-    String response = network.getAccount((*_keypair)->getPublicKey().c_str());
-    if (response.length() == 0) {
-        _sendJson(false, "", "", "Query failed: " + network.getLastError());
-        return;
-    }
-    DynamicJsonDocument doc(4096);
-    if (deserializeJson(doc, response)) {
-        _sendJson(false, "", "", "Failed to parse Horizon response");
+    if (!_request.succeeded()) {
+        _sendJson(false, "", "", "Query failed: " + _request.getError());
         return;
     }
+    JsonDocument& doc = *_requestDoc;
     String data;
     data += "ID:             " + doc["id"].as<String>()                       + "\n";
     data += "Sequence:       " + doc["sequence"].as<String>()                  + "\n";
@@ -887,25 +966,54 @@ void StellarWebServer::_handlePaySend() {
         _sendJson(false, "", "", "Invalid destination or amount");
         return;
     }
-
-    _ensureManagers();
-    if (!(*_account)->isAccountActive()) {
-        _sendJson(false, "", "", "Account not funded yet. Use 'Fund (Friendbot)' first.");
+    if (_payRequest.isPending()) {
+        _sendJson(false, "", "", "A payment is already in progress");
         return;
     }
 
-    PaymentResult result = (*_payment)->sendPayment(
+    // Source account is checked with fresh data on the worker
+    _ensureManagers();
+    bool started = (*_payment)->sendPaymentAsync(
         destination.c_str(),
         amount,
-        memo.length() > 0 ? memo.c_str() : nullptr
+        memo.length() > 0 ? memo.c_str() : nullptr,
+        _payRequest
     );
 
+    if (started) {
+        _sendPending();
+    } else {
+        _sendPaymentResult();
+    }
+}
+
+void StellarWebServer::_handlePaySendPoll() {
+    if (!*_keypair) { _sendJson(false, "", "", "No wallet loaded"); return; }
+    if (!_payRequest.isPending() && !_payRequest.isDone()) {
+        _sendJson(false, "", "", "No payment in progress");
+        return;
+    }
+
+    // Signing happens here, between the account query and the submit
+    _ensureManagers();
+    if (!(*_payment)->poll(_payRequest)) {
+        _sendPending();
+        return;
+    }
+    _sendPaymentResult();
+}
+
+void StellarWebServer::_sendPaymentResult() {
+    const PaymentResult& result = _payRequest.getResult();
+
     if (result.success) {
         String data;
         data += "TX Hash:  " + result.transactionHash + "\n";
         data += "Ledger:   " + String(result.ledger)  + "\n";
         data += "Explorer: https://stellar.expert/explorer/testnet/tx/" + result.transactionHash;
         _sendJson(true, "Payment sent successfully!", data);
+    } else if (result.error == "Source account does not exist") {
+        _sendJson(false, "", "", "Account not funded yet. Use 'Fund (Friendbot)' first.");
     } else {
         _sendJson(false, "", "", "Payment failed: " + result.error);
     }
@@ -921,8 +1029,12 @@ void StellarWebServer::_handlePayStatus() {
         _sendJson(false, "", "", "No transactions sent in this session");
         return;
     }
+    if (!_runJob(JOB_STATUS)) return;
+
     const char* statusStr = "UNKNOWN";
-    switch ((*_payment)->getLastTransactionStatus()) {
+    TransactionStatus status = _request.succeeded()
+        ? StellarPayment::readTransactionStatus(*_requestDoc) : TX_UNKNOWN;
+    switch (status) {
         case TX_SUCCESS: statusStr = "SUCCESS"; break;
         case TX_FAILED:  statusStr = "FAILED";  break;
         case TX_PENDING: statusStr = "PENDING"; break;
@@ -935,17 +1047,14 @@ void StellarWebServer::_handlePayStatus() {
 void StellarWebServer::_handlePayHistory() {
     if (!*_keypair) { _sendJson(false, "", "", "No wallet loaded"); return; }
     if (!WiFi.isConnected()) { _sendJson(false, "", "", "WiFi not connected"); return; }
+    if (!_runJob(JOB_HISTORY)) return;
 
-    _ensureManagers();
-    String response = (*_network)->getAccountPayments(
-        (*_keypair)->getPublicKey().c_str(), nullptr, 10
-    );
-    if (response.length() == 0) {
+    if (!_request.succeeded()) {
         _sendJson(false, "", "", "Failed to fetch payment history");
         return;
     }
-    DynamicJsonDocument doc(8192);
-    if (deserializeJson(doc, response) || !doc.containsKey("_embedded")) {
+    JsonDocument& doc = *_requestDoc;
+    if (!doc.containsKey("_embedded")) {
         _sendJson(false, "", "", "Failed to parse Horizon response");
         return;
     }
@@ -1012,6 +1121,29 @@ void StellarWebServer::_handleCryptoTest() {
     _sendJson(true, allPass ? "All crypto tests passed!" : "Some tests failed", data);
 }
 
+void StellarWebServer::_handleCryptoBench() {
+    // ?case=sha256 limita a los casos con ese prefijo
+    String filter = _server.hasArg("case") ? _server.arg("case") : "";
+
+    BenchResult results[STELLAR_BENCH_MAX_RESULTS];
+    size_t count = StellarBench::run(filter.c_str(), results, STELLAR_BENCH_MAX_RESULTS);
+
+    if (count == 0) {
+        _sendJson(false, "", "", "No matching benchmark cases");
+        return;
+    }
+
+    String data = StellarBench::formatHeader() + "\n";
+    bool allWithinBudget = true;
+
+    for (size_t i = 0; i < count; i++) {
+        data += StellarBench::formatResult(results[i]) + "\n";
+        allWithinBudget = allWithinBudget && results[i].withinBudget;
+    }
+
+    _sendJson(true, allWithinBudget ? "Crypto benchmark complete" : "Some cases over budget", data);
+}
+
 void StellarWebServer::_handleMemory() {
     _sendJson(true, "Memory Statistics", StellarUtils::getMemoryInfo());
 }
@@ -11,6 +11,7 @@
 #include "stellar_payment.h"
 #include "stellar_storage.h"
 #include "stellar_crypto.h"
+#include "stellar_bench.h"
 #include "stellar_utils.h"
 
 /**
@@ -20,6 +21,10 @@
  * via browser. Exposes REST API endpoints for all wallet, network,
  * and payment commands.
  *
+ * Network and payment endpoints never block handle(): they start the
+ * request on the network worker and answer 202 Accepted; the page
+ * repeats the call with ?poll=1 until the result is ready.
+ *
  * Usage:
  *   StellarWebServer webServer(&keypair, &network, &account, &payment);
  *   webServer.begin();      // call in setup()
@@ -45,6 +50,23 @@ private:
     StellarAccount** _account;
     StellarPayment** _payment;
 
+    // Dashboard network request in flight (one at a time)
+    enum DashboardJob : uint8_t {
+        JOB_NONE,
+        JOB_TEST,
+        JOB_FUND,
+        JOB_BALANCE,
+        JOB_INFO,
+        JOB_STATUS,
+        JOB_HISTORY
+    };
+    DashboardJob         _job;
+    NetworkFuture        _request;
+    DynamicJsonDocument* _requestDoc;     // Kept until the next request
+
+    // Payment in flight (POST /api/pay/send, polled with GET)
+    PaymentRequest       _payRequest;
+
     void _setupRoutes();
 
     // Send a JSON response {success, message, data, error}
@@ -53,6 +75,16 @@ private:
                    const String& data    = "",
                    const String& error   = "");
 
+    // 202 Accepted: still working, poll again
+    void _sendPending();
+
+    // Starts 'job' or, with ?poll=1, checks on it. Returns true once its
+    // result is in _request/_requestDoc; otherwise the response is sent.
+    bool _runJob(DashboardJob job);
+
+    // Response for a finished _payRequest
+    void _sendPaymentResult();
+
     // Mirror of ensureManagers() / cleanupDependents() from main.cpp
     void _ensureManagers();
     void _cleanupDependents();
@@ -74,10 +106,12 @@ private:
     void _handleNetworkInfo();
 
     void _handlePaySend();
+    void _handlePaySendPoll();
     void _handlePayStatus();
     void _handlePayHistory();
 
     void _handleCryptoTest();
+    void _handleCryptoBench();
     void _handleMemory();
 };
 
@@ -1,5 +1,8 @@
 #include "stellar_xdr.h"
+#include "stellar_xdr_schema.h"
 #include "stellar_utils.h"
+#include <Hash.h>
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -10,10 +13,10 @@
 // CONSTRUCTOR / DESTRUCTOR
 // ============================================
 
-XDREncoder::XDREncoder() {
+XDREncoder::XDREncoder() : ownsBuffer(true), overflow(false), hashSink(nullptr) {
     buffer = (uint8_t*)malloc(INITIAL_CAPACITY);
     if (!buffer) {
-        StellarUtils::errorPrint("XDR", "Failed to allocate buffer");
+        STELLAR_LOGE("XDR", "Failed to allocate buffer");
         capacity = 0;
         position = 0;
         return;
@@ -22,50 +25,102 @@ XDREncoder::XDREncoder() {
     capacity = INITIAL_CAPACITY;
     position = 0;
     
-    StellarUtils::debugPrint("XDR", "Encoder initialized");
+    STELLAR_LOGD("XDR", "Encoder initialized");
+}
+
+XDREncoder::XDREncoder(uint8_t* externalBuffer, size_t bufferCapacity)
+    : buffer(externalBuffer),
+      position(0),
+      capacity(externalBuffer ? bufferCapacity : 0),
+      ownsBuffer(false),
+      overflow(false),
+      hashSink(nullptr) {
 }
 
 XDREncoder::~XDREncoder() {
-    if (buffer) {
+    if (buffer && ownsBuffer) {
         free(buffer);
-        buffer = nullptr;
     }
+    buffer = nullptr;
 }
 
 // ============================================
 // BUFFER MANAGEMENT
 // ============================================
 
-void XDREncoder::ensureCapacity(size_t needed) {
-    if (position + needed > capacity) {
-        size_t newCapacity = capacity;
-        
-        while (newCapacity < position + needed) {
-            newCapacity += CAPACITY_INCREMENT;
-        }
-        
-        uint8_t* newBuffer = (uint8_t*)realloc(buffer, newCapacity);
-        
-        if (newBuffer) {
-            buffer = newBuffer;
-            capacity = newCapacity;
-            StellarUtils::debugPrint("XDR", 
-                ("Buffer expanded to " + String(newCapacity) + " bytes").c_str());
-        } else {
-            StellarUtils::errorPrint("XDR", "Failed to expand buffer");
-        }
+bool XDREncoder::ensureCapacity(size_t needed) {
+    if (overflow) {
+        return false;
+    }
+    
+    if (position + needed <= capacity) {
+        return true;
+    }
+    
+    // Buffer fijo: fallar de inmediato, nunca tocar el heap
+    if (!ownsBuffer) {
+        overflow = true;
+        STELLAR_LOGE("XDR", "Fixed buffer overflow");
+        return false;
+    }
+    
+    size_t newCapacity = capacity;
+    
+    while (newCapacity < position + needed) {
+        newCapacity += CAPACITY_INCREMENT;
+    }
+    
+    uint8_t* newBuffer = (uint8_t*)realloc(buffer, newCapacity);
+    
+    if (!newBuffer) {
+        overflow = true;
+        STELLAR_LOGE("XDR", "Failed to expand buffer");
+        return false;
     }
+    
+    buffer = newBuffer;
+    capacity = newCapacity;
+    STELLAR_LOGD("XDR", "Buffer expanded to %u bytes", (unsigned)newCapacity);
+    
+    return true;
 }
 
 void XDREncoder::append(const uint8_t* data, size_t length) {
-    ensureCapacity(length);
+    if (!ensureCapacity(length)) {
+        return;
+    }
+    
     memcpy(buffer + position, data, length);
     position += length;
+    
+    if (hashSink) {
+        hashSink->update(data, length);
+    }
+}
+
+uint8_t* XDREncoder::beginWrite(size_t length) {
+    if (!ensureCapacity(length)) {
+        return nullptr;
+    }
+    
+    return buffer + position;
+}
+
+void XDREncoder::endWrite(const uint8_t* end) {
+    const uint8_t* start = buffer + position;
+    size_t written = end - start;
+    
+    position += written;
+    
+    if (hashSink) {
+        hashSink->update(start, written);
+    }
 }
 
 void XDREncoder::reset() {
     position = 0;
-    StellarUtils::debugPrint("XDR", "Encoder reset");
+    overflow = false;
+    STELLAR_LOGD("XDR", "Encoder reset");
 }
 
 String XDREncoder::toHex() const {
@@ -168,21 +223,76 @@ void XDREncoder::encodePublicKey(const uint8_t* publicKey) {
 // ESTRUCTURAS STELLAR
 // ============================================
 
-void XDREncoder::encodeAsset(AssetType type) {
-    // Para MVP solo soportamos native (XLM)
-    encodeUint32(type);
+// Parsea un uint64 decimal (MEMO_ID se representa como texto en Horizon)
+static bool parseUint64(const char* text, uint64_t& value) {
+    if (!text || !*text) {
+        return false;
+    }
     
-    if (type == ASSET_TYPE_NATIVE) {
-        // Native asset no tiene campos adicionales
-    } else {
-        // TODO: Implementar para alphanum4 y alphanum12
-        StellarUtils::errorPrint("XDR", "Non-native assets not implemented yet");
+    value = 0;
+    
+    for (const char* p = text; *p; p++) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+        
+        uint64_t digit = *p - '0';
+        if (value > (UINT64_MAX - digit) / 10) {
+            return false;  // Overflow
+        }
+        
+        value = value * 10 + digit;
+    }
+    
+    return true;
+}
+
+bool XDREncoder::encodeAsset(AssetType type, const char* code, const uint8_t* issuer) {
+    XDRSchema::Asset::Value asset;
+    asset.type = type;
+    asset.issuer = issuer;
+    memset(asset.code, 0, sizeof(asset.code));
+    
+    if (type != ASSET_TYPE_NATIVE) {
+        size_t codeLength = code ? strlen(code) : 0;
+        size_t minLength = (type == ASSET_TYPE_CREDIT_ALPHANUM4) ? 1 : 5;
+        size_t maxLength = (type == ASSET_TYPE_CREDIT_ALPHANUM4) ? 4 : 12;
+        
+        if (type != ASSET_TYPE_CREDIT_ALPHANUM4 && type != ASSET_TYPE_CREDIT_ALPHANUM12) {
+            STELLAR_LOGE("XDR", "Unknown asset type");
+            return false;
+        }
+        
+        if (codeLength < minLength || codeLength > maxLength || !issuer) {
+            STELLAR_LOGE("XDR", "Invalid asset code or issuer");
+            return false;
+        }
+        
+        // Solo [A-Za-z0-9], como StellarAsset::credit()
+        for (size_t i = 0; i < codeLength; i++) {
+            if (!isalnum((unsigned char)code[i])) {
+                STELLAR_LOGE("XDR", "Asset code must be alphanumeric");
+                return false;
+            }
+        }
+        
+        // Código rellenado con ceros hasta 4 o 12 bytes
+        memcpy(asset.code, code, codeLength);
     }
+    
+    return XDRSchema::encode<XDRSchema::Asset>(*this, asset);
 }
 
-void XDREncoder::encodeMemo(MemoType type, const char* text) {
-    // Encodear tipo de memo
-    encodeUint32(type);
+bool XDREncoder::encodeMemo(MemoType type, const char* text) {
+    XDRSchema::Memo::Value memo;
+    memo.type = type;
+    memo.text.data = nullptr;
+    memo.text.length = 0;
+    memo.id = 0;
+    memo.hash = nullptr;
+    
+    uint8_t hash[32];
+    size_t hashLength = sizeof(hash);
     
     switch (type) {
         case MEMO_NONE:
@@ -192,52 +302,925 @@ void XDREncoder::encodeMemo(MemoType type, const char* text) {
         case MEMO_TEXT:
             if (text) {
                 // Verificar longitud (máximo 28 bytes)
-                size_t len = strlen(text);
-                if (len > 28) {
-                    StellarUtils::errorPrint("XDR", "Memo text too long (max 28 bytes)");
-                    encodeString("");
-                } else {
-                    encodeString(text);
+                memo.text.length = strlen(text);
+                memo.text.data = (const uint8_t*)text;
+                
+                if (memo.text.length > XDRSchema::Memo::MAX_TEXT_LENGTH) {
+                    STELLAR_LOGE("XDR", "Memo text too long (max 28 bytes)");
+                    return false;
                 }
-            } else {
-                encodeString("");
             }
             break;
             
         case MEMO_ID:
-            // TODO: Encodear uint64 ID
-            StellarUtils::errorPrint("XDR", "MEMO_ID not implemented yet");
+            // ID como texto decimal
+            if (!parseUint64(text, memo.id)) {
+                STELLAR_LOGE("XDR", "Invalid MEMO_ID (expected decimal uint64)");
+                return false;
+            }
             break;
             
         case MEMO_HASH:
         case MEMO_RETURN:
-            // TODO: Encodear 32 bytes hash
-            StellarUtils::errorPrint("XDR", "MEMO_HASH/RETURN not implemented yet");
+            // Hash como 64 caracteres hex
+            if (!text || strlen(text) != 64 ||
+                !StellarUtils::hexDecode(text, hash, &hashLength) || hashLength != 32) {
+                STELLAR_LOGE("XDR", "Invalid memo hash (expected 64 hex chars)");
+                return false;
+            }
+            memo.hash = hash;
             break;
+            
+        default:
+            STELLAR_LOGE("XDR", "Unknown memo type");
+            return false;
+    }
+    
+    return XDRSchema::encode<XDRSchema::Memo>(*this, memo);
+}
+
+bool XDREncoder::encodeMemoId(uint64_t id) {
+    XDRSchema::Memo::Value memo;
+    memo.type = MEMO_ID;
+    memo.text.data = nullptr;
+    memo.text.length = 0;
+    memo.id = id;
+    memo.hash = nullptr;
+    
+    return XDRSchema::encode<XDRSchema::Memo>(*this, memo);
+}
+
+bool XDREncoder::encodeMemoHash(MemoType type, const uint8_t* hash) {
+    if ((type != MEMO_HASH && type != MEMO_RETURN) || !hash) {
+        STELLAR_LOGE("XDR", "Invalid memo hash");
+        return false;
     }
+    
+    XDRSchema::Memo::Value memo;
+    memo.type = type;
+    memo.text.data = nullptr;
+    memo.text.length = 0;
+    memo.id = 0;
+    memo.hash = hash;
+    
+    return XDRSchema::encode<XDRSchema::Memo>(*this, memo);
 }
 
 void XDREncoder::encodePaymentOp(const uint8_t* destination, int64_t amount) {
-    StellarUtils::debugPrint("XDR", "Encoding Payment operation");
+    STELLAR_LOGD("XDR", "Encoding Payment operation");
     
     // Payment Operation estructura:
-    // - MuxedAccount destination
-    // - Asset asset
+    // - MuxedAccount destination (solo ED25519, sin multiplexing)
+    // - Asset asset (native XLM)
     // - int64 amount
+    XDRSchema::PaymentOp::Value payment;
+    payment.destination.ed25519 = destination;
+    payment.destination.muxed = false;
+    payment.destination.id = 0;
+    payment.asset.type = ASSET_TYPE_NATIVE;
+    payment.asset.issuer = nullptr;
+    payment.amount = amount;
+    
+    XDRSchema::encode<XDRSchema::PaymentOp>(*this, payment);
+    
+    STELLAR_LOGD("XDR", "Payment: %lld stroops", (long long)amount);
+}
+
+// ============================================
+// DECODER - CONSTRUCTOR
+// ============================================
+
+XDRDecoder::XDRDecoder(const uint8_t* data, size_t length)
+    : data(data), length(data ? length : 0), position(0), error(nullptr) {
+}
+
+XDRDecoder::XDRDecoder(const XDRBytesView& view)
+    : data(view.data), length(view.data ? view.length : 0), position(0), error(nullptr) {
+}
+
+bool XDRDecoder::decodeBase64(
+    const char* base64,
+    uint8_t* buffer,
+    size_t capacity,
+    size_t* length
+) {
+    if (!base64 || !buffer || !length) {
+        return false;
+    }
+    
+    // Verificar capacidad antes de escribir (base64Decode no la conoce)
+    size_t inputLength = strlen(base64);
+    if (inputLength % 4 != 0) {
+        return false;
+    }
+    
+    size_t needed = (inputLength / 4) * 3;
+    if (inputLength > 0 && base64[inputLength - 1] == '=') needed--;
+    if (inputLength > 1 && base64[inputLength - 2] == '=') needed--;
+    
+    if (needed > capacity) {
+        STELLAR_LOGE("XDR", "Base64 input exceeds decode buffer");
+        return false;
+    }
+    
+    return StellarUtils::base64Decode(base64, buffer, length);
+}
+
+// ============================================
+// DECODER - BUFFER MANAGEMENT
+// ============================================
+
+bool XDRDecoder::fail(const char* message) {
+    // Guardar solo el primer error: es el que explica el fallo
+    if (!error) {
+        error = message;
+        STELLAR_LOGE("XDR", "%s", message);
+    }
+    return false;
+}
+
+bool XDRDecoder::require(size_t needed) {
+    if (error) {
+        return false;
+    }
+    
+    if (needed > length - position) {
+        return fail("Unexpected end of XDR data");
+    }
+    
+    return true;
+}
+
+bool XDRDecoder::skip(size_t count) {
+    if (!require(count)) {
+        return false;
+    }
+    
+    position += count;
+    return true;
+}
+
+// ============================================
+// DECODER - TIPOS BÁSICOS XDR
+// ============================================
+
+bool XDRDecoder::decodeUint32(uint32_t& value) {
+    if (!require(4)) {
+        return false;
+    }
+    
+    // Big-endian (network byte order)
+    const uint8_t* p = data + position;
+    value = ((uint32_t)p[0] << 24) |
+            ((uint32_t)p[1] << 16) |
+            ((uint32_t)p[2] << 8) |
+            (uint32_t)p[3];
+    
+    position += 4;
+    return true;
+}
+
+bool XDRDecoder::decodeInt32(int32_t& value) {
+    uint32_t raw;
+    if (!decodeUint32(raw)) {
+        return false;
+    }
+    
+    value = (int32_t)raw;
+    return true;
+}
+
+bool XDRDecoder::decodeUint64(uint64_t& value) {
+    uint32_t high, low;
+    if (!decodeUint32(high) || !decodeUint32(low)) {
+        return false;
+    }
+    
+    value = ((uint64_t)high << 32) | low;
+    return true;
+}
+
+bool XDRDecoder::decodeInt64(int64_t& value) {
+    uint64_t raw;
+    if (!decodeUint64(raw)) {
+        return false;
+    }
+    
+    value = (int64_t)raw;
+    return true;
+}
+
+bool XDRDecoder::decodeBool(bool& value) {
+    uint32_t raw;
+    if (!decodeUint32(raw)) {
+        return false;
+    }
+    
+    if (raw > 1) {
+        return fail("Invalid XDR bool");
+    }
+    
+    value = (raw == 1);
+    return true;
+}
+
+bool XDRDecoder::decodeFixedOpaque(size_t count, XDRBytesView& view) {
+    size_t padded = (count + 3) & ~(size_t)3;
+    
+    if (!require(padded)) {
+        return false;
+    }
+    
+    view.data = data + position;
+    view.length = count;
+    position += padded;
+    return true;
+}
+
+bool XDRDecoder::decodeVarOpaque(size_t maxLength, XDRBytesView& view) {
+    uint32_t count;
+    if (!decodeUint32(count)) {
+        return false;
+    }
+    
+    if (count > maxLength) {
+        return fail("XDR opaque exceeds maximum length");
+    }
+    
+    return decodeFixedOpaque(count, view);
+}
+
+// ============================================
+// DECODER - ESTRUCTURAS STELLAR
+// ============================================
+
+bool XDRDecoder::decodeMuxedAccount(XDRBytesView& ed25519, bool* muxed, uint64_t* muxedId) {
+    uint32_t type;
+    if (!decodeUint32(type)) {
+        return false;
+    }
+    
+    uint64_t id = 0;
+    
+    if (type == KEY_TYPE_MUXED_ED25519) {
+        if (!decodeUint64(id)) {
+            return false;
+        }
+    } else if (type != KEY_TYPE_ED25519) {
+        return fail("Unknown MuxedAccount type");
+    }
+    
+    if (muxed) *muxed = (type == KEY_TYPE_MUXED_ED25519);
+    if (muxedId) *muxedId = id;
+    
+    return decodeFixedOpaque(32, ed25519);
+}
+
+bool XDRDecoder::decodeAccountId(XDRBytesView& ed25519) {
+    uint32_t type;
+    if (!decodeUint32(type)) {
+        return false;
+    }
+    
+    if (type != 0) {  // PUBLIC_KEY_TYPE_ED25519
+        return fail("Unknown PublicKey type");
+    }
+    
+    return decodeFixedOpaque(32, ed25519);
+}
+
+bool XDRDecoder::skipAsset() {
+    uint32_t type;
+    if (!decodeUint32(type)) {
+        return false;
+    }
+    
+    XDRBytesView issuer;
+    
+    switch (type) {
+        case ASSET_TYPE_NATIVE:
+            return true;
+        case ASSET_TYPE_CREDIT_ALPHANUM4:
+            return skip(4) && decodeAccountId(issuer);
+        case ASSET_TYPE_CREDIT_ALPHANUM12:
+            return skip(12) && decodeAccountId(issuer);
+        default:
+            return fail("Unknown asset type");
+    }
+}
+
+bool XDRDecoder::skipChangeTrustAsset() {
+    // ChangeTrustAsset = Asset | ASSET_TYPE_POOL_SHARE (3)
+    if (!require(4)) {
+        return false;
+    }
+    
+    const uint8_t* p = data + position;
+    if (p[0] != 0 || p[1] != 0 || p[2] != 0 || p[3] != 3) {
+        return skipAsset();
+    }
+    
+    // LiquidityPoolParameters (solo CONSTANT_PRODUCT = 0)
+    uint32_t poolType;
+    if (!skip(4) || !decodeUint32(poolType)) {
+        return false;
+    }
+    
+    if (poolType != 0) {
+        return fail("Unknown liquidity pool type");
+    }
+    
+    // assetA + assetB + int32 fee
+    return skipAsset() && skipAsset() && skip(4);
+}
+
+bool XDRDecoder::skipSignerKey() {
+    uint32_t type;
+    if (!decodeUint32(type)) {
+        return false;
+    }
+    
+    XDRBytesView payload;
+    
+    switch (type) {
+        case 0:  // SIGNER_KEY_TYPE_ED25519
+        case 1:  // SIGNER_KEY_TYPE_PRE_AUTH_TX
+        case 2:  // SIGNER_KEY_TYPE_HASH_X
+            return skip(32);
+        case 3:  // SIGNER_KEY_TYPE_ED25519_SIGNED_PAYLOAD
+            return skip(32) && decodeVarOpaque(64, payload);
+        default:
+            return fail("Unknown signer key type");
+    }
+}
+
+bool XDRDecoder::skipPreconditions() {
+    uint32_t type;
+    if (!decodeUint32(type)) {
+        return false;
+    }
+    
+    bool present;
+    uint32_t count;
+    
+    switch (type) {
+        case 0:  // PRECOND_NONE
+            return true;
+            
+        case 1:  // PRECOND_TIME: TimeBounds (minTime + maxTime)
+            return skip(16);
+            
+        case 2:  // PRECOND_V2
+            // TimeBounds* timeBounds
+            if (!decodeBool(present) || (present && !skip(16))) return false;
+            // LedgerBounds* ledgerBounds
+            if (!decodeBool(present) || (present && !skip(8))) return false;
+            // SequenceNumber* minSeqNum
+            if (!decodeBool(present) || (present && !skip(8))) return false;
+            // Duration minSeqAge + uint32 minSeqLedgerGap
+            if (!skip(12)) return false;
+            // SignerKey extraSigners<2>
+            if (!decodeUint32(count)) return false;
+            if (count > 2) return fail("Too many extra signers");
+            for (uint32_t i = 0; i < count; i++) {
+                if (!skipSignerKey()) return false;
+            }
+            return true;
+            
+        default:
+            return fail("Unknown precondition type");
+    }
+}
+
+bool XDRDecoder::decodeMemo(XDRTransactionEnvelope& envelope) {
+    if (!decodeUint32(envelope.memoType)) {
+        return false;
+    }
+    
+    envelope.memo.data = nullptr;
+    envelope.memo.length = 0;
+    envelope.memoId = 0;
+    
+    switch (envelope.memoType) {
+        case MEMO_NONE:
+            return true;
+        case MEMO_TEXT:
+            return decodeVarOpaque(28, envelope.memo);
+        case MEMO_ID:
+            return decodeUint64(envelope.memoId);
+        case MEMO_HASH:
+        case MEMO_RETURN:
+            return decodeFixedOpaque(32, envelope.memo);
+        default:
+            return fail("Unknown memo type");
+    }
+}
+
+bool XDRDecoder::skipOperationBody(OperationType type) {
+    XDRBytesView view;
+    bool present;
+    uint32_t count;
+    
+    switch (type) {
+        case CREATE_ACCOUNT:
+            // AccountID destination + int64 startingBalance
+            return decodeAccountId(view) && skip(8);
+            
+        case PAYMENT:
+            // MuxedAccount destination + Asset + int64 amount
+            return decodeMuxedAccount(view) && skipAsset() && skip(8);
+            
+        case PATH_PAYMENT_STRICT_RECEIVE:
+        case PATH_PAYMENT_STRICT_SEND:
+            // sendAsset + int64 + destination + destAsset + int64 + path<5>
+            if (!skipAsset() || !skip(8) || !decodeMuxedAccount(view) ||
+                !skipAsset() || !skip(8) || !decodeUint32(count)) {
+                return false;
+            }
+            if (count > 5) return fail("Payment path too long");
+            for (uint32_t i = 0; i < count; i++) {
+                if (!skipAsset()) return false;
+            }
+            return true;
+            
+        case MANAGE_SELL_OFFER:
+        case MANAGE_BUY_OFFER:
+            // selling + buying + int64 amount + Price + int64 offerID
+            return skipAsset() && skipAsset() && skip(8 + 8 + 8);
+            
+        case CREATE_PASSIVE_SELL_OFFER:
+            // selling + buying + int64 amount + Price
+            return skipAsset() && skipAsset() && skip(8 + 8);
+            
+        case SET_OPTIONS:
+            // AccountID* inflationDest
+            if (!decodeBool(present) || (present && !decodeAccountId(view))) return false;
+            // clearFlags, setFlags, masterWeight, low/med/high thresholds
+            for (int i = 0; i < 6; i++) {
+                if (!decodeBool(present) || (present && !skip(4))) return false;
+            }
+            // string32* homeDomain
+            if (!decodeBool(present) || (present && !decodeVarOpaque(32, view))) return false;
+            // Signer* signer (SignerKey + uint32 weight)
+            if (!decodeBool(present)) return false;
+            return !present || (skipSignerKey() && skip(4));
+            
+        case CHANGE_TRUST:
+            // ChangeTrustAsset line + int64 limit
+            return skipChangeTrustAsset() && skip(8);
+            
+        case ALLOW_TRUST:
+            // AccountID trustor + AssetCode + uint32 authorize
+            if (!decodeAccountId(view) || !decodeUint32(count)) return false;
+            if (count == ASSET_TYPE_CREDIT_ALPHANUM4) return skip(4 + 4);
+            if (count == ASSET_TYPE_CREDIT_ALPHANUM12) return skip(12 + 4);
+            return fail("Unknown asset code type");
+            
+        case ACCOUNT_MERGE:
+            return decodeMuxedAccount(view);
+            
+        case INFLATION:
+            return true;
+            
+        case MANAGE_DATA:
+            // string64 dataName + DataValue* dataValue
+            if (!decodeVarOpaque(64, view) || !decodeBool(present)) return false;
+            return !present || decodeVarOpaque(64, view);
+            
+        case BUMP_SEQUENCE:
+            return skip(8);
+            
+        default:
+            return fail("Unsupported operation type");
+    }
+}
+
+bool XDRDecoder::decodeOperation(XDROperation& operation) {
+    if (!decodeBool(operation.hasSourceAccount)) {
+        return false;
+    }
+    
+    operation.sourceAccount.data = nullptr;
+    operation.sourceAccount.length = 0;
+    
+    if (operation.hasSourceAccount && !decodeMuxedAccount(operation.sourceAccount)) {
+        return false;
+    }
+    
+    uint32_t type;
+    if (!decodeUint32(type)) {
+        return false;
+    }
+    
+    operation.type = (OperationType)type;
+    
+    size_t bodyStart = position;
+    if (!skipOperationBody(operation.type)) {
+        return false;
+    }
+    
+    operation.body.data = data + bodyStart;
+    operation.body.length = position - bodyStart;
+    return true;
+}
+
+bool XDRDecoder::decodeDecoratedSignature(XDRDecoratedSignature& signature) {
+    return decodeFixedOpaque(4, signature.hint) &&
+           decodeVarOpaque(64, signature.signature);
+}
+
+bool XDRDecoder::decodeTransactionV1(XDRTransactionEnvelope& envelope) {
+    size_t txStart = position;
     
-    // MuxedAccount (simplificado - solo ED25519, sin multiplexing)
-    // type: uint32 (0 = KEY_TYPE_ED25519)
-    encodeUint32(0);  // KEY_TYPE_ED25519
+    if (!decodeMuxedAccount(envelope.sourceAccount, &envelope.sourceMuxed, &envelope.sourceMuxedId) ||
+        !decodeUint32(envelope.fee) ||
+        !decodeInt64(envelope.sequenceNumber) ||
+        !skipPreconditions() ||
+        !decodeMemo(envelope)) {
+        return false;
+    }
+    
+    // Operation operations<100>
+    if (!decodeUint32(envelope.operationCount)) {
+        return false;
+    }
+    
+    if (envelope.operationCount > 100) {
+        return fail("Too many operations");
+    }
+    
+    size_t opsStart = position;
+    XDROperation operation;
+    
+    for (uint32_t i = 0; i < envelope.operationCount; i++) {
+        if (!decodeOperation(operation)) {
+            return false;
+        }
+    }
+    
+    envelope.operations.data = data + opsStart;
+    envelope.operations.length = position - opsStart;
+    
+    // Extension (v = 0; Soroban no soportado)
+    uint32_t ext;
+    if (!decodeUint32(ext)) {
+        return false;
+    }
+    
+    if (ext != 0) {
+        return fail("Unsupported transaction extension");
+    }
+    
+    envelope.transaction.data = data + txStart;
+    envelope.transaction.length = position - txStart;
+    return true;
+}
+
+bool XDRDecoder::decodeTransactionV0(XDRTransactionEnvelope& envelope) {
+    size_t txStart = position;
+    bool hasTimeBounds;
+    
+    envelope.sourceMuxed = false;
+    envelope.sourceMuxedId = 0;
+    
+    if (!decodeFixedOpaque(32, envelope.sourceAccount) ||
+        !decodeUint32(envelope.fee) ||
+        !decodeInt64(envelope.sequenceNumber) ||
+        !decodeBool(hasTimeBounds) ||
+        (hasTimeBounds && !skip(16)) ||
+        !decodeMemo(envelope) ||
+        !decodeUint32(envelope.operationCount)) {
+        return false;
+    }
+    
+    if (envelope.operationCount > 100) {
+        return fail("Too many operations");
+    }
+    
+    size_t opsStart = position;
+    XDROperation operation;
+    
+    for (uint32_t i = 0; i < envelope.operationCount; i++) {
+        if (!decodeOperation(operation)) {
+            return false;
+        }
+    }
+    
+    envelope.operations.data = data + opsStart;
+    envelope.operations.length = position - opsStart;
     
-    // ed25519: 32 bytes
-    append(destination, 32);
+    uint32_t ext;
+    if (!decodeUint32(ext)) {
+        return false;
+    }
+    
+    if (ext != 0) {
+        return fail("Unsupported transaction extension");
+    }
     
-    // Asset (native XLM)
-    encodeAsset(ASSET_TYPE_NATIVE);
+    envelope.transaction.data = data + txStart;
+    envelope.transaction.length = position - txStart;
+    return true;
+}
+
+bool XDRDecoder::decodeTransactionEnvelope(XDRTransactionEnvelope& envelope) {
+    memset(&envelope, 0, sizeof(envelope));
     
-    // Amount en stroops
-    encodeInt64(amount);
+    if (!decodeUint32(envelope.envelopeType)) {
+        return false;
+    }
     
-    StellarUtils::debugPrint("XDR", 
-        ("Payment: " + String((long long)amount) + " stroops").c_str());
-}
\ No newline at end of file
+    if (envelope.envelopeType == ENVELOPE_TYPE_TX_FEE_BUMP) {
+        envelope.feeBump = true;
+        
+        // FeeBumpTransaction: feeSource + int64 fee + innerTx
+        uint32_t innerType;
+        if (!decodeMuxedAccount(envelope.feeBumpSource) ||
+            !decodeInt64(envelope.feeBumpFee) ||
+            !decodeUint32(innerType)) {
+            return false;
+        }
+        
+        if (innerType != ENVELOPE_TYPE_TX) {
+            return fail("Unsupported fee bump inner envelope");
+        }
+        
+        // Firmas de la transacción interna
+        uint32_t innerSignatures;
+        XDRDecoratedSignature signature;
+        
+        if (!decodeTransactionV1(envelope) || !decodeUint32(innerSignatures)) {
+            return false;
+        }
+        
+        if (innerSignatures > 20) {
+            return fail("Too many signatures");
+        }
+        
+        for (uint32_t i = 0; i < innerSignatures; i++) {
+            if (!decodeDecoratedSignature(signature)) {
+                return false;
+            }
+        }
+        
+        // Extension de FeeBumpTransaction
+        uint32_t ext;
+        if (!decodeUint32(ext)) {
+            return false;
+        }
+        
+        if (ext != 0) {
+            return fail("Unsupported fee bump extension");
+        }
+        
+    } else if (envelope.envelopeType == ENVELOPE_TYPE_TX) {
+        if (!decodeTransactionV1(envelope)) {
+            return false;
+        }
+        
+    } else if (envelope.envelopeType == ENVELOPE_TYPE_TX_V0) {
+        if (!decodeTransactionV0(envelope)) {
+            return false;
+        }
+        
+    } else {
+        return fail("Unknown envelope type");
+    }
+    
+    // DecoratedSignature signatures<20>
+    if (!decodeUint32(envelope.signatureCount)) {
+        return false;
+    }
+    
+    if (envelope.signatureCount > 20) {
+        return fail("Too many signatures");
+    }
+    
+    size_t sigStart = position;
+    XDRDecoratedSignature signature;
+    
+    for (uint32_t i = 0; i < envelope.signatureCount; i++) {
+        if (!decodeDecoratedSignature(signature)) {
+            return false;
+        }
+    }
+    
+    envelope.signatures.data = data + sigStart;
+    envelope.signatures.length = position - sigStart;
+    return true;
+}
+
+// ============================================
+// DECODER - RESULTADOS
+// ============================================
+
+bool XDRDecoder::skipClaimAtom() {
+    uint32_t type;
+    if (!decodeUint32(type)) {
+        return false;
+    }
+    
+    XDRBytesView seller;
+    
+    switch (type) {
+        case 0:  // CLAIM_ATOM_TYPE_V0: sellerEd25519 + offerID
+            if (!skip(32 + 8)) return false;
+            break;
+        case 1:  // CLAIM_ATOM_TYPE_ORDER_BOOK: sellerID + offerID
+            if (!decodeAccountId(seller) || !skip(8)) return false;
+            break;
+        case 2:  // CLAIM_ATOM_TYPE_LIQUIDITY_POOL: liquidityPoolID
+            if (!skip(32)) return false;
+            break;
+        default:
+            return fail("Unknown claim atom type");
+    }
+    
+    // assetSold + amountSold + assetBought + amountBought
+    return skipAsset() && skip(8) && skipAsset() && skip(8);
+}
+
+bool XDRDecoder::decodeOperationResult(XDROperationResult& result) {
+    result.type = CREATE_ACCOUNT;
+    result.innerCode = 0;
+    
+    if (!decodeInt32(result.code)) {
+        return false;
+    }
+    
+    if (result.code != OP_RESULT_INNER) {
+        // Resto de códigos no llevan datos
+        return true;
+    }
+    
+    uint32_t type;
+    if (!decodeUint32(type) || !decodeInt32(result.innerCode)) {
+        return false;
+    }
+    
+    result.type = (OperationType)type;
+    
+    uint32_t count;
+    XDRBytesView view;
+    
+    switch (result.type) {
+        case CREATE_ACCOUNT:
+        case PAYMENT:
+        case SET_OPTIONS:
+        case CHANGE_TRUST:
+        case ALLOW_TRUST:
+        case MANAGE_DATA:
+        case BUMP_SEQUENCE:
+            // Solo código de resultado
+            return true;
+            
+        case PATH_PAYMENT_STRICT_RECEIVE:
+        case PATH_PAYMENT_STRICT_SEND:
+            if (result.innerCode == -9) {  // *_NO_ISSUER: Asset noIssuer
+                return skipAsset();
+            }
+            if (result.innerCode != 0) {
+                return true;
+            }
+            // ClaimAtom offers<> + SimplePaymentResult
+            if (!decodeUint32(count)) return false;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!skipClaimAtom()) return false;
+            }
+            return decodeAccountId(view) && skipAsset() && skip(8);
+            
+        case MANAGE_SELL_OFFER:
+        case CREATE_PASSIVE_SELL_OFFER:
+        case MANAGE_BUY_OFFER:
+            if (result.innerCode != 0) {
+                return true;
+            }
+            // ClaimAtom offersClaimed<> + ManageOfferEffect
+            if (!decodeUint32(count)) return false;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!skipClaimAtom()) return false;
+            }
+            if (!decodeUint32(count)) return false;
+            if (count == 2) {  // MANAGE_OFFER_DELETED
+                return true;
+            }
+            if (count > 2) return fail("Unknown manage offer effect");
+            // OfferEntry: sellerID + offerID + selling + buying + amount + price + flags + ext
+            if (!decodeAccountId(view) || !skip(8) || !skipAsset() || !skipAsset() ||
+                !skip(8 + 8 + 4) || !decodeUint32(count)) {
+                return false;
+            }
+            return count == 0 || fail("Unsupported offer entry extension");
+            
+        case ACCOUNT_MERGE:
+            // ACCOUNT_MERGE_SUCCESS: int64 sourceAccountBalance
+            return result.innerCode != 0 || skip(8);
+            
+        case INFLATION:
+            if (result.innerCode != 0) {
+                return true;
+            }
+            // InflationPayout payouts<> (AccountID + int64)
+            if (!decodeUint32(count)) return false;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!decodeAccountId(view) || !skip(8)) return false;
+            }
+            return true;
+            
+        default:
+            return fail("Unsupported operation result type");
+    }
+}
+
+bool XDRDecoder::decodeOperationResultList(XDRTransactionResult& result) {
+    if (!decodeUint32(result.operationCount)) {
+        return false;
+    }
+    
+    if (result.operationCount > 100) {
+        return fail("Too many operation results");
+    }
+    
+    size_t start = position;
+    XDROperationResult operation;
+    
+    for (uint32_t i = 0; i < result.operationCount; i++) {
+        if (!decodeOperationResult(operation)) {
+            return false;
+        }
+    }
+    
+    result.operations.data = data + start;
+    result.operations.length = position - start;
+    return true;
+}
+
+bool XDRDecoder::decodeTransactionResult(XDRTransactionResult& result) {
+    memset(&result, 0, sizeof(result));
+    
+    if (!decodeInt64(result.feeCharged) || !decodeInt32(result.code)) {
+        return false;
+    }
+    
+    if (result.code == TX_RESULT_FEE_BUMP_INNER_SUCCESS ||
+        result.code == TX_RESULT_FEE_BUMP_INNER_FAILED) {
+        // InnerTransactionResultPair: hash + InnerTransactionResult
+        result.feeBump = true;
+        result.outerFeeCharged = result.feeCharged;
+        result.outerCode = result.code;
+        
+        if (!decodeFixedOpaque(32, result.innerHash) ||
+            !decodeInt64(result.feeCharged) ||
+            !decodeInt32(result.code)) {
+            return false;
+        }
+        
+        if ((result.code == TX_RESULT_SUCCESS || result.code == TX_RESULT_FAILED) &&
+            !decodeOperationResultList(result)) {
+            return false;
+        }
+        
+        // Extension de InnerTransactionResult
+        uint32_t innerExt;
+        if (!decodeUint32(innerExt)) {
+            return false;
+        }
+        
+        if (innerExt != 0) {
+            return fail("Unsupported inner result extension");
+        }
+        
+    } else if (result.code == TX_RESULT_SUCCESS || result.code == TX_RESULT_FAILED) {
+        if (!decodeOperationResultList(result)) {
+            return false;
+        }
+    }
+    
+    // Extension de TransactionResult
+    uint32_t ext;
+    if (!decodeUint32(ext)) {
+        return false;
+    }
+    
+    if (ext != 0) {
+        return fail("Unsupported result extension");
+    }
+    
+    return true;
+}
+
+bool XDRDecoder::decodeTransactionMeta(XDRTransactionMeta& meta) {
+    if (!decodeInt32(meta.version)) {
+        return false;
+    }
+    
+    if (meta.version < 0 || meta.version > 3) {
+        return fail("Unknown transaction meta version");
+    }
+    
+    // LedgerEntryChanges / OperationMeta quedan sin interpretar
+    meta.body.data = data + position;
+    meta.body.length = length - position;
+    position = length;
+    return true;
+}
@@ -3,16 +3,23 @@
 
 #include <Arduino.h>
 
+class Hash;  // rweather/Crypto
+
 /**
  * Serialización XDR para Stellar Protocol
  * 
  * XDR (External Data Representation) es el formato binario
  * usado por Stellar para codificar transacciones.
  * 
- * Este módulo implementa un subconjunto mínimo para el MVP:
- * - Payment operations
- * - Simple transactions
- * - Memo TEXT
+ * Este módulo implementa:
+ * - Operaciones de pago, path payment, create account,
+ *   change trust y manage data (ver stellar_xdr_schema.h)
+ * - Transacciones de hasta 100 operaciones
+ * - Todos los tipos de memo y assets clásicos
+ *
+ * Además incluye un decoder zero-copy para leer las respuestas
+ * de Horizon (result_xdr, envelope_xdr, result_meta_xdr) sin
+ * pasar por documentos JSON grandes.
  */
 
 // Tipos de Asset según protocolo Stellar
@@ -49,17 +56,80 @@ enum MemoType {
     MEMO_RETURN = 4
 };
 
+// Tipos de Envelope
+enum EnvelopeType {
+    ENVELOPE_TYPE_TX_V0 = 0,
+    ENVELOPE_TYPE_TX = 2,
+    ENVELOPE_TYPE_TX_FEE_BUMP = 5
+};
+
+// Tipos de MuxedAccount
+enum CryptoKeyType {
+    KEY_TYPE_ED25519 = 0,
+    KEY_TYPE_MUXED_ED25519 = 0x100
+};
+
+// Códigos de resultado de transacción (TransactionResultCode)
+enum TransactionResultCode {
+    TX_RESULT_FEE_BUMP_INNER_SUCCESS = 1,
+    TX_RESULT_SUCCESS = 0,
+    TX_RESULT_FAILED = -1,
+    TX_RESULT_TOO_EARLY = -2,
+    TX_RESULT_TOO_LATE = -3,
+    TX_RESULT_MISSING_OPERATION = -4,
+    TX_RESULT_BAD_SEQ = -5,
+    TX_RESULT_BAD_AUTH = -6,
+    TX_RESULT_INSUFFICIENT_BALANCE = -7,
+    TX_RESULT_NO_ACCOUNT = -8,
+    TX_RESULT_INSUFFICIENT_FEE = -9,
+    TX_RESULT_BAD_AUTH_EXTRA = -10,
+    TX_RESULT_INTERNAL_ERROR = -11,
+    TX_RESULT_NOT_SUPPORTED = -12,
+    TX_RESULT_FEE_BUMP_INNER_FAILED = -13,
+    TX_RESULT_BAD_SPONSORSHIP = -14,
+    TX_RESULT_BAD_MIN_SEQ_AGE_OR_GAP = -15,
+    TX_RESULT_MALFORMED = -16
+};
+
+// Código de resultado de operación (OperationResultCode)
+// 0 = opINNER (el resultado específico de la operación sigue)
+enum OperationResultCode {
+    OP_RESULT_INNER = 0,
+    OP_RESULT_BAD_AUTH = -1,
+    OP_RESULT_NO_ACCOUNT = -2,
+    OP_RESULT_NOT_SUPPORTED = -3,
+    OP_RESULT_TOO_MANY_SUBENTRIES = -4,
+    OP_RESULT_EXCEEDED_WORK_LIMIT = -5,
+    OP_RESULT_TOO_MANY_SPONSORING = -6
+};
+
 /**
  * Encoder XDR para construir transacciones Stellar
  * 
+ * Dos modos de buffer:
+ * - Dinámico (constructor por defecto): malloc + realloc según crece
+ * - Fijo (buffer del llamador): nunca toca el heap; si los datos no
+ *   caben, el encoder queda en overflow y descarta todo lo siguiente
+ * 
  * Uso:
  * 1. Crear encoder
  * 2. Encodear cada campo en orden
- * 3. Obtener bytes con getData()
+ * 3. Verificar hasOverflow()
+ * 4. Obtener bytes con getData()
  */
 class XDREncoder {
 public:
     XDREncoder();
+    
+    /**
+     * Crea encoder sobre un buffer del llamador (stack o arena reutilizable)
+     * El buffer debe vivir mientras se use el encoder
+     * 
+     * @param externalBuffer Buffer de salida
+     * @param bufferCapacity Tamaño del buffer en bytes
+     */
+    XDREncoder(uint8_t* externalBuffer, size_t bufferCapacity);
+    
     ~XDREncoder();
     
     // ============================================
@@ -113,18 +183,55 @@ public:
     // ============================================
     
     /**
-     * Encodea Asset (para MVP solo native XLM)
+     * Encodea Asset
+     * 
+     * @param type Tipo de asset
+     * @param code Código [A-Za-z0-9] (1-4 chars alphanum4, 5-12 chars alphanum12)
+     * @param issuer Clave pública del emisor (32 bytes)
+     * @return false si el código o el emisor no son válidos (no escribe nada)
      */
-    void encodeAsset(AssetType type);
+    bool encodeAsset(AssetType type, const char* code = nullptr, const uint8_t* issuer = nullptr);
     
     /**
-     * Encodea Memo
-     * Para MVP solo MEMO_NONE y MEMO_TEXT
+     * Encodea Memo desde texto
+     * MEMO_TEXT: hasta 28 bytes
+     * MEMO_ID: uint64 en decimal
+     * MEMO_HASH / MEMO_RETURN: 32 bytes en hex (64 chars)
+     * 
+     * @return false si el texto no es válido para el tipo (no escribe nada)
      */
-    void encodeMemo(MemoType type, const char* text = nullptr);
+    bool encodeMemo(MemoType type, const char* text = nullptr);
+    
+    /**
+     * Encodea MEMO_ID
+     */
+    bool encodeMemoId(uint64_t id);
+    
+    /**
+     * Encodea MEMO_HASH o MEMO_RETURN (hash de 32 bytes)
+     */
+    bool encodeMemoHash(MemoType type, const uint8_t* hash);
 
     void append(const uint8_t* data, size_t length);
     
+    /**
+     * Reserva espacio para escribir directamente en el buffer
+     * Un solo chequeo de capacidad para toda una estructura cuyo
+     * tamaño ya se conoce (ver stellar_xdr_schema.h).
+     * 
+     * @param length Bytes a reservar
+     * @return Puntero de escritura, o nullptr si no cabe
+     */
+    uint8_t* beginWrite(size_t length);
+    
+    /**
+     * Confirma los bytes escritos desde beginWrite()
+     * Avanza la posición y alimenta el hash conectado.
+     * 
+     * @param end Puntero al byte siguiente al último escrito
+     */
+    void endWrite(const uint8_t* end);
+    
     /**
      * Encodea Payment Operation
      * 
@@ -152,7 +259,31 @@ public:
     size_t getSize() const { return position; }
     
     /**
-     * Reinicia el encoder (limpia buffer)
+     * Capacidad actual del buffer
+     * 
+     * @return Tamaño en bytes
+     */
+    size_t getCapacity() const { return capacity; }
+    
+    /**
+     * Indica si alguna escritura no cupo en el buffer
+     * (buffer fijo lleno o fallo de realloc). Los datos quedan truncados.
+     * 
+     * @return true si hubo overflow
+     */
+    bool hasOverflow() const { return overflow; }
+    
+    /**
+     * Conecta un hash incremental (p.ej. SHA256) al encoder
+     * Mientras esté conectado, cada byte escrito se pasa también al hash,
+     * así el hash queda listo al terminar de encodear sin releer los datos.
+     * 
+     * @param sink Hash a alimentar (nullptr para desconectar)
+     */
+    void setHashSink(Hash* sink) { hashSink = sink; }
+    
+    /**
+     * Reinicia el encoder (limpia buffer y estado de overflow)
      */
     void reset();
     
@@ -165,8 +296,238 @@ private:
     uint8_t* buffer;
     size_t position;
     size_t capacity;
+    bool ownsBuffer;
+    bool overflow;
+    Hash* hashSink;
+    
+    bool ensureCapacity(size_t needed);
+    
+    // No copiable: el buffer dinámico tiene un solo dueño
+    XDREncoder(const XDREncoder&) = delete;
+    XDREncoder& operator=(const XDREncoder&) = delete;
+};
+
+/**
+ * Encoder XDR con buffer fijo embebido (sin heap)
+ * Pensado para vivir en el stack de la función que construye la TX
+ * 
+ * Uso:
+ *   XDRStaticEncoder<256> encoder;
+ *   encoder.encodeUint32(...);
+ */
+template <size_t N>
+class XDRStaticEncoder : public XDREncoder {
+public:
+    XDRStaticEncoder() : XDREncoder(storage, N) {}
+    
+private:
+    uint8_t storage[N];
+};
+
+// ============================================
+// DECODER
+// ============================================
+
+/**
+ * Vista de solo lectura sobre bytes del buffer de entrada
+ * No copia nada: apunta directamente al XDR decodificado
+ */
+struct XDRBytesView {
+    const uint8_t* data;
+    size_t length;
+};
+
+/**
+ * Resultado de una operación (OperationResult)
+ */
+struct XDROperationResult {
+    int32_t code;               // OperationResultCode (0 = opINNER)
+    OperationType type;         // Solo válido si code == OP_RESULT_INNER
+    int32_t innerCode;          // Código específico de la operación (0 = éxito)
+};
+
+/**
+ * Resultado de transacción (TransactionResult)
+ * 
+ * Para fee bumps, feeCharged/code/operations corresponden a la
+ * transacción interna y outerFeeCharged/outerCode a la externa.
+ */
+struct XDRTransactionResult {
+    int64_t feeCharged;
+    int32_t code;               // TransactionResultCode
+    bool feeBump;
+    int64_t outerFeeCharged;
+    int32_t outerCode;
+    XDRBytesView innerHash;     // 32 bytes (solo fee bump)
+    uint32_t operationCount;
+    XDRBytesView operations;    // OperationResult[] sin copiar
+};
+
+/**
+ * Operación de una transacción (Operation)
+ */
+struct XDROperation {
+    bool hasSourceAccount;
+    XDRBytesView sourceAccount; // 32 bytes ed25519
+    OperationType type;
+    XDRBytesView body;          // Cuerpo de la operación sin interpretar
+};
+
+/**
+ * Firma decorada (DecoratedSignature)
+ */
+struct XDRDecoratedSignature {
+    XDRBytesView hint;          // 4 bytes
+    XDRBytesView signature;     // hasta 64 bytes
+};
+
+/**
+ * Envelope de transacción (TransactionEnvelope)
+ * 
+ * Para fee bumps, los campos describen la transacción interna y
+ * feeBumpSource/feeBumpFee la externa.
+ */
+struct XDRTransactionEnvelope {
+    uint32_t envelopeType;      // EnvelopeType
+    XDRBytesView sourceAccount; // 32 bytes ed25519
+    bool sourceMuxed;
+    uint64_t sourceMuxedId;
+    uint32_t fee;
+    int64_t sequenceNumber;
+    uint32_t memoType;          // MemoType
+    XDRBytesView memo;          // Texto (MEMO_TEXT) o 32 bytes (MEMO_HASH/RETURN)
+    uint64_t memoId;            // Solo MEMO_ID
+    uint32_t operationCount;
+    XDRBytesView operations;    // Operation[] sin copiar
+    XDRBytesView transaction;   // Bytes de la Transaction (para recalcular el hash)
+    uint32_t signatureCount;
+    XDRBytesView signatures;    // DecoratedSignature[] sin copiar
+    bool feeBump;
+    XDRBytesView feeBumpSource; // 32 bytes ed25519
+    int64_t feeBumpFee;
+};
+
+/**
+ * Metadata de transacción (TransactionMeta)
+ * 
+ * Solo se interpreta la versión: los LedgerEntryChanges quedan
+ * como vista sin decodificar.
+ */
+struct XDRTransactionMeta {
+    int32_t version;
+    XDRBytesView body;
+};
+
+/**
+ * Decoder XDR zero-copy
+ * 
+ * Lee sobre un buffer externo sin copiarlo; todas las vistas que
+ * devuelve apuntan dentro de ese buffer, así que debe vivir mientras
+ * se usen. Cada lectura verifica límites: tras el primer error el
+ * decoder queda en estado de error y todas las lecturas fallan.
+ * 
+ * Uso:
+ * 1. Decodificar el base64 de Horizon con decodeBase64()
+ * 2. Crear decoder sobre esos bytes
+ * 3. Llamar decodeTransactionResult() / decodeTransactionEnvelope()
+ */
+class XDRDecoder {
+public:
+    XDRDecoder(const uint8_t* data, size_t length);
+    explicit XDRDecoder(const XDRBytesView& view);
+    
+    /**
+     * Decodifica base64 a un buffer del llamador verificando capacidad
+     * 
+     * @param base64 String base64 (result_xdr, envelope_xdr...)
+     * @param buffer Buffer de salida
+     * @param capacity Capacidad del buffer
+     * @param length Bytes escritos
+     * @return true si éxito
+     */
+    static bool decodeBase64(
+        const char* base64,
+        uint8_t* buffer,
+        size_t capacity,
+        size_t* length
+    );
+    
+    // ============================================
+    // TIPOS BÁSICOS XDR
+    // ============================================
+    
+    bool decodeUint32(uint32_t& value);
+    bool decodeInt32(int32_t& value);
+    bool decodeUint64(uint64_t& value);
+    bool decodeInt64(int64_t& value);
+    bool decodeBool(bool& value);
+    
+    /**
+     * Lee opaque de longitud fija (con padding a múltiplo de 4)
+     */
+    bool decodeFixedOpaque(size_t length, XDRBytesView& view);
+    
+    /**
+     * Lee opaque/string de longitud variable (longitud + datos + padding)
+     */
+    bool decodeVarOpaque(size_t maxLength, XDRBytesView& view);
+    
+    /**
+     * Avanza n bytes sin interpretarlos
+     */
+    bool skip(size_t length);
+    
+    /**
+     * Marca el decoder con error (solo se conserva el primero)
+     * Para decoders externos construidos sobre las primitivas.
+     * 
+     * @return Siempre false
+     */
+    bool fail(const char* message);
+    
+    // ============================================
+    // ESTRUCTURAS STELLAR
+    // ============================================
+    
+    bool decodeMuxedAccount(XDRBytesView& ed25519, bool* muxed = nullptr, uint64_t* muxedId = nullptr);
+    bool decodeAccountId(XDRBytesView& ed25519);
+    bool skipAsset();
+    
+    bool decodeTransactionResult(XDRTransactionResult& result);
+    bool decodeOperationResult(XDROperationResult& result);
+    bool decodeTransactionEnvelope(XDRTransactionEnvelope& envelope);
+    bool decodeOperation(XDROperation& operation);
+    bool decodeDecoratedSignature(XDRDecoratedSignature& signature);
+    bool decodeTransactionMeta(XDRTransactionMeta& meta);
+    
+    // ============================================
+    // ESTADO
+    // ============================================
+    
+    size_t getPosition() const { return position; }
+    size_t getRemaining() const { return length - position; }
+    const uint8_t* getCursor() const { return data + position; }
+    bool isAtEnd() const { return position == length; }
+    bool hasError() const { return error != nullptr; }
+    const char* getLastError() const { return error ? error : ""; }
+    
+private:
+    const uint8_t* data;
+    size_t length;
+    size_t position;
+    const char* error;
+    
+    bool require(size_t needed);
     
-    void ensureCapacity(size_t needed);
+    bool decodeTransactionV1(XDRTransactionEnvelope& envelope);
+    bool decodeTransactionV0(XDRTransactionEnvelope& envelope);
+    bool decodeMemo(XDRTransactionEnvelope& envelope);
+    bool skipPreconditions();
+    bool skipSignerKey();
+    bool skipOperationBody(OperationType type);
+    bool skipChangeTrustAsset();
+    bool skipClaimAtom();
+    bool decodeOperationResultList(XDRTransactionResult& result);
 };
 
 #endif // STELLAR_XDR_H
\ No newline at end of file
@@ -0,0 +1,975 @@
+#ifndef STELLAR_XDR_SCHEMA_H
+#define STELLAR_XDR_SCHEMA_H
+
+#include <Arduino.h>
+#include "stellar_xdr.h"
+
+/**
+ * Esquemas XDR en tiempo de compilación
+ *
+ * Cada tipo XDR se describe con un struct que expone:
+ * - Value:    datos a encodear / decodificados (punteros al buffer, sin copias)
+ * - MAX_SIZE: tamaño máximo encodeado, calculado por el compilador
+ * - size(v):  tamaño exacto para un valor concreto
+ * - write():  escritura sin chequeos sobre espacio ya reservado
+ * - read():   decodificación sobre XDRDecoder
+ *
+ * Los structs compuestos se arman con los primitivos, así que el
+ * compilador aplana toda la cadena write() en stores directos y
+ * MAX_SIZE permite dimensionar buffers en stack sin adivinar.
+ *
+ * Uso:
+ *   XDRStaticEncoder<XDRSchema::PaymentEnvelope::MAX_SIZE> encoder;
+ *   XDRSchema::encode<XDRSchema::PaymentTransaction>(encoder, tx);
+ */
+
+namespace XDRSchema {
+
+// ============================================
+// HELPERS
+// ============================================
+
+// Longitud con padding XDR (múltiplo de 4)
+constexpr size_t padded(size_t length) {
+    return (length + 3) & ~(size_t)3;
+}
+
+constexpr size_t maxOf(size_t a, size_t b) {
+    return a > b ? a : b;
+}
+
+inline uint8_t* putUint32(uint8_t* out, uint32_t value) {
+    out[0] = (value >> 24) & 0xFF;
+    out[1] = (value >> 16) & 0xFF;
+    out[2] = (value >> 8) & 0xFF;
+    out[3] = value & 0xFF;
+    return out + 4;
+}
+
+inline uint8_t* putUint64(uint8_t* out, uint64_t value) {
+    out = putUint32(out, (uint32_t)(value >> 32));
+    return putUint32(out, (uint32_t)value);
+}
+
+// Copia length bytes y completa con ceros hasta múltiplo de 4
+inline uint8_t* putPadded(uint8_t* out, const uint8_t* data, size_t length) {
+    if (length > 0) {
+        memcpy(out, data, length);
+    }
+
+    size_t total = padded(length);
+
+    for (size_t i = length; i < total; i++) {
+        out[i] = 0;
+    }
+
+    return out + total;
+}
+
+// ============================================
+// PRIMITIVOS
+// ============================================
+
+struct Uint32 {
+    typedef uint32_t Value;
+    static constexpr size_t MAX_SIZE = 4;
+
+    static size_t size(const Value&) { return MAX_SIZE; }
+    static uint8_t* write(uint8_t* out, const Value& v) { return putUint32(out, v); }
+    static bool read(XDRDecoder& in, Value& v) { return in.decodeUint32(v); }
+};
+
+struct Int32 {
+    typedef int32_t Value;
+    static constexpr size_t MAX_SIZE = 4;
+
+    static size_t size(const Value&) { return MAX_SIZE; }
+    static uint8_t* write(uint8_t* out, const Value& v) { return putUint32(out, (uint32_t)v); }
+    static bool read(XDRDecoder& in, Value& v) { return in.decodeInt32(v); }
+};
+
+struct Uint64 {
+    typedef uint64_t Value;
+    static constexpr size_t MAX_SIZE = 8;
+
+    static size_t size(const Value&) { return MAX_SIZE; }
+    static uint8_t* write(uint8_t* out, const Value& v) { return putUint64(out, v); }
+    static bool read(XDRDecoder& in, Value& v) { return in.decodeUint64(v); }
+};
+
+struct Int64 {
+    typedef int64_t Value;
+    static constexpr size_t MAX_SIZE = 8;
+
+    static size_t size(const Value&) { return MAX_SIZE; }
+    static uint8_t* write(uint8_t* out, const Value& v) { return putUint64(out, (uint64_t)v); }
+    static bool read(XDRDecoder& in, Value& v) { return in.decodeInt64(v); }
+};
+
+struct Bool {
+    typedef bool Value;
+    static constexpr size_t MAX_SIZE = 4;
+
+    static size_t size(const Value&) { return MAX_SIZE; }
+    static uint8_t* write(uint8_t* out, const Value& v) { return putUint32(out, v ? 1 : 0); }
+    static bool read(XDRDecoder& in, Value& v) { return in.decodeBool(v); }
+};
+
+// opaque[N]: N bytes + padding, sin longitud
+template <size_t N>
+struct FixedOpaque {
+    typedef const uint8_t* Value;
+    static constexpr size_t MAX_SIZE = padded(N);
+
+    static size_t size(const Value&) { return MAX_SIZE; }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        return putPadded(out, v, N);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        XDRBytesView view;
+        if (!in.decodeFixedOpaque(N, view)) {
+            return false;
+        }
+        v = view.data;
+        return true;
+    }
+};
+
+// opaque<MAX> / string<MAX>: longitud (uint32) + bytes + padding
+template <size_t MAX_LENGTH>
+struct VarOpaque {
+    typedef XDRBytesView Value;
+    static constexpr size_t MAX_SIZE = 4 + padded(MAX_LENGTH);
+
+    static size_t size(const Value& v) { return 4 + padded(v.length); }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = putUint32(out, (uint32_t)v.length);
+        return putPadded(out, v.data, v.length);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        return in.decodeVarOpaque(MAX_LENGTH, v);
+    }
+};
+
+// ============================================
+// ESTRUCTURAS STELLAR
+// ============================================
+
+/**
+ * MuxedAccount
+ * KEY_TYPE_ED25519: type + ed25519 (36 bytes)
+ * KEY_TYPE_MUXED_ED25519: type + id + ed25519 (44 bytes)
+ */
+struct MuxedAccount {
+    struct Value {
+        const uint8_t* ed25519;   // 32 bytes
+        bool muxed;
+        uint64_t id;
+    };
+
+    static constexpr size_t MAX_SIZE = 4 + 8 + 32;
+
+    static size_t size(const Value& v) { return v.muxed ? 44 : 36; }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        if (v.muxed) {
+            out = putUint32(out, KEY_TYPE_MUXED_ED25519);
+            out = putUint64(out, v.id);
+        } else {
+            out = putUint32(out, KEY_TYPE_ED25519);
+        }
+        memcpy(out, v.ed25519, 32);
+        return out + 32;
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        XDRBytesView key;
+        v.id = 0;
+        if (!in.decodeMuxedAccount(key, &v.muxed, &v.id)) {
+            return false;
+        }
+        v.ed25519 = key.data;
+        return true;
+    }
+};
+
+/**
+ * Asset
+ * Native: type (4 bytes)
+ * AlphaNum4: type + code[4] + issuer AccountID (44 bytes)
+ * AlphaNum12: type + code[12] + issuer AccountID (52 bytes)
+ */
+struct Asset {
+    struct Value {
+        AssetType type;
+        uint8_t code[12];         // Rellenado con ceros
+        const uint8_t* issuer;    // 32 bytes (no native)
+    };
+
+    static constexpr size_t MAX_SIZE = 4 + 12 + 4 + 32;
+
+    static size_t codeLength(AssetType type) {
+        return type == ASSET_TYPE_CREDIT_ALPHANUM4 ? 4 : 12;
+    }
+
+    static size_t size(const Value& v) {
+        if (v.type == ASSET_TYPE_NATIVE) {
+            return 4;
+        }
+        return 4 + codeLength(v.type) + 4 + 32;
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = putUint32(out, v.type);
+
+        if (v.type != ASSET_TYPE_NATIVE) {
+            size_t codeLen = codeLength(v.type);
+            memcpy(out, v.code, codeLen);
+            out += codeLen;
+            out = putUint32(out, KEY_TYPE_ED25519);
+            memcpy(out, v.issuer, 32);
+            out += 32;
+        }
+
+        return out;
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        uint32_t type;
+        if (!in.decodeUint32(type)) {
+            return false;
+        }
+
+        memset(v.code, 0, sizeof(v.code));
+        v.issuer = nullptr;
+        v.type = (AssetType)type;
+
+        if (type == ASSET_TYPE_NATIVE) {
+            return true;
+        }
+
+        if (type != ASSET_TYPE_CREDIT_ALPHANUM4 && type != ASSET_TYPE_CREDIT_ALPHANUM12) {
+            return in.fail("Unsupported asset type");
+        }
+
+        XDRBytesView code, issuer;
+        if (!in.decodeFixedOpaque(codeLength(v.type), code) ||
+            !in.decodeAccountId(issuer)) {
+            return false;
+        }
+
+        memcpy(v.code, code.data, code.length);
+        v.issuer = issuer.data;
+        return true;
+    }
+};
+
+/**
+ * Memo
+ * NONE (4), TEXT string<28> (hasta 36), ID uint64 (12), HASH/RETURN Hash (36)
+ */
+struct Memo {
+    struct Value {
+        MemoType type;
+        XDRBytesView text;        // MEMO_TEXT
+        uint64_t id;              // MEMO_ID
+        const uint8_t* hash;      // MEMO_HASH / MEMO_RETURN (32 bytes)
+    };
+
+    static const size_t MAX_TEXT_LENGTH = 28;
+    static constexpr size_t MAX_SIZE = 4 + maxOf(4 + padded(MAX_TEXT_LENGTH), 32);
+
+    static size_t size(const Value& v) {
+        switch (v.type) {
+            case MEMO_TEXT:   return 4 + VarOpaque<MAX_TEXT_LENGTH>::size(v.text);
+            case MEMO_ID:     return 4 + 8;
+            case MEMO_HASH:
+            case MEMO_RETURN: return 4 + 32;
+            default:          return 4;
+        }
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = putUint32(out, v.type);
+
+        switch (v.type) {
+            case MEMO_TEXT:
+                return VarOpaque<MAX_TEXT_LENGTH>::write(out, v.text);
+            case MEMO_ID:
+                return putUint64(out, v.id);
+            case MEMO_HASH:
+            case MEMO_RETURN:
+                memcpy(out, v.hash, 32);
+                return out + 32;
+            default:
+                return out;
+        }
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        uint32_t type;
+        if (!in.decodeUint32(type)) {
+            return false;
+        }
+
+        v.type = (MemoType)type;
+        v.text.data = nullptr;
+        v.text.length = 0;
+        v.id = 0;
+        v.hash = nullptr;
+
+        switch (type) {
+            case MEMO_NONE:
+                return true;
+            case MEMO_TEXT:
+                return VarOpaque<MAX_TEXT_LENGTH>::read(in, v.text);
+            case MEMO_ID:
+                return in.decodeUint64(v.id);
+            case MEMO_HASH:
+            case MEMO_RETURN:
+                return FixedOpaque<32>::read(in, v.hash);
+            default:
+                return in.fail("Unknown memo type");
+        }
+    }
+};
+
+/**
+ * Preconditions
+ * Solo PRECOND_NONE y PRECOND_TIME (TimeBounds)
+ */
+struct Preconditions {
+    struct Value {
+        bool hasTimeBounds;
+        uint64_t minTime;
+        uint64_t maxTime;
+    };
+
+    static constexpr size_t MAX_SIZE = 4 + 8 + 8;
+
+    static size_t size(const Value& v) { return v.hasTimeBounds ? MAX_SIZE : 4; }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        if (!v.hasTimeBounds) {
+            return putUint32(out, 0);        // PRECOND_NONE
+        }
+        out = putUint32(out, 1);             // PRECOND_TIME
+        out = putUint64(out, v.minTime);
+        return putUint64(out, v.maxTime);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        uint32_t type;
+        if (!in.decodeUint32(type)) {
+            return false;
+        }
+
+        v.hasTimeBounds = (type == 1);
+        v.minTime = 0;
+        v.maxTime = 0;
+
+        if (type == 0) {
+            return true;
+        }
+        if (type == 1) {
+            return in.decodeUint64(v.minTime) && in.decodeUint64(v.maxTime);
+        }
+        return in.fail("Unsupported preconditions");
+    }
+};
+
+/**
+ * PaymentOp: destination (MuxedAccount) + asset + amount
+ */
+struct PaymentOp {
+    static const OperationType TYPE = PAYMENT;
+
+    struct Value {
+        MuxedAccount::Value destination;
+        Asset::Value asset;
+        int64_t amount;               // stroops
+    };
+
+    static constexpr size_t MAX_SIZE = MuxedAccount::MAX_SIZE + Asset::MAX_SIZE + 8;
+
+    static size_t size(const Value& v) {
+        return MuxedAccount::size(v.destination) + Asset::size(v.asset) + 8;
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = MuxedAccount::write(out, v.destination);
+        out = Asset::write(out, v.asset);
+        return putUint64(out, (uint64_t)v.amount);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        return MuxedAccount::read(in, v.destination) &&
+               Asset::read(in, v.asset) &&
+               in.decodeInt64(v.amount);
+    }
+};
+
+/**
+ * Path de assets intermedios (Asset path<5>)
+ */
+struct AssetPath {
+    static const size_t MAX_ASSETS = 5;
+
+    struct Value {
+        uint32_t count;
+        Asset::Value assets[MAX_ASSETS];
+    };
+
+    static constexpr size_t MAX_SIZE = 4 + MAX_ASSETS * Asset::MAX_SIZE;
+
+    static size_t size(const Value& v) {
+        size_t total = 4;
+        for (uint32_t i = 0; i < v.count; i++) {
+            total += Asset::size(v.assets[i]);
+        }
+        return total;
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = putUint32(out, v.count);
+        for (uint32_t i = 0; i < v.count; i++) {
+            out = Asset::write(out, v.assets[i]);
+        }
+        return out;
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        if (!in.decodeUint32(v.count)) {
+            return false;
+        }
+        if (v.count > MAX_ASSETS) {
+            return in.fail("Asset path too long");
+        }
+        for (uint32_t i = 0; i < v.count; i++) {
+            if (!Asset::read(in, v.assets[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * CreateAccountOp: destination (AccountID) + startingBalance
+ */
+struct CreateAccountOp {
+    static const OperationType TYPE = CREATE_ACCOUNT;
+
+    struct Value {
+        const uint8_t* destination;   // 32 bytes
+        int64_t startingBalance;      // stroops
+    };
+
+    static constexpr size_t MAX_SIZE = 4 + 32 + 8;
+
+    static size_t size(const Value&) { return MAX_SIZE; }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = putUint32(out, KEY_TYPE_ED25519);
+        memcpy(out, v.destination, 32);
+        return putUint64(out + 32, (uint64_t)v.startingBalance);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        XDRBytesView destination;
+        if (!in.decodeAccountId(destination) || !in.decodeInt64(v.startingBalance)) {
+            return false;
+        }
+        v.destination = destination.data;
+        return true;
+    }
+};
+
+/**
+ * ChangeTrustOp: line (ChangeTrustAsset) + limit
+ * Solo assets clásicos; las trustlines a pools no están soportadas
+ */
+struct ChangeTrustOp {
+    static const OperationType TYPE = CHANGE_TRUST;
+
+    struct Value {
+        Asset::Value line;
+        int64_t limit;                // stroops (0 = eliminar trustline)
+    };
+
+    static constexpr size_t MAX_SIZE = Asset::MAX_SIZE + 8;
+
+    static size_t size(const Value& v) { return Asset::size(v.line) + 8; }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = Asset::write(out, v.line);
+        return putUint64(out, (uint64_t)v.limit);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        return Asset::read(in, v.line) && in.decodeInt64(v.limit);
+    }
+};
+
+/**
+ * ManageDataOp: dataName string<64> + dataValue opcional opaque<64>
+ */
+struct ManageDataOp {
+    static const OperationType TYPE = MANAGE_DATA;
+    static const size_t MAX_NAME_LENGTH = 64;
+    static const size_t MAX_VALUE_LENGTH = 64;
+
+    struct Value {
+        XDRBytesView name;
+        bool hasValue;                // false = eliminar la entrada
+        XDRBytesView value;
+    };
+
+    static constexpr size_t MAX_SIZE =
+        VarOpaque<MAX_NAME_LENGTH>::MAX_SIZE + 4 + VarOpaque<MAX_VALUE_LENGTH>::MAX_SIZE;
+
+    static size_t size(const Value& v) {
+        return VarOpaque<MAX_NAME_LENGTH>::size(v.name) + 4 +
+               (v.hasValue ? VarOpaque<MAX_VALUE_LENGTH>::size(v.value) : 0);
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = VarOpaque<MAX_NAME_LENGTH>::write(out, v.name);
+        out = putUint32(out, v.hasValue ? 1 : 0);
+        if (v.hasValue) {
+            out = VarOpaque<MAX_VALUE_LENGTH>::write(out, v.value);
+        }
+        return out;
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        v.value.data = nullptr;
+        v.value.length = 0;
+
+        if (!VarOpaque<MAX_NAME_LENGTH>::read(in, v.name) || !in.decodeBool(v.hasValue)) {
+            return false;
+        }
+        return !v.hasValue || VarOpaque<MAX_VALUE_LENGTH>::read(in, v.value);
+    }
+};
+
+/**
+ * PathPaymentStrictReceiveOp
+ * sendAsset + sendMax + destination + destAsset + destAmount + path
+ */
+struct PathPaymentStrictReceiveOp {
+    static const OperationType TYPE = PATH_PAYMENT_STRICT_RECEIVE;
+
+    struct Value {
+        Asset::Value sendAsset;
+        int64_t sendMax;
+        MuxedAccount::Value destination;
+        Asset::Value destAsset;
+        int64_t destAmount;
+        AssetPath::Value path;
+    };
+
+    static constexpr size_t MAX_SIZE =
+        2 * Asset::MAX_SIZE + 2 * 8 + MuxedAccount::MAX_SIZE + AssetPath::MAX_SIZE;
+
+    static size_t size(const Value& v) {
+        return Asset::size(v.sendAsset) + 8 + MuxedAccount::size(v.destination) +
+               Asset::size(v.destAsset) + 8 + AssetPath::size(v.path);
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = Asset::write(out, v.sendAsset);
+        out = putUint64(out, (uint64_t)v.sendMax);
+        out = MuxedAccount::write(out, v.destination);
+        out = Asset::write(out, v.destAsset);
+        out = putUint64(out, (uint64_t)v.destAmount);
+        return AssetPath::write(out, v.path);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        return Asset::read(in, v.sendAsset) &&
+               in.decodeInt64(v.sendMax) &&
+               MuxedAccount::read(in, v.destination) &&
+               Asset::read(in, v.destAsset) &&
+               in.decodeInt64(v.destAmount) &&
+               AssetPath::read(in, v.path);
+    }
+};
+
+/**
+ * PathPaymentStrictSendOp
+ * sendAsset + sendAmount + destination + destAsset + destMin + path
+ */
+struct PathPaymentStrictSendOp {
+    static const OperationType TYPE = PATH_PAYMENT_STRICT_SEND;
+
+    struct Value {
+        Asset::Value sendAsset;
+        int64_t sendAmount;
+        MuxedAccount::Value destination;
+        Asset::Value destAsset;
+        int64_t destMin;
+        AssetPath::Value path;
+    };
+
+    static constexpr size_t MAX_SIZE = PathPaymentStrictReceiveOp::MAX_SIZE;
+
+    static size_t size(const Value& v) {
+        return Asset::size(v.sendAsset) + 8 + MuxedAccount::size(v.destination) +
+               Asset::size(v.destAsset) + 8 + AssetPath::size(v.path);
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = Asset::write(out, v.sendAsset);
+        out = putUint64(out, (uint64_t)v.sendAmount);
+        out = MuxedAccount::write(out, v.destination);
+        out = Asset::write(out, v.destAsset);
+        out = putUint64(out, (uint64_t)v.destMin);
+        return AssetPath::write(out, v.path);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        return Asset::read(in, v.sendAsset) &&
+               in.decodeInt64(v.sendAmount) &&
+               MuxedAccount::read(in, v.destination) &&
+               Asset::read(in, v.destAsset) &&
+               in.decodeInt64(v.destMin) &&
+               AssetPath::read(in, v.path);
+    }
+};
+
+/**
+ * Operation con cuerpo fijo
+ * sourceAccount opcional + type + body
+ */
+template <typename Body>
+struct Operation {
+    struct Value {
+        bool hasSourceAccount;
+        MuxedAccount::Value sourceAccount;
+        typename Body::Value body;
+    };
+
+    static constexpr size_t MAX_SIZE = 4 + MuxedAccount::MAX_SIZE + 4 + Body::MAX_SIZE;
+
+    static size_t size(const Value& v) {
+        return 4 + (v.hasSourceAccount ? MuxedAccount::size(v.sourceAccount) : 0) +
+               4 + Body::size(v.body);
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = putUint32(out, v.hasSourceAccount ? 1 : 0);
+        if (v.hasSourceAccount) {
+            out = MuxedAccount::write(out, v.sourceAccount);
+        }
+        out = putUint32(out, Body::TYPE);
+        return Body::write(out, v.body);
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        if (!in.decodeBool(v.hasSourceAccount)) {
+            return false;
+        }
+        if (v.hasSourceAccount && !MuxedAccount::read(in, v.sourceAccount)) {
+            return false;
+        }
+
+        uint32_t type;
+        if (!in.decodeUint32(type)) {
+            return false;
+        }
+        if (type != (uint32_t)Body::TYPE) {
+            return in.fail("Unexpected operation type");
+        }
+
+        return Body::read(in, v.body);
+    }
+};
+
+/**
+ * Operation con cuerpo elegido en runtime entre los tipos soportados
+ * MAX_SIZE es el del cuerpo más grande.
+ */
+struct AnyOperation {
+    struct Value {
+        bool hasSourceAccount;
+        MuxedAccount::Value sourceAccount;
+        OperationType type;
+        union {
+            CreateAccountOp::Value createAccount;
+            PaymentOp::Value payment;
+            PathPaymentStrictReceiveOp::Value pathPaymentStrictReceive;
+            ChangeTrustOp::Value changeTrust;
+            ManageDataOp::Value manageData;
+            PathPaymentStrictSendOp::Value pathPaymentStrictSend;
+        } body;
+    };
+
+    static constexpr size_t MAX_BODY_SIZE =
+        maxOf(maxOf(CreateAccountOp::MAX_SIZE, PaymentOp::MAX_SIZE),
+              maxOf(maxOf(PathPaymentStrictReceiveOp::MAX_SIZE, PathPaymentStrictSendOp::MAX_SIZE),
+                    maxOf(ChangeTrustOp::MAX_SIZE, ManageDataOp::MAX_SIZE)));
+
+    static constexpr size_t MAX_SIZE = 4 + MuxedAccount::MAX_SIZE + 4 + MAX_BODY_SIZE;
+
+    // Tamaño del cuerpo (0 si el tipo no está soportado)
+    static size_t bodySize(const Value& v) {
+        switch (v.type) {
+            case CREATE_ACCOUNT:              return CreateAccountOp::size(v.body.createAccount);
+            case PAYMENT:                     return PaymentOp::size(v.body.payment);
+            case PATH_PAYMENT_STRICT_RECEIVE: return PathPaymentStrictReceiveOp::size(v.body.pathPaymentStrictReceive);
+            case CHANGE_TRUST:                return ChangeTrustOp::size(v.body.changeTrust);
+            case MANAGE_DATA:                 return ManageDataOp::size(v.body.manageData);
+            case PATH_PAYMENT_STRICT_SEND:    return PathPaymentStrictSendOp::size(v.body.pathPaymentStrictSend);
+            default:                          return 0;
+        }
+    }
+
+    static bool isSupported(OperationType type) {
+        switch (type) {
+            case CREATE_ACCOUNT:
+            case PAYMENT:
+            case PATH_PAYMENT_STRICT_RECEIVE:
+            case CHANGE_TRUST:
+            case MANAGE_DATA:
+            case PATH_PAYMENT_STRICT_SEND:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static size_t size(const Value& v) {
+        return 4 + (v.hasSourceAccount ? MuxedAccount::size(v.sourceAccount) : 0) +
+               4 + bodySize(v);
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = putUint32(out, v.hasSourceAccount ? 1 : 0);
+        if (v.hasSourceAccount) {
+            out = MuxedAccount::write(out, v.sourceAccount);
+        }
+        out = putUint32(out, v.type);
+
+        switch (v.type) {
+            case CREATE_ACCOUNT:              return CreateAccountOp::write(out, v.body.createAccount);
+            case PAYMENT:                     return PaymentOp::write(out, v.body.payment);
+            case PATH_PAYMENT_STRICT_RECEIVE: return PathPaymentStrictReceiveOp::write(out, v.body.pathPaymentStrictReceive);
+            case CHANGE_TRUST:                return ChangeTrustOp::write(out, v.body.changeTrust);
+            case MANAGE_DATA:                 return ManageDataOp::write(out, v.body.manageData);
+            case PATH_PAYMENT_STRICT_SEND:    return PathPaymentStrictSendOp::write(out, v.body.pathPaymentStrictSend);
+            default:                          return out;
+        }
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        if (!in.decodeBool(v.hasSourceAccount)) {
+            return false;
+        }
+        if (v.hasSourceAccount && !MuxedAccount::read(in, v.sourceAccount)) {
+            return false;
+        }
+
+        uint32_t type;
+        if (!in.decodeUint32(type)) {
+            return false;
+        }
+        v.type = (OperationType)type;
+
+        switch (v.type) {
+            case CREATE_ACCOUNT:              return CreateAccountOp::read(in, v.body.createAccount);
+            case PAYMENT:                     return PaymentOp::read(in, v.body.payment);
+            case PATH_PAYMENT_STRICT_RECEIVE: return PathPaymentStrictReceiveOp::read(in, v.body.pathPaymentStrictReceive);
+            case CHANGE_TRUST:                return ChangeTrustOp::read(in, v.body.changeTrust);
+            case MANAGE_DATA:                 return ManageDataOp::read(in, v.body.manageData);
+            case PATH_PAYMENT_STRICT_SEND:    return PathPaymentStrictSendOp::read(in, v.body.pathPaymentStrictSend);
+            default:                          return in.fail("Unsupported operation type");
+        }
+    }
+};
+
+/**
+ * Transaction (v1) con hasta MAX_OPS operaciones de tipo Op
+ *
+ * Al encodear se usa 'operations', o si es nullptr los bytes ya
+ * encodeados de 'encodedOperations' (operaciones acumuladas por un
+ * builder). Al decodear las operaciones quedan como vista en
+ * 'encodedOperations' para leerlas una a una con Op::read.
+ */
+template <typename Op, size_t MAX_OPS>
+struct Transaction {
+    static const size_t MAX_OPERATIONS = MAX_OPS;
+
+    struct Value {
+        MuxedAccount::Value sourceAccount;
+        uint32_t fee;
+        int64_t sequenceNumber;
+        Preconditions::Value cond;
+        Memo::Value memo;
+        uint32_t operationCount;
+        const typename Op::Value* operations;
+        XDRBytesView encodedOperations;
+    };
+
+    static constexpr size_t MAX_SIZE =
+        MuxedAccount::MAX_SIZE + 4 + 8 + Preconditions::MAX_SIZE +
+        Memo::MAX_SIZE + 4 + MAX_OPS * Op::MAX_SIZE + 4;
+
+    static size_t size(const Value& v) {
+        size_t total = MuxedAccount::size(v.sourceAccount) + 4 + 8 +
+                       Preconditions::size(v.cond) + Memo::size(v.memo) + 4 + 4;
+        if (!v.operations) {
+            return total + v.encodedOperations.length;
+        }
+        for (uint32_t i = 0; i < v.operationCount; i++) {
+            total += Op::size(v.operations[i]);
+        }
+        return total;
+    }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        out = MuxedAccount::write(out, v.sourceAccount);
+        out = putUint32(out, v.fee);
+        out = putUint64(out, (uint64_t)v.sequenceNumber);
+        out = Preconditions::write(out, v.cond);
+        out = Memo::write(out, v.memo);
+        out = putUint32(out, v.operationCount);
+        if (!v.operations) {
+            memcpy(out, v.encodedOperations.data, v.encodedOperations.length);
+            out += v.encodedOperations.length;
+        }
+        for (uint32_t i = 0; v.operations && i < v.operationCount; i++) {
+            out = Op::write(out, v.operations[i]);
+        }
+        return putUint32(out, 0);             // ext v0
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        v.operations = nullptr;
+
+        if (!MuxedAccount::read(in, v.sourceAccount) ||
+            !in.decodeUint32(v.fee) ||
+            !in.decodeInt64(v.sequenceNumber) ||
+            !Preconditions::read(in, v.cond) ||
+            !Memo::read(in, v.memo) ||
+            !in.decodeUint32(v.operationCount)) {
+            return false;
+        }
+
+        if (v.operationCount == 0 || v.operationCount > MAX_OPS) {
+            return in.fail("Invalid operation count");
+        }
+
+        size_t start = in.getPosition();
+        v.encodedOperations.data = in.getCursor();
+
+        for (uint32_t i = 0; i < v.operationCount; i++) {
+            typename Op::Value op;
+            if (!Op::read(in, op)) {
+                return false;
+            }
+        }
+
+        v.encodedOperations.length = in.getPosition() - start;
+
+        uint32_t ext;
+        if (!in.decodeUint32(ext)) {
+            return false;
+        }
+        if (ext != 0) {
+            return in.fail("Unsupported transaction extension");
+        }
+        return true;
+    }
+};
+
+/**
+ * DecoratedSignature: hint[4] + signature<64>
+ */
+struct DecoratedSignature {
+    struct Value {
+        const uint8_t* hint;          // 4 bytes
+        const uint8_t* signature;     // 64 bytes
+    };
+
+    static constexpr size_t MAX_SIZE = 4 + 4 + 64;
+
+    static size_t size(const Value&) { return MAX_SIZE; }
+
+    static uint8_t* write(uint8_t* out, const Value& v) {
+        memcpy(out, v.hint, 4);
+        out = putUint32(out + 4, 64);
+        memcpy(out, v.signature, 64);
+        return out + 64;
+    }
+
+    static bool read(XDRDecoder& in, Value& v) {
+        XDRBytesView signature;
+        if (!FixedOpaque<4>::read(in, v.hint) ||
+            !in.decodeVarOpaque(64, signature)) {
+            return false;
+        }
+        if (signature.length != 64) {
+            return in.fail("Invalid signature length");
+        }
+        v.signature = signature.data;
+        return true;
+    }
+};
+
+/**
+ * TransactionV1Envelope: ENVELOPE_TYPE_TX + tx + firmas
+ * Solo describe el tamaño; la TX y las firmas se encodean por separado
+ * porque la firma depende del hash de la TX ya escrita.
+ */
+template <typename Tx, size_t MAX_SIGNATURES>
+struct Envelope {
+    static constexpr size_t MAX_SIZE =
+        4 + Tx::MAX_SIZE + 4 + MAX_SIGNATURES * DecoratedSignature::MAX_SIZE;
+};
+
+// ============================================
+// ENCODE / DECODE
+// ============================================
+
+/**
+ * Encodea un valor con un solo chequeo de capacidad
+ *
+ * @return false si no cabe (el encoder queda en overflow)
+ */
+template <typename Schema>
+inline bool encode(XDREncoder& encoder, const typename Schema::Value& value) {
+    uint8_t* out = encoder.beginWrite(Schema::size(value));
+
+    if (!out) {
+        return false;
+    }
+
+    encoder.endWrite(Schema::write(out, value));
+    return true;
+}
+
+template <typename Schema>
+inline bool decode(XDRDecoder& decoder, typename Schema::Value& value) {
+    return Schema::read(decoder, value);
+}
+
+// ============================================
+// TIPOS CONCRETOS
+// ============================================
+
+typedef Operation<PaymentOp> PaymentOperation;
+typedef Transaction<PaymentOperation, 1> PaymentTransaction;
+typedef Envelope<PaymentTransaction, 1> PaymentEnvelope;
+
+// Transacciones multi-operación (límite del protocolo: 100 operaciones)
+static const size_t MAX_OPERATIONS = 100;
+typedef Transaction<AnyOperation, MAX_OPERATIONS> MultiOpTransaction;
+
+} // namespace XDRSchema
+
+#endif // STELLAR_XDR_SCHEMA_H
@@ -1,5 +1,21 @@
 #include <unity.h>
 #include "../src/stellar_utils.h"
+#include "../src/stellar_bench.h"
+#include "../src/stellar_strkey.h"
+#include "../src/stellar_bip39.h"
+#include "../src/stellar_keypair.h"
+#include "../src/stellar_keyring.h"
+#include "../src/stellar_stream.h"
+#include "../src/stellar_network.h"
+#include "../src/stellar_sse.h"
+#include "../src/stellar_signing.h"
+#include "../src/stellar_random.h"
+#include "../src/stellar_payment.h"
+#include "../src/stellar_crypto.h"
+#include "../src/stellar_ed25519.h"
+#include "../src/stellar_xdr.h"
+#include "../src/stellar_storage.h"
+#include "../src/stellar_secure_file.h"
 
 void test_stroops_to_xlm() {
     TEST_ASSERT_EQUAL_FLOAT(1.0f, StellarUtils::stroopsToXLM(10000000));
@@ -60,6 +76,40 @@ void test_crc16_xmodem() {
     TEST_ASSERT_EQUAL_UINT16(0x3130, crc);
 }
 
+// Versión bit a bit: referencia para la implementación con tablas
+static uint16_t crc16XModemReference(const uint8_t* data, size_t length) {
+    uint16_t crc = 0x0000;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+
+        for (int j = 0; j < 8; j++) {
+            if (crc & 0x8000) {
+                crc = (crc << 1) ^ 0x1021;
+            } else {
+                crc = crc << 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+void test_crc16_xmodem_table() {
+    uint8_t data[80];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    // Todas las longitudes y alineaciones: bloques de 4 y resto
+    for (size_t offset = 0; offset < 4; offset++) {
+        for (size_t length = 0; length + offset <= sizeof(data); length++) {
+            TEST_ASSERT_EQUAL_UINT16(crc16XModemReference(data + offset, length),
+                                     StellarUtils::crc16XModem(data + offset, length));
+        }
+    }
+}
+
 void test_valid_address() {
     // Public key válida
     TEST_ASSERT_TRUE(StellarUtils::isValidAddress(
@@ -77,6 +127,1239 @@ void test_valid_address() {
     TEST_ASSERT_FALSE(StellarUtils::isValidAddress(nullptr));
 }
 
+void test_strkey_roundtrip() {
+    const char* address = "GBRPYHIL2CI3FNQ4BXLFMNDLFJUNPU2HY3ZMFSHONUCEOASW7QC7OX2H";
+    uint8_t key[32];
+    char encoded[STRKEY_MAX_LENGTH + 1];
+    
+    TEST_ASSERT_TRUE(StellarStrKey::decode(address, STRKEY_ACCOUNT_ID, key));
+    StellarStrKey::encode(STRKEY_ACCOUNT_ID, key, encoded);
+    TEST_ASSERT_EQUAL_STRING(address, encoded);
+    
+    // Una public key no es una secret key
+    TEST_ASSERT_FALSE(StellarStrKey::decode(address, STRKEY_SEED, key));
+    
+    // Checksum incorrecto
+    TEST_ASSERT_FALSE(StellarStrKey::isValid("GBRPYHIL2CI3FNQ4BXLFMNDLFJUNPU2HY3ZMFSHONUCEOASW7QC7OX2A"));
+    
+    // Muxed (SEP-23): misma key con id
+    uint8_t muxedKey[32];
+    uint64_t id = 0;
+    StellarStrKey::encodeMuxed(key, 1234, encoded);
+    TEST_ASSERT_EQUAL(STRKEY_MUXED_LENGTH, strlen(encoded));
+    TEST_ASSERT_TRUE(StellarStrKey::decodeMuxed(encoded, muxedKey, &id));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(key, muxedKey, 32);
+    TEST_ASSERT_EQUAL_UINT64(1234, id);
+}
+
+void test_bip39_entropy() {
+    uint8_t entropy[16];
+    memset(entropy, 0x7F, sizeof(entropy));
+    
+    // Vector oficial BIP39
+    String words = StellarBIP39::fromEntropy(entropy, sizeof(entropy));
+    TEST_ASSERT_EQUAL_STRING(
+        "legal winner thank year wave sausage worth useful legal winner thank yellow",
+        words.c_str()
+    );
+    
+    // Checksum incorrecto (última palabra)
+    TEST_ASSERT_TRUE(StellarBIP39::isValid(words.c_str()));
+    TEST_ASSERT_FALSE(StellarBIP39::isValid(
+        "legal winner thank year wave sausage worth useful legal winner thank zoo"
+    ));
+}
+
+void test_sep0005_derivation() {
+    // Vector 1 de SEP-0005
+    const char* words = "illness spike retreat truth genius clock brain pass fit cave bargain toe";
+    
+    StellarKeypair* kp = StellarKeypair::fromMnemonic(words, 0);
+    TEST_ASSERT_NOT_NULL(kp);
+    TEST_ASSERT_EQUAL_STRING("SBGWSG6BTNCKCOB3DIFBGCVMUPQFYPA2G4O34RMTB343OYPXU5DJDVMN",
+                             kp->getSecretKey().c_str());
+    TEST_ASSERT_EQUAL_INT32(0, kp->getAccountIndex());
+    delete kp;
+    
+    // Cuenta 1 desde el nodo en caché (sin repetir la seed)
+    TEST_ASSERT_TRUE(StellarKeypair::hasAccountNode());
+    kp = StellarKeypair::deriveAccount(1);
+    TEST_ASSERT_NOT_NULL(kp);
+    TEST_ASSERT_EQUAL_STRING("SCEPFFWGAG5P2VX5DHIYK3XEMZYLTYWIPWYEKXFHSK25RVMIUNJ7CTIS",
+                             kp->getSecretKey().c_str());
+    delete kp;
+    
+    StellarKeypair::clearAccountNode();
+    TEST_ASSERT_NULL(StellarKeypair::deriveAccount(0));
+}
+
+void test_keypair_move() {
+    const char* secret = "SBGWSG6BTNCKCOB3DIFBGCVMUPQFYPA2G4O34RMTB343OYPXU5DJDVMN";
+    StellarKeypair kp;
+    
+    TEST_ASSERT_TRUE(StellarKeypair::fromSecret(secret, kp));
+    TEST_ASSERT_EQUAL_STRING(secret, kp.getSecretKeyCStr());
+    
+    // La dirección se codifica una vez: mismo buffer en cada llamada
+    const char* address = kp.getPublicKeyCStr();
+    TEST_ASSERT_EQUAL(STRKEY_ED25519_LENGTH, strlen(address));
+    TEST_ASSERT_EQUAL_PTR(address, kp.getPublicKeyCStr());
+    TEST_ASSERT_EQUAL_STRING(address, kp.getPublicKey().c_str());
+    
+    // Mover deja el origen vacío
+    uint8_t zero[32] = {0};
+    StellarKeypair moved(static_cast<StellarKeypair&&>(kp));
+    TEST_ASSERT_EQUAL_STRING(secret, moved.getSecretKeyCStr());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(zero, kp.getRawSecretKey(), 32);
+}
+
+void test_keypair_generate_keeps_node() {
+    uint8_t node[HD_ACCOUNT_NODE_SIZE];
+    uint8_t cached[HD_ACCOUNT_NODE_SIZE];
+    memset(node, 0x5a, sizeof(node));
+    StellarKeypair::setAccountNode(node);
+    
+    // Ruta rápida: seed aleatoria, sin mnemonic ni nodo HD nuevo
+    StellarKeypair kp;
+    TEST_ASSERT_TRUE(StellarKeypair::generate(kp));
+    TEST_ASSERT_EQUAL(0, kp.getMnemonic().length());
+    TEST_ASSERT_TRUE(StellarKeypair::getAccountNode(cached));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(node, cached, sizeof(node));
+    
+    StellarKeypair::clearAccountNode();
+}
+
+void test_signing_context_rekey() {
+    StellarKeypair kp;
+    TEST_ASSERT_TRUE(StellarKeypair::fromSecret("SBGWSG6BTNCKCOB3DIFBGCVMUPQFYPA2G4O34RMTB343OYPXU5DJDVMN", kp));
+    
+    SigningContext context(&kp, nullptr);
+    uint8_t data[32] = {1, 2, 3};
+    uint8_t signature[64];
+    uint8_t expected[64];
+    
+    TEST_ASSERT_TRUE(context.sign(data, sizeof(data), signature));
+    TEST_ASSERT_TRUE(kp.sign(data, sizeof(data), expected));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, signature, 64);
+    
+    // Keypair reemplazado en sitio: la clave expandida no puede ser la vieja
+    TEST_ASSERT_TRUE(StellarKeypair::fromSecret("SCEPFFWGAG5P2VX5DHIYK3XEMZYLTYWIPWYEKXFHSK25RVMIUNJ7CTIS", kp));
+    TEST_ASSERT_TRUE(context.sign(data, sizeof(data), signature));
+    TEST_ASSERT_TRUE(kp.sign(data, sizeof(data), expected));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, signature, 64);
+}
+
+void test_keyring_hint_lookup() {
+    StellarKeyring keyring;
+    
+    TEST_ASSERT_EQUAL(0, keyring.addSecret("SBGWSG6BTNCKCOB3DIFBGCVMUPQFYPA2G4O34RMTB343OYPXU5DJDVMN"));
+    TEST_ASSERT_EQUAL(1, keyring.addSecret("SCEPFFWGAG5P2VX5DHIYK3XEMZYLTYWIPWYEKXFHSK25RVMIUNJ7CTIS"));
+    TEST_ASSERT_EQUAL(-1, keyring.addSecret("SCEPFFWGAG5P2VX5DHIYK3XEMZYLTYWIPWYEKXFHSK25RVMIUNJ7CTIS"));
+    TEST_ASSERT_EQUAL(2, keyring.size());
+    
+    const StellarKeypair* second = keyring.get(1);
+    TEST_ASSERT_EQUAL(1, keyring.findByHint(second->getRawPublicKey() + 28));
+    TEST_ASSERT_EQUAL(-1, keyring.findByHint(second->getRawPublicKey() + 28, 1));
+    TEST_ASSERT_EQUAL(1, keyring.findByAddress(second->getPublicKeyCStr()));
+    
+    // Envelope con una firma de la clave 1 sobre un hash
+    uint8_t hash[32];
+    uint8_t signatures[4 + 4 + 64];
+    StellarCrypto::sha256((const uint8_t*)"tx", 2, hash);
+    memcpy(signatures, second->getRawPublicKey() + 28, 4);
+    signatures[4] = 0; signatures[5] = 0; signatures[6] = 0; signatures[7] = 64;
+    TEST_ASSERT_TRUE(second->sign(hash, 32, signatures + 8));
+    
+    uint8_t source[32];
+    memcpy(source, second->getRawPublicKey(), 32);
+    
+    XDRTransactionEnvelope envelope;
+    memset(&envelope, 0, sizeof(envelope));
+    envelope.sourceAccount.data = source;
+    envelope.sourceAccount.length = 32;
+    envelope.signatureCount = 1;
+    envelope.signatures.data = signatures;
+    envelope.signatures.length = sizeof(signatures);
+    
+    int slots[1];
+    TEST_ASSERT_EQUAL(1, keyring.findSigner(envelope));
+    TEST_ASSERT_EQUAL(1, keyring.matchSignatures(envelope, hash, slots));
+    TEST_ASSERT_EQUAL(1, slots[0]);
+    
+    // Firma que no valida: el hint coincide pero no se empareja
+    hash[0] ^= 1;
+    TEST_ASSERT_EQUAL(0, keyring.matchSignatures(envelope, hash, slots));
+    TEST_ASSERT_EQUAL(-1, slots[0]);
+    
+    // Al quitar la clave 0 la 1 pasa a su slot
+    TEST_ASSERT_TRUE(keyring.remove(0));
+    TEST_ASSERT_EQUAL(1, keyring.size());
+    TEST_ASSERT_EQUAL(0, keyring.findSigner(envelope));
+}
+
+// RFC 8032, sección 7.1 (tests 1 a 3)
+struct Ed25519Vector {
+    const char* seed;
+    const char* publicKey;
+    const char* message;
+    const char* signature;
+};
+
+static const Ed25519Vector RFC8032_VECTORS[] = {
+    {
+        "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+        "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+        "",
+        "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+        "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"
+    },
+    {
+        "4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+        "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+        "72",
+        "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+        "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"
+    },
+    {
+        "c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+        "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+        "af82",
+        "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+        "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a"
+    }
+};
+
+#define RFC8032_VECTOR_COUNT 3
+#define ED25519_BATCH_TEST_SIZE 8
+
+struct Ed25519TestCase {
+    uint8_t seed[32];
+    uint8_t publicKey[32];
+    uint8_t message[2];
+    size_t messageLen;
+    uint8_t signature[64];
+};
+
+static void decodeVector(const Ed25519Vector& vector, Ed25519TestCase& out) {
+    size_t length;
+    TEST_ASSERT_TRUE(StellarUtils::hexDecode(vector.seed, out.seed, &length));
+    TEST_ASSERT_TRUE(StellarUtils::hexDecode(vector.publicKey, out.publicKey, &length));
+    TEST_ASSERT_TRUE(StellarUtils::hexDecode(vector.message, out.message, &out.messageLen));
+    TEST_ASSERT_TRUE(StellarUtils::hexDecode(vector.signature, out.signature, &length));
+}
+
+// Cada entrada debe coincidir con la verificación individual
+static void assertBatchMatchesVerify(const Ed25519BatchEntry* entries, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        bool single = StellarCrypto::verify(
+            entries[i].publicKey, entries[i].message, entries[i].messageLen, entries[i].signature);
+        TEST_ASSERT_EQUAL(single, entries[i].valid);
+    }
+}
+
+void test_ed25519_verify_batch() {
+    Ed25519TestCase cases[ED25519_BATCH_TEST_SIZE];
+    Ed25519BatchEntry entries[ED25519_BATCH_TEST_SIZE];
+    
+    for (size_t i = 0; i < ED25519_BATCH_TEST_SIZE; i++) {
+        decodeVector(RFC8032_VECTORS[i % RFC8032_VECTOR_COUNT], cases[i]);
+        entries[i].publicKey = cases[i].publicKey;
+        entries[i].message = cases[i].message;
+        entries[i].messageLen = cases[i].messageLen;
+        entries[i].signature = cases[i].signature;
+        entries[i].valid = false;
+    }
+    
+    TEST_ASSERT_TRUE(StellarCrypto::verifyBatch(entries, ED25519_BATCH_TEST_SIZE));
+    for (size_t i = 0; i < ED25519_BATCH_TEST_SIZE; i++) {
+        TEST_ASSERT_TRUE(entries[i].valid);
+    }
+    assertBatchMatchesVerify(entries, ED25519_BATCH_TEST_SIZE);
+    
+    // Un mensaje alterado: la bisección marca solo esa entrada
+    cases[5].message[0] ^= 1;
+    TEST_ASSERT_FALSE(StellarCrypto::verifyBatch(entries, ED25519_BATCH_TEST_SIZE));
+    for (size_t i = 0; i < ED25519_BATCH_TEST_SIZE; i++) {
+        TEST_ASSERT_EQUAL(i != 5, entries[i].valid);
+    }
+    assertBatchMatchesVerify(entries, ED25519_BATCH_TEST_SIZE);
+    cases[5].message[0] ^= 1;
+    
+    // S + L (S >= L): misma firma módulo L, maleable
+    static const uint8_t ORDER[32] = {
+        0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+    };
+    uint16_t carry = 0;
+    for (size_t i = 0; i < 32; i++) {
+        carry += cases[1].signature[32 + i] + ORDER[i];
+        cases[1].signature[32 + i] = (uint8_t)carry;
+        carry >>= 8;
+    }
+    
+    // y = 2 no está en la curva: R y A no se pueden decodificar
+    uint8_t offCurve[32] = {2};
+    memcpy(cases[2].signature, offCurve, 32);
+    memcpy(cases[3].publicKey, offCurve, 32);
+    
+    TEST_ASSERT_FALSE(StellarCrypto::verifyBatch(entries, ED25519_BATCH_TEST_SIZE));
+    for (size_t i = 0; i < ED25519_BATCH_TEST_SIZE; i++) {
+        TEST_ASSERT_EQUAL(i < 1 || i > 3, entries[i].valid);
+    }
+    assertBatchMatchesVerify(entries, ED25519_BATCH_TEST_SIZE);
+    
+    // Orden pequeño: A de orden 8, R = neutro y S = 0 cumplen la ecuación con
+    // cofactor para cualquier mensaje. verify() (sin cofactor) solo la acepta
+    // si k = 0 mod 8; el lote rechaza siempre A y R de orden pequeño (como
+    // libsodium). Con este mensaje ambos la rechazan. Diferencias aceptadas:
+    // ese 1/8 de mensajes y A con componente de torsión (A' + T), que solo
+    // fabrica un atacante
+    static const uint8_t SMALL_ORDER[32] = {
+        0xc7, 0x17, 0x6a, 0x70, 0x3d, 0x4d, 0xd8, 0x4f, 0xba, 0x3c, 0x0b, 0x76, 0x0d, 0x10, 0x67, 0x0f,
+        0x2a, 0x20, 0x53, 0xfa, 0x2c, 0x39, 0xcc, 0xc6, 0x4e, 0xc7, 0xfd, 0x77, 0x92, 0xac, 0x03, 0x7a
+    };
+    uint8_t forged[64] = {1};
+    uint8_t message[1] = {0};
+    Ed25519BatchEntry weak = {SMALL_ORDER, message, sizeof(message), forged, true};
+    
+    TEST_ASSERT_FALSE(StellarCrypto::verifyBatch(&weak, 1));
+    TEST_ASSERT_FALSE(weak.valid);
+    assertBatchMatchesVerify(&weak, 1);
+}
+
+void test_ed25519_rfc8032() {
+    for (size_t i = 0; i < RFC8032_VECTOR_COUNT; i++) {
+        Ed25519TestCase vector;
+        decodeVector(RFC8032_VECTORS[i], vector);
+        
+        uint8_t publicKey[32];
+        uint8_t signature[64];
+        TEST_ASSERT_TRUE(StellarCrypto::derivePublicKey(publicKey, vector.seed));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(vector.publicKey, publicKey, 32);
+        
+        TEST_ASSERT_TRUE(StellarCrypto::sign(vector.seed, publicKey, vector.message, vector.messageLen, signature));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(vector.signature, signature, 64);
+        
+        // Clave expandida (tabla del punto base y aritmética propias)
+        Ed25519ExpandedKey key;
+        StellarEd25519::expandKey(vector.seed, key);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(vector.publicKey, key.publicKey, 32);
+        StellarEd25519::sign(key, vector.message, vector.messageLen, signature);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(vector.signature, signature, 64);
+    }
+    
+    // Claves nuevas: la firma propia valida con la implementación de rweather
+    uint8_t seed[32];
+    uint8_t publicKey[32];
+    uint8_t expected[32];
+    uint8_t signature[64];
+    const uint8_t message[] = "stellar-iot";
+    
+    TEST_ASSERT_TRUE(StellarCrypto::generateKeypair(publicKey, seed));
+    Ed25519::derivePublicKey(expected, seed);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, publicKey, 32);
+    
+    TEST_ASSERT_TRUE(StellarCrypto::sign(seed, publicKey, message, sizeof(message) - 1, signature));
+    TEST_ASSERT_TRUE(Ed25519::verify(signature, publicKey, message, sizeof(message) - 1));
+    
+    signature[0] ^= 1;
+    TEST_ASSERT_FALSE(Ed25519::verify(signature, publicKey, message, sizeof(message) - 1));
+}
+
+// XDR con el formato de Horizon en testnet: pago de 1 XLM con memo "hola"
+// firmado con la clave del test 1 de RFC 8032, su versión v0 y un fee bump
+static const char* XDR_ENVELOPE_V1 =
+    "AAAAAgAAAADXWpgBgrEKt9VL/tPJZAc6DuFy89qmIyWvAhpo9wdRGgAAAGQAABI0AAAAAQAAAAEAAAAAAAAAAAAAAABlU/EA"
+    "AAAAAQAAAARob2xhAAAAAQAAAAAAAAABAAAAAD1AF8PoQ4lakrcKp00bfrycmCzPLsSWjMDNVfEq9GYMAAAAAAAAAAAAmJaA"
+    "AAAAAAAAAAH3B1EaAAAAQHp9P/IokAyM4LQPV+ZAWqfhZrQF6+nIKQmT93lqZ+Tl8YSt1aiDMugExrdW4+lXb/MPOZ0GcGDc"
+    "PsDsu3QqtA0=";
+static const char* XDR_ENVELOPE_V0 =
+    "AAAAANdamAGCsQq31Uv+08lkBzoO4XLz2qYjJa8CGmj3B1EaAAAAZAAAEjQAAAACAAAAAAAAAAAAAAABAAAAAAAAAAEAAAAA"
+    "PUAXw+hDiVqStwqnTRt+vJyYLM8uxJaMwM1V8Sr0ZgwAAAAAAAAAAACYloAAAAAAAAAAAfcHURoAAABAeP70d0jIneP2vyiV"
+    "6LAn65cotXbRhqE5XC3MpOf7u5a4BXR3AvNNtCVos5WJpolS/zaWQleVJc/zSjrLgzJODg==";
+static const char* XDR_ENVELOPE_FEE_BUMP =
+    "AAAABQAAAAA9QBfD6EOJWpK3CqdNG368nJgszy7ElozAzVXxKvRmDAAAAAAAAAGQAAAAAgAAAADXWpgBgrEKt9VL/tPJZAc6"
+    "DuFy89qmIyWvAhpo9wdRGgAAAGQAABI0AAAAAQAAAAEAAAAAAAAAAAAAAABlU/EAAAAAAQAAAARob2xhAAAAAQAAAAAAAAAB"
+    "AAAAAD1AF8PoQ4lakrcKp00bfrycmCzPLsSWjMDNVfEq9GYMAAAAAAAAAAAAmJaAAAAAAAAAAAH3B1EaAAAAQHp9P/IokAyM"
+    "4LQPV+ZAWqfhZrQF6+nIKQmT93lqZ+Tl8YSt1aiDMugExrdW4+lXb/MPOZ0GcGDcPsDsu3QqtA0AAAAAAAAAASr0ZgwAAABA"
+    "EREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREREQ==";
+static const char* XDR_TX_HASH = "3a08d8e1f8163788e7416569c52c200a9375397e7aca019b0bf4fc07d53ae8b9";
+
+// result_xdr: pago con éxito, PAYMENT_UNDERFUNDED y fee bump de la v1
+static const char* XDR_RESULT_SUCCESS = "AAAAAAAAAGQAAAAAAAAAAQAAAAAAAAABAAAAAAAAAAA=";
+static const char* XDR_RESULT_OP_FAILED = "AAAAAAAAAGT/////AAAAAQAAAAAAAAAB/////gAAAAA=";
+static const char* XDR_RESULT_FEE_BUMP =
+    "AAAAAAAAAZAAAAABOgjY4fgWN4jnQWVpxSwgCpN1OX56ygGbC/T8B9U66LkAAAAAAAAAZAAAAAAAAAABAAAAAAAAAAEAAAAA"
+    "AAAAAAAAAAA=";
+
+#define XDR_TEST_BUFFER_SIZE 384
+
+static void assertSinglePaymentResult(const XDRTransactionResult& result, int32_t innerCode) {
+    XDROperationResult operation;
+    XDRDecoder decoder(result.operations);
+    
+    TEST_ASSERT_EQUAL(1, result.operationCount);
+    TEST_ASSERT_TRUE(decoder.decodeOperationResult(operation));
+    TEST_ASSERT_TRUE(decoder.isAtEnd());
+    TEST_ASSERT_EQUAL(OP_RESULT_INNER, operation.code);
+    TEST_ASSERT_EQUAL(PAYMENT, operation.type);
+    TEST_ASSERT_EQUAL(innerCode, operation.innerCode);
+}
+
+void test_xdr_decode_results() {
+    uint8_t buffer[XDR_TEST_BUFFER_SIZE];
+    size_t length;
+    XDRTransactionResult result;
+    
+    TEST_ASSERT_TRUE(XDRDecoder::decodeBase64(XDR_RESULT_SUCCESS, buffer, sizeof(buffer), &length));
+    XDRDecoder success(buffer, length);
+    TEST_ASSERT_TRUE(success.decodeTransactionResult(result));
+    TEST_ASSERT_TRUE(success.isAtEnd());
+    TEST_ASSERT_TRUE(result.feeCharged == 100);
+    TEST_ASSERT_EQUAL(TX_RESULT_SUCCESS, result.code);
+    TEST_ASSERT_FALSE(result.feeBump);
+    assertSinglePaymentResult(result, 0);
+    
+    // txFAILED: el código de la operación (PAYMENT_UNDERFUNDED) explica el fallo
+    TEST_ASSERT_TRUE(XDRDecoder::decodeBase64(XDR_RESULT_OP_FAILED, buffer, sizeof(buffer), &length));
+    XDRDecoder failed(buffer, length);
+    TEST_ASSERT_TRUE(failed.decodeTransactionResult(result));
+    TEST_ASSERT_TRUE(failed.isAtEnd());
+    TEST_ASSERT_EQUAL(TX_RESULT_FAILED, result.code);
+    assertSinglePaymentResult(result, -2);
+    
+    // Fee bump: code/operations son de la interna, outer* de la externa
+    uint8_t innerHash[32];
+    TEST_ASSERT_TRUE(StellarUtils::hexDecode(XDR_TX_HASH, innerHash, &length));
+    TEST_ASSERT_TRUE(XDRDecoder::decodeBase64(XDR_RESULT_FEE_BUMP, buffer, sizeof(buffer), &length));
+    XDRDecoder feeBump(buffer, length);
+    TEST_ASSERT_TRUE(feeBump.decodeTransactionResult(result));
+    TEST_ASSERT_TRUE(feeBump.isAtEnd());
+    TEST_ASSERT_TRUE(result.feeBump);
+    TEST_ASSERT_TRUE(result.outerFeeCharged == 400);
+    TEST_ASSERT_EQUAL(TX_RESULT_FEE_BUMP_INNER_SUCCESS, result.outerCode);
+    TEST_ASSERT_EQUAL(32, result.innerHash.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(innerHash, result.innerHash.data, 32);
+    TEST_ASSERT_TRUE(result.feeCharged == 100);
+    TEST_ASSERT_EQUAL(TX_RESULT_SUCCESS, result.code);
+    assertSinglePaymentResult(result, 0);
+}
+
+// SHA256(network id || ENVELOPE_TYPE_TX || transaction), con el prefijo de
+// MuxedAccount que le falta a una v0
+static void transactionHash(const XDRTransactionEnvelope& envelope, uint8_t hash[32]) {
+    uint8_t payload[XDR_TEST_BUFFER_SIZE];
+    size_t length = 0;
+    
+    memcpy(payload, SigningContext::networkIdFor(STELLAR_TESTNET), 32);
+    length += 32;
+    memset(payload + length, 0, 4);
+    payload[length + 3] = ENVELOPE_TYPE_TX;
+    length += 4;
+    if (envelope.envelopeType == ENVELOPE_TYPE_TX_V0) {
+        memset(payload + length, 0, 4);
+        length += 4;
+    }
+    memcpy(payload + length, envelope.transaction.data, envelope.transaction.length);
+    length += envelope.transaction.length;
+    
+    StellarCrypto::sha256(payload, length, hash);
+}
+
+static void assertSignedPayment(const XDRTransactionEnvelope& envelope, uint32_t memoType) {
+    Ed25519TestCase source;
+    Ed25519TestCase destination;
+    decodeVector(RFC8032_VECTORS[0], source);
+    decodeVector(RFC8032_VECTORS[1], destination);
+    
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(source.publicKey, envelope.sourceAccount.data, 32);
+    TEST_ASSERT_FALSE(envelope.sourceMuxed);
+    TEST_ASSERT_EQUAL(100, envelope.fee);
+    TEST_ASSERT_EQUAL(memoType, envelope.memoType);
+    TEST_ASSERT_EQUAL(1, envelope.operationCount);
+    
+    XDROperation operation;
+    XDRDecoder operations(envelope.operations);
+    TEST_ASSERT_TRUE(operations.decodeOperation(operation));
+    TEST_ASSERT_TRUE(operations.isAtEnd());
+    TEST_ASSERT_FALSE(operation.hasSourceAccount);
+    TEST_ASSERT_EQUAL(PAYMENT, operation.type);
+    
+    // Cuerpo: MuxedAccount destino + asset nativo + 10000000 stroops
+    XDRBytesView account;
+    int64_t amount;
+    XDRDecoder body(operation.body);
+    TEST_ASSERT_TRUE(body.decodeMuxedAccount(account));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(destination.publicKey, account.data, 32);
+    TEST_ASSERT_TRUE(body.skipAsset());
+    TEST_ASSERT_TRUE(body.decodeInt64(amount));
+    TEST_ASSERT_TRUE(amount == 10000000);
+    TEST_ASSERT_TRUE(body.isAtEnd());
+    
+    // La vista de la transacción basta para recalcular el hash y verificar
+    uint8_t hash[32];
+    transactionHash(envelope, hash);
+    
+    XDRDecoratedSignature signature;
+    XDRDecoder signatures(envelope.signatures);
+    TEST_ASSERT_TRUE(signatures.decodeDecoratedSignature(signature));
+    TEST_ASSERT_TRUE(signatures.isAtEnd());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(source.publicKey + 28, signature.hint.data, 4);
+    TEST_ASSERT_EQUAL(64, signature.signature.length);
+    TEST_ASSERT_TRUE(StellarCrypto::verify(source.publicKey, hash, 32, signature.signature.data));
+}
+
+void test_xdr_decode_envelopes() {
+    uint8_t buffer[XDR_TEST_BUFFER_SIZE];
+    uint8_t hash[32];
+    uint8_t expectedHash[32];
+    size_t length;
+    XDRTransactionEnvelope envelope;
+    
+    TEST_ASSERT_TRUE(StellarUtils::hexDecode(XDR_TX_HASH, expectedHash, &length));
+    
+    TEST_ASSERT_TRUE(XDRDecoder::decodeBase64(XDR_ENVELOPE_V1, buffer, sizeof(buffer), &length));
+    XDRDecoder v1(buffer, length);
+    TEST_ASSERT_TRUE(v1.decodeTransactionEnvelope(envelope));
+    TEST_ASSERT_TRUE(v1.isAtEnd());
+    TEST_ASSERT_EQUAL(ENVELOPE_TYPE_TX, envelope.envelopeType);
+    TEST_ASSERT_FALSE(envelope.feeBump);
+    TEST_ASSERT_TRUE(envelope.sequenceNumber == 0x0000123400000001LL);
+    TEST_ASSERT_EQUAL(4, envelope.memo.length);
+    TEST_ASSERT_EQUAL_MEMORY("hola", envelope.memo.data, 4);
+    assertSignedPayment(envelope, MEMO_TEXT);
+    transactionHash(envelope, hash);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedHash, hash, 32);
+    
+    TEST_ASSERT_TRUE(XDRDecoder::decodeBase64(XDR_ENVELOPE_V0, buffer, sizeof(buffer), &length));
+    XDRDecoder v0(buffer, length);
+    TEST_ASSERT_TRUE(v0.decodeTransactionEnvelope(envelope));
+    TEST_ASSERT_TRUE(v0.isAtEnd());
+    TEST_ASSERT_EQUAL(ENVELOPE_TYPE_TX_V0, envelope.envelopeType);
+    TEST_ASSERT_TRUE(envelope.sequenceNumber == 0x0000123400000002LL);
+    assertSignedPayment(envelope, MEMO_NONE);
+    
+    // Fee bump: los campos son de la interna (misma transacción y hash que la
+    // v1); la firma externa es de feeSource
+    Ed25519TestCase feeSource;
+    decodeVector(RFC8032_VECTORS[1], feeSource);
+    
+    TEST_ASSERT_TRUE(XDRDecoder::decodeBase64(XDR_ENVELOPE_FEE_BUMP, buffer, sizeof(buffer), &length));
+    XDRDecoder feeBump(buffer, length);
+    TEST_ASSERT_TRUE(feeBump.decodeTransactionEnvelope(envelope));
+    TEST_ASSERT_TRUE(feeBump.isAtEnd());
+    TEST_ASSERT_EQUAL(ENVELOPE_TYPE_TX_FEE_BUMP, envelope.envelopeType);
+    TEST_ASSERT_TRUE(envelope.feeBump);
+    TEST_ASSERT_TRUE(envelope.feeBumpFee == 400);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(feeSource.publicKey, envelope.feeBumpSource.data, 32);
+    TEST_ASSERT_EQUAL(100, envelope.fee);
+    TEST_ASSERT_EQUAL(1, envelope.operationCount);
+    transactionHash(envelope, hash);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedHash, hash, 32);
+    
+    XDRDecoratedSignature signature;
+    XDRDecoder signatures(envelope.signatures);
+    TEST_ASSERT_EQUAL(1, envelope.signatureCount);
+    TEST_ASSERT_TRUE(signatures.decodeDecoratedSignature(signature));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(feeSource.publicKey + 28, signature.hint.data, 4);
+}
+
+// Decodifica una copia de tamaño exacto (un sanitizer detecta cualquier
+// lectura fuera); nullptr si decodifica entero, si no el error
+static const char* decodeXdrError(const uint8_t* data, size_t length, bool envelope) {
+    uint8_t* copy = (uint8_t*)malloc(length ? length : 1);
+    if (!copy) {
+        return "Out of memory";
+    }
+    memcpy(copy, data, length);
+    
+    XDRDecoder decoder(copy, length);
+    bool decoded;
+    if (envelope) {
+        XDRTransactionEnvelope transaction;
+        decoded = decoder.decodeTransactionEnvelope(transaction);
+    } else {
+        XDRTransactionResult result;
+        decoded = decoder.decodeTransactionResult(result);
+    }
+    
+    free(copy);
+    
+    if (decoder.getPosition() > length || decoded == decoder.hasError()) {
+        return "Inconsistent decoder state";
+    }
+    return decoded ? nullptr : decoder.getLastError();
+}
+
+// Cambia un byte y devuelve el error del decoder
+static const char* patchedXdrError(const char* base64, size_t offset, uint8_t value, bool envelope) {
+    uint8_t buffer[XDR_TEST_BUFFER_SIZE];
+    size_t length;
+    if (!XDRDecoder::decodeBase64(base64, buffer, sizeof(buffer), &length) || offset >= length) {
+        return "Bad sample";
+    }
+    buffer[offset] = value;
+    return decodeXdrError(buffer, length, envelope);
+}
+
+void test_xdr_decode_malformed() {
+    static const char* const SAMPLES[] = {
+        XDR_RESULT_SUCCESS, XDR_RESULT_OP_FAILED, XDR_RESULT_FEE_BUMP,
+        XDR_ENVELOPE_V1, XDR_ENVELOPE_V0, XDR_ENVELOPE_FEE_BUMP
+    };
+    uint8_t buffer[XDR_TEST_BUFFER_SIZE];
+    size_t length;
+    
+    // Cualquier buffer truncado falla limpio
+    for (size_t i = 0; i < sizeof(SAMPLES) / sizeof(SAMPLES[0]); i++) {
+        bool envelope = i >= 3;
+        TEST_ASSERT_TRUE(XDRDecoder::decodeBase64(SAMPLES[i], buffer, sizeof(buffer), &length));
+        TEST_ASSERT_NULL(decodeXdrError(buffer, length, envelope));
+        
+        for (size_t truncated = 0; truncated < length; truncated++) {
+            TEST_ASSERT_EQUAL_STRING("Unexpected end of XDR data", decodeXdrError(buffer, truncated, envelope));
+        }
+    }
+    
+    // Vectores más largos que su máximo (los bytes de menor peso de cada longitud)
+    TEST_ASSERT_EQUAL_STRING("Too many operation results", patchedXdrError(XDR_RESULT_SUCCESS, 15, 101, false));
+    TEST_ASSERT_EQUAL_STRING("XDR opaque exceeds maximum length", patchedXdrError(XDR_ENVELOPE_V1, 79, 29, true));
+    TEST_ASSERT_EQUAL_STRING("XDR opaque exceeds maximum length", patchedXdrError(XDR_ENVELOPE_V1, 76, 0xff, true));
+    TEST_ASSERT_EQUAL_STRING("Too many operations", patchedXdrError(XDR_ENVELOPE_V1, 87, 101, true));
+    TEST_ASSERT_EQUAL_STRING("Too many signatures", patchedXdrError(XDR_ENVELOPE_V1, 151, 21, true));
+    TEST_ASSERT_EQUAL_STRING("XDR opaque exceeds maximum length", patchedXdrError(XDR_ENVELOPE_V1, 159, 65, true));
+    
+    // Brazos de unión desconocidos
+    TEST_ASSERT_EQUAL_STRING("Unsupported operation result type", patchedXdrError(XDR_RESULT_SUCCESS, 23, 99, false));
+    TEST_ASSERT_EQUAL_STRING("Unsupported result extension", patchedXdrError(XDR_RESULT_SUCCESS, 31, 1, false));
+    TEST_ASSERT_EQUAL_STRING("Unknown envelope type", patchedXdrError(XDR_ENVELOPE_V1, 3, 7, true));
+    TEST_ASSERT_EQUAL_STRING("Unknown MuxedAccount type", patchedXdrError(XDR_ENVELOPE_V1, 7, 5, true));
+    TEST_ASSERT_EQUAL_STRING("Unknown memo type", patchedXdrError(XDR_ENVELOPE_V1, 75, 9, true));
+    TEST_ASSERT_EQUAL_STRING("Unsupported operation type", patchedXdrError(XDR_ENVELOPE_V1, 95, 99, true));
+    TEST_ASSERT_EQUAL_STRING("Unsupported fee bump inner envelope", patchedXdrError(XDR_ENVELOPE_FEE_BUMP, 51, 0, true));
+}
+
+void test_payment_template_matches_schema() {
+    StellarKeypair* keypair = StellarKeypair::fromSecret("SBGWSG6BTNCKCOB3DIFBGCVMUPQFYPA2G4O34RMTB343OYPXU5DJDVMN");
+    TEST_ASSERT_NOT_NULL(keypair);
+    StellarNetwork network(STELLAR_TESTNET);
+    StellarAccount account(keypair, &network);
+    StellarPayment payment(keypair, &network, &account);
+    
+    const char* destination = "GBY5AZJYQNUD22NLNEX23NWIFWALIGDRQY2X7W6TPNYHJWY6TCV7W64I";
+    const char* memos[] = {nullptr, "1234567890123456789012345678"};
+    
+    // El template desplaza la cola según el memo: mismo envelope que el
+    // encode completo de XDRSchema (memo vacío y de 28 bytes)
+    for (size_t i = 0; i < 2; i++) {
+        String fromTemplate = payment.buildPaymentTransaction(destination, 12.5f, memos[i], 123456789);
+        
+        StellarTransaction transaction;
+        TEST_ASSERT_TRUE(transaction.addPayment(destination, 125000000));
+        if (memos[i]) {
+            TEST_ASSERT_TRUE(transaction.setMemoText(memos[i]));
+        }
+        String fromSchema = payment.buildTransaction(transaction, 123456789);
+        
+        TEST_ASSERT_TRUE(fromTemplate.length() > 0);
+        TEST_ASSERT_EQUAL_STRING(fromSchema.c_str(), fromTemplate.c_str());
+    }
+    
+    delete keypair;
+}
+
+void test_xdr_encode_asset() {
+    uint8_t issuer[32];
+    memset(issuer, 0xab, sizeof(issuer));
+    XDREncoder encoder;
+    
+    // Tipo + código rellenado con ceros hasta 4 o 12 bytes + emisor (AccountID)
+    static const uint8_t ALPHANUM4[] = {0, 0, 0, 1, 'U', 'S', 'D', 0, 0, 0, 0, KEY_TYPE_ED25519};
+    TEST_ASSERT_TRUE(encoder.encodeAsset(ASSET_TYPE_CREDIT_ALPHANUM4, "USD", issuer));
+    TEST_ASSERT_EQUAL(sizeof(ALPHANUM4) + 32, encoder.getSize());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ALPHANUM4, encoder.getData(), sizeof(ALPHANUM4));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(issuer, encoder.getData() + sizeof(ALPHANUM4), 32);
+    
+    static const uint8_t ALPHANUM12[] = {0, 0, 0, 2, 'S', 't', 'e', 'l', 'l', 'a', 'r', '9', 0, 0, 0, 0,
+                                          0, 0, 0, KEY_TYPE_ED25519};
+    encoder.reset();
+    TEST_ASSERT_TRUE(encoder.encodeAsset(ASSET_TYPE_CREDIT_ALPHANUM12, "Stellar9", issuer));
+    TEST_ASSERT_EQUAL(sizeof(ALPHANUM12) + 32, encoder.getSize());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ALPHANUM12, encoder.getData(), sizeof(ALPHANUM12));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(issuer, encoder.getData() + sizeof(ALPHANUM12), 32);
+    
+    // Inválidos: false sin escribir nada
+    struct InvalidAsset {
+        AssetType type;
+        const char* code;
+    };
+    static const InvalidAsset INVALID[] = {
+        {ASSET_TYPE_CREDIT_ALPHANUM4, ""},
+        {ASSET_TYPE_CREDIT_ALPHANUM4, "USDCX"},
+        {ASSET_TYPE_CREDIT_ALPHANUM12, "USDC"},
+        {ASSET_TYPE_CREDIT_ALPHANUM12, "ABCDEFGHIJKLM"},
+        {ASSET_TYPE_CREDIT_ALPHANUM4, "US D"},
+        {ASSET_TYPE_CREDIT_ALPHANUM4, "US-D"},
+        {ASSET_TYPE_CREDIT_ALPHANUM12, "STELLAR_USD"},
+        {ASSET_TYPE_CREDIT_ALPHANUM4, "\xc3\x91U"},
+        {(AssetType)3, "USD"}
+    };
+    
+    encoder.reset();
+    for (size_t i = 0; i < sizeof(INVALID) / sizeof(INVALID[0]); i++) {
+        TEST_ASSERT_FALSE(encoder.encodeAsset(INVALID[i].type, INVALID[i].code, issuer));
+        TEST_ASSERT_EQUAL(0, encoder.getSize());
+    }
+    TEST_ASSERT_FALSE(encoder.encodeAsset(ASSET_TYPE_CREDIT_ALPHANUM4, nullptr, issuer));
+    TEST_ASSERT_FALSE(encoder.encodeAsset(ASSET_TYPE_CREDIT_ALPHANUM4, "USD", nullptr));
+    TEST_ASSERT_EQUAL(0, encoder.getSize());
+    
+    static const uint8_t NATIVE[] = {0, 0, 0, 0};
+    TEST_ASSERT_TRUE(encoder.encodeAsset(ASSET_TYPE_NATIVE));
+    TEST_ASSERT_EQUAL(sizeof(NATIVE), encoder.getSize());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(NATIVE, encoder.getData(), sizeof(NATIVE));
+}
+
+void test_xdr_encode_memo() {
+    XDREncoder encoder;
+    
+    // MEMO_ID en decimal, hasta UINT64_MAX
+    static const uint8_t MEMO_ID_MAX[] = {0, 0, 0, 2, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    TEST_ASSERT_TRUE(encoder.encodeMemo(MEMO_ID, "18446744073709551615"));
+    TEST_ASSERT_EQUAL(sizeof(MEMO_ID_MAX), encoder.getSize());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(MEMO_ID_MAX, encoder.getData(), sizeof(MEMO_ID_MAX));
+    
+    static const uint8_t MEMO_ID_42[] = {0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 42};
+    encoder.reset();
+    TEST_ASSERT_TRUE(encoder.encodeMemo(MEMO_ID, "42"));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(MEMO_ID_42, encoder.getData(), sizeof(MEMO_ID_42));
+    
+    // MEMO_HASH / MEMO_RETURN: 64 caracteres hex (mayúsculas o minúsculas)
+    const char* hashHex = "3a08d8e1f8163788e7416569c52c200a9375397e7aca019b0bf4fc07d53ae8b9";
+    uint8_t hash[32];
+    size_t hashLength;
+    TEST_ASSERT_TRUE(StellarUtils::hexDecode(hashHex, hash, &hashLength));
+    
+    encoder.reset();
+    TEST_ASSERT_TRUE(encoder.encodeMemo(MEMO_HASH, hashHex));
+    TEST_ASSERT_TRUE(encoder.encodeMemo(MEMO_RETURN, "3A08D8E1F8163788E7416569C52C200A9375397E7ACA019B0BF4FC07D53AE8B9"));
+    TEST_ASSERT_EQUAL(2 * (4 + 32), encoder.getSize());
+    TEST_ASSERT_EQUAL(MEMO_HASH, encoder.getData()[3]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(hash, encoder.getData() + 4, 32);
+    TEST_ASSERT_EQUAL(MEMO_RETURN, encoder.getData()[4 + 32 + 3]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(hash, encoder.getData() + 4 + 32 + 4, 32);
+    
+    // Inválidos: false sin escribir nada
+    struct InvalidMemo {
+        MemoType type;
+        const char* text;
+    };
+    static const InvalidMemo INVALID[] = {
+        {MEMO_ID, nullptr},
+        {MEMO_ID, ""},
+        {MEMO_ID, "-1"},
+        {MEMO_ID, "12a"},
+        {MEMO_ID, "18446744073709551616"},
+        {MEMO_HASH, nullptr},
+        {MEMO_HASH, "3a08d8e1f8163788e7416569c52c200a9375397e7aca019b0bf4fc07d53ae8b"},
+        {MEMO_RETURN, "3a08d8e1f8163788e7416569c52c200a9375397e7aca019b0bf4fc07d53ae8bg"},
+        {MEMO_TEXT, "12345678901234567890123456789"},
+        {(MemoType)5, "42"}
+    };
+    
+    encoder.reset();
+    for (size_t i = 0; i < sizeof(INVALID) / sizeof(INVALID[0]); i++) {
+        TEST_ASSERT_FALSE(encoder.encodeMemo(INVALID[i].type, INVALID[i].text));
+        TEST_ASSERT_EQUAL(0, encoder.getSize());
+    }
+}
+
+void test_pbkdf2_known_answers() {
+    // Referencia: hashlib.pbkdf2_hmac("sha256", password, salt, iterations)
+    struct Pbkdf2Vector {
+        const char* password;
+        uint32_t iterations;
+        const char* key;
+    };
+    static const Pbkdf2Vector VECTORS[] = {
+        {"password", 1000, "46f895baaa185f0265c1da708d799953de592f576c4538b7eba99ced700ee75b"},
+        {"password", 10000, "16706ecbfc95af70f32e335aee4da70fd9596d9045d6eee27e5885ea817cf471"},
+        // 64 bytes: justo un bloque, se usa tal cual
+        {"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx", 1000,
+         "52b3530b132b8f0003ea7a2b4941ae2abb4f3659a695585c6c487a56dd3d3367"},
+        // 91 bytes: más largo que el bloque, la clave HMAC es su hash
+        {"passwordPASSWORDpasswordpasswordPASSWORDpasswordpasswordPASSWORDpasswordlonger-than-a-block", 1000,
+         "2e190eb762d39e5f79e1c8789b5c431b98238ea59da4e7538cafa3f0fef13abc"}
+    };
+    const uint8_t* salt = (const uint8_t*)"saltSALTsaltSALT";
+    
+    for (size_t i = 0; i < sizeof(VECTORS) / sizeof(VECTORS[0]); i++) {
+        uint8_t expected[32];
+        uint8_t key[32];
+        size_t length;
+        TEST_ASSERT_TRUE(StellarUtils::hexDecode(VECTORS[i].key, expected, &length));
+        TEST_ASSERT_TRUE(StellarCrypto::deriveKeyPBKDF2(VECTORS[i].password, salt, VECTORS[i].iterations, key));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, key, 32);
+    }
+}
+
+void test_wallet_v1_upgrade() {
+    const char* password = "correct horse battery";
+    StellarKeypair keypair;
+    TEST_ASSERT_TRUE(StellarKeypair::fromSecret("SBGWSG6BTNCKCOB3DIFBGCVMUPQFYPA2G4O34RMTB343OYPXU5DJDVMN", keypair));
+    
+    // Archivo v1 (116 bytes, little-endian con alineación natural): magic 0,
+    // version 4, salt 5, iv 21, ciphertext 33, tag 65, publicKey 81,
+    // relleno 113, checksum 114 (CRC de los 114 bytes anteriores)
+    uint8_t legacy[116];
+    uint8_t key[32];
+    uint32_t magic = STORAGE_MAGIC;
+    memset(legacy, 0, sizeof(legacy));
+    memcpy(legacy, &magic, 4);
+    legacy[4] = STORAGE_VERSION_LEGACY;
+    memset(legacy + 5, 0x11, 16);
+    memset(legacy + 21, 0x22, 12);
+    
+    TEST_ASSERT_TRUE(StellarCrypto::deriveKeyPBKDF2(password, legacy + 5, PBKDF2_ITERATIONS, key));
+    TEST_ASSERT_TRUE(StellarCrypto::encryptAES256GCM(
+        keypair.getRawSecretKey(), 32, key, legacy + 21, legacy + 33, legacy + 65));
+    memcpy(legacy + 81, keypair.getRawPublicKey(), 32);
+    uint16_t checksum = StellarUtils::crc16XModem(legacy, 114);
+    memcpy(legacy + 114, &checksum, 2);
+    
+    StellarKeypair* loaded = SecureWallet::loadFromBytes(legacy, sizeof(legacy), password);
+    TEST_ASSERT_NOT_NULL(loaded);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(keypair.getRawSecretKey(), loaded->getRawSecretKey(), 32);
+    delete loaded;
+    
+    TEST_ASSERT_NULL(SecureWallet::loadFromBytes(legacy, sizeof(legacy), "wrong password"));
+    
+    // Cualquier byte alterado rompe el checksum
+    legacy[40] ^= 1;
+    TEST_ASSERT_NULL(SecureWallet::loadFromBytes(legacy, sizeof(legacy), password));
+}
+
+void test_aes_gcm_stream_chunked() {
+    uint8_t key[32];
+    uint8_t iv[12];
+    uint8_t plaintext[100];
+    for (size_t i = 0; i < sizeof(key); i++) key[i] = i * 7;
+    for (size_t i = 0; i < sizeof(iv); i++) iv[i] = i + 1;
+    for (size_t i = 0; i < sizeof(plaintext); i++) plaintext[i] = i;
+    
+    uint8_t expected[100];
+    uint8_t expectedTag[16];
+    TEST_ASSERT_TRUE(StellarCrypto::encryptAES256GCM(plaintext, sizeof(plaintext), key, iv, expected, expectedTag));
+    
+    // Trozos que no coinciden con el bloque de 16 bytes
+    static const size_t CHUNKS[] = {1, 15, 16, 17, 3, 48};
+    uint8_t buffer[100];
+    uint8_t tag[16];
+    AESGCMStream gcm;
+    
+    gcm.begin(AESGCMStream::ENCRYPT, key, iv);
+    size_t offset = 0;
+    for (size_t i = 0; i < sizeof(CHUNKS) / sizeof(CHUNKS[0]); i++) {
+        TEST_ASSERT_TRUE(gcm.update(plaintext + offset, buffer + offset, CHUNKS[i]));
+        offset += CHUNKS[i];
+    }
+    TEST_ASSERT_EQUAL(sizeof(plaintext), offset);
+    TEST_ASSERT_TRUE(gcm.finish(tag));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buffer, sizeof(expected));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedTag, tag, 16);
+    
+    // Descifrado en sitio con otros trozos
+    gcm.begin(AESGCMStream::DECRYPT, key, iv);
+    TEST_ASSERT_TRUE(gcm.update(buffer, buffer, 33));
+    TEST_ASSERT_TRUE(gcm.update(buffer + 33, buffer + 33, sizeof(buffer) - 33));
+    TEST_ASSERT_TRUE(gcm.verify(tag));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(plaintext, buffer, sizeof(plaintext));
+    
+    tag[0] ^= 1;
+    gcm.begin(AESGCMStream::DECRYPT, key, iv);
+    TEST_ASSERT_TRUE(gcm.update(expected, buffer, sizeof(expected)));
+    TEST_ASSERT_FALSE(gcm.verify(tag));
+}
+
+// Archivo en memoria: lo escrito se vuelve a leer desde el principio
+class MemoryStream : public Stream {
+public:
+    MemoryStream() : length(0), position(0) { setTimeout(0); }
+    
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) {
+        size_t n = sizeof(data) - length < size ? sizeof(data) - length : size;
+        memcpy(data + length, buf, n);
+        length += n;
+        return n;
+    }
+    int available() { return (int)(length - position); }
+    int read() { return position < length ? data[position++] : -1; }
+    int peek() { return position < length ? data[position] : -1; }
+    void flush() {}
+    
+    uint8_t data[512];
+    size_t length;
+    size_t position;
+};
+
+// Descifra una copia del archivo (bytes [0, length))
+static bool decryptSecureFile(const MemoryStream& file, size_t length, const uint8_t key[32], MemoryStream& plaintext) {
+    MemoryStream input;
+    input.write(file.data, length);
+    plaintext.length = 0;
+    return SecureFileReader::decryptStream(input, plaintext, key);
+}
+
+void test_secure_file_tamper() {
+    uint8_t key[32];
+    uint8_t plaintext[200];
+    for (size_t i = 0; i < sizeof(key); i++) key[i] = 0xa0 + i;
+    for (size_t i = 0; i < sizeof(plaintext); i++) plaintext[i] = i * 3;
+    
+    // Segmentos de 64 bytes: 64 + 64 + 64 + 8 (el último marcado)
+    const size_t segment = SECURE_FILE_MIN_SEGMENT_SIZE;
+    const size_t sealed = segment + SECURE_FILE_TAG_SIZE;
+    MemoryStream file;
+    SecureFileWriter writer;
+    TEST_ASSERT_TRUE(writer.begin(file, key, segment));
+    TEST_ASSERT_TRUE(writer.write(plaintext, 50));
+    TEST_ASSERT_TRUE(writer.write(plaintext + 50, sizeof(plaintext) - 50));
+    TEST_ASSERT_TRUE(writer.finish());
+    TEST_ASSERT_EQUAL(SECURE_FILE_HEADER_SIZE + sizeof(plaintext) + 4 * SECURE_FILE_TAG_SIZE, file.length);
+    
+    MemoryStream output;
+    TEST_ASSERT_TRUE(decryptSecureFile(file, file.length, key, output));
+    TEST_ASSERT_EQUAL(sizeof(plaintext), output.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(plaintext, output.data, sizeof(plaintext));
+    
+    // Cada segmento coincide con un cifrado de una vez (IV = prefijo || índice || último)
+    uint8_t iv[12];
+    uint8_t ciphertext[64];
+    uint8_t tag[16];
+    memcpy(iv, file.data + 5, 7);
+    iv[7] = 0; iv[8] = 0; iv[9] = 0; iv[10] = 3; iv[11] = 1;
+    AESGCMStream gcm;
+    gcm.begin(AESGCMStream::ENCRYPT, key, iv);
+    TEST_ASSERT_TRUE(gcm.addAuthData(file.data, SECURE_FILE_HEADER_SIZE));
+    TEST_ASSERT_TRUE(gcm.update(plaintext + 3 * segment, ciphertext, 8));
+    TEST_ASSERT_TRUE(gcm.finish(tag));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(ciphertext, file.data + SECURE_FILE_HEADER_SIZE + 3 * sealed, 8);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(tag, file.data + SECURE_FILE_HEADER_SIZE + 3 * sealed + 8, 16);
+    
+    // Truncado: en un límite de segmento, dentro de un tag y sin el último
+    TEST_ASSERT_FALSE(decryptSecureFile(file, SECURE_FILE_HEADER_SIZE + sealed, key, output));
+    TEST_ASSERT_FALSE(decryptSecureFile(file, file.length - 5, key, output));
+    TEST_ASSERT_FALSE(decryptSecureFile(file, SECURE_FILE_HEADER_SIZE + 3 * sealed, key, output));
+    TEST_ASSERT_FALSE(decryptSecureFile(file, SECURE_FILE_HEADER_SIZE, key, output));
+    
+    // Segmentos 0 y 1 intercambiados
+    MemoryStream reordered;
+    reordered.write(file.data, file.length);
+    memcpy(reordered.data + SECURE_FILE_HEADER_SIZE, file.data + SECURE_FILE_HEADER_SIZE + sealed, sealed);
+    memcpy(reordered.data + SECURE_FILE_HEADER_SIZE + sealed, file.data + SECURE_FILE_HEADER_SIZE, sealed);
+    TEST_ASSERT_FALSE(decryptSecureFile(reordered, reordered.length, key, output));
+    
+    // Header modificado (prefijo del nonce): va como auth data en cada segmento
+    MemoryStream modified;
+    modified.write(file.data, file.length);
+    modified.data[5] ^= 1;
+    TEST_ASSERT_FALSE(decryptSecureFile(modified, modified.length, key, output));
+    
+    // Un bit del ciphertext
+    modified.data[5] ^= 1;
+    modified.data[SECURE_FILE_HEADER_SIZE + 70] ^= 0x80;
+    TEST_ASSERT_FALSE(decryptSecureFile(modified, modified.length, key, output));
+}
+
+// Cuerpo "tx=..." de referencia, construido en memoria
+static String expectedForm(const uint8_t* data, size_t length) {
+    return String("tx=") + StellarUtils::urlEncode(StellarUtils::base64Encode(data, length));
+}
+
+// Lee el stream completo en trozos de chunk bytes (0 = byte a byte con read())
+static String readForm(Base64FormStream& body, size_t chunk) {
+    String result;
+    char buffer[8];
+    
+    while (body.available() > 0) {
+        if (chunk == 0) {
+            result += (char)body.read();
+            continue;
+        }
+        
+        size_t n = body.readBytes(buffer, chunk);
+        if (n == 0) {
+            break;
+        }
+        
+        for (size_t i = 0; i < n; i++) {
+            result += buffer[i];
+        }
+    }
+    
+    return result;
+}
+
+void test_base64_form_stream() {
+    // 0xFB 0xFF 0xBF -> "+/+/": cubre '+' y '/'; las longitudes 0..6
+    // recorren todos los restos mod 3 ('=' y "==")
+    const uint8_t input[] = {0xFB, 0xFF, 0xBF, 0xFB, 0xEF, 0xFF, 0x00};
+    const size_t chunks[] = {0, 1, 3, 7};
+    
+    for (size_t length = 0; length <= sizeof(input); length++) {
+        String expected = expectedForm(input, length);
+        
+        Base64FormStream body("tx", input, length);
+        TEST_ASSERT_EQUAL(expected.length(), body.size());
+        
+        for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+            body.rewind();
+            TEST_ASSERT_EQUAL(expected.length(), body.available());
+            TEST_ASSERT_EQUAL_STRING(expected.c_str(), readForm(body, chunks[c]).c_str());
+            TEST_ASSERT_EQUAL(0, body.available());
+            TEST_ASSERT_EQUAL(-1, body.read());
+        }
+    }
+    
+    // Todos los caracteres escapados a la vez
+    String padded = expectedForm(input, 4);
+    TEST_ASSERT_TRUE(padded.indexOf("%2B") >= 0);
+    TEST_ASSERT_TRUE(padded.indexOf("%2F") >= 0);
+    TEST_ASSERT_TRUE(padded.indexOf("%3D%3D") >= 0);
+}
+
+// Socket en memoria: entrega los bytes de una respuesta ya recibida
+class MemoryClient : public Client {
+public:
+    explicit MemoryClient(const char* data) : data(data), length(strlen(data)), position(0) {}
+    
+    int connect(IPAddress, uint16_t) { return 0; }
+    int connect(IPAddress, uint16_t, int32_t) { return 0; }
+    int connect(const char*, uint16_t) { return 0; }
+    int connect(const char*, uint16_t, int32_t) { return 0; }
+    size_t write(uint8_t) { return 0; }
+    size_t write(const uint8_t*, size_t) { return 0; }
+    int available() { return (int)(length - position); }
+    int read() { return position < length ? (uint8_t)data[position++] : -1; }
+    int read(uint8_t* buf, size_t size) {
+        size_t n = length - position < size ? length - position : size;
+        memcpy(buf, data + position, n);
+        position += n;
+        return (int)n;
+    }
+    int peek() { return position < length ? (uint8_t)data[position] : -1; }
+    void flush() {}
+    void stop() {}
+    uint8_t connected() { return 0; }
+    operator bool() { return false; }
+    
+    const char* rest() const { return data + position; }
+    
+private:
+    const char* data;
+    size_t length;
+    size_t position;
+};
+
+void test_http_body_chunked() {
+    // Chunks partidos a mitad de token, extensión y trailer
+    MemoryClient client("4\r\n{\"a\"\r\n7\r\n:1,\"b\":\r\n2;x=1\r\n2}\r\n0\r\nX-T: y\r\n\r\nNEXT");
+    HttpBodyStream body(client, -1, true, 10);
+    
+    char buffer[32] = {0};
+    TEST_ASSERT_EQUAL('{', body.peek());
+    TEST_ASSERT_EQUAL(13, body.readBytes(buffer, sizeof(buffer) - 1));
+    TEST_ASSERT_EQUAL_STRING("{\"a\":1,\"b\":2}", buffer);
+    TEST_ASSERT_TRUE(body.finished());
+    TEST_ASSERT_TRUE(body.drain());
+    
+    // La siguiente respuesta queda intacta en el socket
+    TEST_ASSERT_EQUAL_STRING("NEXT", client.rest());
+    
+    // Content-Length: no lee más allá del cuerpo
+    MemoryClient plain("hello world");
+    HttpBodyStream fixed(plain, 5, false, 10);
+    TEST_ASSERT_EQUAL('h', fixed.read());
+    TEST_ASSERT_TRUE(fixed.drain());
+    TEST_ASSERT_EQUAL(5, fixed.position());
+    TEST_ASSERT_EQUAL_STRING(" world", plain.rest());
+    
+    // Cortado a mitad de chunk
+    MemoryClient truncated("a\r\n{}");
+    HttpBodyStream broken(truncated, -1, true, 10);
+    TEST_ASSERT_FALSE(broken.drain());
+    TEST_ASSERT_TRUE(broken.failed());
+}
+
+static uint8_t ssePayments = 0;
+
+static void countPayment(const PaymentEvent&, void*) {
+    ssePayments++;
+}
+
+void test_sse_parser() {
+    StellarNetwork network(STELLAR_TESTNET);
+    StellarEventStream stream(network);
+    stream.onPayment(countPayment);
+    ssePayments = 0;
+    
+    // Terminadores CR, LF y CRLF mezclados; comentarios y saludo "open"
+    MemoryClient client(
+        ": keep-alive\r\n"
+        "retry: 2500\r\n"
+        "event: open\n"
+        "data: \"hello\"\n"
+        "\n"
+        "id: 123-1\r"
+        "data: {\"type\":\"payment\"}\r"
+        "\r"
+        "id: 123-2\r\n"
+        ":comentario entre campos\r\n"
+        "data: {\"type\":\"payment\"}\r\n"
+        "data: {\"type\":\"ignored\"}\r\n"
+        "\r\n"
+        "retry: soon\n"
+        "data\n"
+        "\n"
+        "id: 123-3\n"
+        "data:{\"type\":\"payment\"}\n"
+        "\n");
+    stream.parse(client);
+    
+    // "open" no es un registro, "data" sin ':' es un campo vacío y el
+    // segundo "data:" de un evento se descarta sin generar otro
+    TEST_ASSERT_EQUAL(3, ssePayments);
+    TEST_ASSERT_EQUAL(3, stream.getStats().events);
+    TEST_ASSERT_EQUAL(0, stream.getStats().dropped);
+    TEST_ASSERT_EQUAL_STRING("123-3", stream.getLastEventId());
+    
+    // "retry:" no numérico se ignora
+    TEST_ASSERT_EQUAL(2500, stream.getRetryDelay());
+    
+    // Evento sin línea vacía final: no se despacha hasta completarlo
+    MemoryClient partial("id: 124-1\ndata: {}\n");
+    stream.parse(partial);
+    TEST_ASSERT_EQUAL(3, ssePayments);
+    TEST_ASSERT_EQUAL_STRING("124-1", stream.getLastEventId());
+    
+    MemoryClient rest("\r\n");
+    stream.parse(rest);
+    TEST_ASSERT_EQUAL(4, ssePayments);
+}
+
+static uint8_t futureCallbacks = 0;
+
+static void countFuture(NetworkFuture&, void*) {
+    futureCallbacks++;
+}
+
+void test_network_future_reject() {
+    StellarNetwork network(STELLAR_TESTNET);
+    StaticJsonDocument<HORIZON_TRANSACTION_DOC_SIZE> doc;
+    NetworkFuture future;
+    future.onComplete(countFuture);
+    
+    // Argumentos inválidos: terminado al volver, sin callback ni red
+    TEST_ASSERT_FALSE(network.getTransactionAsync("abc", doc, future));
+    TEST_ASSERT_TRUE(future.isDone());
+    TEST_ASSERT_FALSE(future.succeeded());
+    TEST_ASSERT_TRUE(future.wait(0));
+    TEST_ASSERT_EQUAL_STRING("Invalid transaction hash", future.getError().c_str());
+    TEST_ASSERT_EQUAL(0, futureCallbacks);
+    
+    // Reutilizable; el síncrono deja el mismo error en getLastError()
+    TEST_ASSERT_FALSE(network.getAccountAsync("GBAD", doc, future));
+    TEST_ASSERT_EQUAL_STRING("Invalid account ID", future.getError().c_str());
+    TEST_ASSERT_FALSE(network.getAccount("GBAD", doc));
+    TEST_ASSERT_EQUAL_STRING("Invalid account ID", network.getLastError().c_str());
+}
+
+void test_payment_request_reject() {
+    StellarKeypair* keypair = StellarKeypair::generate();
+    TEST_ASSERT_NOT_NULL(keypair);
+    StellarNetwork network(STELLAR_TESTNET);
+    StellarAccount account(keypair, &network);
+    StellarPayment payment(keypair, &network, &account);
+    PaymentRequest request;
+    
+    // Parámetros inválidos: terminado al volver, sin tocar la red
+    TEST_ASSERT_FALSE(payment.sendPaymentAsync("GBAD", 1.0f, nullptr, request));
+    TEST_ASSERT_TRUE(request.isDone());
+    TEST_ASSERT_FALSE(request.getResult().success);
+    TEST_ASSERT_EQUAL_STRING("Invalid destination address", request.getResult().error.c_str());
+    TEST_ASSERT_TRUE(payment.poll(request));
+    
+    // Reutilizable
+    const char* destination = "GBY5AZJYQNUD22NLNEX23NWIFWALIGDRQY2X7W6TPNYHJWY6TCV7W64I";
+    TEST_ASSERT_FALSE(payment.sendPaymentAsync(destination, 1.0f, "12345678901234567890123456789", request));
+    TEST_ASSERT_EQUAL_STRING("Memo too long (max 28 bytes)", request.getResult().error.c_str());
+    
+    delete keypair;
+}
+
+#define RANDOM_CHUNK 32
+#define RANDOM_CHUNKS_PER_TASK 256
+
+static bool randomStart = false;
+
+struct RandomTask {
+    uint8_t output[RANDOM_CHUNKS_PER_TASK * RANDOM_CHUNK];
+    bool done;
+};
+
+static void fillFromTask(void* context) {
+    RandomTask* task = (RandomTask*)context;
+    // Espera activa: las dos tareas arrancan a la vez y se solapan
+    while (!__atomic_load_n(&randomStart, __ATOMIC_ACQUIRE)) {}
+    for (size_t i = 0; i < RANDOM_CHUNKS_PER_TASK; i++) {
+        StellarRandom::fill(task->output + i * RANDOM_CHUNK, RANDOM_CHUNK);
+    }
+    __atomic_store_n(&task->done, true, __ATOMIC_RELEASE);
+    vTaskDelete(nullptr);
+}
+
+void test_random_two_tasks() {
+    static const uint8_t seed[] = "stellar-random-tasks";
+    static uint8_t reference[2 * RANDOM_CHUNKS_PER_TASK * RANDOM_CHUNK];
+    static RandomTask tasks[2];
+    bool used[2 * RANDOM_CHUNKS_PER_TASK] = {false};
+    
+    // Secuencia de referencia desde una sola tarea
+    DeterministicEntropySource source(seed, sizeof(seed));
+    StellarRandom::setEntropySource(&source);
+    StellarRandom::fill(reference, sizeof(reference));
+    
+    // La misma secuencia repartida entre dos tareas en cores distintos
+    DeterministicEntropySource again(seed, sizeof(seed));
+    StellarRandom::setEntropySource(&again);
+    randomStart = false;
+    for (int t = 0; t < 2; t++) {
+        tasks[t].done = false;
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(
+            fillFromTask, "rand", 4096, &tasks[t], 1, nullptr, t));
+    }
+    __atomic_store_n(&randomStart, true, __ATOMIC_RELEASE);
+    for (int t = 0; t < 2; t++) {
+        while (!__atomic_load_n(&tasks[t].done, __ATOMIC_ACQUIRE)) delay(1);
+    }
+    StellarRandom::setEntropySource(nullptr);
+    
+    // Serializado: cada trozo es un trozo distinto de la referencia
+    for (int t = 0; t < 2; t++) {
+        for (size_t i = 0; i < RANDOM_CHUNKS_PER_TASK; i++) {
+            const uint8_t* chunk = tasks[t].output + i * RANDOM_CHUNK;
+            bool found = false;
+            for (size_t k = 0; k < 2 * RANDOM_CHUNKS_PER_TASK && !found; k++) {
+                if (!used[k] && memcmp(chunk, reference + k * RANDOM_CHUNK, RANDOM_CHUNK) == 0) {
+                    used[k] = found = true;
+                }
+            }
+            TEST_ASSERT_TRUE_MESSAGE(found, "Interleaved DRBG output");
+        }
+    }
+}
+
 void test_valid_amount() {
     TEST_ASSERT_TRUE(StellarUtils::isValidAmount(1.0f));
     TEST_ASSERT_TRUE(StellarUtils::isValidAmount(0.0000001f));
@@ -95,6 +1378,25 @@ void test_valid_memo() {
     TEST_ASSERT_FALSE(StellarUtils::isValidMemo("12345678901234567890123456789"));  // 29 chars
 }
 
+void test_crypto_bench_budget() {
+    // Los tiempos dependen de la placa y la carga: solo se informan.
+    // El presupuesto se exige en el entorno esp32_bench
+    BenchResult results[STELLAR_BENCH_MAX_RESULTS];
+    size_t count = StellarBench::run(results, STELLAR_BENCH_MAX_RESULTS, 8);
+    
+    TEST_ASSERT_GREATER_THAN(0, count);
+    
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT_GREATER_THAN(0, results[i].iterations);
+        TEST_ASSERT_TRUE(results[i].opsPerSecond > 0.0f);
+        TEST_MESSAGE(StellarBench::formatResult(results[i]).c_str());
+        
+#ifdef STELLAR_BENCH_ENFORCE_BUDGET
+        TEST_ASSERT_TRUE_MESSAGE(results[i].withinBudget, StellarBench::formatResult(results[i]).c_str());
+#endif
+    }
+}
+
 void setup() {
     delay(2000);  // Esperar a que el serial esté listo
     
@@ -107,9 +1409,36 @@ void setup() {
     RUN_TEST(test_hex_encode);
     RUN_TEST(test_hex_decode);
     RUN_TEST(test_crc16_xmodem);
+    RUN_TEST(test_crc16_xmodem_table);
     RUN_TEST(test_valid_address);
+    RUN_TEST(test_strkey_roundtrip);
+    RUN_TEST(test_bip39_entropy);
+    RUN_TEST(test_sep0005_derivation);
+    RUN_TEST(test_keypair_move);
+    RUN_TEST(test_keypair_generate_keeps_node);
+    RUN_TEST(test_signing_context_rekey);
+    RUN_TEST(test_keyring_hint_lookup);
+    RUN_TEST(test_ed25519_rfc8032);
+    RUN_TEST(test_ed25519_verify_batch);
+    RUN_TEST(test_xdr_decode_results);
+    RUN_TEST(test_xdr_decode_envelopes);
+    RUN_TEST(test_xdr_decode_malformed);
+    RUN_TEST(test_xdr_encode_asset);
+    RUN_TEST(test_xdr_encode_memo);
+    RUN_TEST(test_pbkdf2_known_answers);
+    RUN_TEST(test_wallet_v1_upgrade);
+    RUN_TEST(test_aes_gcm_stream_chunked);
+    RUN_TEST(test_secure_file_tamper);
+    RUN_TEST(test_base64_form_stream);
+    RUN_TEST(test_http_body_chunked);
+    RUN_TEST(test_sse_parser);
+    RUN_TEST(test_network_future_reject);
+    RUN_TEST(test_payment_request_reject);
+    RUN_TEST(test_payment_template_matches_schema);
+    RUN_TEST(test_random_two_tasks);
     RUN_TEST(test_valid_amount);
     RUN_TEST(test_valid_memo);
+    RUN_TEST(test_crypto_bench_budget);
     
     UNITY_END();
 }